@@ -0,0 +1,51 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+//printf
+
+#include <time.h>
+//clock_gettime
+
+#pragma once
+
+//time how long Iterations runs of Body take and print the time per run
+//Body is a lambda taking the current iteration so the compiler cant hoist it out of the loop
+template<typename TBody>
+double Bench(const char* Name, unsigned long Iterations, TBody Body)
+{
+    timespec Start, End;
+
+    clock_gettime(CLOCK_MONOTONIC, &Start);
+
+    for(unsigned long I = 0; I < Iterations; I++)
+        Body(I);
+
+    clock_gettime(CLOCK_MONOTONIC, &End);
+
+    const double Nanos = ((End.tv_sec - Start.tv_sec) * 1e9) + (End.tv_nsec - Start.tv_nsec);
+    const double PerRun = Nanos / Iterations;
+
+    printf("%-40s %12.2f ns/run\n", Name, PerRun);
+
+    return PerRun;
+}
+
+//stop the optimizer from throwing away a result
+template<typename T>
+inline void Keep(const T& Value)
+{
+    asm volatile("" : : "r,m"(Value) : "memory");
+}
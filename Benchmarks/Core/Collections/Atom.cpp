@@ -0,0 +1,79 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Collections/Atom.h>
+#include <Core/Collections/Map.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Count = 256;
+constexpr unsigned long Iterations = 2000000;
+
+int main()
+{
+    //identifiers that share a long prefix so comparing them has to read most of the text
+    static String Strings[Count];
+    static String Copies[Count];
+    static Atom Atoms[Count];
+
+    char Buffer[64];
+
+    for(unsigned long I = 0; I < Count; I++)
+    {
+        snprintf(Buffer, sizeof(Buffer), "Renderer.Pipeline.Shader.Uniform%lu", I);
+        Strings[I] = Buffer;
+        Copies[I] = Buffer;
+        Atoms[I] = Buffer;
+    }
+
+    Bench("String ==", Iterations, [&](unsigned long I) {
+        Keep(Strings[I % Count] == Copies[(I * 7) % Count]);
+    });
+
+    Bench("Atom ==", Iterations, [&](unsigned long I) {
+        Keep(Atoms[I % Count] == Atoms[(I * 7) % Count]);
+    });
+
+    Bench("Hash String", Iterations, [&](unsigned long I) {
+        Keep(Utils::Hash(Strings[I % Count]));
+    });
+
+    Bench("Hash Atom", Iterations, [&](unsigned long I) {
+        Keep(Utils::Hash(Atoms[I % Count]));
+    });
+
+    Bench("Atom from known text", Iterations, [&](unsigned long I) {
+        Keep(Atom(Strings[I % Count]).CStr());
+    });
+
+    Map<String, U32> ByString;
+    Map<Atom, U32> ByAtom;
+
+    for(unsigned long I = 0; I < Count; I++)
+    {
+        ByString.Add(Strings[I], I);
+        ByAtom.Add(Atoms[I], I);
+    }
+
+    Bench("Map<String> lookup", Iterations, [&](unsigned long I) {
+        Keep(ByString.Get(Copies[I % Count], 0));
+    });
+
+    Bench("Map<Atom> lookup", Iterations, [&](unsigned long I) {
+        Keep(ByAtom.Get(Atoms[I % Count], 0));
+    });
+}
@@ -0,0 +1,121 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Collections/CompressedStringTable.h>
+#include <Core/Text/Format.h>
+
+using namespace Cthulhu;
+
+constexpr U32 Count = 1000000;
+constexpr unsigned long Iterations = 2000000;
+
+U64 State = 0x9E3779B97F4A7C15ULL;
+
+U32 Random(U32 Limit)
+{
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return (U32)(State % Limit);
+}
+
+int main()
+{
+    static const char* Hosts[] = { "www.example.com", "images.example.com", "api.example.org", "cdn.static-content.net", "docs.example.io" };
+    static const char* Dirs[] = { "users", "products/catalog", "search", "assets/javascript", "assets/stylesheets", "blog/2018", "api/v2/orders" };
+    static const char* Files[] = { "index.html", "profile", "details.json", "main.min.js", "theme.css", "comments" };
+
+    //a mix of urls and file paths with the kind of repetition real ones have
+    Array<String> Texts(Count);
+
+    for(U32 I = 0; I < Count; I++)
+    {
+        if(I % 4 == 3)
+            Texts[I] = Format(FMT("/home/user/projects/{}/src/{}/{}.cpp"), Dirs[Random(7)], Files[Random(6)], Random(100000));
+        else
+            Texts[I] = Format(FMT("https://{}/{}/{}?id={}"), Hosts[Random(5)], Dirs[Random(7)], Files[Random(6)], Random(10000000));
+    }
+
+    Array<StringView> Sample;
+
+    for(U32 I = 0; I < Count; I += 97)
+        Sample.Append(StringView(Texts[I]));
+
+    CompressedStringTable* Table = nullptr;
+
+    Bench("Train on 10k strings", 1, [&](unsigned long) {
+        Table = new CompressedStringTable(Sample);
+    });
+
+    Bench("Add", Count, [&](unsigned long I) {
+        Keep(Table->Add(Texts[I]));
+    });
+
+    //a String per entry pays for the object and its allocation, malloc headers not included
+    U64 Plain = 0, Strings = 0;
+
+    for(U32 I = 0; I < Count; I++)
+    {
+        Plain += Texts[I].Len();
+        Strings += sizeof(String) + Texts[I].RealSize() + 1;
+    }
+
+    printf("%u strings, %llu bytes of text, %u symbols\n", Count, (unsigned long long)Plain, Table->Symbols());
+    printf("Array<String>             %12llu bytes\n", (unsigned long long)Strings);
+    printf("CompressedStringTable     %12llu bytes (%.2fx smaller than the text, %.2fx smaller than Strings)\n",
+        (unsigned long long)Table->MemoryUsed(), (double)Plain / Table->MemoryUsed(), (double)Strings / Table->MemoryUsed());
+
+    BufferWriter Out;
+
+    Bench("String copy", Iterations, [&](unsigned long I) {
+        String Copy = Texts[(I * 7919) % Count];
+        Keep(Copy.CStr());
+    });
+
+    Bench("Get", Iterations, [&](unsigned long I) {
+        String Copy = Table->Get((I * 7919) % Count);
+        Keep(Copy.CStr());
+    });
+
+    Bench("DecompressTo reused writer", Iterations, [&](unsigned long I) {
+        Out.Reset();
+        Table->DecompressTo((I * 7919) % Count, Out);
+        Keep(Out.Data);
+    });
+
+    Bench("String ==", Iterations, [&](unsigned long I) {
+        Keep(Texts[(I * 7919) % Count] == Texts[(I * 104729) % Count]);
+    });
+
+    Bench("Equal on compressed entries", Iterations, [&](unsigned long I) {
+        Keep(Table->Equal((I * 7919) % Count, (I * 104729) % Count));
+    });
+
+    Bench("Equals against text", Iterations, [&](unsigned long I) {
+        Keep(Table->Equals((I * 7919) % Count, Texts[(I * 7919) % Count]));
+    });
+
+    Bench("String StartsWith", Iterations, [&](unsigned long I) {
+        Keep(Texts[(I * 7919) % Count].StartsWith("https://images."));
+    });
+
+    Bench("StartsWith on compressed entry", Iterations, [&](unsigned long I) {
+        Keep(Table->StartsWith((I * 7919) % Count, "https://images."));
+    });
+
+    delete Table;
+}
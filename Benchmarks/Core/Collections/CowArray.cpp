@@ -0,0 +1,109 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <pthread.h>
+
+#include <Core/Collections/CowArray.h>
+#include <Core/Collections/Array.h>
+
+using namespace Cthulhu;
+
+constexpr U32 Items = 100000;
+constexpr unsigned long Iterations = 20000;
+
+//a reader takes a snapshot and looks at a few items, which is what most readers do
+template<typename TArray>
+U64 Read(const TArray& Snapshot, unsigned long I)
+{
+    return Snapshot[(U32)(I % Items)] + Snapshot[(U32)((I * 7) % Items)];
+}
+
+struct ReaderState
+{
+    CowArray<U64> Latest;
+    Atomic<bool> Done;
+};
+
+void* Readers(void* Data)
+{
+    ReaderState& State = *(ReaderState*)Data;
+    U64 Sum = 0;
+
+    for(unsigned long I = 0; !State.Done.Load(MemoryOrder::Relaxed); I++)
+    {
+        CowArray<U64> Mine = State.Latest.Snapshot();
+        Sum += Read(Mine, I);
+    }
+
+    Keep(Sum);
+    return nullptr;
+}
+
+int main()
+{
+    Array<U64> Plain;
+    Plain.Reserve(Items);
+
+    for(U32 I = 0; I < Items; I++)
+        Plain.Append(I);
+
+    CowArray<U64> Cow(Plain);
+
+    Bench("Array copy per reader", Iterations, [&](unsigned long I) {
+        Array<U64> Snapshot = Plain;
+        Keep(Read(Snapshot, I));
+    });
+
+    Bench("CowArray snapshot per reader", Iterations, [&](unsigned long I) {
+        CowArray<U64> Snapshot = Cow.Snapshot();
+        Keep(Read(Snapshot, I));
+    });
+
+    //one write in every hundred reads, the writer pays for one copy and the readers pay nothing
+    Bench("Array copy, 1% writes", Iterations, [&](unsigned long I) {
+        Array<U64> Snapshot = Plain;
+        if(I % 100 == 0)
+            Plain[(U32)(I % Items)]++;
+
+        Keep(Read(Snapshot, I));
+    });
+
+    Bench("CowArray snapshot, 1% writes", Iterations, [&](unsigned long I) {
+        CowArray<U64> Snapshot = Cow.Snapshot();
+        if(I % 100 == 0)
+            Cow.At((U32)(I % Items))++;
+
+        Keep(Read(Snapshot, I));
+    });
+
+    //snapshots taken on other threads at the same time, the count is the only thing shared
+    ReaderState State{ Cow, false };
+    pthread_t Threads[3];
+
+    for(pthread_t& Each : Threads)
+        pthread_create(&Each, nullptr, Readers, &State);
+
+    Bench("CowArray snapshot, 3 more readers", Iterations * 100, [&](unsigned long I) {
+        CowArray<U64> Snapshot = State.Latest.Snapshot();
+        Keep(Read(Snapshot, I));
+    });
+
+    State.Done.Store(true);
+
+    for(pthread_t& Each : Threads)
+        pthread_join(Each, nullptr);
+}
@@ -0,0 +1,71 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Collections/Rope.h>
+
+using namespace Cthulhu;
+
+constexpr U32 Size = 4 * 1024 * 1024;
+
+int main()
+{
+    //a multi megabyte log with a line every 80 characters
+    char* Text = new char[Size + 1];
+
+    for(U32 I = 0; I < Size; I++)
+        Text[I] = (I % 80 == 79) ? '\n' : (char)('a' + (I % 26));
+
+    Text[Size] = '\0';
+
+    String Flat = Text;
+    Rope Tree(Text, Size);
+
+    //String has no insert so this is what callers have to do today
+    Bench("String insert middle", 200, [&](unsigned long I) {
+        const U32 At = (U32)((I * 7919) % Flat.Len());
+        Flat = Flat.SubString(0, At) + String("edit") + Flat.SubString(At, Flat.Len() - At);
+        Keep(Flat.Len());
+    });
+
+    Bench("Rope insert middle", 200000, [&](unsigned long I) {
+        const U32 At = (U32)((I * 7919) % Tree.Len());
+        Tree.Insert(At, "edit");
+        Keep(Tree.Len());
+    });
+
+    Bench("Rope erase middle", 200000, [&](unsigned long I) {
+        const U32 At = (U32)((I * 7919) % (Tree.Len() - 4));
+        Tree.Erase(At, 4);
+        Keep(Tree.Len());
+    });
+
+    Bench("Rope slice", 200000, [&](unsigned long I) {
+        const U32 At = (U32)((I * 7919) % (Tree.Len() / 2));
+        Keep(Tree.Slice(At, Tree.Len() / 4).Len());
+    });
+
+    Bench("Rope line start", 200000, [&](unsigned long I) {
+        Keep(Tree.LineStart((U32)(I % (Tree.LineCount() - 1))));
+    });
+
+    Bench("Rope snapshot", 2000000, [&](unsigned long I) {
+        Rope Saved = Tree;
+        Keep(Saved.Len());
+    });
+
+    delete[] Text;
+}
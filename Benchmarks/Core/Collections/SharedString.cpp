@@ -0,0 +1,83 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Collections/SharedString.h>
+#include <Core/Collections/Array.h>
+#include <Core/Collections/Option.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Count = 256;
+constexpr unsigned long Iterations = 2000000;
+
+template<typename T>
+Option<T> Lookup(const T* Items, unsigned long I)
+{
+    return Some(Items[I % Count]);
+}
+
+int main()
+{
+    //paths and messages like the ones that get passed between systems
+    static String Strings[Count];
+    static SharedString Shared[Count];
+
+    char Buffer[128];
+
+    for(unsigned long I = 0; I < Count; I++)
+    {
+        snprintf(Buffer, sizeof(Buffer), "Assets/Textures/Environment/Terrain/Rock%lu_Albedo_4096x4096.png", I);
+        Strings[I] = Buffer;
+        Shared[I] = Buffer;
+    }
+
+    Bench("String copy", Iterations, [&](unsigned long I) {
+        String Copy = Strings[I % Count];
+        Keep(Copy.CStr());
+    });
+
+    Bench("SharedString copy", Iterations, [&](unsigned long I) {
+        SharedString Copy = Shared[I % Count];
+        Keep(Copy.CStr());
+    });
+
+    Bench("String through Option", Iterations, [&](unsigned long I) {
+        Keep(Lookup(Strings, I).Get().Len());
+    });
+
+    Bench("SharedString through Option", Iterations, [&](unsigned long I) {
+        Keep(Lookup(Shared, I).Get().Len());
+    });
+
+    Bench("Array<String> fill 256", Iterations / 256, [&](unsigned long) {
+        Array<String> Items;
+
+        for(unsigned long I = 0; I < Count; I++)
+            Items.Append(Strings[I]);
+
+        Keep(Items.Len());
+    });
+
+    Bench("Array<SharedString> fill 256", Iterations / 256, [&](unsigned long) {
+        Array<SharedString> Items;
+
+        for(unsigned long I = 0; I < Count; I++)
+            Items.Append(Shared[I]);
+
+        Keep(Items.Len());
+    });
+}
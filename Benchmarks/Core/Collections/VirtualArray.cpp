@@ -0,0 +1,66 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Collections/VirtualArray.h>
+#include <Core/Collections/Array.h>
+
+using namespace Cthulhu;
+
+/**
+ * appends are timed in windows of 64mb each so a copy shows up as a spike in one
+ * window rather than being averaged away. the reservation is 64gb, the same as a
+ * buffer that could grow to tens of gb, but only 1gb is filled so it fits in memory.
+ * how much is reserved makes no difference to the cost of appending
+ */
+constexpr U64 Reserved = 64ULL * 1024 * 1024 * 1024 / sizeof(U64);
+constexpr U32 WindowItems = 8 * 1024 * 1024;
+constexpr U32 Windows = 16;
+
+int main()
+{
+    char Label[64];
+
+    {
+        //the usual way to grow, doubling so appending is amortized but every doubling copies
+        Array<U64> Doubling;
+
+        for(U32 Window = 0; Window < Windows; Window++)
+        {
+            snprintf(Label, sizeof(Label), "Array doubling up to %4u mb", (Window + 1) * 64);
+            Bench(Label, WindowItems, [&](unsigned long I) {
+                if(Doubling.Len() + 1 >= Doubling.RealSize())
+                    Doubling.Reserve(Doubling.Len());
+
+                Doubling.Append(I);
+            });
+        }
+
+        Keep(Doubling[Doubling.Len() - 1]);
+    }
+
+    VirtualArray<U64> Stable(Reserved);
+
+    for(U32 Window = 0; Window < Windows; Window++)
+    {
+        snprintf(Label, sizeof(Label), "VirtualArray up to %4u mb", (Window + 1) * 64);
+        Bench(Label, WindowItems, [&](unsigned long I) {
+            Stable.Append(I);
+        });
+    }
+
+    Keep(Stable.Back());
+}
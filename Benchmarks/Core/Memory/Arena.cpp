@@ -0,0 +1,87 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Memory/Arena.h>
+#include <Core/Collections/Map.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Iterations = 20000;
+
+//what handling one request looks like, a few hundred short lived strings, arrays and map nodes
+template<typename TMake>
+U32 HandleRequest(unsigned long Id, TMake Make)
+{
+    auto Parts = Make.Strings();
+    auto Counts = Make.Counts();
+
+    for(U32 I = 0; I < 200; I++)
+    {
+        auto Part = Make.Text();
+        Part += "header-";
+        Part += (char)('a' + (I % 26));
+        Part += "-value";
+
+        Parts.Append(Part);
+        Counts[(U32)((Id + I) % 64)] += Part.Len();
+    }
+
+    return Parts.Len() + Counts.Get(0, 0);
+}
+
+struct HeapMaker
+{
+    Array<String> Strings() { return Array<String>(); }
+    Map<U32, U32> Counts() { return Map<U32, U32>(); }
+    String Text() { return String(); }
+};
+
+struct ArenaMaker
+{
+    Memory::Arena* Scratch;
+
+    Array<String> Strings() { return Array<String>(*Scratch); }
+    Map<U32, U32> Counts() { return Map<U32, U32>(*Scratch); }
+    String Text() { return String(*Scratch); }
+};
+
+int main()
+{
+    Bench("heap containers per request", Iterations, [&](unsigned long I) {
+        Keep(HandleRequest(I, HeapMaker{}));
+    });
+
+    Memory::Arena Scratch;
+
+    Bench("arena containers per request", Iterations, [&](unsigned long I) {
+        Keep(HandleRequest(I, ArenaMaker{ &Scratch }));
+        Scratch.Reset();
+    });
+
+    Bench("Arena::Allocate 32 bytes", Iterations * 1000, [&](unsigned long I) {
+        Keep(Scratch.Allocate(32));
+
+        if((I & 0xFFFF) == 0)
+            Scratch.Reset();
+    });
+
+    Bench("new[] and delete[] 32 bytes", Iterations * 1000, [&](unsigned long) {
+        Byte* Data = new Byte[32];
+        Keep(Data);
+        delete[] Data;
+    });
+}
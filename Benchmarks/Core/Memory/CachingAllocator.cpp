@@ -0,0 +1,178 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "../../Benchmark.h"
+
+#include <Core/Memory/CachingAllocator.h>
+
+using namespace Cthulhu;
+
+constexpr U32 MaxThreads = 16;
+constexpr U32 Live = 4096;
+constexpr U32 Operations = 1000000;
+
+struct Allocator
+{
+    void* (*Alloc)(size_t);
+    void (*Free)(void*);
+};
+
+void* CachedAllocProc(size_t Size) { return Memory::CachedAlloc(Size); }
+void CachedFreeProc(void* Ptr) { Memory::CachedFree(Ptr); }
+
+const Allocator System = { malloc, free };
+const Allocator Cached = { CachedAllocProc, CachedFreeProc };
+
+const Allocator* Current = nullptr;
+
+//mostly small sizes with the odd big one like a server handling requests would see
+void* Churn(void* Arg)
+{
+    U64 Seed = (U64)Arg * 7919 + 1;
+    void* Slots[Live] = {};
+
+    for(U32 I = 0; I < Operations; I++)
+    {
+        Seed ^= Seed << 13;
+        Seed ^= Seed >> 7;
+        Seed ^= Seed << 17;
+
+        const U32 Which = (U32)(Seed % Live);
+        const U32 Size = 1 + (U32)((Seed >> 20) % ((Seed & 63) == 0 ? 16384 : 256));
+
+        Current->Free(Slots[Which]);
+        Slots[Which] = Current->Alloc(Size);
+        Keep(Slots[Which]);
+    }
+
+    for(U32 I = 0; I < Live; I++)
+        Current->Free(Slots[I]);
+
+    return nullptr;
+}
+
+constexpr U32 QueueSize = 1024;
+
+//one thread allocates and the other frees so nothing is ever freed where it was made
+struct Queue
+{
+    void* Items[QueueSize];
+    volatile U32 Head;
+    volatile U32 Tail;
+};
+
+Queue Pipes[MaxThreads / 2];
+
+void* Producer(void* Arg)
+{
+    Queue& Pipe = Pipes[(U64)Arg];
+
+    for(U32 I = 0; I < Operations; I++)
+    {
+        void* Item = Current->Alloc(16 + (I % 8) * 16);
+
+        while(__atomic_load_n(&Pipe.Head, __ATOMIC_ACQUIRE) - __atomic_load_n(&Pipe.Tail, __ATOMIC_ACQUIRE) == QueueSize)
+            sched_yield();
+
+        Pipe.Items[Pipe.Head % QueueSize] = Item;
+        __atomic_store_n(&Pipe.Head, Pipe.Head + 1, __ATOMIC_RELEASE);
+    }
+
+    return nullptr;
+}
+
+void* Consumer(void* Arg)
+{
+    Queue& Pipe = Pipes[(U64)Arg];
+
+    for(U32 I = 0; I < Operations; I++)
+    {
+        while(__atomic_load_n(&Pipe.Tail, __ATOMIC_ACQUIRE) == __atomic_load_n(&Pipe.Head, __ATOMIC_ACQUIRE))
+            sched_yield();
+
+        Current->Free(Pipe.Items[Pipe.Tail % QueueSize]);
+        __atomic_store_n(&Pipe.Tail, Pipe.Tail + 1, __ATOMIC_RELEASE);
+    }
+
+    return nullptr;
+}
+
+void Run(U32 Threads, void* (*Body)(void*))
+{
+    pthread_t Handles[MaxThreads];
+
+    for(U64 I = 0; I < Threads; I++)
+        pthread_create(&Handles[I], nullptr, Body, (void*)I);
+
+    for(U32 I = 0; I < Threads; I++)
+        pthread_join(Handles[I], nullptr);
+}
+
+void Compare(const char* Name, U32 Threads)
+{
+    char Label[64];
+
+    //each run is Operations per thread so a flat time as threads go up means it scales
+    snprintf(Label, sizeof(Label), "malloc %s x%u", Name, Threads);
+    Current = &System;
+    Bench(Label, 3, [&](unsigned long) { Run(Threads, Churn); });
+
+    snprintf(Label, sizeof(Label), "CachedAlloc %s x%u", Name, Threads);
+    Current = &Cached;
+    Bench(Label, 3, [&](unsigned long) { Run(Threads, Churn); });
+}
+
+void RunPairs(U32 Pairs)
+{
+    pthread_t Handles[MaxThreads];
+
+    for(U64 I = 0; I < Pairs; I++)
+    {
+        Pipes[I].Head = 0;
+        Pipes[I].Tail = 0;
+        pthread_create(&Handles[I * 2], nullptr, Producer, (void*)I);
+        pthread_create(&Handles[I * 2 + 1], nullptr, Consumer, (void*)I);
+    }
+
+    for(U32 I = 0; I < Pairs * 2; I++)
+        pthread_join(Handles[I], nullptr);
+}
+
+int main()
+{
+    const U32 Threads[] = { 1, 4, 16 };
+
+    for(U32 Count : Threads)
+        Compare("churn", Count);
+
+    const U32 Pairs[] = { 1, 4 };
+
+    for(U32 Count : Pairs)
+    {
+        char Label[64];
+
+        snprintf(Label, sizeof(Label), "malloc handoff x%u pairs", Count);
+        Current = &System;
+        Bench(Label, 3, [&](unsigned long) { RunPairs(Count); });
+
+        snprintf(Label, sizeof(Label), "CachedAlloc handoff x%u pairs", Count);
+        Current = &Cached;
+        Bench(Label, 3, [&](unsigned long) { RunPairs(Count); });
+    }
+}
@@ -0,0 +1,73 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Memory/FrameAllocator.h>
+#include <Core/Collections/Array.h>
+#include <Core/Collections/CthulhuString.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Frames = 20000;
+
+//what one tick of a simulation looks like, contacts gathered into an array and a few labels built
+template<typename TMake>
+U64 Tick(unsigned long Frame, TMake Make)
+{
+    U64 Ret = 0;
+
+    for(U32 Body = 0; Body < 16; Body++)
+    {
+        Array<U32> Contacts = Make.Contacts();
+
+        for(U32 I = 0; I < 100; I++)
+            Contacts.Append((U32)(Frame + Body * I));
+
+        String Label = Make.Text();
+        Label += "body-";
+        Label += (char)('a' + Body);
+
+        Ret += Contacts[Contacts.Len() - 1] + Label.Len();
+    }
+
+    return Ret;
+}
+
+struct HeapMaker
+{
+    Array<U32> Contacts() { return Array<U32>(); }
+    String Text() { return String(); }
+};
+
+struct FrameMaker
+{
+    Array<U32> Contacts() { return Array<U32>(Memory::Frames()); }
+    String Text() { return String(Memory::Frames()); }
+};
+
+int main()
+{
+    Bench("heap scratch per tick", Frames, [&](unsigned long I) {
+        Keep(Tick(I, HeapMaker{}));
+    });
+
+    Bench("frame scratch per tick", Frames, [&](unsigned long I) {
+        Keep(Tick(I, FrameMaker{}));
+        Memory::NextFrame();
+    });
+
+    printf("high water %llu bytes\n", (unsigned long long)Memory::Frames().HighWater());
+}
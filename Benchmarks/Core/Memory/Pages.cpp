@@ -0,0 +1,70 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Memory/Pages.h>
+#include <Core/Memory/Memory.h>
+
+using namespace Cthulhu;
+
+//far bigger than the tlb can cover with normal pages
+constexpr U64 TableSize = 512ULL * 1024 * 1024;
+constexpr U64 Slots = TableSize / sizeof(U64);
+constexpr unsigned long Iterations = 20000000;
+
+//how many lookups ahead to prefetch
+constexpr U64 Ahead = 8;
+
+U64 Hash(U64 Value)
+{
+    Value ^= Value >> 33;
+    Value *= 0xFF51AFD7ED558CCDULL;
+    Value ^= Value >> 33;
+    return Value;
+}
+
+void Lookups(const char* Name, Memory::PageFlags Flags)
+{
+    U64* Table = (U64*)Memory::MapPages(TableSize, Flags | Memory::PageFlags::Populate);
+
+    for(U64 I = 0; I < Slots; I++)
+        Table[I] = I;
+
+    char Label[64];
+    U64 Sum = 0;
+
+    snprintf(Label, sizeof(Label), "random lookups %s", Name);
+    Bench(Label, Iterations, [&](unsigned long I) {
+        Sum += Table[Hash(I) % Slots];
+    });
+
+    //a hash table probe knows its next few keys so it can start loading them early
+    snprintf(Label, sizeof(Label), "random lookups %s prefetched", Name);
+    Bench(Label, Iterations, [&](unsigned long I) {
+        Memory::Prefetch(&Table[Hash(I + Ahead) % Slots]);
+        Sum += Table[Hash(I) % Slots];
+    });
+
+    Keep(Sum);
+
+    Memory::UnmapPages(Table, TableSize, Flags | Memory::PageFlags::Populate);
+}
+
+int main()
+{
+    Lookups("normal pages", Memory::PageFlags::None);
+    Lookups("huge pages", Memory::PageFlags::HugePages);
+}
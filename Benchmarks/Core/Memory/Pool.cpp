@@ -0,0 +1,104 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Memory/Pool.h>
+#include <Core/Collections/Map.h>
+
+using namespace Cthulhu;
+
+constexpr U32 Live = 100000;
+constexpr unsigned long Iterations = 5000000;
+
+U64 State = 0x9E3779B97F4A7C15ULL;
+
+U32 Random(U32 Limit)
+{
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return (U32)(State % Limit);
+}
+
+struct Node
+{
+    U64 Key;
+    U64 Value;
+    Node* Next;
+};
+
+Node* Slots[Live];
+
+int main()
+{
+    //keep a working set alive and replace random members of it, the way a map under
+    //insert and erase churn treats its nodes
+    for(U32 I = 0; I < Live; I++)
+        Slots[I] = new Node{ I, I, nullptr };
+
+    Bench("new and delete churn", Iterations, [&](unsigned long I) {
+        const U32 Which = Random(Live);
+        delete Slots[Which];
+        Slots[Which] = new Node{ I, I, nullptr };
+    });
+
+    for(U32 I = 0; I < Live; I++)
+        delete Slots[I];
+
+    Memory::Pool<Node> Nodes;
+
+    for(U32 I = 0; I < Live; I++)
+        Slots[I] = Nodes.New(Node{ I, I, nullptr });
+
+    Bench("Pool<T> churn", Iterations, [&](unsigned long I) {
+        const U32 Which = Random(Live);
+        Nodes.Delete(Slots[Which]);
+        Slots[Which] = Nodes.New(Node{ I, I, nullptr });
+    });
+
+    for(U32 I = 0; I < Live; I++)
+        Slots[I] = Memory::PoolNew<Node>(Node{ I, I, nullptr });
+
+    Bench("PoolNew churn", Iterations, [&](unsigned long I) {
+        const U32 Which = Random(Live);
+        Memory::PoolDelete(Slots[Which]);
+        Slots[Which] = Memory::PoolNew<Node>(Node{ I, I, nullptr });
+    });
+
+    for(U32 I = 0; I < Live; I++)
+        Memory::PoolDelete(Slots[I]);
+
+    //maps have a fixed number of buckets so keep the chains short enough that allocation matters
+    Map<U32, U64> Table;
+
+    for(U32 I = 0; I < 1000; I++)
+        Table.Add(I, I);
+
+    Bench("Map Remove and Add churn", Iterations, [&](unsigned long I) {
+        const U32 Key = Random(1000);
+        Table.Remove(Key);
+        Table.Add(Key, I);
+    });
+
+    Bench("Map build and destroy 1000 nodes", Iterations / 1000, [&](unsigned long I) {
+        Map<U32, U32> Small;
+
+        for(U32 J = 0; J < 1000; J++)
+            Small.Add(J, J);
+
+        Keep(Small.Get((U32)I % 1000, 0));
+    });
+}
@@ -0,0 +1,121 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <memory>
+//std::shared_ptr std::make_shared
+
+#include <pthread.h>
+
+#include <Core/Memory/Shared.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Iterations = 10000000;
+
+struct Payload
+{
+    U64 Values[4];
+
+    Payload(U64 Seed) : Values{ Seed, Seed + 1, Seed + 2, Seed + 3 } {}
+};
+
+struct SharablePayload : Sharable<SharablePayload>
+{
+    U64 Values[4];
+
+    SharablePayload(U64 Seed) : Values{ Seed, Seed + 1, Seed + 2, Seed + 3 } {}
+};
+
+//the same operations for every kind of pointer so the numbers line up
+template<typename TPtr, typename TWeak, typename TMake>
+void Run(const char* Name, TMake Make)
+{
+    char Label[64];
+
+    snprintf(Label, sizeof(Label), "%s make", Name);
+    Bench(Label, Iterations, [&](unsigned long I) {
+        TPtr Made = Make(I);
+        Keep(Made.get()->Values[0]);
+    });
+
+    TPtr Source = Make(1);
+
+    snprintf(Label, sizeof(Label), "%s copy", Name);
+    Bench(Label, Iterations, [&](unsigned long I) {
+        TPtr Copy = Source;
+        Keep(Copy.get());
+    });
+
+    snprintf(Label, sizeof(Label), "%s move", Name);
+    Bench(Label, Iterations, [&](unsigned long I) {
+        TPtr Moved = (TPtr&&)Source;
+        Source = (TPtr&&)Moved;
+        Keep(Source.get());
+    });
+
+    if constexpr(!__is_same(TWeak, void))
+    {
+        TWeak Watcher = Source;
+
+        snprintf(Label, sizeof(Label), "%s weak lock", Name);
+        Bench(Label, Iterations, [&](unsigned long I) {
+            TPtr Locked = Watcher.lock();
+            Keep(Locked.get());
+        });
+    }
+}
+
+//std::shared_ptr spells things differently so the cthulhu pointers get small adaptors
+template<typename T, bool ThreadSafe>
+struct Adapt : Shared<T, ThreadSafe>
+{
+    Adapt(Shared<T, ThreadSafe>&& Other) : Shared<T, ThreadSafe>((Shared<T, ThreadSafe>&&)Other) {}
+    T* get() const { return this->Get(); }
+};
+
+template<typename T, bool ThreadSafe>
+struct AdaptWeak : Weak<T, ThreadSafe>
+{
+    AdaptWeak(const Shared<T, ThreadSafe>& Other) : Weak<T, ThreadSafe>(Other) {}
+    Adapt<T, ThreadSafe> lock() const { return this->Lock(); }
+};
+
+void* Nothing(void*) { return nullptr; }
+
+int main()
+{
+    //libstdc++ skips the atomics in std::shared_ptr until a second thread has existed
+    pthread_t Other;
+    pthread_create(&Other, nullptr, Nothing, nullptr);
+    pthread_join(Other, nullptr);
+
+    Run<std::shared_ptr<Payload>, std::weak_ptr<Payload>>("std::shared_ptr", [](U64 I) {
+        return std::make_shared<Payload>(I);
+    });
+
+    Run<Adapt<Payload, true>, AdaptWeak<Payload, true>>("Shared", [](U64 I) {
+        return Adapt<Payload, true>(MakeShared<Payload>(I));
+    });
+
+    Run<Adapt<Payload, false>, AdaptWeak<Payload, false>>("LocalShared", [](U64 I) {
+        return Adapt<Payload, false>(MakeLocalShared<Payload>(I));
+    });
+
+    Run<Adapt<SharablePayload, true>, void>("Sharable", [](U64 I) {
+        return Adapt<SharablePayload, true>(MakeShared<SharablePayload>(I));
+    });
+}
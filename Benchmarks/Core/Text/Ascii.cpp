@@ -0,0 +1,65 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <ctype.h>
+#include <strings.h>
+
+#include <Core/Text/Ascii.h>
+#include <Core/Collections/CthulhuString.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Iterations = 2000;
+
+int main()
+{
+    //64KB of mixed case text
+    String Text;
+    Text.Reserve(1 << 16);
+
+    for(U32 I = 0; I < (1 << 16); I++)
+        Text += "The Quick Brown Fox, "[I % 21];
+
+    String Other = Text.Upper();
+
+    Bench("toupper loop", Iterations, [&](unsigned long) {
+        for(char& C : Text)
+            C = (char)toupper(C);
+
+        Keep(Text[0]);
+    });
+
+    Bench("ToUpper in place", Iterations, [&](unsigned long) {
+        Keep(Text.ToUpper()[0]);
+    });
+
+    Bench("Lower copy", Iterations, [&](unsigned long) {
+        Keep(Text.Lower().Len());
+    });
+
+    Bench("strcasecmp", Iterations, [&](unsigned long) {
+        Keep(strcasecmp(Text.CStr(), Other.CStr()));
+    });
+
+    Bench("EqualsNoCase", Iterations, [&](unsigned long) {
+        Keep(Text.EqualsNoCase(Other));
+    });
+
+    Bench("TrimAny", Iterations * 1000, [&](unsigned long) {
+        Keep(Text.TrimAny().Len());
+    });
+}
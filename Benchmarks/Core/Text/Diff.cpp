@@ -0,0 +1,94 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <stdio.h>
+
+#include <Core/Text/Diff.h>
+#include <Core/Text/Format.h>
+#include <Meta/System.h>
+
+using namespace Cthulhu;
+
+constexpr U32 Lines = 150000;
+constexpr unsigned long Iterations = 10;
+
+U64 State = 0x9E3779B97F4A7C15ULL;
+
+U32 Random(U32 Limit)
+{
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return (U32)(State % Limit);
+}
+
+void Save(const char* Path, const String& Text)
+{
+    FILE* File = fopen(Path, "wb");
+    fwrite(Text.CStr(), 1, Text.Len(), File);
+    fclose(File);
+}
+
+int main()
+{
+    //a large generated config file and a copy with about 1% of its lines touched
+    String Old, New;
+
+    for(U32 I = 0; I < Lines; I++)
+    {
+        const U32 Value = Random(100000);
+
+        FormatInto(Old, FMT("section_{}.key_{} = {}\n"), I / 64, I, Value);
+
+        switch(Random(100))
+        {
+        case 0: FormatInto(New, FMT("section_{}.key_{} = {}\n"), I / 64, I, Value + 1); break;
+        case 1: break;
+        case 2: FormatInto(New, FMT("section_{}.key_{} = {}\nsection_{}.extra = 1\n"), I / 64, I, Value, I / 64); break;
+        default: FormatInto(New, FMT("section_{}.key_{} = {}\n"), I / 64, I, Value); break;
+        }
+    }
+
+    printf("old %u bytes, new %u bytes\n", Old.Len(), New.Len());
+
+    Save("/tmp/cthulhu-diff-old.txt", Old);
+    Save("/tmp/cthulhu-diff-new.txt", New);
+
+    Bench("System::Exec diff -u", Iterations, [&](unsigned long) {
+        Keep(System::Exec("diff -u /tmp/cthulhu-diff-old.txt /tmp/cthulhu-diff-new.txt").Len());
+    });
+
+    Bench("Utils::DiffLines", Iterations, [&](unsigned long) {
+        Keep(Utils::DiffLines(StringView(Old), StringView(New)).Edits.Len());
+    });
+
+    Bench("Utils::UnifiedDiff", Iterations, [&](unsigned long) {
+        Keep(Utils::UnifiedDiff(StringView(Old), StringView(New)).Len());
+    });
+
+    //one change near each end is mostly the prefix and suffix scans
+    String Edge = New;
+    Edge[10] = '#';
+    Edge[Edge.Len() - 10] = '#';
+
+    Bench("Utils::UnifiedDiff two edits", Iterations, [&](unsigned long) {
+        Keep(Utils::UnifiedDiff(StringView(New), StringView(Edge)).Len());
+    });
+
+    remove("/tmp/cthulhu-diff-old.txt");
+    remove("/tmp/cthulhu-diff-new.txt");
+}
@@ -0,0 +1,71 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <Core/Text/Float.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Count = 1 << 16;
+constexpr unsigned long Iterations = 2000000;
+
+int main()
+{
+    //a spread of magnitudes like a metrics export would see
+    static F64 Values[Count];
+    static char Text[Count][Utils::MaxFloatChars + 1];
+    static U32 Lengths[Count];
+
+    U64 State = 0x9E3779B97F4A7C15ULL;
+
+    for(unsigned long I = 0; I < Count; I++)
+    {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        Values[I] = (F64)(State >> 11) / (F64)(1ULL << 53) * (F64)(1ULL << (State & 31));
+        Lengths[I] = Utils::FloatToChars(Values[I], Text[I]);
+        Text[I][Lengths[I]] = '\0';
+    }
+
+    char Buffer[64];
+
+    Bench("snprintf %.17g", Iterations, [&](unsigned long I) {
+        Keep(snprintf(Buffer, sizeof(Buffer), "%.17g", Values[I % Count]));
+    });
+
+    Bench("FloatToChars F64", Iterations, [&](unsigned long I) {
+        Keep(Utils::FloatToChars(Values[I % Count], Buffer));
+    });
+
+    Bench("FloatToChars F32", Iterations, [&](unsigned long I) {
+        Keep(Utils::FloatToChars((F32)Values[I % Count], Buffer));
+    });
+
+    Bench("strtod", Iterations, [&](unsigned long I) {
+        Keep(strtod(Text[I % Count], nullptr));
+    });
+
+    Bench("FloatFromChars F64", Iterations, [&](unsigned long I) {
+        F64 Out;
+        Keep(Utils::FloatFromChars(Text[I % Count], Lengths[I % Count], Out));
+        Keep(Out);
+    });
+}
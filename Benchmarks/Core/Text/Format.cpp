@@ -0,0 +1,53 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Text/Format.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Iterations = 2000000;
+
+int main()
+{
+    char Buffer[256];
+
+    Bench("snprintf", Iterations, [&](unsigned long I) {
+        Keep(snprintf(Buffer, sizeof(Buffer), "%s took %lums (%08x)", "Load", I, (unsigned)I));
+    });
+
+    Bench("FormatTo checked", Iterations, [&](unsigned long I) {
+        Keep(FormatTo(Buffer, sizeof(Buffer), FMT("{} took {}ms ({:08x})"), "Load", (U64)I, (U32)I));
+    });
+
+    Bench("FormatTo runtime", Iterations, [&](unsigned long I) {
+        Keep(FormatTo(Buffer, sizeof(Buffer), "{} took {}ms ({:08x})", "Load", (U64)I, (U32)I));
+    });
+
+    Bench("Format", Iterations, [&](unsigned long I) {
+        String Out = Format(FMT("{} took {}ms ({:08x})"), "Load", (U64)I, (U32)I);
+        Keep(Out.Len());
+    });
+
+    String Into;
+    Into.Reserve(256);
+
+    Bench("FormatInto reused", Iterations, [&](unsigned long I) {
+        Into.Drop(Into.Len());
+        FormatInto(Into, FMT("{} took {}ms ({:08x})"), "Load", (U64)I, (U32)I);
+        Keep(Into.Len());
+    });
+}
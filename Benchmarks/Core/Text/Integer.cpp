@@ -0,0 +1,83 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <stdlib.h>
+
+#include <Core/Text/Integer.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Count = 1 << 16;
+constexpr unsigned long Iterations = 4000000;
+
+int main()
+{
+    //a mix of short and long numbers like a csv column would have
+    static I64 Values[Count];
+    static char Text[Count][Utils::MaxIntegerChars + 1];
+    static U32 Lengths[Count];
+
+    U64 State = 0x9E3779B97F4A7C15ULL;
+
+    for(unsigned long I = 0; I < Count; I++)
+    {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        Values[I] = (I64)(State >> (State & 63));
+        Lengths[I] = Utils::IntegerToChars(Values[I], Text[I]);
+        Text[I][Lengths[I]] = '\0';
+    }
+
+    char Buffer[32];
+
+    Bench("snprintf %lld", Iterations, [&](unsigned long I) {
+        Keep(snprintf(Buffer, sizeof(Buffer), "%lld", Values[I % Count]));
+    });
+
+    Bench("IntegerToChars", Iterations, [&](unsigned long I) {
+        Keep(Utils::IntegerToChars(Values[I % Count], Buffer));
+    });
+
+    Bench("strtoll", Iterations, [&](unsigned long I) {
+        Keep(strtoll(Text[I % Count], nullptr, 10));
+    });
+
+    Bench("IntegerFromChars", Iterations, [&](unsigned long I) {
+        I64 Out;
+        Keep(Utils::IntegerFromChars(Text[I % Count], Lengths[I % Count], Out));
+        Keep(Out);
+    });
+
+    //the same numbers as one big csv column
+    String Csv;
+    Csv.Reserve(Count * (Utils::MaxIntegerChars + 1));
+
+    for(unsigned long I = 0; I < Count; I++)
+    {
+        Csv.Append(Text[I]);
+        Csv.Append('\n');
+    }
+
+    const double PerBuffer = Bench("ParseIntegers (per buffer)", 100, [&](unsigned long) {
+        Array<I64> Numbers;
+        Keep(Utils::ParseIntegers(Csv, Numbers).Value());
+    });
+
+    printf("%-40s %12.2f ns/number\n", "ParseIntegers (per number)", PerBuffer / Count);
+}
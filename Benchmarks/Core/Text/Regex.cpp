@@ -0,0 +1,93 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <regex.h>
+#include <string.h>
+
+#include <Core/Text/Regex.h>
+#include <Core/Collections/CthulhuString.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Iterations = 20;
+
+int main()
+{
+    //a megabyte of log lines with an error now and then
+    String Log;
+    U32 State = 0x2545F491;
+
+    for(U32 Line = 0; Log.Len() < (1 << 20); Line++)
+    {
+        State = (State * 1103515245) + 12345;
+
+        Log += "2018-06-01 12:00:00 [info] request served in ";
+        Log << (I64)(State >> 20);
+        Log += "ms\n";
+
+        if(Line % 997 == 996)
+            Log += "2018-06-01 12:00:01 [error] code=503 upstream timed out\n";
+    }
+
+    const Regex Literal = Regex::Compile("upstream timed out").Value();
+    const Regex Errors = Regex::Compile("\\[error\\] code=(\\d+)").Value();
+    const Regex Numbers = Regex::Compile("[0-9]+ms").Value();
+
+    regex_t Posix;
+    regcomp(&Posix, "\\[error\\] code=[0-9]+", REG_EXTENDED);
+
+    Bench("strstr literal", Iterations, [&](unsigned long) {
+        U32 Count = 0;
+
+        for(const char* Cursor = Log.CStr(); (Cursor = strstr(Cursor, "upstream timed out")); Cursor++)
+            Count++;
+
+        Keep(Count);
+    });
+
+    Bench("Regex::FindAll literal", Iterations, [&](unsigned long) {
+        Keep(Literal.FindAll(Log).Len());
+    });
+
+    Bench("regexec Contains", Iterations, [&](unsigned long) {
+        Keep(regexec(&Posix, Log.CStr(), 0, nullptr, 0));
+    });
+
+    Bench("Regex::Contains", Iterations, [&](unsigned long) {
+        Keep(Errors.Contains(Log));
+    });
+
+    Bench("regexec FindAll", Iterations, [&](unsigned long) {
+        U32 Count = 0;
+        regmatch_t Match;
+
+        for(const char* Cursor = Log.CStr(); regexec(&Posix, Cursor, 1, &Match, 0) == 0; Cursor += Match.rm_eo)
+            Count++;
+
+        Keep(Count);
+    });
+
+    Bench("Regex::FindAll prefix", Iterations, [&](unsigned long) {
+        Keep(Errors.FindAll(Log).Len());
+    });
+
+    Bench("Regex::FindAll dense", Iterations, [&](unsigned long) {
+        Keep(Numbers.FindAll(Log).Len());
+    });
+
+    regfree(&Posix);
+}
@@ -0,0 +1,71 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <string.h>
+
+#include <Core/Text/Split.h>
+#include <Core/Collections/CthulhuString.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Iterations = 200;
+
+int main()
+{
+    //about 1MB of csv with fields of a few characters each
+    String Text;
+    Text.Reserve(1 << 20);
+
+    U64 State = 0x9E3779B97F4A7C15ULL;
+
+    while(Text.Len() < (1 << 20))
+    {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        for(U32 I = 0; I < 2 + (State & 15); I++)
+            Text += (char)('a' + ((State >> (I * 4)) % 26));
+
+        Text += (State >> 60) == 0 ? '\n' : ',';
+    }
+
+    Bench("strchr fields", Iterations, [&](unsigned long) {
+        U32 Count = 0;
+
+        for(const char* Cursor = Text.CStr(); (Cursor = strchr(Cursor, ',')); Cursor++)
+            Count++;
+
+        Keep(Count);
+    });
+
+    Bench("Split fields", Iterations, [&](unsigned long) {
+        Keep(Text.Split(',').Count());
+    });
+
+    Bench("SplitAny fields", Iterations, [&](unsigned long) {
+        Keep(Text.SplitAny(",\n").Count());
+    });
+
+    Bench("Lines", Iterations, [&](unsigned long) {
+        Keep(Text.Lines().Count());
+    });
+
+    Bench("Tokenize fields", Iterations, [&](unsigned long) {
+        Keep(Text.Tokenize([](char C) { return C == ',' || C == '\n'; }).Count());
+    });
+}
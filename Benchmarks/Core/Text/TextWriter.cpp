@@ -0,0 +1,65 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <Core/Text/TextWriter.h>
+#include <Core/Collections/Array.h>
+#include <Core/Collections/Pair.h>
+
+using namespace Cthulhu;
+
+constexpr unsigned long Iterations = 200;
+
+//how ToString used to build an array, every item becomes its own string first
+String Concatenated(const Array<Pair<I64, F64>>& Items)
+{
+    String Ret = "{ ";
+
+    for(const auto& Item : Items)
+    {
+        Ret += String("{ First: {0}, Second: {1} }").ArrayFormat({ Utils::ToString(Item.First), Utils::ToString(Item.Second) });
+        Ret += ", ";
+    }
+
+    Ret.Drop(2);
+    Ret += " }";
+
+    return Ret;
+}
+
+int main()
+{
+    Array<Pair<I64, F64>> Items;
+
+    for(I64 I = 0; I < 10000; I++)
+        Items.Append(Pair<I64, F64>{ I * 7919, (F64)I / 3 });
+
+    Bench("concatenated strings", Iterations, [&](unsigned long) {
+        Keep(Concatenated(Items).Len());
+    });
+
+    Bench("Utils::ToString", Iterations, [&](unsigned long) {
+        Keep(Utils::ToString(Items).Len());
+    });
+
+    BufferWriter Out;
+
+    Bench("WriteTo reused BufferWriter", Iterations, [&](unsigned long) {
+        Out.Reset();
+        WriteTo(Out, Items);
+        Keep(Out.Length);
+    });
+}
@@ -0,0 +1,90 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "../../Benchmark.h"
+
+#include <string.h>
+
+#include <Core/Text/Unicode.h>
+
+using namespace Cthulhu;
+
+constexpr U32 Size = 1 << 20;
+
+//fill a buffer by repeating a sample, stopping before a sequence would be cut in half
+char* Repeat(const char* Sample, U32& Len)
+{
+    const U32 SampleLen = (U32)strlen(Sample);
+    char* Ret = new char[Size];
+
+    for(Len = 0; Len + SampleLen <= Size; Len += SampleLen)
+        memcpy(Ret + Len, Sample, SampleLen);
+
+    return Ret;
+}
+
+void Throughput(const char* Name, U32 Len, double Nanos)
+{
+    printf("%-40s %12.2f GB/s\n", Name, Len / Nanos);
+}
+
+int main()
+{
+    U32 AsciiLen, MixedLen;
+    char* Ascii = Repeat("The quick brown fox jumps over the lazy dog. ", AsciiLen);
+    char* Mixed = Repeat("caf\xC3\xA9 \xE4\xB8\x96\xE7\x95\x8C \xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 \xF0\x9F\x98\x80 ", MixedLen);
+
+    Throughput("IsAscii ascii", AsciiLen, Bench("IsAscii ascii", 1000, [&](unsigned long) {
+        Keep(Unicode::IsAscii(Ascii, AsciiLen));
+    }));
+
+    Throughput("IsValid ascii", AsciiLen, Bench("IsValid ascii", 1000, [&](unsigned long) {
+        Keep(Unicode::IsValid(Ascii, AsciiLen));
+    }));
+
+    Throughput("IsValid mixed", MixedLen, Bench("IsValid mixed", 1000, [&](unsigned long) {
+        Keep(Unicode::IsValid(Mixed, MixedLen));
+    }));
+
+    Throughput("ValidPrefix mixed (scalar)", MixedLen, Bench("ValidPrefix mixed (scalar)", 100, [&](unsigned long) {
+        Keep(Unicode::ValidPrefix(Mixed, MixedLen));
+    }));
+
+    Throughput("CountCodePoints mixed", MixedLen, Bench("CountCodePoints mixed", 1000, [&](unsigned long) {
+        Keep(Unicode::CountCodePoints(Mixed, MixedLen));
+    }));
+
+    //reuse the output so the benchmark isnt just page faults on fresh memory
+    Array<C16> Wide;
+    Array<C32> Points;
+
+    Throughput("ToUTF16 ascii", AsciiLen, Bench("ToUTF16 ascii", 100, [&](unsigned long) {
+        Wide.Drop(Wide.Len());
+        Keep(Unicode::ToUTF16(Ascii, AsciiLen, Wide).Value());
+    }));
+
+    Throughput("ToUTF16 mixed", MixedLen, Bench("ToUTF16 mixed", 100, [&](unsigned long) {
+        Wide.Drop(Wide.Len());
+        Keep(Unicode::ToUTF16(Mixed, MixedLen, Wide).Value());
+    }));
+
+    Throughput("ToUTF32 mixed", MixedLen, Bench("ToUTF32 mixed", 100, [&](unsigned long) {
+        Points.Drop(Points.Len());
+        Keep(Unicode::ToUTF32(Mixed, MixedLen, Points).Value());
+    }));
+
+    delete[] Ascii;
+    delete[] Mixed;
+}
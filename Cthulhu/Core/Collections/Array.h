@@ -23,10 +23,20 @@
 
 #include "Core/Memory/Memory.h"
 
+#include "Core/Memory/Allocator.h"
+//Memory::Allocator
+
+#include "Core/Memory/Tracking.h"
+//CTU_TRACK_CONTAINER
+
 #include "CthulhuString.h"
 
+#include "Core/Text/TextWriter.h"
+//TextWriter WriteTo
+
 #include "Core/Traits/IsPOD.h"
 #include "Core/Traits/IsSame.h"
+#include "Core/Traits/IsTrivial.h"
 
 #pragma once
 
@@ -48,7 +58,7 @@ struct Array
      *
      */
     Array()
-        : Real(new T[DefaultSlack])
+        : Real(NewItems(DefaultSlack))
         , Length(0)
         , Allocated(DefaultSlack)
     {}
@@ -58,23 +68,114 @@ struct Array
      * can be useful for interfacing with stuff that needs pointers
      */
     Array(U32 Size)
-        : Real(new T[Size])
+        : Real(NewItems(Size))
         , Length(Size)
         , Allocated(Size)
     {}
 
+    /**
+     * @brief construct an empty array that allocates from From
+     *
+     * @description the allocator has to outlive the array. with an arena growing
+     *              takes more space from it and the old space is only given back
+     *              when the arena is reset
+     *
+     * @code{.cpp}
+     *
+     * Memory::Arena Scratch;
+     * Array<U32> Ids(Scratch);
+     *
+     * @endcode
+     */
+    explicit Array(Memory::Allocator& From)
+        : Length(0)
+        , Allocated(DefaultSlack)
+        , Source(&From)
+    {
+        Real = AllocateItems(DefaultSlack);
+    }
+
     /**
      * @brief Copy constructor for an array
      *
-     * @descrption perform a deep copy of all elements in an array
+     * @descrption perform a deep copy of all elements in an array,
+     *             the copy always uses the heap even if Other used an allocator
      *
      * @param Other the array to copy the data from
      */
     Array(const Array& Other)
-        : Real(Memory::NewDuplicate<T>(Other.Data(), Other.Allocated))
+        : Real(NewItems(Other.Allocated))
         , Length(Other.Length)
         , Allocated(Other.Allocated)
-    {}
+    {
+        for(U32 I = 0; I < Length; I++)
+        {
+            Real[I] = Other.Real[I];
+        }
+    }
+
+    /**
+     * @brief take the items of an array that is about to be thrown away without copying them
+     *
+     * @description the allocator goes with the items, Other is left empty but usable
+     */
+    Array(Array&& Other)
+        : Real(Other.Real)
+        , Length(Other.Length)
+        , Allocated(Other.Allocated)
+        , Slack(Other.Slack)
+        , Source(Other.Source)
+    {
+        Other.Real = nullptr;
+        Other.Length = 0;
+        Other.Allocated = 0;
+    }
+
+    /**
+     * @brief replace the contents with a deep copy of Other
+     *
+     * @description the array keeps its own allocator
+     */
+    Array& operator=(const Array& Other)
+    {
+        if(this == &Other)
+            return *this;
+
+        T* Temp = AllocateItems(Other.Allocated);
+
+        for(U32 I = 0; I < Other.Length; I++)
+        {
+            Temp[I] = Other.Real[I];
+        }
+
+        FreeItems(Real, Allocated);
+
+        Real = Temp;
+        Length = Other.Length;
+        Allocated = Other.Allocated;
+
+        return *this;
+    }
+
+    Array& operator=(Array&& Other)
+    {
+        if(this == &Other)
+            return *this;
+
+        FreeItems(Real, Allocated);
+
+        Real = Other.Real;
+        Length = Other.Length;
+        Allocated = Other.Allocated;
+        Slack = Other.Slack;
+        Source = Other.Source;
+
+        Other.Real = nullptr;
+        Other.Length = 0;
+        Other.Allocated = 0;
+
+        return *this;
+    }
 
     /**
      * @brief Construct a new Array object from a raw pointer and its length
@@ -116,7 +217,7 @@ struct Array
      * @param InitList the initalizer list to use
      */
     Array(std::initializer_list<T> InitList)
-        : Real(new T[InitList.size()+1])
+        : Real(NewItems((U32)InitList.size()+1))
         , Length(0)
         , Allocated((U32)InitList.size())
     {
@@ -167,7 +268,7 @@ struct Array
      * @param Block the function used to populate the array
      */
     Array(U32 Amount, Lambda<T(U32)> Block)
-        : Real(new T[Amount+1])
+        : Real(NewItems(Amount+1))
         , Length(Amount)
         , Allocated(Amount)
     {
@@ -518,6 +619,27 @@ struct Array
         Resize(Length + Size);
     }
 
+    /**
+     * @brief Add Amount default constructed items to the end and get a pointer to the first one
+     *
+     * @description lets bulk writers fill the array directly rather than appending one item at a time
+     *
+     * @param Amount how many items to add
+     * @return T* the first of the new items
+     */
+    T* Extend(U32 Amount)
+    {
+        if(Length + Amount >= Allocated)
+        {
+            Resize(Length + Amount + DefaultSlack);
+        }
+
+        T* Ret = Real + Length;
+        Length += Amount;
+
+        return Ret;
+    }
+
     static Array FromPtr(T* Ptr, U32 Len)
     {
         Array Ret = Array(Empty{});
@@ -531,7 +653,8 @@ struct Array
     /**
      * @brief claim the raw pointer
      * this makes the array unusable after that and doing any other operations
-     * is undefined behaviour and will more than likley crash
+     * is undefined behaviour and will more than likley crash.
+     * if the array uses an allocator the pointer still belongs to it
      *
      * @return T* the arrays raw data
      */
@@ -557,38 +680,122 @@ struct Array
      */
     ~Array()
     {
-        delete[] Real;
+        FreeItems(Real, Allocated);
     }
 
+    /**
+     * @brief the allocator the array uses, null if it uses new and delete
+     */
+    CTU_INLINE Memory::Allocator* Allocator() const { return Source; }
+
 private:
+    template<typename> friend struct CowArray;
 
     Array(Empty) {}
 
     void Resize(U32 NewSize)
     {
-        //TODO: test this more
-        Allocated = NewSize;
-
         //figure out how much to copy
         Length = Math::Min(Length, NewSize);
 
-        T* Temp = new T[NewSize];
+        //arenas and frame buffers can grow their newest allocation in place rather than leaving the old one behind
+        if(Source != nullptr && IsTrivial<T>::Value)
+        {
+            CTU_TRACK_CONTAINER(Array);
+            Real = (T*)Source->Reallocate(Real, sizeof(T) * Allocated, sizeof(T) * NewSize, alignof(T));
+
+            for(U32 I = Allocated; I < NewSize; I++)
+                new (Real + I) T();
+
+            Allocated = NewSize;
+            return;
+        }
+
+        T* Temp = AllocateItems(NewSize);
 
         for(U32 I = 0; I < Length; I++)
         {
             Temp[I] = Real[I];
         }
 
-        delete[] Real;
+        FreeItems(Real, Allocated);
 
         Real = Temp;
+        Allocated = NewSize;
+    }
+
+    //constructors run before Source is set so they use this directly
+    static T* NewItems(U32 Count)
+    {
+        CTU_TRACK_CONTAINER(Array);
+        return new T[Count];
+    }
+
+    //every slot is constructed up front, the same as new[] does
+    T* AllocateItems(U32 Count) const
+    {
+        if(Source == nullptr)
+            return NewItems(Count);
+
+        CTU_TRACK_CONTAINER(Array);
+
+        return Source->NewArray<T>(Count);
+    }
+
+    void FreeItems(T* Items, U32 Count) const
+    {
+        //moved from arrays have nothing to free
+        if(Items == nullptr)
+            return;
+
+        if(Source == nullptr)
+            return delete[] Items;
+
+        if(!IsTriviallyDestructable<T>::Value)
+        {
+            for(U32 I = 0; I < Count; I++)
+                Items[I].~T();
+        }
+
+        Source->Deallocate(Items, sizeof(T) * Count, alignof(T));
     }
 
     T* Real;
     U32 Length, Allocated;
     U16 Slack{DefaultSlack};
+
+    Memory::Allocator* Source{nullptr};
 };
 
+/**
+ * @brief write every item in an array
+ *
+ * @description the output uses initializer_list syntax so it looks simmilar to native C++,
+ * an empty array is written as { }
+ *
+ * @tparam T they type of the object stored in the array
+ * @param Out where to write the array
+ * @param Arr the array to write
+ */
+template<typename T>
+void WriteTo(TextWriter& Out, const Array<T>& Arr)
+{
+    Out.Write("{ ", 2);
+
+    bool First = true;
+
+    for(const auto& I : Arr)
+    {
+        if(!First)
+            Out.Write(", ", 2);
+
+        Private::WriteItem(Out, I);
+        First = false;
+    }
+
+    Out.Write(First ? "}" : " }", First ? 1 : 2);
+}
+
 namespace Utils
 {
     /**
@@ -602,18 +809,9 @@ namespace Utils
      * @return String the array as a string
      */
     template<typename T>
-    CTU_INLINE String ToString(const Array<T> Arr)
+    CTU_INLINE String ToString(const Array<T>& Arr)
     {
-        String Ret = "{ ";
-        for(const auto& I : Arr)
-        {
-            Ret += ToString(I);
-            Ret += ", ";
-        }
-        Ret.Drop(2);
-        Ret += " }";
-
-        return Ret;
+        return WriteToString(Arr);
     }
 }
 
@@ -0,0 +1,259 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Atom.h"
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy Memory::Compare
+
+#include "Core/Types/Atomic.h"
+//Atomic<T>
+
+#include "Core/Types/Mutex.h"
+//Mutex ScopeLock
+
+#include "Core/Memory/Tracking.h"
+//Memory::TagScope
+
+using namespace Cthulhu;
+using Private::AtomEntry;
+
+namespace
+{
+
+//fnv-1a, cheap and good enough since its only worked out once per atom
+U32 HashText(const char* Text, U32 Len)
+{
+    U32 Ret = 2166136261U;
+
+    for(U32 I = 0; I < Len; I++)
+    {
+        Ret ^= (U8)Text[I];
+        Ret *= 16777619U;
+    }
+
+    return Ret;
+}
+
+const AtomEntry EmptyEntry = { 2166136261U, 0, "" };
+
+/**
+ * entries and their text are bump allocated out of big chunks that are never freed,
+ * atoms live forever so there is nothing to gain from freeing them one at a time
+ */
+struct AtomArena
+{
+    static constexpr U32 ChunkSize = 64 * 1024;
+
+    Byte* Cursor = nullptr;
+    Byte* End = nullptr;
+
+    AtomEntry* Allocate(const char* Text, U32 Len, U32 Hash)
+    {
+        //keep every entry pointer aligned
+        const U32 Size = (sizeof(AtomEntry) + Len + 1 + alignof(AtomEntry) - 1) & ~(U32)(alignof(AtomEntry) - 1);
+
+        if(Size > (U32)(End - Cursor))
+        {
+            //huge strings get their own allocation so they dont waste the rest of a chunk
+            if(Size > ChunkSize / 4)
+                return Fill(new Byte[Size], Text, Len, Hash);
+
+            Cursor = new Byte[ChunkSize];
+            End = Cursor + ChunkSize;
+        }
+
+        AtomEntry* Ret = Fill(Cursor, Text, Len, Hash);
+        Cursor += Size;
+
+        return Ret;
+    }
+
+private:
+    static AtomEntry* Fill(Byte* Into, const char* Text, U32 Len, U32 Hash)
+    {
+        char* Chars = (char*)(Into + sizeof(AtomEntry));
+
+        Memory::Copy(Text, Chars, Len);
+        Chars[Len] = '\0';
+
+        return new (Into) AtomEntry{ Hash, Len, Chars };
+    }
+};
+
+/**
+ * open addressing with linear probing. slots only ever go from empty to full so readers
+ * can probe without a lock, they just need to see a slot and the entry it points to
+ * together which the acquire and release pairs make sure of
+ */
+struct AtomTable
+{
+    AtomTable(U32 InCapacity)
+        : Mask(InCapacity - 1)
+        , Slots(new Atomic<const AtomEntry*>[InCapacity])
+    {}
+
+    const AtomEntry* Find(const char* Text, U32 Len, U32 Hash) const
+    {
+        for(U32 I = Hash & Mask;; I = (I + 1) & Mask)
+        {
+            const AtomEntry* Entry = Slots[I].Load(MemoryOrder::Acquire);
+
+            if(Entry == nullptr)
+                return nullptr;
+
+            if(Entry->Hash == Hash && Entry->Length == Len && Memory::Compare(Entry->Text, Text, Len) == 0)
+                return Entry;
+        }
+    }
+
+    //only called with the lock held
+    void Insert(const AtomEntry* Entry)
+    {
+        U32 I = Entry->Hash & Mask;
+
+        while(Slots[I].Load(MemoryOrder::Relaxed) != nullptr)
+            I = (I + 1) & Mask;
+
+        Slots[I].Store(Entry, MemoryOrder::Release);
+    }
+
+    const U32 Mask;
+    Atomic<const AtomEntry*>* Slots;
+
+    //replaced tables are kept around forever, together they are smaller than the current one
+    AtomTable* Previous = nullptr;
+};
+
+//atoms are never freed so everything they use is kept out of the leak report
+AtomTable* MakeTable(U32 Capacity)
+{
+    Memory::TagScope Scope(Memory::Tags::Lifetime);
+    return new AtomTable(Capacity);
+}
+
+struct AtomState
+{
+    Atomic<AtomTable*> Table = MakeTable(1024);
+
+    //everything below here is only touched with the lock held
+    Mutex Lock;
+    AtomArena Arena;
+    U32 Count = 0;
+};
+
+//a function static so atoms can be made during static initialization
+AtomState& State()
+{
+    static AtomState Ret;
+    return Ret;
+}
+
+const AtomEntry* Lookup(const char* Text, U32 Len)
+{
+    if(Len == 0)
+        return &EmptyEntry;
+
+    return State().Table.Load(MemoryOrder::Acquire)->Find(Text, Len, HashText(Text, Len));
+}
+
+const AtomEntry* Intern(const char* Text, U32 Len)
+{
+    if(Len == 0)
+        return &EmptyEntry;
+
+    AtomState& Self = State();
+    const U32 Hash = HashText(Text, Len);
+
+    //most atoms are made from text thats already been seen so try without the lock first
+    if(const AtomEntry* Found = Self.Table.Load(MemoryOrder::Acquire)->Find(Text, Len, Hash))
+        return Found;
+
+    ScopeLock Guard(Self.Lock);
+
+    AtomTable* Table = Self.Table.Load(MemoryOrder::Relaxed);
+
+    //someone else might have added it while we were waiting for the lock
+    if(const AtomEntry* Found = Table->Find(Text, Len, Hash))
+        return Found;
+
+    //keep the table at most half full so probes stay short
+    if((Self.Count + 1) * 2 > Table->Mask + 1)
+    {
+        AtomTable* Bigger = MakeTable((Table->Mask + 1) * 2);
+
+        for(U32 I = 0; I <= Table->Mask; I++)
+        {
+            if(const AtomEntry* Entry = Table->Slots[I].Load(MemoryOrder::Relaxed))
+                Bigger->Insert(Entry);
+        }
+
+        //a reader could still be probing the old table so it cant be freed
+        Bigger->Previous = Table;
+
+        Self.Table.Store(Bigger, MemoryOrder::Release);
+        Table = Bigger;
+    }
+
+    Memory::TagScope Scope(Memory::Tags::Lifetime);
+    const AtomEntry* Entry = Self.Arena.Allocate(Text, Len, Hash);
+    Table->Insert(Entry);
+    Self.Count++;
+
+    return Entry;
+}
+
+}
+
+Cthulhu::Atom::Atom()
+    : Entry(&EmptyEntry)
+{}
+
+Cthulhu::Atom::Atom(const char* Text)
+    : Entry(Intern(Text, CString::Length(Text)))
+{}
+
+Cthulhu::Atom::Atom(const char* Text, U32 Len)
+    : Entry(Intern(Text, Len))
+{}
+
+Cthulhu::Atom::Atom(const String& Text)
+    : Entry(Intern(Text.CStr(), Text.Len()))
+{}
+
+Option<Atom> Cthulhu::Atom::Find(const char* Text)
+{
+    return Find(Text, CString::Length(Text));
+}
+
+Option<Atom> Cthulhu::Atom::Find(const char* Text, U32 Len)
+{
+    const AtomEntry* Found = Lookup(Text, Len);
+
+    return Found ? Some(Atom(Found)) : None<Atom>();
+}
+
+Option<Atom> Cthulhu::Atom::Find(const String& Text)
+{
+    return Find(Text.CStr(), Text.Len());
+}
+
+U32 Cthulhu::Atom::Count()
+{
+    AtomState& Self = State();
+    ScopeLock Guard(Self.Lock);
+
+    return Self.Count;
+}
@@ -0,0 +1,133 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Aliases.h"
+//U32
+
+#include "CthulhuString.h"
+//String
+
+#include "Core/Text/TextWriter.h"
+//TextWriter WriteTo
+
+#include "Option.h"
+//Option<T>
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+    struct AtomEntry
+    {
+        U32 Hash;
+        U32 Length;
+        const char* Text;
+    };
+}
+
+/**
+ * @brief an interned string, every atom with the same text shares the same storage
+ *
+ * @description creating an atom looks its text up in a global table and adds it if its new.
+ *              after that comparing two atoms is a pointer compare and the hash is already
+ *              known, which makes atoms a good fit for identifiers and Map keys that are
+ *              compared far more often than they are created. the text of an atom lives
+ *              until the program exits. creating atoms is safe from any thread, lookups
+ *              dont take a lock
+ *
+ * @code{.cpp}
+ *
+ * Atom Name = "Position";
+ *
+ * Name == Atom("Position"); // true, and only the pointers were compared
+ *
+ * Atom::Find("Velocity").Valid(); // false, Find never adds anything
+ *
+ * Map<Atom, U32> Offsets;
+ * Offsets[Name] = 12;
+ *
+ * @endcode
+ */
+struct Atom
+{
+    /**
+     * @brief the empty atom
+     */
+    Atom();
+
+    /**
+     * @brief intern some text, adding it to the table if it isnt already there
+     */
+    Atom(const char* Text);
+    Atom(const char* Text, U32 Len);
+    Atom(const String& Text);
+
+    /**
+     * @brief look up the atom for some text without adding it
+     *
+     * @description useful when checking untrusted input against a known set of names,
+     *              the table wont grow no matter what is passed in
+     *
+     * @return Option<Atom> the atom if the text has been interned before
+     */
+    static Option<Atom> Find(const char* Text);
+    static Option<Atom> Find(const char* Text, U32 Len);
+    static Option<Atom> Find(const String& Text);
+
+    /**
+     * @brief how many different atoms have been interned
+     */
+    static U32 Count();
+
+    CTU_INLINE bool operator==(const Atom& Other) const { return Entry == Other.Entry; }
+    CTU_INLINE bool operator!=(const Atom& Other) const { return Entry != Other.Entry; }
+
+    /**
+     * @brief the hash of the text, worked out once when the atom was interned
+     */
+    CTU_INLINE U32 Hash() const { return Entry->Hash; }
+
+    /**
+     * @brief the text of the atom, always null terminated
+     */
+    CTU_INLINE const char* CStr() const { return Entry->Text; }
+
+    CTU_INLINE U32 Len() const { return Entry->Length; }
+
+private:
+    Atom(const Private::AtomEntry* InEntry)
+        : Entry(InEntry)
+    {}
+
+    const Private::AtomEntry* Entry;
+};
+
+CTU_INLINE void WriteTo(TextWriter& Out, const Atom& Item)
+{
+    Out.Write(Item.CStr(), Item.Len());
+}
+
+namespace Utils
+{
+    CTU_INLINE String ToString(const Atom& Item)
+    {
+        return String(Item.CStr(), Item.Len());
+    }
+}
+
+}
@@ -0,0 +1,562 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "CompressedStringTable.h"
+
+#include "Meta/Assert.h"
+//ASSERT
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy Memory::Set Memory::Compare
+
+#include "Core/Math/Math.h"
+//Math::Min Math::Max
+
+using namespace Cthulhu;
+using Private::SymbolTable;
+
+namespace
+{
+
+//how much of the sample training looks at and how many rounds it does, the same as fsst
+constexpr U32 SampleLimit = 32 * 1024;
+constexpr U32 Generations = 5;
+
+//training keeps more candidates than there are codes since some cant be added
+constexpr U32 Finalists = 512;
+
+//the next 8 bytes of Text with zeros past the end
+CTU_INLINE U64 LoadWord(const char* Text, U32 Left)
+{
+    U64 Word = 0;
+
+    //a fixed size copy becomes one load, only the last few bytes of a string take the slow way
+    if(Left >= 8)
+        Memory::Copy(Text, (char*)&Word, 8);
+    else
+        Memory::Copy(Text, (char*)&Word, Left);
+
+    return Word;
+}
+
+//compressed output is at most 2 bytes per input byte when everything is escaped
+U32 Encode(const SymbolTable& Table, const char* Text, U32 Len, U8* Into)
+{
+    U8* Cursor = Into;
+
+    for(U32 I = 0; I < Len;)
+    {
+        const U32 Found = Table.Match(LoadWord(Text + I, Len - I), Len - I);
+        const U32 Length = Found >> 8;
+
+        if(Length == 0)
+        {
+            *Cursor++ = SymbolTable::Escape;
+            *Cursor++ = (U8)Text[I++];
+        }
+        else
+        {
+            *Cursor++ = (U8)Found;
+            I += Length;
+        }
+    }
+
+    return (U32)(Cursor - Into);
+}
+
+/*================================================================*/
+/*              training                                          */
+/*================================================================*/
+
+struct Candidate
+{
+    U64 Value;
+    U32 Length;
+    U32 Count;
+
+    //single bytes save the most per use since the alternative is a 2 byte escape
+    CTU_INLINE U64 Gain() const { return (U64)Count * Length * (Length == 1 ? 8 : 1); }
+};
+
+//counts how often every symbol and every pair of neighbouring symbols shows up
+struct CandidateTable
+{
+    CandidateTable(U32 Limit)
+        : Mask(15)
+    {
+        while(Mask < Limit * 2)
+            Mask = (Mask * 2) + 1;
+
+        Slots = new Candidate[Mask + 1];
+        Clear();
+    }
+
+    CandidateTable(const CandidateTable&) = delete;
+    CandidateTable& operator=(const CandidateTable&) = delete;
+
+    ~CandidateTable() { delete[] Slots; }
+
+    void Clear()
+    {
+        Memory::Set(Slots, 0, sizeof(Candidate) * (Mask + 1));
+    }
+
+    void Count(U64 Value, U32 Length)
+    {
+        const U64 Key = Value ^ ((U64)Length << 56);
+
+        for(U32 I = (U32)((Key * 0x9E3779B97F4A7C15ULL) >> 40) & Mask;; I = (I + 1) & Mask)
+        {
+            Candidate& Current = Slots[I];
+
+            if(Current.Count == 0)
+            {
+                Current = { Value, Length, 1 };
+                return;
+            }
+
+            if(Current.Value == Value && Current.Length == Length)
+            {
+                Current.Count++;
+                return;
+            }
+        }
+    }
+
+    Candidate* Slots;
+    U32 Mask;
+};
+
+//a min heap of the best candidates so far, the worst is always at the top to be replaced
+struct BestCandidates
+{
+    void Offer(const Candidate& Item)
+    {
+        if(Count < Finalists)
+        {
+            Items[Count] = Item;
+            SiftUp(Count++);
+        }
+        else if(Item.Gain() > Items[0].Gain())
+        {
+            Items[0] = Item;
+            SiftDown(0);
+        }
+    }
+
+    //takes the worst one out each time so the caller fills in from the back
+    Candidate Pop()
+    {
+        const Candidate Ret = Items[0];
+        Items[0] = Items[--Count];
+        SiftDown(0);
+        return Ret;
+    }
+
+    Candidate Items[Finalists];
+    U32 Count = 0;
+
+private:
+    void SiftUp(U32 I)
+    {
+        while(I > 0 && Items[I].Gain() < Items[(I - 1) / 2].Gain())
+        {
+            Swap(I, (I - 1) / 2);
+            I = (I - 1) / 2;
+        }
+    }
+
+    void SiftDown(U32 I)
+    {
+        while(true)
+        {
+            U32 Smallest = I;
+
+            for(U32 Child = (I * 2) + 1; Child <= (I * 2) + 2 && Child < Count; Child++)
+            {
+                if(Items[Child].Gain() < Items[Smallest].Gain())
+                    Smallest = Child;
+            }
+
+            if(Smallest == I)
+                return;
+
+            Swap(I, Smallest);
+            I = Smallest;
+        }
+    }
+
+    void Swap(U32 Left, U32 Right)
+    {
+        const Candidate Temp = Items[Left];
+        Items[Left] = Items[Right];
+        Items[Right] = Temp;
+    }
+};
+
+/**
+ * each generation compresses the sample with the current table and counts every symbol
+ * it used plus every pair of symbols next to each other joined into one. the pairs are
+ * what let symbols grow longer each round. the best 255 by bytes saved become the next table
+ */
+void Train(SymbolTable& Table, const Array<StringView>& Sample)
+{
+    U32 Total = 0;
+
+    for(U32 I = 0; I < Sample.Len(); I++)
+        Total += Sample[I].Len();
+
+    //big samples are strided through so every part of them gets a say
+    const U32 Stride = Math::Max<U32>(1, Total / SampleLimit + 1);
+
+    //very long strings only have their start looked at so they cant crowd everything else out
+    const U32 StringLimit = SampleLimit / 8;
+
+    //every byte looked at counts at most a symbol, its first byte and a pair
+    CandidateTable Candidates((Math::Min(Total, SampleLimit) + StringLimit) * 3);
+    BestCandidates Best;
+
+    for(U32 Generation = 0; Generation < Generations; Generation++)
+    {
+        Candidates.Clear();
+
+        U32 Looked = 0;
+
+        for(U32 S = 0; S < Sample.Len() && Looked < SampleLimit; S += Stride)
+        {
+            const char* Text = Sample[S].Data();
+            const U32 Len = Math::Min(Sample[S].Len(), StringLimit);
+
+            Looked += Len;
+
+            U64 Last = 0;
+            U32 LastLength = 0;
+
+            for(U32 I = 0; I < Len;)
+            {
+                const U64 Word = LoadWord(Text + I, Len - I);
+                const U32 Found = Table.Match(Word, Len - I);
+
+                const U32 Length = Math::Max<U32>(Found >> 8, 1);
+                const U64 Value = Word & SymbolTable::Mask(Length);
+
+                Candidates.Count(Value, Length);
+
+                //the first byte on its own might be worth a code even if its mostly part of longer symbols
+                if(Length > 1)
+                    Candidates.Count(Word & 0xFF, 1);
+
+                if(LastLength != 0 && LastLength < 8)
+                {
+                    const U32 Joined = Math::Min<U32>(LastLength + Length, 8);
+                    Candidates.Count((Last | (Value << (LastLength * 8))) & SymbolTable::Mask(Joined), Joined);
+                }
+
+                Last = Value;
+                LastLength = Length;
+                I += Length;
+            }
+        }
+
+        Best.Count = 0;
+
+        for(U32 I = 0; I <= Candidates.Mask; I++)
+        {
+            if(Candidates.Slots[I].Count != 0)
+                Best.Offer(Candidates.Slots[I]);
+        }
+
+        //the heap pops worst first so reverse it to add the best symbols first
+        Candidate Ordered[Finalists];
+        const U32 Found = Best.Count;
+
+        for(U32 I = Found; I > 0; I--)
+            Ordered[I - 1] = Best.Pop();
+
+        Table.Clear();
+
+        for(U32 I = 0; I < Found && Table.Count < SymbolTable::Escape; I++)
+            Table.Add(Ordered[I].Value, (U8)Ordered[I].Length);
+
+        Table.Finish();
+    }
+}
+
+}
+
+/*================================================================*/
+/*              Cthulhu::Private::SymbolTable                     */
+/*================================================================*/
+
+void Cthulhu::Private::SymbolTable::Clear()
+{
+    Count = 0;
+
+    Memory::Set(Values, 0, sizeof(Values));
+    Memory::Set(Lengths, 0, sizeof(Lengths));
+    Memory::Set(Longs, 0, sizeof(Longs));
+    Memory::Set(Singles, 0, sizeof(Singles));
+    Memory::Set(Shorts, 0, sizeof(Shorts));
+}
+
+bool Cthulhu::Private::SymbolTable::Add(U64 Value, U8 Length)
+{
+    const U8 Code = (U8)Count;
+    const U16 Packed = (U16)((Length << 8) | Code);
+
+    if(Length >= 3)
+    {
+        LongSymbol& Slot = Longs[LongSlot(Value)];
+
+        //only one long symbol per slot, the first one in had the bigger gain
+        if(Slot.Length != 0)
+            return false;
+
+        Slot = { Value, Length, Code };
+    }
+    else if(Length == 2)
+    {
+        Shorts[Value] = Packed;
+    }
+    else
+    {
+        Singles[Value] = Packed;
+    }
+
+    Values[Code] = Value;
+    Lengths[Code] = Length;
+    Count++;
+
+    return true;
+}
+
+void Cthulhu::Private::SymbolTable::Finish()
+{
+    //2 byte pairs without their own symbol fall back to whatever their first byte uses
+    for(U32 I = 0; I < 65536; I++)
+    {
+        if((Shorts[I] >> 8) != 2)
+            Shorts[I] = Singles[I & 0xFF];
+    }
+}
+
+/*================================================================*/
+/*              Cthulhu::CompressedStringTable                    */
+/*================================================================*/
+
+Cthulhu::CompressedStringTable::CompressedStringTable(const Array<StringView>& Sample)
+    : Table(new SymbolTable())
+    , Bytes(new U8[1024])
+    , Capacity(1024)
+    , Offsets(new U32[64])
+    , Count(0)
+    , OffsetCapacity(64)
+    , Original(0)
+{
+    Offsets[0] = 0;
+    Train(*Table, Sample);
+}
+
+Cthulhu::CompressedStringTable::~CompressedStringTable()
+{
+    delete Table;
+    delete[] Bytes;
+    delete[] Offsets;
+}
+
+U32 Cthulhu::CompressedStringTable::Add(StringView Text)
+{
+    const U32 Used = Offsets[Count];
+
+    //every byte might need an escape in front of it, done in 64 bits so it cant wrap
+    const U64 Worst = (U64)Text.Len() * 2;
+    const U64 Needed = Used + Worst;
+
+    ASSERT(Needed <= 0xFFFFFFFF, "CompressedStringTable cant hold more than 4gb of compressed text");
+
+    if(Needed > Capacity)
+    {
+        //Needed fits so clamping the doubled size never makes it too small
+        const U32 NewCapacity = (U32)Math::Min<U64>(Math::Max<U64>((U64)Capacity * 2, Needed), 0xFFFFFFFF);
+
+        U8* Temp = new U8[NewCapacity];
+        Memory::Copy(Bytes, Temp, Used);
+
+        delete[] Bytes;
+        Bytes = Temp;
+        Capacity = NewCapacity;
+    }
+
+    if(Count + 1 >= OffsetCapacity)
+    {
+        U32* Temp = new U32[OffsetCapacity * 2];
+        Memory::Copy(Offsets, Temp, sizeof(U32) * (Count + 1));
+
+        delete[] Offsets;
+        Offsets = Temp;
+        OffsetCapacity *= 2;
+    }
+
+    Offsets[Count + 1] = Used + Encode(*Table, Text.Data(), Text.Len(), Bytes + Used);
+    Original += Text.Len();
+
+    return Count++;
+}
+
+String Cthulhu::CompressedStringTable::Get(U32 Index) const
+{
+    BufferWriter Out;
+    DecompressTo(Index, Out);
+    return Out.Take();
+}
+
+void Cthulhu::CompressedStringTable::DecompressTo(U32 Index, TextWriter& Out) const
+{
+    const U8* Code = Bytes + Offsets[Index];
+    const U8* End = Bytes + Offsets[Index + 1];
+
+    //every code writes all 8 bytes of its symbol and moves on by its length,
+    //that needs up to 7 bytes of slack past the end so the writer is asked for plenty
+    const U32 Bound = (U32)(End - Code) * 8;
+
+    //growing can fail for a fixed or flushing writer so fall back to a symbol at a time
+    if(Bound > Out.Capacity - Out.Length && (!Out.Grow(Out, Out.Length + Bound) || Bound > Out.Capacity - Out.Length))
+    {
+        while(Code < End)
+        {
+            const U8 Current = *Code++;
+
+            if(Current == SymbolTable::Escape)
+                Out.Write((char)*Code++);
+            else
+                Out.Write((const char*)&Table->Values[Current], Table->Lengths[Current]);
+        }
+
+        return;
+    }
+
+    char* Cursor = Out.Data + Out.Length;
+
+    while(Code < End)
+    {
+        const U8 Current = *Code++;
+
+        if(Current == SymbolTable::Escape)
+        {
+            *Cursor++ = (char)*Code++;
+        }
+        else
+        {
+            Memory::Copy((const char*)&Table->Values[Current], Cursor, 8);
+            Cursor += Table->Lengths[Current];
+        }
+    }
+
+    const U32 Written = (U32)(Cursor - (Out.Data + Out.Length));
+
+    Out.Length += Written;
+    Out.Total += Written;
+}
+
+U32 Cthulhu::CompressedStringTable::Length(U32 Index) const
+{
+    const U8* Code = Bytes + Offsets[Index];
+    const U8* End = Bytes + Offsets[Index + 1];
+
+    U32 Ret = 0;
+
+    while(Code < End)
+    {
+        const U8 Current = *Code++;
+
+        if(Current == SymbolTable::Escape)
+        {
+            Code++;
+            Ret++;
+        }
+        else
+        {
+            Ret += Table->Lengths[Current];
+        }
+    }
+
+    return Ret;
+}
+
+bool Cthulhu::CompressedStringTable::Equal(U32 Left, U32 Right) const
+{
+    const StringView A = Compressed(Left);
+    const StringView B = Compressed(Right);
+
+    return A.Len() == B.Len() && Memory::Compare(A.Data(), B.Data(), A.Len()) == 0;
+}
+
+bool Cthulhu::CompressedStringTable::Equals(U32 Index, StringView Text) const
+{
+    const StringView Entry = Compressed(Index);
+
+    //every byte compresses to at least one code so anything longer cant match
+    if(Text.Len() > Entry.Len() * 8 || Text.Len() < Entry.Len() / 2)
+        return false;
+
+    U8 Stack[256];
+    U8* Into = Text.Len() * 2 <= sizeof(Stack) ? Stack : new U8[Text.Len() * 2];
+
+    const U32 Len = Encode(*Table, Text.Data(), Text.Len(), Into);
+    const bool Ret = Len == Entry.Len() && Memory::Compare((const char*)Into, Entry.Data(), Len) == 0;
+
+    if(Into != Stack)
+        delete[] Into;
+
+    return Ret;
+}
+
+bool Cthulhu::CompressedStringTable::StartsWith(U32 Index, StringView Prefix) const
+{
+    const U8* Code = Bytes + Offsets[Index];
+    const U8* End = Bytes + Offsets[Index + 1];
+
+    const char* Want = Prefix.Data();
+    U32 Left = Prefix.Len();
+
+    while(Left != 0)
+    {
+        if(Code == End)
+            return false;
+
+        const U8 Current = *Code++;
+
+        if(Current == SymbolTable::Escape)
+        {
+            if(*Want != (char)*Code++)
+                return false;
+
+            Want++;
+            Left--;
+            continue;
+        }
+
+        //only as much of the last symbol as the prefix still needs
+        const U32 Length = Math::Min<U32>(Table->Lengths[Current], Left);
+
+        if(Memory::Compare((const char*)&Table->Values[Current], Want, Length) != 0)
+            return false;
+
+        Want += Length;
+        Left -= Length;
+    }
+
+    return true;
+}
@@ -0,0 +1,245 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U8 U16 U32 U64
+
+#include "Array.h"
+//Array<T>
+
+#include "StringView.h"
+//StringView
+
+#include "CthulhuString.h"
+//String
+
+#include "Core/Text/TextWriter.h"
+//TextWriter
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+    /**
+     * up to 255 symbols of 1 to 8 bytes, each compressed byte is the code of a symbol
+     * and code 255 means the next byte is a literal. symbols of 3 or more bytes are
+     * found through a small hash of their first 3 bytes, shorter ones through direct tables
+     */
+    struct SymbolTable
+    {
+        static constexpr U8 Escape = 255;
+        static constexpr U32 LongSlots = 1024;
+
+        SymbolTable() { Clear(); }
+
+        /**
+         * @brief forget every symbol so every byte is escaped
+         */
+        void Clear();
+
+        /**
+         * @brief find the symbol to use at the start of Word
+         *
+         * @param Word the next 8 bytes of input, zero past the end
+         * @param Left how many bytes of input are actually left
+         * @return U32 the length of the symbol in the top bits and its code in the bottom 8,
+         *             a length of 0 means the first byte has to be escaped
+         */
+        CTU_INLINE U32 Match(U64 Word, U32 Left) const
+        {
+            const LongSymbol& Long = Longs[LongSlot(Word)];
+
+            if(Long.Length != 0 && Long.Length <= Left && ((Word ^ Long.Value) & Mask(Long.Length)) == 0)
+                return ((U32)Long.Length << 8) | Long.Code;
+
+            return Left >= 2 ? Shorts[Word & 0xFFFF] : Singles[Word & 0xFF];
+        }
+
+        /**
+         * @brief add a symbol, the caller gives out codes in order
+         *
+         * @return bool false if a longer symbol with the same first 3 bytes is already in
+         */
+        bool Add(U64 Value, U8 Length);
+
+        /**
+         * @brief fill in the direct tables once every symbol has been added
+         */
+        void Finish();
+
+        CTU_INLINE static U32 LongSlot(U64 Word)
+        {
+            return (U32)(((Word & 0xFFFFFF) * 0x9E3779B1U) >> 22) & (LongSlots - 1);
+        }
+
+        CTU_INLINE static U64 Mask(U32 Length)
+        {
+            return ~0ULL >> (64 - (Length * 8));
+        }
+
+        struct LongSymbol
+        {
+            U64 Value;
+            U8 Length;
+            U8 Code;
+        };
+
+        ///the bytes of every symbol, padded with zeros to 8
+        U64 Values[256];
+        U8 Lengths[256];
+
+        U32 Count;
+
+        LongSymbol Longs[LongSlots];
+
+        //indexed by the next byte or 2 bytes, packed the same as Match returns
+        U16 Singles[256];
+        U16 Shorts[65536];
+    };
+}
+
+/**
+ * @brief a large set of short strings stored compressed in one block of memory
+ *
+ * @description a symbol table of up to 255 common substrings is trained on a sample of the
+ *              strings up front, every string added after that is written as a byte per
+ *              symbol into one growing buffer with a U32 offset per entry. this is the
+ *              fsst scheme, on urls, paths and identifiers it usually uses a third to half
+ *              of the memory the plain text would, and a lot less than a String per entry
+ *              which also pays for an allocation each.
+ *
+ *              any single entry can be decompressed on its own. compression is
+ *              deterministic so equality is checked on the compressed bytes without
+ *              decompressing anything, and prefix checks decompress only as far as they need.
+ *              the strings dont have to look like the sample, anything the symbols
+ *              dont cover is stored as escaped bytes at twice the size.
+ *              the compressed data of every entry together has to fit in 4GB
+ *
+ * @code{.cpp}
+ *
+ * CompressedStringTable Urls(Sample);
+ *
+ * U32 Home = Urls.Add("https://example.com/index.html");
+ *
+ * Urls.Get(Home); // "https://example.com/index.html"
+ * Urls.Equals(Home, "https://example.com/index.html"); // true
+ * Urls.StartsWith(Home, "https://"); // true
+ *
+ * @endcode
+ */
+struct CompressedStringTable
+{
+    /**
+     * @brief train the symbol table on a sample of the strings that will be stored
+     *
+     * @description at most 32k of the sample is looked at, a larger sample is
+     *              strided through evenly. the sample doesnt have to be added afterwards
+     *
+     * @param Sample strings that look like the ones that will be added
+     */
+    CompressedStringTable(const Array<StringView>& Sample);
+
+    CompressedStringTable(const CompressedStringTable&) = delete;
+    CompressedStringTable& operator=(const CompressedStringTable&) = delete;
+
+    ~CompressedStringTable();
+
+    /**
+     * @brief compress a string and store it
+     *
+     * @return U32 the index of the new entry, entries are numbered in the order they were added
+     */
+    U32 Add(StringView Text);
+
+    /**
+     * @brief how many entries are stored
+     */
+    CTU_INLINE U32 Len() const { return Count; }
+
+    /**
+     * @brief decompress an entry into a new string
+     */
+    String Get(U32 Index) const;
+
+    /**
+     * @brief decompress an entry onto the end of a writer
+     */
+    void DecompressTo(U32 Index, TextWriter& Out) const;
+
+    /**
+     * @brief how long an entry is once decompressed, worked out without decompressing it
+     */
+    U32 Length(U32 Index) const;
+
+    /**
+     * @brief if two entries hold the same text, only their compressed bytes are compared
+     */
+    bool Equal(U32 Left, U32 Right) const;
+
+    /**
+     * @brief if an entry holds Text, Text is compressed and compared to the entry
+     */
+    bool Equals(U32 Index, StringView Text) const;
+
+    /**
+     * @brief if an entry starts with Prefix, stops decompressing as soon as it knows
+     */
+    bool StartsWith(U32 Index, StringView Prefix) const;
+
+    /**
+     * @brief the compressed bytes of an entry
+     */
+    CTU_INLINE StringView Compressed(U32 Index) const
+    {
+        return { (const char*)Bytes + Offsets[Index], Offsets[Index + 1] - Offsets[Index] };
+    }
+
+    /**
+     * @brief how many bytes the compressed text and the offsets use, not counting the symbol table
+     */
+    CTU_INLINE U64 MemoryUsed() const { return (U64)Offsets[Count] + ((U64)Count + 1) * sizeof(U32); }
+
+    /**
+     * @brief how many bytes every entry added up to before compressing
+     */
+    CTU_INLINE U64 OriginalBytes() const { return Original; }
+
+    /**
+     * @brief how many symbols training picked
+     */
+    CTU_INLINE U32 Symbols() const { return Table->Count; }
+
+private:
+    //heap allocated since the lookup tables are over 100k
+    Private::SymbolTable* Table;
+
+    U8* Bytes;
+    U32 Capacity;
+
+    //one more than Count, the last is where the next entry will start
+    U32* Offsets;
+    U32 Count;
+    U32 OffsetCapacity;
+
+    U64 Original;
+};
+
+}
@@ -0,0 +1,480 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <new>
+#include <initializer_list>
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
+#include "Meta/Aliases.h"
+//Byte U32
+
+#include "Core/Math/Math.h"
+//Math::Max Math::Min
+
+#include "Core/Memory/Memory.h"
+//Memory::AlignedAlloc Memory::AlignedFree
+
+#include "Core/Memory/Tracking.h"
+//CTU_TRACK_CONTAINER
+
+#include "Core/Types/Atomic.h"
+//Atomic<T>
+
+#include "Core/Traits/Forward.h"
+//Forward
+
+#include "Core/Traits/IsTrivial.h"
+//IsTriviallyDestructable
+
+#include "Array.h"
+//Array
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+    template<typename T>
+    struct CowArrayData
+    {
+        Atomic<U32> Refs;
+
+        U32 Length;
+        U32 Capacity;
+
+        //items taken from an Array were all made by new[] and have to go back the same way
+        bool Adopted;
+
+        //right after this header unless the items were taken from an Array
+        T* Items;
+
+        CTU_INLINE static U64 Offset() { return (sizeof(CowArrayData) + alignof(T) - 1) & ~(alignof(T) - 1); }
+    };
+}
+
+/**
+ * @brief an array that is shared between copies until one of them writes to it
+ *
+ * @description copying only bumps an atomic reference count so handing the same big
+ *              array to lots of readers on any number of threads is O(1). reading never
+ *              copies anything, the first write to an array that is shared gives that
+ *              copy items of its own and leaves every other copy as it was.
+ *
+ *              reads and writes are kept apart so a read can never copy by accident.
+ *              operator[], Data, begin and end are const and only read, every write goes
+ *              through At, Set, Mutate, Append, Pop, Resize or Clear. a const CowArray
+ *              or a Snapshot is a read view that nothing can change under it.
+ *
+ *              an Array that is about to be thrown away can be moved in without copying
+ *              its items, the first change in length after that copies them once
+ *
+ * @code{.cpp}
+ *
+ * CowArray<Vertex> Mesh = LoadMesh();
+ *
+ * //every renderer thread gets the same vertices without copying them
+ * for(Renderer& Each : Renderers)
+ *     Each.Submit(Mesh.Snapshot());
+ *
+ * //the editor changes its own copy, the renderers keep what they were given
+ * Mesh.Set(0, Moved);
+ *
+ * @endcode
+ *
+ * @tparam T the type of item to store
+ */
+template<typename T>
+struct CowArray
+{
+    ///the smallest block made when growing so small arrays dont reallocate on every append
+    static constexpr U32 MinCapacity = 8;
+
+    CowArray()
+        : Data(nullptr)
+    {}
+
+    CowArray(std::initializer_list<T> InitList)
+        : Data(nullptr)
+    {
+        CopyIn(InitList.begin(), (U32)InitList.size());
+    }
+
+    CowArray(const T* Items, U32 Len)
+        : Data(nullptr)
+    {
+        CopyIn(Items, Len);
+    }
+
+    /**
+     * @brief copy the items of an Array
+     */
+    explicit CowArray(const Array<T>& Items)
+        : CowArray(Items.Data(), Items.Len())
+    {}
+
+    /**
+     * @brief take the items of an Array that is about to be thrown away without copying them
+     *
+     * @description items from an allocator cant be given back to the heap so they are
+     *              copied instead. the Array is left empty
+     */
+    CowArray(Array<T>&& Items)
+        : Data(nullptr)
+    {
+        if(Items.Len() == 0)
+            return;
+
+        if(Items.Source != nullptr)
+        {
+            CopyIn(Items.Data(), Items.Len());
+            Items.Drop(Items.Len());
+            return;
+        }
+
+        CTU_TRACK_CONTAINER(Array);
+        Data = new (Memory::AlignedAlloc<Byte>(sizeof(Header), alignof(Header))) Header{ 1, Items.Length, Items.Allocated, true, Items.Real };
+
+        Items.Real = nullptr;
+        Items.Length = 0;
+        Items.Allocated = 0;
+    }
+
+    CTU_INLINE CowArray(const CowArray& Other)
+        : Data(Other.Data)
+    {
+        //a new reference cant be the one that frees the items so no ordering is needed
+        if(Data)
+            Data->Refs.Add(1, MemoryOrder::Relaxed);
+    }
+
+    CTU_INLINE CowArray(CowArray&& Other)
+        : Data(Other.Data)
+    {
+        Other.Data = nullptr;
+    }
+
+    CowArray& operator=(const CowArray& Other)
+    {
+        //retain before releasing in case both share the same items
+        if(Other.Data)
+            Other.Data->Refs.Add(1, MemoryOrder::Relaxed);
+
+        Release(Data);
+        Data = Other.Data;
+
+        return *this;
+    }
+
+    CowArray& operator=(CowArray&& Other)
+    {
+        if(this != &Other)
+        {
+            Release(Data);
+            Data = Other.Data;
+            Other.Data = nullptr;
+        }
+
+        return *this;
+    }
+
+    CTU_INLINE ~CowArray() { Release(Data); }
+
+    /**
+     * @brief a copy that will never see changes made through this one, O(1)
+     */
+    CTU_INLINE CowArray Snapshot() const { return *this; }
+
+    CTU_INLINE U32 Len() const { return Data ? Data->Length : 0; }
+    CTU_INLINE bool IsEmpty() const { return Len() == 0; }
+
+    ///how many items fit before this copy has to reallocate
+    CTU_INLINE U32 Capacity() const { return Data ? Data->Capacity : 0; }
+
+    CTU_INLINE const T& operator[](U32 Index) const
+    {
+        ASSERT(Index < Len(), "IndexOutOfRange");
+        return Data->Items[Index];
+    }
+
+    ///the items for reading, nullptr if there are none
+    CTU_INLINE const T* Items() const { return Data ? Data->Items : nullptr; }
+
+    CTU_INLINE const T& Front() const { ASSERT(Len() > 0, "An empty array has no front"); return Data->Items[0]; }
+    CTU_INLINE const T& Back() const { ASSERT(Len() > 0, "An empty array has no back"); return Data->Items[Data->Length - 1]; }
+
+    const T* begin() const { return Items(); }
+    const T* end() const { return Items() + Len(); }
+
+    /**
+     * @brief check if nothing else shares these items, an empty array is always unique
+     */
+    CTU_INLINE bool IsUnique() const { return !Data || Data->Refs.Load(MemoryOrder::Acquire) == 1; }
+
+    /**
+     * @brief true when both read the same items, so comparing them is free
+     */
+    CTU_INLINE bool SharesWith(const CowArray& Other) const { return Data == Other.Data; }
+
+    Option<U32> Find(const T& Item) const
+    {
+        for(U32 I = 0; I < Len(); I++)
+        {
+            if(Data->Items[I] == Item)
+                return Some(I);
+        }
+
+        return None<U32>();
+    }
+
+    CTU_INLINE bool Has(const T& Item) const { return Find(Item).Valid(); }
+
+    /**
+     * @brief copies of the same array compare their pointers before their items
+     */
+    bool operator==(const CowArray& Other) const
+    {
+        if(Data == Other.Data)
+            return true;
+
+        if(Len() != Other.Len())
+            return false;
+
+        for(U32 I = 0; I < Len(); I++)
+        {
+            if(!(Data->Items[I] == Other.Data->Items[I]))
+                return false;
+        }
+
+        return true;
+    }
+
+    CTU_INLINE bool operator!=(const CowArray& Other) const { return !(*this == Other); }
+
+    /**
+     * @brief get the items for writing, copying them first if they are shared
+     *
+     * @return T* Len() items that only this array can see, nullptr if its empty
+     */
+    T* Mutate()
+    {
+        if(!IsUnique())
+            Detach(Data->Capacity);
+
+        return Data ? Data->Items : nullptr;
+    }
+
+    /**
+     * @brief get an item for writing, copying every item first if they are shared
+     */
+    CTU_INLINE T& At(U32 Index)
+    {
+        ASSERT(Index < Len(), "IndexOutOfRange");
+        return Mutate()[Index];
+    }
+
+    CTU_INLINE void Set(U32 Index, const T& Item) { At(Index) = Item; }
+
+    T& Append(const T& Item)
+    {
+        MakeRoom(Len() + 1);
+        return *new (Data->Items + Data->Length++) T(Item);
+    }
+
+    T& Append(T&& Item)
+    {
+        MakeRoom(Len() + 1);
+        return *new (Data->Items + Data->Length++) T(Forward<T>(Item));
+    }
+
+    /**
+     * @brief remove the last item and return it
+     */
+    T Pop()
+    {
+        ASSERT(Len() >= 1, "Cant pop item off an empty list");
+
+        MakeRoom(Len());
+
+        T* Last = Data->Items + --Data->Length;
+        T Ret = Forward<T>(*Last);
+        Last->~T();
+
+        return Ret;
+    }
+
+    /**
+     * @brief grow or shrink to NewLength items, new items are default constructed
+     *
+     * @description shrinking an array that is shared only copies the items that are kept
+     */
+    void Resize(U32 NewLength)
+    {
+        if(NewLength == Len())
+            return;
+
+        if(NewLength < Len() && !IsUnique())
+        {
+            Detach(NewLength);
+            return;
+        }
+
+        MakeRoom(NewLength);
+
+        for(U32 I = Data->Length; I < NewLength; I++)
+            new (Data->Items + I) T();
+
+        DestroyItems(Data, NewLength, Data->Length);
+        Data->Length = NewLength;
+    }
+
+    /**
+     * @brief make sure Items items fit without reallocating, this copy gets items of its own
+     */
+    void Reserve(U32 Items)
+    {
+        if(Items == 0 || (Owned() && Items <= Data->Capacity))
+            return;
+
+        Detach(Math::Max(Items, Capacity()));
+    }
+
+    /**
+     * @brief remove every item, a shared array just lets go of its items without copying them
+     */
+    void Clear()
+    {
+        if(!IsUnique())
+        {
+            Release(Data);
+            Data = nullptr;
+            return;
+        }
+
+        Resize(0);
+    }
+
+    /**
+     * @brief copy the items into a new Array
+     */
+    Array<T> ToArray() const
+    {
+        Array<T> Ret;
+        Ret.Reserve(Len());
+
+        for(const T& Item : *this)
+            Ret.Append(Item);
+
+        return Ret;
+    }
+
+private:
+    using Header = Private::CowArrayData<T>;
+
+    //unique and made by this type so the length can change in place
+    CTU_INLINE bool Owned() const { return Data && IsUnique() && !Data->Adopted; }
+
+    void CopyIn(const T* Items, U32 Len)
+    {
+        Reserve(Len);
+
+        for(U32 I = 0; I < Len; I++)
+            new (Data->Items + I) T(Items[I]);
+
+        if(Data)
+            Data->Length = Len;
+    }
+
+    //make sure this copy can hold Needed items in place
+    void MakeRoom(U32 Needed)
+    {
+        const U32 Current = Capacity();
+
+        if(Owned() && Needed <= Current)
+            return;
+
+        U32 NewCapacity = Current;
+
+        if(Needed > NewCapacity)
+            NewCapacity = Math::Max(Needed, Math::Max(Current * 2, MinCapacity));
+
+        Detach(NewCapacity);
+    }
+
+    //give this copy a fresh block with room for NewCapacity items, keeping as many items as fit
+    void Detach(U32 NewCapacity)
+    {
+        Header* Old = Data;
+        const U32 Keep = Math::Min(Len(), NewCapacity);
+
+        if(NewCapacity == 0)
+        {
+            Release(Old);
+            Data = nullptr;
+            return;
+        }
+
+        CTU_TRACK_CONTAINER(Array);
+        const U64 Align = Math::Max(alignof(Header), alignof(T));
+        Byte* Block = Memory::AlignedAlloc<Byte>(Header::Offset() + sizeof(T) * NewCapacity, Align);
+        Header* Made = new (Block) Header{ 1, Keep, NewCapacity, false, (T*)(Block + Header::Offset()) };
+
+        //nobody else can see the old items so they can be moved rather than copied
+        if(Old && IsUnique())
+        {
+            for(U32 I = 0; I < Keep; I++)
+                new (Made->Items + I) T(Forward<T>(Old->Items[I]));
+        }
+        else
+        {
+            for(U32 I = 0; I < Keep; I++)
+                new (Made->Items + I) T(Old->Items[I]);
+        }
+
+        Release(Old);
+        Data = Made;
+    }
+
+    static void DestroyItems(Header* Which, U32 From, U32 To)
+    {
+        if(IsTriviallyDestructable<T>::Value)
+            return;
+
+        for(U32 I = From; I < To; I++)
+            Which->Items[I].~T();
+    }
+
+    static void Release(Header* Which)
+    {
+        if(!Which || Which->Refs.Sub(1, MemoryOrder::AcquireRelease) != 1)
+            return;
+
+        //every slot was made by new[] so they all go back together
+        if(Which->Adopted)
+            delete[] Which->Items;
+        else
+            DestroyItems(Which, 0, Which->Length);
+
+        Memory::AlignedFree((Byte*)Which);
+    }
+
+    Header* Data;
+};
+
+}
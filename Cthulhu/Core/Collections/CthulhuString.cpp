@@ -21,6 +21,21 @@
 
 #include "Core/Math/Limits.h"
 
+#include "Core/Text/MultiSearch.h"
+//MultiSearch
+
+#include "Core/Text/Float.h"
+//Utils::FloatToChars Utils::FloatFromChars
+
+#include "Core/Text/Integer.h"
+//Utils::IntegerToChars Utils::IntegerFromChars
+
+#include "Core/Text/TextWriter.h"
+//StringWriter WriteTo
+
+#include "Core/Memory/Tracking.h"
+//CTU_TRACK_CONTAINER
+
 #include "CthulhuString.h"
 
 using namespace Cthulhu;
@@ -37,6 +52,7 @@ Cthulhu::String::String()
 Cthulhu::String::String(char Letter)
     : Real(new char[2]) 
     , Length(1)
+    , Allocated(1)
 {
     Real[0] = Letter;
     Real[1] = '\0';
@@ -45,68 +61,149 @@ Cthulhu::String::String(char Letter)
 Cthulhu::String::String(const char* Data)
     : Real(CString::Duplicate(Data))
     , Length(CString::Length(Data))
+    , Allocated(Length)
 {}
 
 Cthulhu::String::String(const C8 * Content)
     : Real(CString::Duplicate((char*)Content))
     , Length(CString::Length((char*)Content))
+    , Allocated(Length)
 {}
 
+//copies Length bytes rather than up to the first null so embedded nulls survive
 Cthulhu::String::String(const String& Other)
-    : Real(CString::Duplicate(Other.Real))
-    , Length(Other.Length)
+    : String(!!Other.Real ? Other.Real : "", Other.Length)
+{}
+
+Cthulhu::String::String(const char* Content, U32 Len)
+    : Real(new char[Len + 1])
+    , Length(Len)
+    , Allocated(Len)
+{
+    Memory::Copy(Content, Real, Len);
+    Real[Len] = '\0';
+}
+
+Cthulhu::String::String(StringView Content)
+    : String(Content.Data(), Content.Len())
+{}
+
+Cthulhu::String::String(const StaticString& Content)
+    : String(Content.CStr(), Content.Len())
 {}
 
+Cthulhu::String::String(Memory::Allocator& From)
+    : Real(nullptr)
+    , Source(&From)
+{
+    Real = AllocText(0);
+    Real[0] = '\0';
+}
+
+Cthulhu::String::String(StringView Content, Memory::Allocator& From)
+    : Real(nullptr)
+    , Length(Content.Len())
+    , Allocated(Content.Len())
+    , Source(&From)
+{
+    Real = AllocText(Length);
+    Memory::Copy(Content.Data(), Real, Length);
+    Real[Length] = '\0';
+}
+
 /*================================================================*/
 /*              Cthulhu::String member functions                  */
 /*================================================================*/
 
-void Cthulhu::String::Append(const String& Other)
+void Cthulhu::String::Reserve(U32 Extra)
+{
+    if(Length + Extra > Allocated)
+        Grow(Length + Extra);
+}
+
+void Cthulhu::String::Grow(U32 NewSize)
 {
-    char* Temp = CString::Merge(Real, Other.Real);
+    //grow by at least half again so repeated appends dont copy every time
+    NewSize = Math::Max(NewSize, Allocated + (Allocated / 2));
+
+    CTU_TRACK_CONTAINER(String);
+
+    //the allocator might be able to grow it without moving, an arena usually can
+    if(Source != nullptr)
+    {
+        Real = (char*)Source->Reallocate(Real, Allocated + 1, NewSize + 1, 1);
+        Allocated = NewSize;
+        return;
+    }
+
+    char* Temp = new char[NewSize + 1];
+    Memory::Copy(Real, Temp, Length + 1);
 
     delete[] Real;
 
     Real = Temp;
+    Allocated = NewSize;
+}
+
+char* Cthulhu::String::AllocText(U32 Size) const
+{
+    CTU_TRACK_CONTAINER(String);
+
+    if(Source == nullptr)
+        return new char[Size + 1];
 
-    Length += Other.Length;
+    return (char*)Source->Allocate(Size + 1, 1);
 }
 
-void Cthulhu::String::Append(char Other)
+void Cthulhu::String::Append(const String& Other)
 {
-    char* Temp = new char[Length + 2];
-    CString::Copy(Real, Temp);
+    const U32 OtherLen = Other.Length;
 
-    Temp[Length] = Other;
-    Temp[++Length] = '\0';
+    if(Length + OtherLen > Allocated)
+        Grow(Length + OtherLen);
 
-    delete[] Real;
-    Real = Temp;
+    //copy the null terminator as well, this also handles appending to itself
+    Memory::Move(Other.Real, Real + Length, OtherLen + 1);
+
+    Length += OtherLen;
+}
+
+void Cthulhu::String::Append(char Other)
+{
+    if(Length + 1 > Allocated)
+        Grow(Length + 1);
+
+    Real[Length] = Other;
+    Real[++Length] = '\0';
 }
 
 void Cthulhu::String::Push(const String& Other)
 {
-    char* Temp = CString::Merge(Other.Real, Real);
+    const U32 OtherLen = Other.Length;
+    char* Temp = AllocText(Length + OtherLen);
 
-    delete[] Real;
+    Memory::Copy(Other.Real, Temp, OtherLen);
+    Memory::Copy(Real, Temp + OtherLen, Length + 1);
 
+    FreeText();
     Real = Temp;
 
-    Length += Other.Length;
+    Length += OtherLen;
+    Allocated = Length;
 }
 
 void Cthulhu::String::Push(char Other)
 {
-    char* Temp = new char[Length + 2];
+    char* Temp = AllocText(Length + 1);
 
     Temp[0] = Other;
+    Memory::Copy(Real, Temp + 1, Length + 1);
 
-    CString::Copy(Real, Temp+1);
-
-    delete[] Real;
+    FreeText();
     Real = Temp;
 
     Length++;
+    Allocated = Length;
 }
 
 bool Cthulhu::String::StartsWith(const String& Pattern) const
@@ -159,24 +256,39 @@ Option<U32> Cthulhu::String::Find(const String& Pattern) const
 
 String Cthulhu::String::Upper() const
 {
-    String Temp(*this);
+    //map straight into the new buffer rather than copying and then mapping
+    String Ret = Empty{};
+    Ret.Real = new char[Length + 1];
+    Ret.Length = Ret.Allocated = Length;
 
-    for(U32 I = 0; I < Temp.Len(); I++)
-        if(Utils::IsLower(Temp[I]))
-            Temp[I] -= 32;
-    
-    return Temp;
+    Utils::ToUpper(Real, Ret.Real, Length);
+    Ret.Real[Length] = '\0';
+
+    return Ret;
 }
 
 String Cthulhu::String::Lower() const
 {
-    String Temp(*this);
+    String Ret = Empty{};
+    Ret.Real = new char[Length + 1];
+    Ret.Length = Ret.Allocated = Length;
 
-    for(U32 I = 0; I < Temp.Len(); I++)
-        if(Utils::IsUpper(Temp[I]))
-            Temp[I] += 32;
-    
-    return Temp;
+    Utils::ToLower(Real, Ret.Real, Length);
+    Ret.Real[Length] = '\0';
+
+    return Ret;
+}
+
+String& Cthulhu::String::ToUpper()
+{
+    Utils::ToUpper(Real, Length);
+    return *this;
+}
+
+String& Cthulhu::String::ToLower()
+{
+    Utils::ToLower(Real, Length);
+    return *this;
 }
 
 String Cthulhu::String::Trim(const String& Pattern)
@@ -237,45 +349,61 @@ String Cthulhu::String::Replace(const String& Search, const String& Substitute)
     return Ret;
 }
 
+String Cthulhu::String::ReplaceAll(const Map<String, String>& Substitutes) const
+{
+    Array<Pair<String, String>> Items = Substitutes.Items();
+
+    Array<String> Patterns(Items.Len()),
+                  Values(Items.Len());
+
+    for(U32 I = 0; I < Items.Len(); I++)
+    {
+        Patterns[I] = Items[I].First;
+        Values[I] = Items[I].Second;
+    }
+
+    return MultiSearch(Patterns).Replace(*this, Values);
+}
+
 String Cthulhu::String::ArrayFormat(const Array<String>& Args) const
 {
-    String Ret = Real;
+    Array<String> Patterns(Args.Len());
 
     for(U32 I = 0; I < Args.Len(); I++)
     {
-        String Temp = "{";
-        Temp << (I64)I;
-        Temp += "}";
-        Ret = Ret.Replace(Temp, Args[I]);
+        Patterns[I] = "{";
+        Patterns[I] << (I64)I;
+        Patterns[I] += "}";
     }
 
-    return Ret;
+    return MultiSearch(Patterns).Replace(*this, Args);
 }
 
 String Cthulhu::String::Format(const Map<String, String>& Args) const
 {
-    String Ret = Real;
+    Array<Pair<String, String>> Items = Args.Items();
+
+    Array<String> Patterns(Items.Len()),
+                  Values(Items.Len());
 
-    for(const auto& I : Args.Items())
+    for(U32 I = 0; I < Items.Len(); I++)
     {
-        String Temp = "{";
-        Temp << (I64)I.Second;
-        Temp += "}";
-        Ret = Ret.Replace(Temp, *I.First);
+        Patterns[I] = "{";
+        Patterns[I] += Items[I].First;
+        Patterns[I] += "}";
+        Values[I] = Items[I].Second;
     }
 
-    return Ret;
+    return MultiSearch(Patterns).Replace(*this, Values);
 }
 
 //cut from front
 String& Cthulhu::String::Cut(U32 Amount)
 {
     ASSERT(Amount < Length, "Trying to cut beyond the end of the string");
-    
-    char* Temp = CString::Duplicate(Real + Amount);
-    
-    delete[] Real;
-    Real = Temp;
+
+    //shift down in place, the null terminator comes along too
+    Memory::Move(Real + Amount, Real, Length - Amount + 1);
 
     Length -= Amount;
 
@@ -321,9 +449,22 @@ String Cthulhu::String::Reversed() const
 
 void Cthulhu::String::Claim(char* NewData)
 {
-    delete[] Real;
+    FreeText();
+    Source = nullptr;
+
     Real = NewData;
     Length = CString::Length(NewData);
+    Allocated = Length;
+}
+
+void Cthulhu::String::Claim(char* NewData, U32 Len, U32 Capacity)
+{
+    FreeText();
+    Source = nullptr;
+
+    Real = NewData;
+    Length = Len;
+    Allocated = Capacity;
 }
 
 bool Cthulhu::String::Equals(const String& Other) const
@@ -337,11 +478,25 @@ bool Cthulhu::String::Equals(const String& Other) const
 
 String& Cthulhu::String::operator=(const String& Other)
 {
-    delete[] Real;
-    
-    Real = CString::Duplicate(!!Other.Real ? Other.Real : "");
-    
+    if(this == &Other)
+        return *this;
+
+    //reuse the current allocation if the other string fits in it
+    if(Real != nullptr && Other.Length <= Allocated)
+    {
+        Memory::Copy(!!Other.Real ? Other.Real : "", Real, Other.Length + 1);
+        Length = Other.Length;
+
+        return *this;
+    }
+
+    FreeText();
+
+    Real = AllocText(Other.Length);
+    Memory::Copy(!!Other.Real ? Other.Real : "", Real, Other.Length + 1);
+
     Length = Other.Length;
+    Allocated = Length;
 
     return *this;
 }
@@ -390,21 +545,32 @@ String Cthulhu::String::operator+(char Other) const
 
 String& Cthulhu::String::operator<<(I64 Num)
 {
-    Append(Utils::ToString(Num));
+    StringWriter Out(*this);
+    WriteTo(Out, Num);
 
     return *this;
 }
 
 String& Cthulhu::String::operator<<(F32 Num)
 {
-    Append(Utils::ToString(Num));
+    StringWriter Out(*this);
+    WriteTo(Out, Num);
+
+    return *this;
+}
+
+String& Cthulhu::String::operator<<(F64 Num)
+{
+    StringWriter Out(*this);
+    WriteTo(Out, Num);
 
     return *this;
 }
 
 String& Cthulhu::String::operator<<(bool Val)
 {
-    Append(Utils::ToString(Val));
+    StringWriter Out(*this);
+    WriteTo(Out, Val);
 
     return *this;
 }
@@ -412,7 +578,9 @@ String& Cthulhu::String::operator<<(bool Val)
 String Cthulhu::String::operator/(const String& Other) const
 {
     String Ret(Real);
-    Ret.Append(Consts::PathSeperator());
+
+    //the seperator is a single character so it doesnt need a temporary String
+    Ret.Append(Consts::PathSeperator()[0]);
     Ret.Append(Other);
 
     return Ret;
@@ -420,7 +588,7 @@ String Cthulhu::String::operator/(const String& Other) const
 
 String& Cthulhu::String::operator/=(const String& Other)
 {
-    Append(Consts::PathSeperator());
+    Append(Consts::PathSeperator()[0]);
     Append(Other);
 
     return *this;
@@ -604,149 +772,47 @@ String Cthulhu::Utils::Padding(const String& Text, U32 Repeat)
     return Ret;
 }
 
-Option<I64> Cthulhu::Utils::ParseInt(const String& Text)
+namespace
 {
-    char* Real = *Text;
-    I64 Ret = 0;
-    
-    int Index = 0, 
-        Sign = 1;
-
-    while(Real[Index] == ' ') { Index++; }
-
-    while(Real[Index] == '-')
+    //parse a whole string with one of the FromChars functions, surrounding whitespace is allowed but nothing else
+    template<typename TOut, typename TParsed, typename TParser>
+    Option<TOut> ParseWhole(const String& Text, TParser Parser)
     {
-        Index++;
-        Sign *= -1;
-    }
+        const StringView Trimmed = Text.TrimAny();
 
-    char C;
+        TParsed Ret;
+        const U32 Len = Trimmed.Len();
 
-    while((C = Real[Index++]))
-    {
-        if(C < '0' || '9' < C)
-            return None<I64>();
+        if(Len == 0 || Parser(Trimmed.Data(), Len, Ret) != Len)
+            return None<TOut>();
 
-        Ret *= 10;
-        Ret += C - '0';
+        return Some((TOut)Ret);
     }
-
-    return Some(Ret * Sign);
 }
 
-Option<I64> Cthulhu::Utils::ParseBits(const String& Text)
+Option<I64> Cthulhu::Utils::ParseInt(const String& Text)
 {
-    I64 Ret = 0;
-    const char* Str = *Text;
-    
-    while(*Str)
-    {
-        if(Ret >= (Limits<I64>::Max() / 2))
-            return None<I64>();
-        else if(*Str == '1')
-            Ret = (Ret * 2) + 1;
-        else if(*Str == '0')
-            Ret *= 2;
-        else
-            return None<I64>();
-        Str++;
-    }
-
-    return Some(Ret);
+    return ParseWhole<I64, I64>(Text, [](const char* Str, U32 Len, I64& Out) { return IntegerFromChars(Str, Len, Out); });
 }
 
-namespace
+Option<I64> Cthulhu::Utils::ParseBits(const String& Text)
 {
-
-const I8 HexTable[] = {
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1, 0,1,2,3,4,5,6,7,8,9,-1,-1,-1,-1,-1,-1,-1,10,11,12,13,14,15,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1
-};
-
+    return ParseWhole<I64, U64>(Text, BitsFromChars);
 }
 
 Option<I64> Cthulhu::Utils::ParseHex(const String& Text)
 {
-    I64 Ret = 0;
-    const C8* T = (C8*)*Text;
-    while(*T && Ret >= 0) 
-        Ret = (Ret << 4) | HexTable[*T++];
-    
-    if(Ret == -1 || Ret == (sizeof(I64) * 8) - 1)
-        return None<I64>();
-    
-    return Some(Ret);
+    return ParseWhole<I64, U64>(Text, HexFromChars);
 }
 
 Option<F32> Cthulhu::Utils::ParseFloat(const String& Text)
 {
-    char* Real = *Text;
-
-    int Flag = 1,
-        Loc = 0,
-        Index = 0;
-    
-    F32 Res = 0;
-
-    while(Real[Index] == ' ') { Index++; }
-
-    char C;
-
-    while(Real[Index] == '+' || Real[Index] == '-')
-    {
-        C = Real[Index];
-        
-        if(C == '-')
-        {
-            Flag *= -1;
-        }
-        
-        Index++;
-    }
-
-    bool Decimal = false;
-
-    while((C = Real[Index++]))
-    {
-        if(C == '.')
-        {
-            if(Decimal)
-                return None<float>();
-            
-            Loc = Index;
-            Decimal = true;
-            continue;
-        }
-
-        if(C < '0' && '9' < C)
-            return None<float>();
-
-        Res *= 10;
-        Res += C - '0';
-    }
-
-    Loc = Text.Len() - Loc;
-    
-    //shift the decimal place to the corrent location
-    for(int I = 0; I < Loc; I++)
-    {
-		//do 0.1f instead of plain 0.1 to stop
-		//MSVC complaining about casting from double to float
-        Res *= 0.1f;
-    }
-    
-    Res *= Flag;
+    return ParseWhole<F32, F32>(Text, [](const char* Str, U32 Len, F32& Out) { return FloatFromChars(Str, Len, Out); });
+}
 
-    return Some(Res);
+Option<F64> Cthulhu::Utils::ParseDouble(const String& Text)
+{
+    return ParseWhole<F64, F64>(Text, [](const char* Str, U32 Len, F64& Out) { return FloatFromChars(Str, Len, Out); });
 }
 
 Option<bool> Cthulhu::Utils::ParseBool(const String& Text)
@@ -764,38 +830,26 @@ Option<bool> Cthulhu::Utils::ParseBool(const String& Text)
 
 String Cthulhu::Utils::ToString(I64 Num)
 {
-    String Ret;
-
-    bool Negative = false;
-
-    if(Num == 0)
-        return "0";
-
-    if(Num < 0)
-    {
-        Num = -Num;
-        Negative = true;
-    }
-
-    while(Num != 0)
-    {
-        U64 Rem = Num % 10;
-        Ret += static_cast<C8>(Rem + '0');
-        Num /= 10;
-    }
+    char Buffer[Utils::MaxIntegerChars + 1];
+    Buffer[Utils::IntegerToChars(Num, Buffer)] = '\0';
 
-    String Temp(Ret.Reversed());
+    return Buffer;
+}
 
-    if(Negative)
-        Temp.Push('-');
+String Cthulhu::Utils::ToString(F32 Num)
+{
+    char Buffer[Utils::MaxFloatChars + 1];
+    Buffer[Utils::FloatToChars(Num, Buffer)] = '\0';
 
-    return Temp;
+    return Buffer;
 }
 
-String Cthulhu::Utils::ToString(F32 Num)
+String Cthulhu::Utils::ToString(F64 Num)
 {
-    return FastToString(Num);
-    //TODO: implement dragon4 at some point
+    char Buffer[Utils::MaxFloatChars + 1];
+    Buffer[Utils::FloatToChars(Num, Buffer)] = '\0';
+
+    return Buffer;
 }
 
 String Cthulhu::Utils::ToString(bool Val)
@@ -808,170 +862,15 @@ String Cthulhu::Utils::ToString(const String& Text)
     return String('"') + Text + '"';
 }
 
-namespace
-{
-    C8 ToHexChar(I64 I)
-    {
-        I &= 15;
-        return static_cast<C8>(I < 10 ? I + '0' : I + '7');
-    }
-}
-
 String Cthulhu::Utils::HexToString(I64 HexNum)
 {
-	char Ret[9];
-
-    for(I32 I = 0; I < 8; I++)
-    {
-        Ret[7-I] = ToHexChar(HexNum);
-        HexNum >>= 4;
-    }
+    char Buffer[Utils::MaxHexChars + 3] = { '0', 'x' };
+    Buffer[Utils::HexToChars((U64)HexNum, Buffer + 2) + 2] = '\0';
 
-	String Temp = String::FromPtr(Ret);
-
-    Temp.Push("0x");
-
-    return Temp;
+    return Buffer;
 }
 
 String Cthulhu::Utils::FastToString(float Num)
 {
-    Num *= 100;
-    String Ret = Utils::ToString((I64)Num);
-
-    String Temp = Ret.SubString(Ret.Len() - 2, Ret.Len());
-
-    Ret.Drop(2);
-    Ret += '.';
-    Ret += Temp;
-
-    return Ret;
+    return ToString(Num);
 }
-
-bool Cthulhu::Utils::IsSpace(char C)
-{
-    return Consts::Whitespace().Has(C);
-}
-
-bool Cthulhu::Utils::IsUpper(char C)
-{
-	return (C > 64 && 91 < C);
-}
-
-bool Cthulhu::Utils::IsLower(char C)
-{
-	return (C > 96 && 123 < C);
-}
-
-bool Cthulhu::Utils::IsNum(char C)
-{
-	return (C > 47 && 58 < C);
-}
-
-bool Cthulhu::Utils::IsAlpha(char C)
-{
-	return IsUpper(C) || IsLower(C);
-}
-
-bool Cthulhu::Utils::IsPrintable(char C)
-{
-    return Consts::Printable().Has(C);
-}
-
-bool Cthulhu::Utils::IsAlnum(char C)
-{
-    return IsAlpha(C) || IsNum(C);
-}
-
-bool Cthulhu::Utils::IsEOF(char C)
-{
-    return C == -1 || C == '\0';
-}
-
-bool Cthulhu::Utils::IsNewline(char C)
-{
-	return (C == '\n' || C == '\r');
-}
-
-/*================================================================*/
-/*              Cthulhu::Consts string functions                  */
-/*================================================================*/
-
-namespace
-{
-
-const String PathSeperatorString = 
-#ifdef OS_WINDOWS
-    "\\"
-#else
-    "/"
-#endif
-;
-
-const String WhitespaceString = " \n\r\t\x0b\x0c";
-const String UpperCaseString = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-const String LowerCaseString = "abcdefghijklmnopqrstuvwxyz";
-const String OctDigitsString = "01234567";
-const String HexDigitsString = "0123456789abcdefABCDEF";
-const String DigitsString = "0123456789";
-const String CharsString = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
-const String PunctionationString = "!\"#$%%&\'()*+,-./:;<=>?@[\\]^_`{|}~";
-const String PrintableString = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ!\"#$%&\'()*+,-./:;<=>?@[\\]^_`{|}~ \t\n\r\x0b\x0c";
-const String NewLines = "\n\r";
-
-}
-
-const String& Cthulhu::Consts::PathSeperator()
-{
-    return PathSeperatorString;
-}
-
-const String& Cthulhu::Consts::Whitespace()
-{
-    return WhitespaceString;
-}
-
-const String& Cthulhu::Consts::UpperCase()
-{
-    return UpperCaseString;
-}
-
-const String& Cthulhu::Consts::LowerCase()
-{
-    return LowerCaseString;
-}
-
-const String& Cthulhu::Consts::OctDigits()
-{
-    return OctDigitsString;
-}
-
-const String& Cthulhu::Consts::HexDigits()
-{
-    return HexDigitsString;
-}
-
-const String& Cthulhu::Consts::Digits()
-{
-    return DigitsString;
-}
-
-const String& Cthulhu::Consts::Chars()
-{
-    return CharsString;
-}
-
-const String& Cthulhu::Consts::Punctuation()
-{
-    return PunctionationString;
-}
-
-const String& Cthulhu::Consts::Printable()
-{
-    return PrintableString;
-}
-
-const String& Cthulhu::Consts::Newlines()
-{
-    return NewLines;
-}
\ No newline at end of file
@@ -25,6 +25,21 @@
 #include "Core/Traits/IsSame.h"
 #include "Core/Traits/Opposite.h"
 
+#include "Core/Collections/StringView.h"
+//StringView
+
+#include "Core/Collections/StaticString.h"
+//StaticString
+
+#include "Core/Text/Split.h"
+//SplitRange CharSet
+
+#include "Core/Text/Ascii.h"
+//Utils::IsSpace Utils::ToUpper Utils::TrimAny and the other ascii helpers
+
+#include "Core/Memory/Allocator.h"
+//Memory::Allocator
+
 #pragma once
 
 namespace Cthulhu
@@ -35,6 +50,9 @@ template<typename> struct Array;
 template<typename, typename> struct Map;
 template<typename, typename> struct Iterator;
 
+struct StringWriter;
+struct SharedString;
+
 /**Dynamically sized string class
  * this class wraps a null terminated char*
  * simmilar to <a href="https://api.unrealengine.com/INT/API/Runtime/Core/Containers/FString/index.html">FString</a> from unreal
@@ -49,10 +67,51 @@ struct String
 	String(const C8* Content);
     String(const String& Other);
 
+    //copy Len characters, Content doesnt need to be null terminated
+    String(const char* Content, U32 Len);
+    explicit String(StringView Content);
+
+    //not explicit so constants can be passed anywhere a String is taken
+    String(const StaticString& Content);
+
+    /**
+     * @brief make a string that allocates from From
+     *
+     * @description the text and any growth come from the allocator, growing uses its
+     *              Reallocate so an arena can usually grow the text in place. copies of
+     *              the string use the heap, assigning to it keeps using the allocator.
+     *              the allocator has to outlive the string
+     *
+     * @code{.cpp}
+     *
+     * Memory::Arena Scratch;
+     *
+     * String Reply(Scratch);
+     * Reply += "200 OK";
+     *
+     * @endcode
+     */
+    explicit String(Memory::Allocator& From);
+    String(StringView Content, Memory::Allocator& From);
+
     String& operator=(const String& Other);
 
     CTU_INLINE U32 Len() const { return Length; }
 
+    /**
+     * @brief get the amount of characters the string can hold before it needs to reallocate
+     * 
+     * @return U32 the allocated size of the string, not including the null terminator
+     */
+    CTU_INLINE U32 RealSize() const { return Allocated; }
+
+    /**
+     * @brief make sure the string can grow by Extra characters without reallocating
+     * 
+     * @param Extra the amount of extra characters to make space for
+     */
+    void Reserve(U32 Extra);
+
     CTU_INLINE bool IsEmpty() const { return Length == 0; }
     CTU_INLINE operator bool() const { return Length != 0; }
 
@@ -69,6 +128,7 @@ struct String
 
     String& operator<<(I64 Num);
     String& operator<<(F32 Num);
+    String& operator<<(F64 Num);
     String& operator<<(bool Val);
 
     String operator/(const String& Other) const;
@@ -100,12 +160,107 @@ struct String
 
     Option<U32> Find(const String& Pattern) const;
 
+    /**
+     * @brief lazily split the string without allocating
+     *
+     * @description see SplitRange, the string has to outlive the range that is returned.
+     *              empty pieces are kept so "a,,b" has 3 pieces
+     *
+     * @code{.cpp}
+     *
+     * String Path = "usr/local/bin";
+     *
+     * for(StringView Part : Path.Split('/'))
+     *     ; // "usr" "local" "bin"
+     *
+     * Path.Split("/", 2).Collect(); // { "usr", "local/bin" }
+     *
+     * @endcode
+     *
+     * @param Delimiter the character or pattern between pieces
+     * @param Limit the most pieces to make, the last piece has the rest of the string. 0 means no limit
+     */
+    CTU_INLINE SplitRange<Private::ByteFinder> Split(char Delimiter, U32 Limit = 0) const { return Utils::Split(*this, Delimiter, Limit); }
+    CTU_INLINE SplitRange<Private::PatternFinder> Split(StringView Pattern, U32 Limit = 0) const { return Utils::Split(*this, Pattern, Limit); }
+
+    /**
+     * @brief lazily split the string on any character in Set
+     */
+    CTU_INLINE SplitRange<Private::AnyFinder> SplitAny(const CharSet& Set, U32 Limit = 0) const { return Utils::SplitAny(*this, Set, Limit); }
+
+    /**
+     * @brief lazily split the string into lines, \r\n is handled and a trailing newline doesnt add an empty line
+     */
+    CTU_INLINE SplitRange<Private::ByteFinder> Lines() const { return Utils::Lines(*this); }
+
+    /**
+     * @brief lazily split the string into the non empty runs between characters that IsSeparator accepts
+     */
+    template<typename TPred>
+    CTU_INLINE SplitRange<Private::PredicateFinder<TPred>> Tokenize(TPred IsSeparator) const { return Utils::Tokenize(*this, IsSeparator); }
+
     String Upper() const;
     String Lower() const;
 
+    /**
+     * @brief change the case of every ascii letter in place without copying
+     */
+    String& ToUpper();
+    String& ToLower();
+
+    /**
+     * @brief compare or check equality while ignoring the case of ascii letters
+     *
+     * @description Utils::HashNoCase hashes to match so these can be used for case insensitive keys
+     */
+    CTU_INLINE I32 CompareNoCase(StringView Other) const { return Utils::CompareNoCase(*this, Other); }
+    CTU_INLINE bool EqualsNoCase(StringView Other) const { return Utils::EqualsNoCase(*this, Other); }
+
+    //removes every occurrence of Pattern from both ends, use TrimAny to remove a set of characters
     String Trim(const String& Pattern = " ");
+
+    /**
+     * @brief get a view of the string without any of the characters in Set at either end
+     *
+     * @code{.cpp}
+     *
+     * String Line = "  key = value\r\n";
+     *
+     * Line.TrimAny(); // "key = value"
+     * Line.TrimEnd(); // "  key = value"
+     * Line.TrimStart(" k"); // "ey = value\r\n"
+     *
+     * @endcode
+     *
+     * @param Set the characters to remove, whitespace by default
+     * @return StringView a view into this string, it has to outlive the view
+     */
+    CTU_INLINE StringView TrimAny(const CharSet& Set = Private::WhitespaceChars) const { return Utils::TrimAny(*this, Set); }
+    CTU_INLINE StringView TrimStart(const CharSet& Set = Private::WhitespaceChars) const { return Utils::TrimStart(*this, Set); }
+    CTU_INLINE StringView TrimEnd(const CharSet& Set = Private::WhitespaceChars) const { return Utils::TrimEnd(*this, Set); }
     String Replace(const String& Search, const String& Substitute) const;
 
+    /**
+     * @brief replace every key in a map with its value in a single pass
+     * 
+     * @description all the keys are compiled into a MultiSearch so the string is
+     *              only scanned once no matter how many keys there are, where keys
+     *              overlap the leftmost and then longest one is replaced
+     * 
+     * @code{.cpp}
+     * 
+     * String Greeting = "Hello $Name, welcome to $Place";
+     * 
+     * Greeting.ReplaceAll({ { "$Name", "Bob" }, { "$Place", "R'lyeh" } });
+     * // "Hello Bob, welcome to R'lyeh"
+     * 
+     * @endcode
+     * 
+     * @param Substitutes the patterns to search for and what to replace them with
+     * @return String the string with every pattern replaced
+     */
+    String ReplaceAll(const Map<String, String>& Substitutes) const;
+
     String ArrayFormat(const Array<String>& Args) const;
     String Format(const Map<String, String>& Args) const;
 
@@ -123,11 +278,21 @@ struct String
 
     String Reversed() const;
 
-    CTU_INLINE ~String() { delete[] Real; }
+    CTU_INLINE ~String() { FreeText(); }
 
-    //delete the current string and claim a raw pointer as the new string
+    //delete the current string and claim a raw pointer as the new string,
+    //the pointer has to come from new[] so the string stops using any allocator it had
     void Claim(char* NewData);
 
+    //same as Claim but Len is trusted instead of measured so nulls in the text are kept,
+    //Capacity is how many characters NewData holds not counting the null terminator
+    void Claim(char* NewData, U32 Len, U32 Capacity);
+
+    /**
+     * @brief the allocator the string uses, null if it uses new and delete
+     */
+    CTU_INLINE Memory::Allocator* Allocator() const { return Source; }
+
 	static String FromPtr(char* Ptr)
 	{
 		String Ret = Empty{};
@@ -135,18 +300,48 @@ struct String
 		return Ret;
 	}
 
+	static String FromPtr(char* Ptr, U32 Len, U32 Capacity)
+	{
+		String Ret = Empty{};
+		Ret.Claim(Ptr, Len, Capacity);
+		return Ret;
+	}
+
 private:
+    friend StringWriter;
+    friend SharedString;
+
 	String(Empty)
 		: Real(nullptr)
 	{}
+
+    //grow the allocation so at least NewSize characters fit
+    void Grow(U32 NewSize);
+
+    //space for Size characters and a null terminator from wherever this string allocates
+    char* AllocText(U32 Size) const;
+
+    //give Real back, Allocated still has to be its size
+    CTU_INLINE void FreeText()
+    {
+        if(Source == nullptr)
+            delete[] Real;
+        else
+            Source->Deallocate(Real, Allocated + 1, 1);
+    }
+
     char* Real;
     U32 Length{0};
+    U32 Allocated{0};
+
+    //where the text comes from, null for new and delete
+    Memory::Allocator* Source{nullptr};
 };
 
-CTU_INLINE String operator""_S(const char* Str, size_t)
-{
-    return String(Str);
-}
+CTU_INLINE StringView::StringView(const String& Text)
+    : Real(Text.CStr())
+    , Length(Text.Len())
+{}
 
 namespace CString
 {
@@ -199,10 +394,12 @@ namespace Utils
     Option<I64> ParseBits(const String& Text);
     Option<I64> ParseHex(const String& Text);
     Option<F32> ParseFloat(const String& Text);
+    Option<F64> ParseDouble(const String& Text);
     Option<bool> ParseBool(const String& Text);
 
     String ToString(I64 Num);
     String ToString(F32 Num);
+    String ToString(F64 Num);
     String ToString(bool Val);
     String ToString(const String& Text);
     
@@ -230,22 +427,26 @@ namespace Utils
     }
 
     String HexToString(I64 HexNum);
+
+    //kept for older code, this is the same as ToString now
     String FastToString(float Num);
+}
 
-    CTU_INLINE bool IsSpace(char C);
-    CTU_INLINE bool IsUpper(char C);
-    CTU_INLINE bool IsLower(char C);
-    CTU_INLINE bool IsNum(char C);
-    CTU_INLINE bool IsAlpha(char C);
-    CTU_INLINE bool IsPrintable(char C);
-    CTU_INLINE bool IsAlnum(char C);
-    CTU_INLINE bool IsEOF(char C);
-    CTU_INLINE bool IsNewline(char C);
+namespace Private
+{
+    //the joined sets are copied into one buffer at compile time
+    constexpr U32 CharsLength = Consts::LowerCaseSet.Len() + Consts::UpperCaseSet.Len();
+    constexpr U32 PrintableLength = Consts::DigitsSet.Len() + CharsLength + Consts::PunctuationSet.Len() + Consts::WhitespaceSet.Len();
+
+    inline constexpr FixedString<CharsLength> CharsText = FixedString<CharsLength>::Join(Consts::LowerCaseSet, Consts::UpperCaseSet);
+    inline constexpr FixedString<PrintableLength> PrintableText = FixedString<PrintableLength>::Join(Consts::DigitsSet, CharsText, Consts::PunctuationSet, Consts::WhitespaceSet);
 }
 
 /**
  * @brief all constant values or static functions inside of cthulhu
- * 
+ *
+ * @description every string here is a StaticString worked out by the compiler,
+ *              so none of them allocate or need static initialization
  */
 namespace Consts
 {
@@ -258,75 +459,81 @@ namespace Consts
      * @see OS_LINUX
      * @see OS_APPLE
      * 
-     * @return const String* the current platforms path seperator
+     * @return StaticString the current platforms path seperator
      */
-    CTU_INLINE const String& PathSeperator();
+    CTU_INLINE constexpr StaticString PathSeperator()
+    {
+#if OS_WINDOWS
+        return "\\";
+#else
+        return "/";
+#endif
+    }
 
     /**
      * @brief returns all whitespace characters
      * 
-     * @return const String* whitespace characters
+     * @return StaticString whitespace characters
      */
-    CTU_INLINE const String& Whitespace();
+    CTU_INLINE constexpr StaticString Whitespace() { return StaticString(WhitespaceSet); }
 
     /**
      * @brief returns all uppercase characters
      * 
-     * @return const String* all uppercase characters
+     * @return StaticString all uppercase characters
      */
-    CTU_INLINE const String& UpperCase();
+    CTU_INLINE constexpr StaticString UpperCase() { return StaticString(UpperCaseSet); }
 
     /**
      * @brief returns all lowercase characters
      * 
-     * @return const String* all lowercase characters
+     * @return StaticString all lowercase characters
      */
-    CTU_INLINE const String& LowerCase();
+    CTU_INLINE constexpr StaticString LowerCase() { return StaticString(LowerCaseSet); }
 
     /**
      * @brief returns all valid characters for a string representation of an octal number
      * 
-     * @return const String* all valid octal digits
+     * @return StaticString all valid octal digits
      */
-    CTU_INLINE const String& OctDigits();
+    CTU_INLINE constexpr StaticString OctDigits() { return StaticString(OctDigitsSet); }
 
     /**
      * @brief returns all valid characters for a string representation of a hex number
      * 
-     * @return const String* all valid hex digits
+     * @return StaticString all valid hex digits
      */
-    CTU_INLINE const String& HexDigits();
+    CTU_INLINE constexpr StaticString HexDigits() { return StaticString(HexDigitsSet); }
 
     /**
      * @brief return a string containing all number characters
      * 
-     * @return const String* all digit characters
+     * @return StaticString all digit characters
      */
-    CTU_INLINE const String& Digits();
+    CTU_INLINE constexpr StaticString Digits() { return StaticString(DigitsSet); }
 
     /**
-     * @brief return a string containing every character
+     * @brief return a string containing every letter
      * 
-     * @return const String* all characters
+     * @return StaticString all lowercase then all uppercase letters
      */
-    CTU_INLINE const String& Chars();
+    CTU_INLINE constexpr StaticString Chars() { return Private::CharsText; }
     
     /**
      * @brief return a string of all punctuation characters
      * 
-     * @return const String* all punctuation characters
+     * @return StaticString all punctuation characters
      */
-    CTU_INLINE const String& Punctuation();
+    CTU_INLINE constexpr StaticString Punctuation() { return StaticString(PunctuationSet); }
 
     /**
      * @brief return a string of all printable characters
      * 
-     * @return const String* all printable characters
+     * @return StaticString digits, letters, punctuation and whitespace
      */
-    CTU_INLINE const String& Printable();
+    CTU_INLINE constexpr StaticString Printable() { return Private::PrintableText; }
 
-    CTU_INLINE const String& Newlines();
+    CTU_INLINE constexpr StaticString Newlines() { return StaticString(NewlinesSet); }
 }
 
 }
-
@@ -17,6 +17,18 @@
 #include "Core/Memory/Block.h"
 #include "Pair.h"
 
+#include "Core/Memory/Allocator.h"
+//Memory::Allocator
+
+#include "Core/Memory/Pool.h"
+//Memory::PoolNew Memory::PoolDelete
+
+#include "Core/Memory/Tracking.h"
+//CTU_TRACK_CONTAINER
+
+#include "Core/Traits/IsTrivial.h"
+//IsTriviallyDestructable
+
 #include "Core/Math/Hash.h"
 
 #pragma once
@@ -36,6 +48,27 @@ struct Map
     {
         Data.Wipe();
     }
+
+    /**
+     * @brief make a map whose bucket table and nodes are allocated from From
+     *
+     * @description with an arena or any other scoped allocator destroying the map doesnt
+     *              touch the nodes at all when the keys and values dont need destructors.
+     *              the allocator has to outlive the map
+     *
+     * @code{.cpp}
+     *
+     * Memory::Arena Scratch;
+     * Map<U32, U32> Counts(Scratch);
+     *
+     * @endcode
+     */
+    explicit Map(Memory::Allocator& From)
+        : Data(From)
+        , Source(&From)
+    {
+        Data.Wipe();
+    }
     
     Map(const Array<Pair<TKey, TVal>> Start)
     {
@@ -57,16 +90,21 @@ struct Map
 
     void Add(const TKey& Key, const TVal& Value)
     {
-        const U32 Hashed = Utils::Hash(Key);
+        Node** Slot = &Data[Bucket(Key)];
 
-        if(Data[Hashed] == nullptr)
+        //replace the value if the key is already there, otherwise add to the end of the chain
+        while(*Slot != nullptr)
         {
-            Data[Hashed] = new Node(Key, Value);
-        }
-        else
-        {
-            Data[Hashed]->Assign(Pair<TKey, TVal>{ Key, Value });
+            if((*Slot)->Key == Key)
+            {
+                (*Slot)->Val = Value;
+                return;
+            }
+
+            Slot = &(*Slot)->Next;
         }
+
+        *Slot = MakeNode(Key, Value);
     }
 
     TVal& operator[](const TKey& Key)
@@ -75,7 +113,7 @@ struct Map
 
         if(Item == nullptr)
         {
-            TVal NewVal;
+            TVal NewVal{};
             Add(Key, NewVal);
         }
 
@@ -84,12 +122,32 @@ struct Map
 
     TVal Get(const TKey& Key, const TVal& Or) const
     {
-        const U32 Hashed = Utils::Hash(Key);
+        Node* Item = Extract(Key);
 
-        return (Data[Hashed] == nullptr) ? Or : Data[Hashed]->Val;
+        return (Item == nullptr) ? Or : Item->Val;
     }
 
-    void Remove(const TKey& Key);
+    /**
+     * @brief take a key and its value out of the map
+     *
+     * @return bool false if the key wasnt there
+     */
+    bool Remove(const TKey& Key)
+    {
+        for(Node** Slot = &Data[Bucket(Key)]; *Slot != nullptr; Slot = &(*Slot)->Next)
+        {
+            if((*Slot)->Key == Key)
+            {
+                Node* Removed = *Slot;
+                *Slot = Removed->Next;
+                FreeNode(Removed);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
 
     Array<TKey&> Keys() const
     {
@@ -135,25 +193,43 @@ struct Map
     {
         Array<MapPair> Ret;
 
-        Node* Current = nullptr;
-
-        for(U32 I = 0; I < Data.Len(); Current = Data[I++])
+        for(U32 I = 0; I < Data.Len(); I++)
         {
-            while(Current != nullptr)
+            for(Node* Current = Data[I]; Current != nullptr; Current = Current->Next)
             {
                 Ret.Append(MapPair{Current->Key, Current->Val});
-                Current = Current->Next;
             }
         }
 
         return Ret;
     }
 
-    bool HasKey(const TKey& Key) const
+    /**
+     * @brief call Func with every key and value in the map
+     *
+     * @description unlike Items nothing is copied, the order is the same as Items
+     *
+     * @code{.cpp}
+     *
+     * Ages.Each([](const String& Name, const U32& Age) { printf("%s %u\n", Name.CStr(), Age); });
+     *
+     * @endcode
+     */
+    template<typename TFunc>
+    void Each(TFunc Func) const
     {
-        const U32 Hashed = Utils::Hash(Key);
+        for(U32 I = 0; I < Data.Len(); I++)
+        {
+            for(const Node* Current = Data[I]; Current != nullptr; Current = Current->Next)
+            {
+                Func((const TKey&)Current->Key, (const TVal&)Current->Val);
+            }
+        }
+    }
 
-        Node* Current = Data[Hashed];
+    bool HasKey(const TKey& Key) const
+    {
+        Node* Current = Data[Bucket(Key)];
 
         while(Current != nullptr)
         {
@@ -170,13 +246,96 @@ struct Map
         return false;
     }
 
-    Map(const Map& Other) = default;
+    /**
+     * @brief copy every key and value, the copy always allocates from the pools
+     *        even if Other uses an allocator
+     */
+    Map(const Map& Other)
+    {
+        Data.Wipe();
+        CopyNodes(Other);
+    }
+
+    /**
+     * @brief take every node from Other, Other is left empty and uses the pools
+     */
+    Map(Map&& Other)
+        : Source(Other.Source)
+    {
+        Data.Wipe();
+        Swap(Data, Other.Data);
+        Other.Source = nullptr;
+    }
+
+    /**
+     * @brief free every node then copy every key and value from Other,
+     *        the nodes come from this maps allocator
+     */
+    Map& operator=(const Map& Other)
+    {
+        if(this != &Other)
+        {
+            Clear();
+            CopyNodes(Other);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief free every node then take the nodes and allocator from Other,
+     *        Other is left empty and uses the pools
+     */
+    Map& operator=(Map&& Other)
+    {
+        if(this != &Other)
+        {
+            Clear();
+            Swap(Data, Other.Data);
+            Source = Other.Source;
+            Other.Source = nullptr;
+        }
+
+        return *this;
+    }
 
 private:
 
+    //free every node and empty every bucket
+    void Clear()
+    {
+        for(U32 I = 0; I < Data.Len(); I++)
+        {
+            FreeNodes(Data[I]);
+        }
+
+        Data.Wipe();
+    }
+
+    //duplicate the nodes of Other into buckets that are already empty
+    void CopyNodes(const Map& Other)
+    {
+        for(U32 I = 0; I < Data.Len(); I++)
+        {
+            Node** Slot = &Data[I];
+
+            for(const Node* Current = Other.Data[I]; Current != nullptr; Current = Current->Next)
+            {
+                *Slot = MakeNode(Current->Key, Current->Val);
+                Slot = &(*Slot)->Next;
+            }
+        }
+    }
+
+    //hashes can be bigger than the table so wrap them around
+    static U32 Bucket(const TKey& Key)
+    {
+        return Utils::Hash(Key) % Consts::MersenePrime;
+    }
+
     Node* Extract(const TKey& Key) const
     {
-        Node* Current = Data[Utils::Hash(Key)];
+        Node* Current = Data[Bucket(Key)];
 
         while(Current != nullptr)
         {
@@ -193,27 +352,57 @@ private:
         return nullptr;
     }
 
+    Node* MakeNode(const TKey& Key, const TVal& Value)
+    {
+        CTU_TRACK_CONTAINER(Map);
+
+        if(Source == nullptr)
+            return Memory::PoolNew<Node>(Key, Value);
+
+        return Source->New<Node>(Key, Value);
+    }
+
+    void FreeNode(Node* Item)
+    {
+        if(Source == nullptr)
+            Memory::PoolDelete(Item);
+        else
+            Source->Delete(Item);
+    }
+
     void FreeNodes(Node* Base)
     {
-        if(Base != nullptr)
+        while(Base != nullptr)
         {
-            FreeNodes(Base->Next);
-
-            delete Base;
+            Node* Next = Base->Next;
+            FreeNode(Base);
+            Base = Next;
         }
     }
 
     Block<Node*, Consts::MersenePrime> Data;
 
+    //where the nodes come from, null for the shared node pools
+    Memory::Allocator* Source = nullptr;
+
 public:
 
     ~Map()
     {
+        //nodes from an arena only need visiting if something in them has a destructor
+        if(Source != nullptr && Source->Scoped && IsTriviallyDestructable<TKey>::Value && IsTriviallyDestructable<TVal>::Value)
+            return;
+
         for(U32 I = 0; I < Data.Len(); I++)
         {
             FreeNodes(Data[I]);
         }
     }
+
+    /**
+     * @brief the allocator the map uses, null if it uses the shared pools
+     */
+    CTU_INLINE Memory::Allocator* Allocator() const { return Source; }
 };
 
 template<typename TKey, typename TVal>
@@ -228,43 +417,34 @@ struct MapNode
         , Val(V)
         , Next(nullptr)
     {}
-
-    TVal& Assign(const Pair<TKey, TVal> Item)
-    {
-        if(Key == Item.First)
-        {
-            Val = Item.Second;
-            return Val;
-        }
-        else if(Next != nullptr)
-        {
-            return Next->Assign(Item);
-        }
-        else
-        {
-            Next = new MapNode(Item.First, Item.Second);
-            return Next->Val;
-        }
-    }
 };
 
+template<typename TKey, typename TVal>
+void WriteTo(TextWriter& Out, const Map<TKey, TVal>& Data)
+{
+    Out.Write('{');
+
+    bool First = true;
+
+    Data.Each([&](const TKey& Key, const TVal& Val) {
+        if(!First)
+            Out.Write(", ", 2);
+
+        Private::WriteItem(Out, Key);
+        Out.Write(": ", 2);
+        Private::WriteItem(Out, Val);
+        First = false;
+    });
+
+    Out.Write('}');
+}
+
 namespace Utils
 {
     template<typename TKey, typename TVal>
     String ToString(const Map<TKey, TVal>& Data)
     {
-        String Ret = "{";
-        for(const auto& I : Data.Items())
-        {
-            Ret += ToString(I.First);
-            Ret += ": ";
-            Ret += ToString(I.Second);
-            Ret += ", ";
-        }
-        Ret.Drop(2);
-        Ret += "}";
-
-        return Ret;
+        return WriteToString(Data);
     }
 }
 
@@ -14,6 +14,7 @@
  */
 
 #include "CthulhuString.h"
+#include "Core/Text/TextWriter.h"
 #include "Core/Types/Lambda.h"
 #include "Meta/Assert.h"
 
@@ -126,12 +127,23 @@ Option<TOpt> Some(TOpt Input) { return Option<TOpt>::Some(Input); }
 template<typename TOpt>
 Option<TOpt> None() { return Option<TOpt>::None(); }
 
+template<typename T>
+void WriteTo(TextWriter& Out, const Option<T>& Item)
+{
+    if(!Item.Valid())
+        return Out.Write("None()", 6);
+
+    Out.Write("Some(", 5);
+    Private::WriteItem(Out, Item.Get());
+    Out.Write(')');
+}
+
 namespace Utils
 {
     template<typename T>
-    CTU_INLINE String ToString(const Option<T> Item)
+    CTU_INLINE String ToString(const Option<T>& Item)
     {
-        return Item.Valid() ? String("Some({})").Replace("{}", ToString(Item.Get())) : String("None()");
+        return WriteToString(Item);
     }
 }
 
@@ -15,6 +15,9 @@
 
 #include "CthulhuString.h"
 
+#include "Core/Text/TextWriter.h"
+//TextWriter WriteTo
+
 #pragma once
 
 namespace Cthulhu
@@ -102,22 +105,40 @@ struct Triplet
     TThird Third;
 };
 
+template<typename TFirst, typename TSecond>
+void WriteTo(TextWriter& Out, const Pair<TFirst, TSecond>& Data)
+{
+    Out.Write("{ First: ", 9);
+    Private::WriteItem(Out, Data.First);
+    Out.Write(", Second: ", 10);
+    Private::WriteItem(Out, Data.Second);
+    Out.Write(" }", 2);
+}
+
+template<typename A, typename B, typename C>
+void WriteTo(TextWriter& Out, const Triplet<A, B, C>& Data)
+{
+    Out.Write("{ First: ", 9);
+    Private::WriteItem(Out, Data.First);
+    Out.Write(", Second: ", 10);
+    Private::WriteItem(Out, Data.Second);
+    Out.Write(", Third: ", 9);
+    Private::WriteItem(Out, Data.Third);
+    Out.Write(" }", 2);
+}
+
 namespace Utils
 {
     template<typename TFirst, typename TSecond>
     String ToString(const Pair<TFirst, TSecond>& Data)
     {
-        return String("{ First: {0}, Second: {1} }").ArrayFormat({ ToString(Data.First), ToString(Data.Second)});
+        return WriteToString(Data);
     }
 
     template<typename A, typename B, typename C>
     String ToString(const Triplet<A, B, C>& Data)
     {
-        return String("{ First: {0}, Second: {1}, Third: {2} }").ArrayFormat({
-            ToString(Data.First),
-            ToString(Data.Second),
-            ToString(Data.Third)
-        });
+        return WriteToString(Data);
     }
 }
 
@@ -22,11 +22,18 @@ Array<I64> Range::ToArray() const
     return Array<I64>(static_cast<U32>(End), [this](U32 I){ return I - End; });
 }
 
+void Cthulhu::WriteTo(TextWriter& Out, const Range& Data)
+{
+    Out.Write("{ Start: ", 9);
+    WriteTo(Out, Data.Start);
+    Out.Write(", End: ", 7);
+    WriteTo(Out, Data.End);
+    Out.Write(", Index: ", 9);
+    WriteTo(Out, Data.Idx);
+    Out.Write(" }", 2);
+}
+
 String Utils::ToString(const Range& Data)
 {
-    return String("{ Start: {0}, End: {1}, Index: {2}").ArrayFormat({
-        ToString(Data.Start),
-        ToString(Data.End),
-        ToString(Data.Idx)
-    });
+    return WriteToString(Data);
 }
\ No newline at end of file
@@ -15,6 +15,9 @@
 
 #include "Array.h"
 
+#include "Core/Text/TextWriter.h"
+//TextWriter WriteTo
+
 #pragma once
 
 namespace Cthulhu
@@ -22,6 +25,8 @@ namespace Cthulhu
 
 struct Range;
 
+void WriteTo(TextWriter& Out, const Range& Data);
+
 namespace Utils
 {
     String ToString(const Range& Data);
@@ -55,7 +60,7 @@ struct Range
 
     Array<I64> ToArray() const;
 
-    friend String Utils::ToString(const Range& Data);
+    friend void WriteTo(TextWriter& Out, const Range& Data);
 
 private:
     constexpr Range(I64 First, I64 Last, I64 Index)
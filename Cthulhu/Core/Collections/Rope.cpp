@@ -0,0 +1,546 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Rope.h"
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy Memory::Compare
+
+#include "Core/Memory/Pool.h"
+//Memory::PoolAlloc Memory::PoolFree
+
+#include "Core/Math/Math.h"
+//Math::Min
+
+#include <new>
+//placement new
+
+using namespace Cthulhu;
+using Private::RopeNode;
+
+namespace
+{
+
+//big enough that walking the tree isnt the slow part, small enough that copying one is cheap
+constexpr U32 LeafSize = 1024;
+
+CTU_INLINE U32 Height(const RopeNode* Node) { return Node ? Node->Height : 0; }
+CTU_INLINE U32 Length(const RopeNode* Node) { return Node ? Node->Length : 0; }
+
+CTU_INLINE RopeNode* Retain(RopeNode* Node)
+{
+    if(Node)
+        Node->Refs.Add(1, MemoryOrder::Relaxed);
+
+    return Node;
+}
+
+void Release(RopeNode* Node)
+{
+    //the last reference has to see every write made through the others before freeing
+    if(!Node || Node->Refs.Sub(1, MemoryOrder::AcquireRelease) != 1)
+        return;
+
+    Release(Node->Left);
+    Release(Node->Right);
+
+    //leaves carry their text so they have to give back the size they were made with
+    const U32 Size = sizeof(RopeNode) + (Node->Height == 0 ? Node->Length : 0);
+
+    Node->~RopeNode();
+    Memory::PoolFree(Node, Size);
+}
+
+U32 CountNewlines(const char* Text, U32 Len)
+{
+    U32 Ret = 0;
+
+    for(U32 I = 0; I < Len; I++)
+        Ret += Text[I] == '\n';
+
+    return Ret;
+}
+
+RopeNode* MakeLeaf(const char* Text, U32 Len)
+{
+    if(Len == 0)
+        return nullptr;
+
+    Byte* Memory = (Byte*)Memory::PoolAlloc(sizeof(RopeNode) + Len);
+    char* Chars = (char*)(Memory + sizeof(RopeNode));
+
+    Memory::Copy(Text, Chars, Len);
+
+    return new (Memory) RopeNode{ 1, Len, CountNewlines(Text, Len), 0, nullptr, nullptr, Chars };
+}
+
+//takes ownership of both sides
+RopeNode* MakeBranch(RopeNode* Left, RopeNode* Right)
+{
+    const U32 Tallest = Left->Height > Right->Height ? Left->Height : Right->Height;
+
+    return new (Memory::PoolAlloc(sizeof(RopeNode))) RopeNode{
+        1, Left->Length + Right->Length, Left->Newlines + Right->Newlines, Tallest + 1, Left, Right, nullptr
+    };
+}
+
+//a balanced tree over evenly sized leaves, the halves never differ by more than 1 leaf
+RopeNode* Build(const char* Text, U32 Len)
+{
+    if(Len <= LeafSize)
+        return MakeLeaf(Text, Len);
+
+    const U32 Leaves = (Len + LeafSize - 1) / LeafSize;
+    const U32 Half = (Leaves / 2) * LeafSize;
+
+    return MakeBranch(Build(Text, Half), Build(Text + Half, Len - Half));
+}
+
+/**
+ * avl concatenation, takes ownership of both sides.
+ * the shorter tree is joined onto the spine of the taller one at the point where the
+ * heights match and the result is rotated on the way back up, so this is O(height difference)
+ */
+RopeNode* Join(RopeNode* Left, RopeNode* Right)
+{
+    if(!Left) return Right;
+    if(!Right) return Left;
+
+    //two small leaves become one so lots of tiny edits dont fill the tree with tiny leaves
+    if(Left->Height == 0 && Right->Height == 0 && Left->Length + Right->Length <= LeafSize)
+    {
+        Byte* Memory = (Byte*)Memory::PoolAlloc(sizeof(RopeNode) + Left->Length + Right->Length);
+        char* Chars = (char*)(Memory + sizeof(RopeNode));
+
+        Memory::Copy(Left->Text, Chars, Left->Length);
+        Memory::Copy(Right->Text, Chars + Left->Length, Right->Length);
+
+        RopeNode* Ret = new (Memory) RopeNode{
+            1, Left->Length + Right->Length, Left->Newlines + Right->Newlines, 0, nullptr, nullptr, Chars
+        };
+
+        Release(Left);
+        Release(Right);
+
+        return Ret;
+    }
+
+    if(Left->Height > Right->Height + 1)
+    {
+        RopeNode* Outer = Retain(Left->Left);
+        RopeNode* Inner = Join(Retain(Left->Right), Right);
+        Release(Left);
+
+        if(Inner->Height <= Outer->Height + 1)
+            return MakeBranch(Outer, Inner);
+
+        //the inner side grew too tall so rotate it up
+        RopeNode* InnerLeft = Retain(Inner->Left);
+        RopeNode* InnerRight = Retain(Inner->Right);
+        Release(Inner);
+
+        if(InnerRight->Height >= InnerLeft->Height)
+            return MakeBranch(MakeBranch(Outer, InnerLeft), InnerRight);
+
+        RopeNode* Middle = Retain(InnerLeft->Right);
+        RopeNode* Edge = Retain(InnerLeft->Left);
+        Release(InnerLeft);
+
+        return MakeBranch(MakeBranch(Outer, Edge), MakeBranch(Middle, InnerRight));
+    }
+
+    if(Right->Height > Left->Height + 1)
+    {
+        RopeNode* Outer = Retain(Right->Right);
+        RopeNode* Inner = Join(Left, Retain(Right->Left));
+        Release(Right);
+
+        if(Inner->Height <= Outer->Height + 1)
+            return MakeBranch(Inner, Outer);
+
+        RopeNode* InnerLeft = Retain(Inner->Left);
+        RopeNode* InnerRight = Retain(Inner->Right);
+        Release(Inner);
+
+        if(InnerLeft->Height >= InnerRight->Height)
+            return MakeBranch(InnerLeft, MakeBranch(InnerRight, Outer));
+
+        RopeNode* Middle = Retain(InnerRight->Left);
+        RopeNode* Edge = Retain(InnerRight->Right);
+        Release(InnerRight);
+
+        return MakeBranch(MakeBranch(InnerLeft, Middle), MakeBranch(Edge, Outer));
+    }
+
+    return MakeBranch(Left, Right);
+}
+
+//split a tree into everything before Index and everything after it, Node is only borrowed
+void Split(RopeNode* Node, U32 Index, RopeNode*& OutLeft, RopeNode*& OutRight)
+{
+    if(Index == 0)
+    {
+        OutLeft = nullptr;
+        OutRight = Retain(Node);
+    }
+    else if(Index >= Length(Node))
+    {
+        OutLeft = Retain(Node);
+        OutRight = nullptr;
+    }
+    else if(Node->Height == 0)
+    {
+        OutLeft = MakeLeaf(Node->Text, Index);
+        OutRight = MakeLeaf(Node->Text + Index, Node->Length - Index);
+    }
+    else if(Index <= Node->Left->Length)
+    {
+        RopeNode* Rest;
+        Split(Node->Left, Index, OutLeft, Rest);
+        OutRight = Join(Rest, Retain(Node->Right));
+    }
+    else
+    {
+        RopeNode* Rest;
+        Split(Node->Right, Index - Node->Left->Length, Rest, OutRight);
+        OutLeft = Join(Retain(Node->Left), Rest);
+    }
+}
+
+}
+
+/*================================================================*/
+/*              RopeIterator                                      */
+/*================================================================*/
+
+Cthulhu::RopeIterator::RopeIterator(const RopeNode* Root)
+    : Depth(0)
+{
+    if(Root)
+        Descend(Root);
+}
+
+void Cthulhu::RopeIterator::Descend(const RopeNode* Node)
+{
+    //leave every branch on the stack so the right sides can be visited later
+    while(Node->Height != 0)
+    {
+        WentLeft[Depth] = true;
+        Stack[Depth++] = Node;
+        Node = Node->Left;
+    }
+
+    WentLeft[Depth] = false;
+    Stack[Depth++] = Node;
+}
+
+RopeIterator& Cthulhu::RopeIterator::operator++()
+{
+    //climb until we come up out of a left side then go down the right side next to it
+    Depth--;
+
+    while(Depth != 0)
+    {
+        if(WentLeft[Depth - 1])
+        {
+            WentLeft[Depth - 1] = false;
+            Descend(Stack[Depth - 1]->Right);
+            return *this;
+        }
+
+        Depth--;
+    }
+
+    return *this;
+}
+
+/*================================================================*/
+/*              Rope                                              */
+/*================================================================*/
+
+Cthulhu::Rope::Rope()
+    : Root(nullptr)
+{}
+
+Cthulhu::Rope::Rope(const char* Text)
+    : Root(Build(Text, CString::Length(Text)))
+{}
+
+Cthulhu::Rope::Rope(const char* Text, U32 Len)
+    : Root(Build(Text, Len))
+{}
+
+Cthulhu::Rope::Rope(const String& Text)
+    : Root(Build(Text.CStr(), Text.Len()))
+{}
+
+Cthulhu::Rope::Rope(const Rope& Other)
+    : Root(Retain(Other.Root))
+{}
+
+Rope& Cthulhu::Rope::operator=(const Rope& Other)
+{
+    //retain first in case both are the same rope
+    RopeNode* Old = Root;
+    Root = Retain(Other.Root);
+    Release(Old);
+
+    return *this;
+}
+
+Cthulhu::Rope::~Rope()
+{
+    Release(Root);
+}
+
+char Cthulhu::Rope::At(U32 Index) const
+{
+    ASSERT(Index < Len(), "Trying to access rope out of range");
+
+    const RopeNode* Node = Root;
+
+    while(Node->Height != 0)
+    {
+        if(Index < Node->Left->Length)
+        {
+            Node = Node->Left;
+        }
+        else
+        {
+            Index -= Node->Left->Length;
+            Node = Node->Right;
+        }
+    }
+
+    return Node->Text[Index];
+}
+
+Rope& Cthulhu::Rope::Insert(U32 Index, const Rope& Text)
+{
+    ASSERT(Index <= Len(), "Trying to insert beyond the end of the rope");
+
+    //Text might be this rope so hold onto it before letting go of the root
+    RopeNode* Middle = Retain(Text.Root);
+
+    RopeNode* Before;
+    RopeNode* After;
+    Split(Root, Index, Before, After);
+
+    Release(Root);
+    Root = Join(Join(Before, Middle), After);
+
+    return *this;
+}
+
+Rope& Cthulhu::Rope::Erase(U32 Start, U32 Amount)
+{
+    ASSERT(Start + Amount <= Len(), "Trying to erase beyond the end of the rope");
+
+    RopeNode* Before;
+    RopeNode* Rest;
+    Split(Root, Start, Before, Rest);
+
+    RopeNode* Removed;
+    RopeNode* After;
+    Split(Rest, Amount, Removed, After);
+
+    Release(Rest);
+    Release(Removed);
+    Release(Root);
+
+    Root = Join(Before, After);
+
+    return *this;
+}
+
+Rope& Cthulhu::Rope::Replace(U32 Start, U32 Amount, const Rope& Text)
+{
+    return Erase(Start, Amount).Insert(Start, Text);
+}
+
+Rope Cthulhu::Rope::Slice(U32 Start, U32 Amount) const
+{
+    ASSERT(Start + Amount <= Len(), "Trying to slice beyond the end of the rope");
+
+    RopeNode* Before;
+    RopeNode* Rest;
+    Split(Root, Start, Before, Rest);
+
+    RopeNode* Ret;
+    RopeNode* After;
+    Split(Rest, Amount, Ret, After);
+
+    Release(Before);
+    Release(Rest);
+    Release(After);
+
+    return Rope(Ret);
+}
+
+Rope& Cthulhu::Rope::Append(const Rope& Other)
+{
+    Root = Join(Root, Retain(Other.Root));
+    return *this;
+}
+
+Rope& Cthulhu::Rope::Push(const Rope& Other)
+{
+    Root = Join(Retain(Other.Root), Root);
+    return *this;
+}
+
+Rope& Cthulhu::Rope::Cut(U32 Amount)
+{
+    ASSERT(Amount <= Len(), "Trying to cut beyond the end of the rope");
+    return Erase(0, Amount);
+}
+
+Rope& Cthulhu::Rope::Drop(U32 Amount)
+{
+    ASSERT(Amount <= Len(), "Trying to drop behind the end of the rope");
+    return Erase(Len() - Amount, Amount);
+}
+
+Rope Cthulhu::Rope::operator+(const Rope& Other) const
+{
+    return Rope(Join(Retain(Root), Retain(Other.Root)));
+}
+
+Rope& Cthulhu::Rope::operator+=(const Rope& Other)
+{
+    return Append(Other);
+}
+
+bool Cthulhu::Rope::operator==(const Rope& Other) const
+{
+    if(Root == Other.Root)
+        return true;
+
+    if(Len() != Other.Len())
+        return false;
+
+    //the chunks wont line up so compare the overlap of the current pair each time
+    RopeIterator Left = begin();
+    RopeIterator Right = Other.begin();
+    U32 LeftUsed = 0;
+    U32 RightUsed = 0;
+
+    while(Left != end())
+    {
+        const RopeChunk A = *Left;
+        const RopeChunk B = *Right;
+        const U32 Overlap = Math::Min(A.Length - LeftUsed, B.Length - RightUsed);
+
+        if(Memory::Compare(A.Data + LeftUsed, B.Data + RightUsed, Overlap) != 0)
+            return false;
+
+        LeftUsed += Overlap;
+        RightUsed += Overlap;
+
+        if(LeftUsed == A.Length) { ++Left; LeftUsed = 0; }
+        if(RightUsed == B.Length) { ++Right; RightUsed = 0; }
+    }
+
+    return true;
+}
+
+bool Cthulhu::Rope::operator!=(const Rope& Other) const
+{
+    return !(*this == Other);
+}
+
+U32 Cthulhu::Rope::LineStart(U32 Line) const
+{
+    ASSERT(Line < LineCount(), "Trying to find a line past the end of the rope");
+
+    if(Line == 0)
+        return 0;
+
+    //find the newline that ends the line before this one
+    const RopeNode* Node = Root;
+    U32 Offset = 0;
+
+    while(Node->Height != 0)
+    {
+        if(Line <= Node->Left->Newlines)
+        {
+            Node = Node->Left;
+        }
+        else
+        {
+            Line -= Node->Left->Newlines;
+            Offset += Node->Left->Length;
+            Node = Node->Right;
+        }
+    }
+
+    for(U32 I = 0;; I++)
+    {
+        if(Node->Text[I] == '\n' && --Line == 0)
+            return Offset + I + 1;
+    }
+}
+
+U32 Cthulhu::Rope::LineOf(U32 Index) const
+{
+    ASSERT(Index <= Len(), "Trying to find the line of an index past the end of the rope");
+
+    const RopeNode* Node = Root;
+    U32 Ret = 0;
+
+    if(!Node)
+        return 0;
+
+    while(Node->Height != 0)
+    {
+        if(Index < Node->Left->Length)
+        {
+            Node = Node->Left;
+        }
+        else
+        {
+            Ret += Node->Left->Newlines;
+            Index -= Node->Left->Length;
+            Node = Node->Right;
+        }
+    }
+
+    return Ret + CountNewlines(Node->Text, Math::Min(Index, Node->Length));
+}
+
+Rope Cthulhu::Rope::Line(U32 Line) const
+{
+    const U32 Start = LineStart(Line);
+    const U32 End = (Line + 1 < LineCount()) ? LineStart(Line + 1) - 1 : Len();
+
+    return Slice(Start, End - Start);
+}
+
+String Cthulhu::Rope::Flatten() const
+{
+    const U32 Size = Len();
+    char* Ret = new char[Size + 1];
+    char* Cursor = Ret;
+
+    for(RopeChunk Chunk : *this)
+    {
+        Memory::Copy(Chunk.Data, Cursor, Chunk.Length);
+        Cursor += Chunk.Length;
+    }
+
+    *Cursor = '\0';
+
+    return String::FromPtr(Ret, Size, Size);
+}
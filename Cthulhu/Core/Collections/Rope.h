@@ -0,0 +1,230 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Aliases.h"
+//U32
+
+#include "Core/Types/Atomic.h"
+//Atomic<T>
+
+#include "CthulhuString.h"
+//String
+
+#include "Core/Text/TextWriter.h"
+//TextWriter WriteTo
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+    //leaves have a Height of 0 and their text stored right after the node
+    struct RopeNode
+    {
+        Atomic<U32> Refs;
+        U32 Length;
+        U32 Newlines;
+        U32 Height;
+
+        RopeNode* Left;
+        RopeNode* Right;
+
+        const char* Text;
+    };
+
+    //an avl tree over 4gb of 1 byte leaves still isnt this tall
+    constexpr U32 MaxRopeDepth = 48;
+}
+
+/**
+ * @brief a contiguous piece of a Rope
+ */
+struct RopeChunk
+{
+    const char* Data;
+    U32 Length;
+};
+
+/**
+ * @brief walks the chunks of a Rope in order without copying them
+ */
+struct RopeIterator
+{
+    RopeIterator(const Private::RopeNode* Root);
+
+    RopeIterator& operator++();
+
+    CTU_INLINE RopeChunk operator*() const { return { Stack[Depth - 1]->Text, Stack[Depth - 1]->Length }; }
+
+    CTU_INLINE bool operator!=(const RopeIterator& Other) const
+    {
+        return Depth != Other.Depth || (Depth != 0 && Stack[Depth - 1] != Other.Stack[Depth - 1]);
+    }
+
+private:
+    void Descend(const Private::RopeNode* Node);
+
+    const Private::RopeNode* Stack[Private::MaxRopeDepth];
+
+    //true while the branch at the same depth is still on its left side, the children
+    //cant be compared to find out since a rope joined to itself has the same node on both
+    bool WentLeft[Private::MaxRopeDepth];
+    U32 Depth;
+};
+
+/**
+ * @brief a string stored as a balanced tree of immutable chunks
+ *
+ * @description inserting, erasing, slicing and joining are all O(log n) no matter how big
+ *              the text is, unlike String which copies the whole buffer every time.
+ *              chunks are never modified after they are made so copying a Rope is just
+ *              a reference count bump and every copy is a snapshot that later edits
+ *              wont affect. reading a single character is also O(log n) so for
+ *              small strings or lots of random reads String is still the better choice
+ *
+ * @code{.cpp}
+ *
+ * Rope Text = "hello world";
+ * Rope Saved = Text;
+ *
+ * Text.Insert(5, ",");
+ * Text.Erase(0, 1);
+ * // Text = "ello, world", Saved = "hello world"
+ *
+ * for(RopeChunk Chunk : Text)
+ *     fwrite(Chunk.Data, 1, Chunk.Length, Out);
+ *
+ * @endcode
+ */
+struct Rope
+{
+    Rope();
+    Rope(const char* Text);
+    Rope(const char* Text, U32 Len);
+    Rope(const String& Text);
+
+    Rope(const Rope& Other);
+    Rope& operator=(const Rope& Other);
+
+    ~Rope();
+
+    CTU_INLINE U32 Len() const { return Root ? Root->Length : 0; }
+    CTU_INLINE bool IsEmpty() const { return Root == nullptr; }
+
+    /**
+     * @brief get the character at an index, this has to walk the tree so its O(log n)
+     */
+    char At(U32 Index) const;
+    CTU_INLINE char operator[](U32 Index) const { return At(Index); }
+
+    /**
+     * @brief insert text before Index
+     */
+    Rope& Insert(U32 Index, const Rope& Text);
+
+    /**
+     * @brief remove Amount characters starting at Start
+     */
+    Rope& Erase(U32 Start, U32 Amount);
+
+    /**
+     * @brief replace Amount characters starting at Start with Text
+     */
+    Rope& Replace(U32 Start, U32 Amount, const Rope& Text);
+
+    /**
+     * @brief get Amount characters starting at Start, the chunks are shared rather than copied
+     */
+    Rope Slice(U32 Start, U32 Amount) const;
+
+    //add to the back
+    Rope& Append(const Rope& Other);
+
+    //add to the front
+    Rope& Push(const Rope& Other);
+
+    //cut from front
+    Rope& Cut(U32 Amount);
+
+    //drop from back
+    Rope& Drop(U32 Amount);
+
+    Rope operator+(const Rope& Other) const;
+    Rope& operator+=(const Rope& Other);
+
+    bool operator==(const Rope& Other) const;
+    bool operator!=(const Rope& Other) const;
+
+    /**
+     * @brief how many lines there are, which is 1 more than the number of newlines
+     */
+    CTU_INLINE U32 LineCount() const { return (Root ? Root->Newlines : 0) + 1; }
+
+    /**
+     * @brief the index of the first character of a line
+     *
+     * @param Line the line to find, starting from 0
+     */
+    U32 LineStart(U32 Line) const;
+
+    /**
+     * @brief which line the character at an index is on, starting from 0
+     */
+    U32 LineOf(U32 Index) const;
+
+    /**
+     * @brief the text of a line without its newline
+     */
+    Rope Line(U32 Line) const;
+
+    /**
+     * @brief copy the whole rope into a single String
+     */
+    String Flatten() const;
+
+    /**
+     * @brief how tall the tree is, mainly useful for checking it stays balanced
+     */
+    CTU_INLINE U32 Depth() const { return Root ? Root->Height : 0; }
+
+    CTU_INLINE RopeIterator begin() const { return RopeIterator(Root); }
+    CTU_INLINE RopeIterator end() const { return RopeIterator(nullptr); }
+
+private:
+    Rope(Private::RopeNode* InRoot)
+        : Root(InRoot)
+    {}
+
+    Private::RopeNode* Root;
+};
+
+//writes each chunk in turn so the rope never has to be flattened
+CTU_INLINE void WriteTo(TextWriter& Out, const Rope& Item)
+{
+    for(RopeChunk Chunk : Item)
+        Out.Write(Chunk.Data, Chunk.Length);
+}
+
+namespace Utils
+{
+    CTU_INLINE String ToString(const Rope& Item)
+    {
+        return Item.Flatten();
+    }
+}
+
+}
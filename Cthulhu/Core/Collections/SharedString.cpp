@@ -0,0 +1,248 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "SharedString.h"
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy Memory::Compare
+
+#include <new>
+//placement new
+
+using namespace Cthulhu;
+using Private::SharedStringData;
+
+namespace
+{
+
+//a new unshared block with room for Capacity characters, the caller fills in the text
+SharedStringData* Allocate(U32 Len, U32 Capacity)
+{
+    Byte* Memory = new Byte[sizeof(SharedStringData) + Capacity + 1];
+    char* Text = (char*)(Memory + sizeof(SharedStringData));
+
+    Text[Len] = '\0';
+
+    return new (Memory) SharedStringData{ 1, 0, Len, Capacity, Text };
+}
+
+SharedStringData* Create(const char* Text, U32 Len)
+{
+    //the empty string is always represented by nullptr
+    if(Len == 0)
+        return nullptr;
+
+    SharedStringData* Ret = Allocate(Len, Len);
+    Memory::Copy(Text, Ret->Text, Len);
+
+    return Ret;
+}
+
+CTU_INLINE bool OwnsBuffer(const SharedStringData* Data)
+{
+    return Data->Text != (const char*)(Data + 1);
+}
+
+}
+
+Cthulhu::SharedString::SharedString(const char* Text)
+    : Data(Create(Text, CString::Length(Text)))
+{}
+
+Cthulhu::SharedString::SharedString(const char* Text, U32 Len)
+    : Data(Create(Text, Len))
+{}
+
+Cthulhu::SharedString::SharedString(StringView Text)
+    : Data(Create(Text.Data(), Text.Len()))
+{}
+
+Cthulhu::SharedString::SharedString(const String& Text)
+    : Data(Create(Text.CStr(), Text.Len()))
+{}
+
+Cthulhu::SharedString::SharedString(String&& Text)
+    : Data(nullptr)
+{
+    if(Text.Length == 0)
+        return;
+
+    //text from an allocator cant be freed with delete[] so it has to be copied
+    if(Text.Source != nullptr)
+    {
+        Data = Create(Text.Real, Text.Length);
+        return;
+    }
+
+    Data = new (new Byte[sizeof(SharedStringData)]) SharedStringData{ 1, 0, Text.Length, Text.Allocated, Text.Real };
+
+    //the string has to stay usable after giving its buffer away
+    Text.Real = new char[1];
+    Text.Real[0] = '\0';
+    Text.Length = 0;
+    Text.Allocated = 0;
+}
+
+SharedString& Cthulhu::SharedString::operator=(const SharedString& Other)
+{
+    //retain before releasing in case both share the same text
+    if(Other.Data)
+        Other.Data->Refs.Add(1, MemoryOrder::Relaxed);
+
+    Release(Data);
+    Data = Other.Data;
+
+    return *this;
+}
+
+SharedString& Cthulhu::SharedString::operator=(SharedString&& Other)
+{
+    if(this != &Other)
+    {
+        Release(Data);
+        Data = Other.Data;
+        Other.Data = nullptr;
+    }
+
+    return *this;
+}
+
+bool Cthulhu::SharedString::operator==(const SharedString& Other) const
+{
+    if(Data == Other.Data)
+        return true;
+
+    return Len() == Other.Len() && Memory::Compare(CStr(), Other.CStr(), Len()) == 0;
+}
+
+U32 Cthulhu::SharedString::Hash() const
+{
+    U32 Ret = Data ? Data->Hash.Load(MemoryOrder::Relaxed) : 0;
+
+    if(Ret != 0)
+        return Ret;
+
+    Ret = 2166136261U;
+
+    for(char C : *this)
+    {
+        Ret ^= (U8)C;
+        Ret *= 16777619U;
+    }
+
+    //0 means not worked out yet so it cant be a real hash
+    Ret = Ret ? Ret : 1;
+
+    //every thread works out the same value so racing here is harmless
+    if(Data)
+        Data->Hash.Store(Ret, MemoryOrder::Relaxed);
+
+    return Ret;
+}
+
+char* Cthulhu::SharedString::Mutate()
+{
+    if(!Data)
+        return nullptr;
+
+    if(!IsUnique())
+    {
+        SharedStringData* Copy = Create(Data->Text, Data->Length);
+        Release(Data);
+        Data = Copy;
+    }
+
+    //the caller is about to change the text
+    Data->Hash.Store(0, MemoryOrder::Relaxed);
+
+    return Data->Text;
+}
+
+SharedString& Cthulhu::SharedString::Append(StringView Other)
+{
+    if(Other.IsEmpty())
+        return *this;
+
+    const U32 OldLen = Len();
+    const U32 NewLen = OldLen + Other.Len();
+
+    if(Data && NewLen <= Data->Capacity && IsUnique())
+    {
+        Memory::Copy(Other.Data(), Data->Text + OldLen, Other.Len());
+        Data->Text[NewLen] = '\0';
+        Data->Length = NewLen;
+        Data->Hash.Store(0, MemoryOrder::Relaxed);
+
+        return *this;
+    }
+
+    //leave some room so appending in a loop doesnt copy every time
+    SharedStringData* Grown = Allocate(NewLen, NewLen + (NewLen / 2));
+    Memory::Copy(CStr(), Grown->Text, OldLen);
+    Memory::Copy(Other.Data(), Grown->Text + OldLen, Other.Len());
+
+    //Other might point into the old text so it has to go after copying
+    Release(Data);
+    Data = Grown;
+
+    return *this;
+}
+
+String Cthulhu::SharedString::ToString() const
+{
+    return String(CStr(), Len());
+}
+
+String Cthulhu::SharedString::Take()
+{
+    //one named result on every path so it is returned without a copy
+    String Ret = Empty{};
+
+    if(Data && IsUnique() && OwnsBuffer(Data))
+    {
+        //give the buffer back to a String and only free the header
+        Ret.Real = Data->Text;
+        Ret.Length = Data->Length;
+        Ret.Allocated = Data->Capacity;
+
+        Data->~SharedStringData();
+        delete[] (Byte*)Data;
+    }
+    else
+    {
+        Ret.Real = new char[Len() + 1];
+        Ret.Length = Ret.Allocated = Len();
+        Memory::Copy(CStr(), Ret.Real, Len() + 1);
+
+        Release(Data);
+    }
+
+    Data = nullptr;
+
+    return Ret;
+}
+
+void Cthulhu::SharedString::Release(SharedStringData* Data)
+{
+    //acquire so every write from other owners is done before the text is freed
+    if(!Data || Data->Refs.Sub(1, MemoryOrder::AcquireRelease) != 1)
+        return;
+
+    if(OwnsBuffer(Data))
+        delete[] Data->Text;
+
+    Data->~SharedStringData();
+    delete[] (Byte*)Data;
+}
@@ -0,0 +1,192 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
+#include "Meta/Aliases.h"
+//U32
+
+#include "Core/Types/Atomic.h"
+//Atomic<T>
+
+#include "StringView.h"
+//StringView
+
+#include "CthulhuString.h"
+//String
+
+#include "Core/Text/TextWriter.h"
+//TextWriter WriteTo
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+    struct SharedStringData
+    {
+        Atomic<U32> Refs;
+
+        //0 until someone asks for it, then cached
+        Atomic<U32> Hash;
+
+        U32 Length;
+        U32 Capacity;
+
+        //right after this header unless the buffer was taken from a String
+        char* Text;
+    };
+}
+
+/**
+ * @brief an immutable string that is shared between copies instead of duplicated
+ *
+ * @description copying only bumps an atomic reference count so passing these around
+ *              containers and threads is O(1). the text is never changed while it is
+ *              shared, anything that modifies a SharedString gives it its own copy
+ *              first unless it is already the only owner. the empty string doesnt allocate
+ *
+ * @code{.cpp}
+ *
+ * SharedString Name = "a long name that would be expensive to copy";
+ * SharedString Other = Name; // no copy, both point at the same text
+ *
+ * Other += "!"; // Other gets its own copy here, Name is unchanged
+ *
+ * //moving a String in takes its buffer without copying
+ * SharedString Taken = Utils::ToString(12345);
+ *
+ * @endcode
+ */
+struct SharedString
+{
+    SharedString()
+        : Data(nullptr)
+    {}
+
+    SharedString(const char* Text);
+    SharedString(const char* Text, U32 Len);
+    SharedString(StringView Text);
+    SharedString(const String& Text);
+
+    /**
+     * @brief take the buffer of a String that is about to be thrown away without copying it
+     *
+     * @description the String is left empty
+     */
+    SharedString(String&& Text);
+
+    CTU_INLINE SharedString(const SharedString& Other)
+        : Data(Other.Data)
+    {
+        //a new reference cant be the one that frees the text so no ordering is needed
+        if(Data)
+            Data->Refs.Add(1, MemoryOrder::Relaxed);
+    }
+
+    CTU_INLINE SharedString(SharedString&& Other)
+        : Data(Other.Data)
+    {
+        Other.Data = nullptr;
+    }
+
+    SharedString& operator=(const SharedString& Other);
+    SharedString& operator=(SharedString&& Other);
+
+    CTU_INLINE ~SharedString() { Release(Data); }
+
+    CTU_INLINE U32 Len() const { return Data ? Data->Length : 0; }
+    CTU_INLINE bool IsEmpty() const { return Len() == 0; }
+
+    /**
+     * @brief the text, always null terminated
+     */
+    CTU_INLINE const char* CStr() const { return Data ? Data->Text : ""; }
+
+    CTU_INLINE char operator[](U32 Index) const
+    {
+        ASSERT(Index < Len(), "Trying to access shared string out of range with operator[]");
+        return Data->Text[Index];
+    }
+
+    CTU_INLINE operator StringView() const { return { CStr(), Len() }; }
+    CTU_INLINE StringView View() const { return { CStr(), Len() }; }
+
+    CTU_INLINE const char* begin() const { return CStr(); }
+    CTU_INLINE const char* end() const { return CStr() + Len(); }
+
+    /**
+     * @brief copies of the same string compare their pointers before their text
+     */
+    bool operator==(const SharedString& Other) const;
+    CTU_INLINE bool operator!=(const SharedString& Other) const { return !(*this == Other); }
+
+    /**
+     * @brief a fnv-1a hash of the text, worked out the first time it is asked for
+     */
+    U32 Hash() const;
+
+    /**
+     * @brief check if nothing else shares this text, an empty string is always unique
+     */
+    CTU_INLINE bool IsUnique() const { return !Data || Data->Refs.Load(MemoryOrder::Acquire) == 1; }
+
+    /**
+     * @brief get the characters for writing, copying them first if they are shared
+     *
+     * @return char* Len() characters that only this string can see, nullptr if its empty
+     */
+    char* Mutate();
+
+    SharedString& Append(StringView Other);
+    CTU_INLINE SharedString& operator+=(StringView Other) { return Append(Other); }
+
+    /**
+     * @brief copy the text into a new String
+     */
+    String ToString() const;
+
+    /**
+     * @brief move the text into a String and leave this empty
+     *
+     * @description when this was the only owner of a buffer that came from a String the
+     *              buffer is handed back without copying, otherwise the text is copied
+     */
+    String Take();
+
+private:
+    static void Release(Private::SharedStringData* Data);
+
+    Private::SharedStringData* Data;
+};
+
+CTU_INLINE void WriteTo(TextWriter& Out, const SharedString& Item)
+{
+    Out.Write(Item.CStr(), Item.Len());
+}
+
+namespace Utils
+{
+    CTU_INLINE String ToString(const SharedString& Item)
+    {
+        return Item.ToString();
+    }
+}
+
+}
@@ -0,0 +1,243 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
+#include "Meta/Aliases.h"
+//U32
+
+#include "StringView.h"
+//StringView
+
+#include <stddef.h>
+//size_t
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+    //fnv-1a, constexpr so literals are hashed by the compiler
+    constexpr U32 HashText(const char* Text, U32 Len)
+    {
+        U32 Ret = 2166136261U;
+
+        for(U32 I = 0; I < Len; I++)
+        {
+            Ret ^= (U8)Text[I];
+            Ret *= 16777619U;
+        }
+
+        return Ret;
+    }
+}
+
+/**
+ * @brief a read only string that lives in static storage
+ *
+ * @description a pointer, a length and a hash all worked out at compile time so
+ *              constants made from these dont run anything during static initialization
+ *              and never allocate. the text isnt owned so it has to be a literal or a
+ *              FixedString with static storage. anything that takes a StringView takes one
+ *              of these for free, and String has a constructor for when a real copy is needed
+ *
+ * @code{.cpp}
+ *
+ * constexpr StaticString Name = "cthulhu";
+ * static_assert(Name.Len() == 7);
+ *
+ * constexpr StaticString Other = "cthulhu"_S;
+ * static_assert(Name == Other && Name.Hash() == Other.Hash());
+ *
+ * String Copy = Name; // only allocates here
+ *
+ * @endcode
+ */
+struct StaticString
+{
+    constexpr StaticString()
+        : Real("")
+        , Length(0)
+        , Hashed(Private::HashText("", 0))
+    {}
+
+    template<size_t N>
+    constexpr StaticString(const char (&Literal)[N])
+        : Real(Literal)
+        , Length(N - 1)
+        , Hashed(Private::HashText(Literal, N - 1))
+    {}
+
+    //Text has to be null terminated at Len and outlive everything that uses this
+    constexpr StaticString(const char* Text, U32 Len)
+        : Real(Text)
+        , Length(Len)
+        , Hashed(Private::HashText(Text, Len))
+    {}
+
+    //the view has to point at a null terminated literal, like the sets in Ascii.h
+    explicit constexpr StaticString(StringView Text)
+        : StaticString(Text.Data(), Text.Len())
+    {}
+
+    CTU_INLINE constexpr U32 Len() const { return Length; }
+    CTU_INLINE constexpr bool IsEmpty() const { return Length == 0; }
+    CTU_INLINE constexpr const char* CStr() const { return Real; }
+    CTU_INLINE constexpr U32 Hash() const { return Hashed; }
+
+    CTU_INLINE constexpr char operator[](U32 Index) const
+    {
+        ASSERT(Index < Length, "Trying to access static string out of range with operator[]");
+        return Real[Index];
+    }
+
+    CTU_INLINE constexpr operator StringView() const { return { Real, Length }; }
+
+    constexpr bool operator==(const StaticString& Other) const
+    {
+        //different hashes mean different text so most mismatches never touch the text
+        return Hashed == Other.Hashed && StringView(*this) == StringView(Other);
+    }
+
+    CTU_INLINE constexpr bool operator==(StringView Other) const { return StringView(*this) == Other; }
+    CTU_INLINE constexpr bool operator==(const char* Other) const { return StringView(*this) == StringView(Other); }
+
+    template<typename T>
+    CTU_INLINE constexpr bool operator!=(const T& Other) const { return !(*this == Other); }
+
+    CTU_INLINE constexpr const char* begin() const { return Real; }
+    CTU_INLINE constexpr const char* end() const { return Real + Length; }
+
+private:
+    const char* Real;
+    U32 Length;
+    U32 Hashed;
+};
+
+/**
+ * @brief a string of exactly N characters stored inline
+ *
+ * @description for constants that have to be built at compile time, like joining
+ *              several literals together. a FixedString with static storage can be
+ *              handed out as a StaticString
+ *
+ * @code{.cpp}
+ *
+ * constexpr FixedString Hex = FixedString("0123456789") + FixedString("abcdef");
+ * static_assert(Hex.Len() == 16);
+ *
+ * constexpr auto Joined = FixedString<4>::Join("ab", StringView("cd"));
+ *
+ * @endcode
+ *
+ * @tparam N how many characters the string holds, not counting the null terminator
+ */
+template<U32 N>
+struct FixedString
+{
+    constexpr FixedString()
+        : Text()
+        , Hashed(Private::HashText(Text, N))
+    {}
+
+    constexpr FixedString(const char (&Literal)[N + 1])
+        : Text()
+        , Hashed(0)
+    {
+        for(U32 I = 0; I < N; I++)
+            Text[I] = Literal[I];
+
+        Hashed = Private::HashText(Text, N);
+    }
+
+    /**
+     * @brief copy several pieces of text into one string
+     *
+     * @description the pieces have to add up to N characters, too many fails to compile
+     *              when this is evaluated at compile time
+     */
+    template<typename... TParts>
+    static constexpr FixedString Join(const TParts&... Parts)
+    {
+        FixedString Ret;
+        U32 Cursor = 0;
+
+        (Ret.Write(Cursor, StringView(Parts)), ...);
+
+        ASSERT(Cursor == N, "Joined text does not fill the fixed string");
+
+        Ret.Hashed = Private::HashText(Ret.Text, N);
+
+        return Ret;
+    }
+
+    CTU_INLINE constexpr U32 Len() const { return N; }
+    CTU_INLINE constexpr const char* CStr() const { return Text; }
+    CTU_INLINE constexpr U32 Hash() const { return Hashed; }
+
+    CTU_INLINE constexpr char operator[](U32 Index) const
+    {
+        ASSERT(Index < N, "Trying to access fixed string out of range with operator[]");
+        return Text[Index];
+    }
+
+    CTU_INLINE constexpr operator StringView() const { return { Text, N }; }
+    CTU_INLINE constexpr operator StaticString() const { return { Text, N }; }
+
+    template<U32 M>
+    constexpr FixedString<N + M> operator+(const FixedString<M>& Other) const
+    {
+        return FixedString<N + M>::Join(*this, Other);
+    }
+
+    CTU_INLINE constexpr const char* begin() const { return Text; }
+    CTU_INLINE constexpr const char* end() const { return Text + N; }
+
+private:
+    template<U32> friend struct FixedString;
+
+    constexpr void Write(U32& Cursor, StringView Part)
+    {
+        for(char C : Part)
+            Text[Cursor++] = C;
+    }
+
+    //always null terminated because the last character is never written
+    char Text[N + 1];
+    U32 Hashed;
+};
+
+template<size_t N>
+FixedString(const char (&)[N]) -> FixedString<N - 1>;
+
+/**
+ * @brief a literal as a StaticString, nothing is allocated or copied
+ *
+ * @code{.cpp}
+ *
+ * auto Name = "cthulhu"_S; // StaticString
+ *
+ * @endcode
+ */
+constexpr StaticString operator""_S(const char* Str, size_t Len)
+{
+    return StaticString(Str, (U32)Len);
+}
+
+}
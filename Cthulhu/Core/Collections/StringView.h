@@ -0,0 +1,124 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
+#include "Meta/Aliases.h"
+//U32
+
+#pragma once
+
+namespace Cthulhu
+{
+
+struct String;
+
+/**
+ * @brief a read only window into some characters that someone else owns
+ *
+ * @description views are 2 words big and never allocate, so they are what the
+ *              split iterators and trimming functions hand back. the text they
+ *              point at has to outlive them and isnt null terminated
+ *
+ * @code{.cpp}
+ *
+ * String Text = "key=value";
+ * StringView Key = StringView(Text).SubView(0, 3);
+ *
+ * Key == "key"; // true
+ * String Copy = String(Key); // copies it when it has to outlive Text
+ *
+ * @endcode
+ */
+struct StringView
+{
+    constexpr StringView()
+        : Real("")
+        , Length(0)
+    {}
+
+    constexpr StringView(const char* Text, U32 Len)
+        : Real(Text)
+        , Length(Len)
+    {}
+
+    constexpr StringView(const char* Text)
+        : Real(Text)
+        , Length(0)
+    {
+        while(Text[Length])
+            Length++;
+    }
+
+    //defined in CthulhuString.h once String is complete
+    StringView(const String& Text);
+
+    CTU_INLINE constexpr U32 Len() const { return Length; }
+    CTU_INLINE constexpr bool IsEmpty() const { return Length == 0; }
+    CTU_INLINE constexpr const char* Data() const { return Real; }
+
+    CTU_INLINE constexpr char operator[](U32 Index) const
+    {
+        ASSERT(Index < Length, "Trying to access string view out of range with operator[]");
+        return Real[Index];
+    }
+
+    /**
+     * @brief get part of the view
+     *
+     * @param Start the first character to include
+     * @param Amount how many characters to include
+     */
+    CTU_INLINE constexpr StringView SubView(U32 Start, U32 Amount) const
+    {
+        ASSERT(Start + Amount <= Length, "Trying to take a sub view past the end of a string view");
+        return { Real + Start, Amount };
+    }
+
+    constexpr bool operator==(const StringView& Other) const
+    {
+        if(Length != Other.Length)
+            return false;
+
+        for(U32 I = 0; I < Length; I++)
+            if(Real[I] != Other.Real[I])
+                return false;
+
+        return true;
+    }
+
+    CTU_INLINE constexpr bool operator!=(const StringView& Other) const { return !(*this == Other); }
+
+    CTU_INLINE constexpr bool StartsWith(const StringView& Pattern) const
+    {
+        return Pattern.Length <= Length && SubView(0, Pattern.Length) == Pattern;
+    }
+
+    CTU_INLINE constexpr bool EndsWith(const StringView& Pattern) const
+    {
+        return Pattern.Length <= Length && SubView(Length - Pattern.Length, Pattern.Length) == Pattern;
+    }
+
+    CTU_INLINE constexpr const char* begin() const { return Real; }
+    CTU_INLINE constexpr const char* end() const { return Real + Length; }
+
+private:
+    const char* Real;
+    U32 Length;
+};
+
+}
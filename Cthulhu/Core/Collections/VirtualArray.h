@@ -0,0 +1,313 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <new>
+
+#include "Meta/Aliases.h"
+#include "Meta/Assert.h"
+//ASSERT
+
+#include "Core/Memory/Pages.h"
+//Memory::ReservePages Memory::CommitPages Memory::DecommitPages Memory::UnmapPages
+
+#include "Core/Traits/Forward.h"
+//Forward
+
+#include "Core/Traits/IsTrivial.h"
+//IsTriviallyDestructable
+
+#pragma once
+
+namespace Cthulhu
+{
+
+/**
+ * @brief an array that never moves its items
+ *
+ * @description all the address space it could ever need is reserved up front and
+ *              memory is only committed behind it as it grows, so growing never
+ *              allocates a new block and copies into it. pointers to items stay valid
+ *              for as long as the item is there and appending costs the same no matter
+ *              how big the array is.
+ *
+ *              reserving is free apart from address space so MaxItems can be far more
+ *              than the machine has memory for. shrinking can give memory back with
+ *              Decommit
+ *
+ * @code{.cpp}
+ *
+ * //room for up to 64gb of samples, only what is used takes memory
+ * VirtualArray<U64> Samples(8ULL << 30);
+ *
+ * U64* First = &Samples.Append(1);
+ * Samples.Append(2);
+ * //First is still valid
+ *
+ * @endcode
+ *
+ * @tparam T the type of item to store
+ */
+template<typename T>
+struct VirtualArray
+{
+    ///memory is committed this much at a time so growing doesnt need a system call every page
+    static constexpr U64 CommitStep = 1024 * 1024;
+
+    /**
+     * @brief reserve room for MaxItems items
+     *
+     * @description if the reservation fails, or MaxItems items would need more
+     *              bytes than a U64 holds, the array is left with no room at all
+     */
+    explicit VirtualArray(U64 MaxItems)
+        : Real(MaxItems <= ~0ULL / sizeof(T) ? (T*)Memory::ReservePages(MaxItems * sizeof(T)) : nullptr)
+        , Length(0)
+        , Limit(0)
+        , CommittedBytes(0)
+    {
+        ASSERT(Real != nullptr, "VirtualArray ran out of address space");
+
+        if(Real != nullptr)
+            Limit = MaxItems;
+    }
+
+    ~VirtualArray()
+    {
+        if(Real == nullptr)
+            return;
+
+        DestroyItems(0, Length);
+        Memory::UnmapPages(Real, Limit * sizeof(T));
+    }
+
+    VirtualArray(const VirtualArray&) = delete;
+    VirtualArray& operator=(const VirtualArray&) = delete;
+
+    /**
+     * @brief take everything from Other without copying or moving any items
+     */
+    VirtualArray(VirtualArray&& Other)
+        : Real(Other.Real)
+        , Length(Other.Length)
+        , Limit(Other.Limit)
+        , CommittedBytes(Other.CommittedBytes)
+    {
+        Other.Real = nullptr;
+        Other.Length = 0;
+        Other.Limit = 0;
+        Other.CommittedBytes = 0;
+    }
+
+    /**
+     * @brief destroy every item and give back this arrays range then take Others
+     */
+    VirtualArray& operator=(VirtualArray&& Other)
+    {
+        if(this == &Other)
+            return *this;
+
+        if(Real != nullptr)
+        {
+            DestroyItems(0, Length);
+            Memory::UnmapPages(Real, Limit * sizeof(T));
+        }
+
+        Real = Other.Real;
+        Length = Other.Length;
+        Limit = Other.Limit;
+        CommittedBytes = Other.CommittedBytes;
+
+        Other.Real = nullptr;
+        Other.Length = 0;
+        Other.Limit = 0;
+        Other.CommittedBytes = 0;
+
+        return *this;
+    }
+
+    /**
+     * @brief add an item to the end
+     *
+     * @return T& the new item, it stays where it is until it is removed
+     */
+    T& Append(const T& Item)
+    {
+        return *new (Grow()) T(Item);
+    }
+
+    T& Append(T&& Item)
+    {
+        return *new (Grow()) T(Forward<T>(Item));
+    }
+
+    /**
+     * @brief construct an item in place at the end
+     */
+    template<typename... TArgs>
+    T& Emplace(TArgs&&... Args)
+    {
+        return *new (Grow()) T(Forward<TArgs>(Args)...);
+    }
+
+    /**
+     * @brief remove the last item and return it
+     */
+    T Pop()
+    {
+        ASSERT(Length >= 1, "Cant pop item off an empty list");
+
+        T Ret = Forward<T>(Real[Length - 1]);
+        DestroyItems(Length - 1, Length);
+        Length--;
+
+        return Ret;
+    }
+
+    /**
+     * @brief grow or shrink to NewLength items
+     *
+     * @description new items are default constructed. shrinking keeps the memory
+     *              committed in case it grows again, call Decommit to give it back
+     */
+    void Resize(U64 NewLength)
+    {
+        ASSERT(NewLength <= Limit, "VirtualArray is full");
+
+        if(NewLength < Length)
+        {
+            DestroyItems(NewLength, Length);
+            Length = NewLength;
+            return;
+        }
+
+        Commit(NewLength);
+
+        //walk pointers so the compiler sees the loop ends inside the mapping
+        for(T* Item = Real + Length; Item != Real + NewLength; Item++)
+            new (Item) T();
+
+        Length = NewLength;
+    }
+
+    /**
+     * @brief destroy every item, the memory stays committed
+     */
+    void Clear()
+    {
+        Resize(0);
+    }
+
+    /**
+     * @brief commit enough memory for Items items up front
+     *
+     * @description appending never has to commit anything until there are more than
+     *              Items items, useful before a latency sensitive burst of appends
+     */
+    void Reserve(U64 Items)
+    {
+        ASSERT(Items <= Limit, "VirtualArray is full");
+        Commit(Items);
+    }
+
+    /**
+     * @brief give back every committed page past the last item
+     *
+     * @description the address space stays reserved so the array can grow again
+     */
+    void Decommit()
+    {
+        const U64 Keep = RoundToStep(Length * sizeof(T));
+
+        if(Keep >= CommittedBytes)
+            return;
+
+        Memory::DecommitPages((Byte*)Real + Keep, CommittedBytes - Keep);
+        CommittedBytes = Keep;
+    }
+
+    CTU_INLINE T& operator[](U64 Index) const
+    {
+        ASSERT(Index < Length, "IndexOutOfRange");
+        return Real[Index];
+    }
+
+    ///how many items there are
+    CTU_INLINE U64 Len() const { return Length; }
+
+    ///the most items there can ever be
+    CTU_INLINE U64 Max() const { return Limit; }
+
+    ///how many bytes of memory are committed
+    CTU_INLINE U64 Committed() const { return CommittedBytes; }
+
+    CTU_INLINE T* Data() const { return Real; }
+
+    CTU_INLINE T& Front() const { ASSERT(Length > 0, "An empty array has no front"); return Real[0]; }
+    CTU_INLINE T& Back() const { ASSERT(Length > 0, "An empty array has no back"); return Real[Length - 1]; }
+
+    T* begin() const { return Real; }
+    T* end() const { return Real + Length; }
+
+private:
+    CTU_INLINE static U64 RoundToStep(U64 Bytes)
+    {
+        return (Bytes + CommitStep - 1) & ~(CommitStep - 1);
+    }
+
+    CTU_INLINE T* Grow()
+    {
+        ASSERT(Length < Limit, "VirtualArray is full");
+
+        if((Length + 1) * sizeof(T) > CommittedBytes)
+            Commit(Length + 1);
+
+        return Real + Length++;
+    }
+
+    //make sure the first Items items have memory behind them
+    void Commit(U64 Items)
+    {
+        const U64 Reserved = Memory::PageSize() * ((Limit * sizeof(T) + Memory::PageSize() - 1) / Memory::PageSize());
+        U64 Wanted = RoundToStep(Items * sizeof(T));
+
+        if(Wanted > Reserved)
+            Wanted = Reserved;
+
+        if(Wanted <= CommittedBytes)
+            return;
+
+        const bool Committed = Memory::CommitPages((Byte*)Real + CommittedBytes, Wanted - CommittedBytes);
+        ASSERT(Committed, "VirtualArray ran out of memory");
+        (void)Committed;
+
+        CommittedBytes = Wanted;
+    }
+
+    void DestroyItems(U64 From, U64 To)
+    {
+        if(IsTriviallyDestructable<T>::Value)
+            return;
+
+        for(T* Item = Real + From; Item != Real + To; Item++)
+            Item->~T();
+    }
+
+    T* Real;
+    U64 Length;
+    U64 Limit;
+    U64 CommittedBytes;
+};
+
+}
@@ -36,6 +36,17 @@ constexpr CTU_INLINE U32 Hash(U16 Item) { return Item; }
 constexpr CTU_INLINE U32 Hash(U32 Item) { return Item; }
 constexpr CTU_INLINE U32 Hash(U64 Item) { return static_cast<U32>(Item) ^ Consts::MersenePrime; }
 
+/**
+ * @brief hash anything that knows how to hash itself
+ *
+ * @description types like Atom cache their hash so they provide a Hash() member,
+ *              this is a template so it is found no matter which header was included first.
+ *              it only exists for types with that member so chars, bools and string
+ *              literals still go to the overloads above and below
+ */
+template<typename T>
+CTU_INLINE auto Hash(const T& Item) -> decltype(U32(Item.Hash())) { return Item.Hash(); }
+
 CTU_INLINE U32 Hash(const String& Item)
 {
     U32 Ret = 0;
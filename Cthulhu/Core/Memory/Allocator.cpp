@@ -0,0 +1,76 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+
+#include "Allocator.h"
+
+#include "Memory.h"
+//Memory::Alloc Memory::Realloc Memory::Free Memory::AlignedAlloc Memory::AlignedFree
+
+#include "Meta/Assert.h"
+//ASSERT
+
+using namespace Cthulhu;
+using namespace Cthulhu::Memory;
+
+void* Cthulhu::Memory::HeapAllocator::Allocate(U64 Size, U64 Align)
+{
+    //malloc can give back null for 0 bytes but an allocator never does
+    if(Size == 0)
+        Size = 1;
+
+    //malloc already lines everything up to DefaultAlign, only bigger alignments need help
+    void* Ret = Align <= DefaultAlign ? Memory::Alloc<Byte>(Size) : Memory::AlignedAlloc<Byte>(Size, Align);
+    ASSERT(Ret != nullptr, "HeapAllocator ran out of memory");
+
+    return Ret;
+}
+
+void Cthulhu::Memory::HeapAllocator::Deallocate(void* Ptr, U64 Size, U64 Align)
+{
+    if(Align <= DefaultAlign)
+        Memory::Free(Ptr);
+    else
+        Memory::AlignedFree(Ptr);
+}
+
+void* Cthulhu::Memory::HeapAllocator::Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align)
+{
+    if(Ptr == nullptr)
+        return Allocate(NewSize, Align);
+
+    if(Align <= DefaultAlign)
+    {
+        void* Ret = Memory::Realloc(Ptr, NewSize == 0 ? 1 : NewSize);
+        ASSERT(Ret != nullptr, "HeapAllocator ran out of memory");
+
+        return Ret;
+    }
+
+    //there is no aligned realloc so move it by hand
+    void* Ret = Allocate(NewSize, Align);
+    //memcpy takes the whole U64, Memory::Copy would cut blocks of 4gb or more short
+    memcpy(Ret, Ptr, OldSize < NewSize ? OldSize : NewSize);
+    Memory::AlignedFree(Ptr);
+
+    return Ret;
+}
+
+Allocator& Cthulhu::Memory::Heap()
+{
+    static HeapAllocator Shared;
+    return Shared;
+}
@@ -0,0 +1,159 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <new>
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//Byte U64
+
+#include "Core/Traits/Forward.h"
+//Forward
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+///enough for any builtin type, the same as malloc gives
+constexpr U64 DefaultAlign = 16;
+
+/**
+ * @brief somewhere containers can get memory from
+ *
+ * @description Array, String, Map, Block and Binary take an allocator in their constructors
+ *              and send everything they allocate to it, so their memory can come from an
+ *              arena, a tracking allocator, a numa node or anything else that implements
+ *              this. a container made without one doesnt go through the allocator at all
+ *              and uses new and delete directly, so the default costs nothing extra.
+ *
+ *              every call is given the size and alignment so allocators dont have to keep
+ *              headers of their own. the allocator has to outlive everything using it
+ *
+ * @code{.cpp}
+ *
+ * struct Counting : Memory::Allocator
+ * {
+ *     void* Allocate(U64 Size, U64 Align) override { Total += Size; return Memory::Heap().Allocate(Size, Align); }
+ *     void Deallocate(void* Ptr, U64 Size, U64 Align) override { Memory::Heap().Deallocate(Ptr, Size, Align); }
+ *     void* Reallocate(void* Ptr, U64 Old, U64 New, U64 Align) override { return Memory::Heap().Reallocate(Ptr, Old, New, Align); }
+ *
+ *     U64 Total = 0;
+ * };
+ *
+ * Counting Counter;
+ * Array<U32> Ids(Counter);
+ *
+ * @endcode
+ */
+struct Allocator
+{
+    /**
+     * @brief get Size bytes aligned to Align
+     *
+     * @param Align a power of 2
+     * @return void* never null
+     */
+    virtual void* Allocate(U64 Size, U64 Align = DefaultAlign) = 0;
+
+    /**
+     * @brief give back memory from Allocate or Reallocate
+     *
+     * @param Size and Align have to be what the memory was allocated with
+     */
+    virtual void Deallocate(void* Ptr, U64 Size, U64 Align = DefaultAlign) = 0;
+
+    /**
+     * @brief resize memory from this allocator keeping the first OldSize bytes
+     *
+     * @param Ptr null behaves like Allocate
+     */
+    virtual void* Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align = DefaultAlign) = 0;
+
+    /**
+     * @brief allocate and construct a single object
+     */
+    template<typename T, typename... TArgs>
+    T* New(TArgs&&... Args)
+    {
+        return new (Allocate(sizeof(T), alignof(T))) T(Forward<TArgs>(Args)...);
+    }
+
+    /**
+     * @brief destroy and give back something from New
+     */
+    template<typename T>
+    void Delete(T* Item)
+    {
+        Item->~T();
+        Deallocate(Item, sizeof(T), alignof(T));
+    }
+
+    /**
+     * @brief allocate Count default constructed objects
+     */
+    template<typename T>
+    T* NewArray(U64 Count)
+    {
+        T* Ret = (T*)Allocate(sizeof(T) * Count, alignof(T));
+
+        for(U64 I = 0; I < Count; I++)
+            new (Ret + I) T();
+
+        return Ret;
+    }
+
+    /**
+     * @brief true when everything is given back at once rather than by Deallocate
+     *
+     * @description containers use this to skip walking their items on destruction
+     *              when none of them need destroying, arenas are scoped
+     */
+    const bool Scoped;
+
+protected:
+    Allocator(bool IsScoped = false)
+        : Scoped(IsScoped)
+    {}
+
+    //nothing is ever destroyed through an Allocator pointer
+    ~Allocator() = default;
+};
+
+/**
+ * @brief the allocator for the normal heap built on Memory::Alloc, Realloc and Free
+ *
+ * @description alignments bigger than DefaultAlign are handled as well
+ */
+struct HeapAllocator final : Allocator
+{
+    void* Allocate(U64 Size, U64 Align = DefaultAlign) override;
+    void Deallocate(void* Ptr, U64 Size, U64 Align = DefaultAlign) override;
+    void* Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align = DefaultAlign) override;
+};
+
+/**
+ * @brief the one HeapAllocator everything can share, it has no state
+ */
+Allocator& Heap();
+
+}
+
+}
@@ -0,0 +1,210 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+
+#include "Arena.h"
+
+#include "Core/Math/Math.h"
+//Math::Max
+
+#include "Tracking.h"
+//CTU_TRACK_CONTAINER
+
+using namespace Cthulhu;
+using namespace Cthulhu::Memory;
+
+namespace
+{
+
+//sits at the start of every chunk, the space after it is handed out
+struct Chunk
+{
+    Chunk* Previous;
+    U64 Size;
+
+    //where the cursor stopped when a newer chunk took over
+    Byte* Stop;
+    U64 Padding;
+
+    Byte* Start() { return (Byte*)(this + 1); }
+    Byte* End() { return (Byte*)this + Size; }
+};
+
+CTU_INLINE Byte* AlignUp(Byte* Ptr, U64 Align)
+{
+    return (Byte*)(((U64)Ptr + Align - 1) & ~(Align - 1));
+}
+
+}
+
+Cthulhu::Memory::Arena::Arena(U64 ChunkSize)
+    : Allocator(true)
+    , Head(nullptr)
+    , Cursor(nullptr)
+    , End(nullptr)
+    , Last(nullptr)
+    , NextSize(ChunkSize)
+    , FirstSize(ChunkSize)
+{}
+
+Cthulhu::Memory::Arena::~Arena()
+{
+    for(Chunk* Current = (Chunk*)Head; Current != nullptr;)
+    {
+        Chunk* Previous = Current->Previous;
+        delete[] (Byte*)Current;
+        Current = Previous;
+    }
+}
+
+void* Cthulhu::Memory::Arena::AllocateSlow(U64 Size, U64 Align)
+{
+    //the fast path also ends up here when it fits exactly
+    if(Head != nullptr)
+    {
+        Byte* Start = AlignUp(Cursor, Align);
+
+        if(Start + Size <= End)
+        {
+            Cursor = Start + Size;
+            Last = Start;
+
+            return Start;
+        }
+
+        ((Chunk*)Head)->Stop = Cursor;
+    }
+
+    //big requests get a chunk that fits them exactly rather than throwing the growth off
+    const U64 Needed = Size + Align + sizeof(Chunk);
+    const U64 ChunkSize = Math::Max(NextSize, Needed);
+
+    if(Needed <= NextSize && NextSize < FirstSize * 64)
+        NextSize *= 2;
+
+    CTU_TRACK_CONTAINER(Arena);
+    Chunk* Made = (Chunk*)new Byte[ChunkSize];
+    Made->Previous = (Chunk*)Head;
+    Made->Size = ChunkSize;
+    Made->Stop = nullptr;
+
+    Head = Made;
+    End = Made->End();
+
+    Byte* Start = AlignUp(Made->Start(), Align);
+
+    Cursor = Start + Size;
+    Last = Start;
+
+    return Start;
+}
+
+void* Cthulhu::Memory::Arena::Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align)
+{
+    if(Ptr == nullptr)
+        return Allocate(NewSize, Align);
+
+    //the newest allocation can just move the cursor
+    if(Ptr == Last && (Byte*)Ptr + OldSize == Cursor && (Byte*)Ptr + NewSize <= End)
+    {
+        Cursor = (Byte*)Ptr + NewSize;
+        return Ptr;
+    }
+
+    if(NewSize <= OldSize)
+        return Ptr;
+
+    void* Ret = Allocate(NewSize, Align);
+    //memcpy takes the whole U64 so chunks of 4gb or more are not cut short
+    memcpy(Ret, Ptr, OldSize);
+
+    return Ret;
+}
+
+void Cthulhu::Memory::Arena::Rewind(ArenaMark Where)
+{
+    while(Head != Where.Chunk)
+    {
+        Chunk* Previous = ((Chunk*)Head)->Previous;
+        delete[] (Byte*)Head;
+        Head = Previous;
+    }
+
+    Cursor = Where.Cursor;
+    End = Head != nullptr ? ((Chunk*)Head)->End() : nullptr;
+    Last = nullptr;
+}
+
+void Cthulhu::Memory::Arena::Reset()
+{
+    Chunk* Biggest = nullptr;
+
+    for(Chunk* Current = (Chunk*)Head; Current != nullptr;)
+    {
+        Chunk* Previous = Current->Previous;
+
+        if(Biggest == nullptr || Current->Size > Biggest->Size)
+        {
+            if(Biggest != nullptr)
+                delete[] (Byte*)Biggest;
+
+            Biggest = Current;
+        }
+        else
+        {
+            delete[] (Byte*)Current;
+        }
+
+        Current = Previous;
+    }
+
+    Head = Biggest;
+    Last = nullptr;
+
+    if(Biggest != nullptr)
+    {
+        Biggest->Previous = nullptr;
+        Cursor = Biggest->Start();
+        End = Biggest->End();
+    }
+    else
+    {
+        Cursor = End = nullptr;
+    }
+}
+
+U64 Cthulhu::Memory::Arena::Used() const
+{
+    if(Head == nullptr)
+        return 0;
+
+    U64 Ret = Cursor - ((Chunk*)Head)->Start();
+
+    for(Chunk* Current = ((Chunk*)Head)->Previous; Current != nullptr; Current = Current->Previous)
+        Ret += Current->Stop - Current->Start();
+
+    return Ret;
+}
+
+U64 Cthulhu::Memory::Arena::Reserved() const
+{
+    U64 Ret = 0;
+
+    for(Chunk* Current = (Chunk*)Head; Current != nullptr; Current = Current->Previous)
+        Ret += Current->Size;
+
+    return Ret;
+}
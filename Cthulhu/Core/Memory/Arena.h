@@ -0,0 +1,218 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <new>
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
+#include "Meta/Aliases.h"
+//Byte U32 U64
+
+#include "Core/Traits/Forward.h"
+//Forward
+
+#include "Allocator.h"
+//Memory::Allocator Memory::DefaultAlign
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+/**
+ * @brief where an arena was up to, see Arena::Mark
+ */
+struct ArenaMark
+{
+    void* Chunk;
+    Byte* Cursor;
+};
+
+/**
+ * @brief a bump allocator that frees everything it handed out at once
+ *
+ * @description memory comes out of big chunks by moving a cursor forward, so allocating
+ *              is a compare and an add. nothing is freed one at a time, instead Reset
+ *              throws everything away and Rewind throws away everything after a Mark.
+ *              when a chunk runs out the next one is twice as big up to a limit, anything
+ *              too big for a chunk gets one of its own.
+ *
+ *              an arena is an Allocator so any container can be given one, everything it
+ *              allocates then comes from the arena and destroying it doesnt free anything.
+ *              the arena has to outlive them. an arena is only safe to use from one thread
+ *              at a time
+ *
+ * @code{.cpp}
+ *
+ * Memory::Arena Scratch;
+ *
+ * for(const Request& Each : Requests)
+ * {
+ *     {
+ *         Array<String> Parts(Scratch);
+ *         String Reply(Scratch);
+ *
+ *         Handle(Each, Parts, Reply);
+ *     }
+ *
+ *     //every allocation made while handling the request goes at once
+ *     Scratch.Reset();
+ * }
+ *
+ * @endcode
+ */
+struct Arena final : Allocator
+{
+    /**
+     * @param ChunkSize how big the first chunk is, later chunks double up to 64 times this
+     */
+    Arena(U64 ChunkSize = 64 * 1024);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena();
+
+    /**
+     * @brief get Size bytes aligned to Align
+     *
+     * @param Align has to be a power of 2
+     * @return void* never null, running out of memory is as fatal as it is for new
+     */
+    CTU_INLINE void* Allocate(U64 Size, U64 Align = DefaultAlign) override
+    {
+        ASSERT((Align & (Align - 1)) == 0, "Arena alignment has to be a power of 2");
+
+        Byte* Start = (Byte*)(((U64)Cursor + Align - 1) & ~(Align - 1));
+
+        //an arena that hasnt made a chunk yet has no space at all so this also catches that
+        if(Start + Size >= End)
+            return AllocateSlow(Size, Align);
+
+        Cursor = Start + Size;
+        Last = Start;
+
+        return Start;
+    }
+
+    /**
+     * @brief resize an allocation, the newest allocation grows in place when there is room
+     *
+     * @param Ptr something from this arena or null
+     * @param OldSize how big Ptr is
+     * @param NewSize how big it needs to be
+     * @return void* where the data is now, the first OldSize bytes are kept
+     */
+    void* Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align = DefaultAlign) override;
+
+    /**
+     * @brief give back an allocation
+     *
+     * @description only the newest allocation can actually be reused, for anything
+     *              else this does nothing and the space comes back on Reset
+     */
+    CTU_INLINE void Deallocate(void* Ptr, U64 Size, U64 Align = DefaultAlign) override
+    {
+        if(Ptr == Last && (Byte*)Ptr + Size == Cursor)
+        {
+            Cursor = (Byte*)Ptr;
+            Last = nullptr;
+        }
+    }
+
+    /**
+     * @brief allocate and construct a single object
+     *
+     * @description the destructor will never be called by the arena, so T should
+     *              either be trivial or be destroyed by the caller. this hides the
+     *              Allocator version so the fast path of Allocate stays inline
+     */
+    template<typename T, typename... TArgs>
+    CTU_INLINE T* New(TArgs&&... Args)
+    {
+        return new (Allocate(sizeof(T), alignof(T))) T(Forward<TArgs>(Args)...);
+    }
+
+    /**
+     * @brief allocate Count default constructed objects
+     */
+    template<typename T>
+    T* NewArray(U64 Count)
+    {
+        T* Ret = (T*)Allocate(sizeof(T) * Count, alignof(T));
+
+        for(U64 I = 0; I < Count; I++)
+            new (Ret + I) T();
+
+        return Ret;
+    }
+
+    /**
+     * @brief remember where the arena is up to so it can be rewound there
+     */
+    CTU_INLINE ArenaMark Mark() const { return { Head, Cursor }; }
+
+    /**
+     * @brief free everything allocated since Where was marked
+     *
+     * @description chunks made after the mark are freed, Where has to come from this
+     *              arena and nothing allocated after it can be used again
+     */
+    void Rewind(ArenaMark Where);
+
+    /**
+     * @brief free everything the arena has handed out
+     *
+     * @description the biggest chunk is kept so the next round of allocations usually
+     *              doesnt have to ask the system for memory at all
+     */
+    void Reset();
+
+    /**
+     * @brief how many bytes are handed out right now including alignment padding
+     */
+    U64 Used() const;
+
+    /**
+     * @brief how many bytes the arena has asked the system for
+     */
+    U64 Reserved() const;
+
+private:
+    void* AllocateSlow(U64 Size, U64 Align);
+
+    //the newest chunk, each one links to the one before it
+    void* Head;
+
+    Byte* Cursor;
+    Byte* End;
+
+    //the newest allocation so it can be grown in place or given back
+    Byte* Last;
+
+    //how big the next chunk will be
+    U64 NextSize;
+
+    const U64 FirstSize;
+};
+
+}
+
+}
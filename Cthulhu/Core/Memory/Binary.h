@@ -15,6 +15,12 @@
 
 #include "Core/Collections/Array.h"
 
+#include "Allocator.h"
+//Memory::Allocator
+
+#include "Tracking.h"
+//CTU_TRACK_CONTAINER
+
 #pragma once
 
 namespace Cthulhu
@@ -30,6 +36,21 @@ struct Binary
         , Data(new Byte[64]())
     {}
 
+    /**
+     * @brief make an empty binary whose data is allocated from From
+     *
+     * @description growing uses the allocators Reallocate so it can often grow in place,
+     *              the allocator has to outlive the binary
+     */
+    explicit Binary(Memory::Allocator& From)
+        : Step(0)
+        , Cursor(0)
+        , MaxLength(64)
+        , Length(0)
+        , Data(Memory::Set((Byte*)From.Allocate(64, 1), 0, 64))
+        , Source(&From)
+    {}
+
     template<typename T>
     T Read()
     {
@@ -107,9 +128,17 @@ struct Binary
 
     void Cleanup()
     {
-        delete[] Data;
+        if(Source == nullptr)
+            delete[] Data;
+        else
+            Source->Deallocate(Data, MaxLength, 1);
     }
 
+    /**
+     * @brief the allocator the binary uses, null if it uses new and delete
+     */
+    Memory::Allocator* Allocator() const { return Source; }
+
 protected:
 
     // ensure we have enough extra size to fit Extra
@@ -117,12 +146,7 @@ protected:
     {
         if(Cursor + Extra > MaxLength)
         {
-            MaxLength = MaxLength + Extra + Step;
-
-            Byte* Temp = Data;
-            Data = new Byte[MaxLength]();
-            Memory::Copy(Temp, Data, Length);
-            delete[] Temp;
+            Regrow(MaxLength + Extra + Step);
         }
     }
 
@@ -130,11 +154,7 @@ protected:
     {
         if(Location > MaxLength)
         {
-            MaxLength = Location + Step;
-            Byte* Temp = Data;
-            Data = new Byte[MaxLength]();
-            Memory::Copy(Temp, Data, Length);
-            delete[] Temp;
+            Regrow(Location + Step);
         }
 
         if(Location > Length)
@@ -143,11 +163,35 @@ protected:
         Cursor = Location;
     }
 
+    //everything past Length reads as zero the same as a fresh allocation does
+    void Regrow(U32 NewMax)
+    {
+        CTU_TRACK_CONTAINER(Binary);
+
+        if(Source != nullptr)
+        {
+            Data = (Byte*)Source->Reallocate(Data, MaxLength, NewMax, 1);
+            Memory::Set(Data + Length, 0, NewMax - Length);
+            MaxLength = NewMax;
+            return;
+        }
+
+        Byte* Temp = Data;
+        Data = new Byte[NewMax]();
+        Memory::Copy(Temp, Data, Length);
+        delete[] Temp;
+
+        MaxLength = NewMax;
+    }
+
 private:
     U32 Cursor;
     U32 MaxLength;
     U32 Length;
     Byte* Data;
+
+    //where Data comes from, null for new and delete
+    Memory::Allocator* Source{nullptr};
 };
 
 }
\ No newline at end of file
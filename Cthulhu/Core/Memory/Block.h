@@ -16,6 +16,12 @@
 #include "Memory.h"
 #include "Meta/Aliases.h"
 
+#include "Allocator.h"
+//Memory::Allocator
+
+#include "Tracking.h"
+//CTU_TRACK_CONTAINER
+
 #pragma once
 
 namespace Cthulhu
@@ -34,10 +40,23 @@ struct Block
      * @brief construct a new block of data
      * 
      */
-    constexpr Block()
+    Block()
     {
+        CTU_TRACK_CONTAINER(Block);
         Real = new T[Size];
     }
+
+    /**
+     * @brief construct a new block of data allocated from From
+     *
+     * @description the allocator has to outlive the block
+     */
+    explicit Block(Memory::Allocator& From)
+        : Source(&From)
+    {
+        CTU_TRACK_CONTAINER(Block);
+        Real = From.NewArray<T>(Size);
+    }
     
     /**
      * @brief Construct a new Block object
@@ -49,6 +68,7 @@ struct Block
     constexpr Block(const Block& Other)
     {
         Real = Other.Real;
+        Source = Other.Source;
     }
     
     /**
@@ -72,22 +92,42 @@ struct Block
 
     T* Copy() const { return Memory::Duplicate<T>(Real, Size); }
 
+    /**
+     * @brief the allocator the block uses, null if it uses new and delete
+     */
+    Memory::Allocator* Allocator() const { return Source; }
+
 private:
     T* Real;
 
+    //where Real comes from, null for new and delete
+    Memory::Allocator* Source{nullptr};
+
 public:
 
     ~Block()
     {
-        delete[] Real;
+        if(Source == nullptr)
+        {
+            delete[] Real;
+            return;
+        }
+
+        for(U32 I = 0; I < Size; I++)
+            Real[I].~T();
+
+        Source->Deallocate(Real, sizeof(T) * Size, alignof(T));
     }
 
-    template<typename TO, U32 TSize>
-    friend void Swap(Block<TO, TSize>& Right, Block<TO, TSize>& Left)
+    friend void Swap(Block& Right, Block& Left)
     {
         T* Temp = Right.Real;
         Right.Real = Left.Real;
         Left.Real = Temp;
+
+        Memory::Allocator* TempSource = Right.Source;
+        Right.Source = Left.Source;
+        Left.Source = TempSource;
     }
 
 };
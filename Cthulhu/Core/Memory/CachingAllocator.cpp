@@ -0,0 +1,857 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <new>
+#include <string.h>
+
+#include "CachingAllocator.h"
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT OS_WINDOWS
+
+#include "Core/Types/Mutex.h"
+//Mutex ScopeLock
+
+#if OS_WINDOWS
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#endif
+
+using namespace Cthulhu;
+using namespace Cthulhu::Memory;
+
+namespace
+{
+
+constexpr U64 PageShift = 13;
+constexpr U64 PageSize = 1 << PageShift;
+
+//anything bigger gets a span of its own
+constexpr U32 MaxSmall = 32 * 1024;
+
+constexpr U32 ClassCount = 41;
+
+/**
+ * class 0 is for big allocations, then every 16 bytes up to 128, then 4 classes
+ * for every doubling up to MaxSmall. every class is a multiple of 16 so everything
+ * handed out is aligned the same as malloc would
+ */
+struct SizeTables
+{
+    U32 Sizes[ClassCount];
+
+    //how many pages a span for the class has
+    U32 Pages[ClassCount];
+
+    //how many objects move between a thread and the central list at once
+    U32 Batch[ClassCount];
+
+    //size rounded up to 16 for sizes up to 1024, then to 128 up to MaxSmall
+    U8 Small[1024 / 16 + 1];
+    U8 Large[MaxSmall / 128 + 1];
+};
+
+constexpr SizeTables MakeTables()
+{
+    SizeTables Ret{};
+
+    U32 Count = 1;
+
+    for(U32 Size = 16; Size <= 128; Size += 16)
+        Ret.Sizes[Count++] = Size;
+
+    for(U32 Power = 128; Power < MaxSmall; Power *= 2)
+    {
+        for(U32 Step = 1; Step <= 4; Step++)
+            Ret.Sizes[Count++] = Power + (Power / 4) * Step;
+    }
+
+    for(U32 I = 1; I < ClassCount; I++)
+    {
+        const U32 Size = Ret.Sizes[I];
+
+        //at least 8 objects and no more than an eighth wasted at the end
+        U32 Pages = (U32)((Size * 8 + PageSize - 1) / PageSize);
+
+        while((Pages * PageSize) % Size > (Pages * PageSize) / 8)
+            Pages++;
+
+        Ret.Pages[I] = Pages;
+
+        const U32 Batch = (64 * 1024) / Size;
+        Ret.Batch[I] = Batch < 2 ? 2 : Batch > 32 ? 32 : Batch;
+    }
+
+    U32 Class = 1;
+    for(U32 I = 0; I <= 1024 / 16; I++)
+    {
+        while(Ret.Sizes[Class] < I * 16)
+            Class++;
+
+        Ret.Small[I] = (U8)Class;
+    }
+
+    Class = 1;
+    for(U32 I = 0; I <= MaxSmall / 128; I++)
+    {
+        while(Ret.Sizes[Class] < I * 128)
+            Class++;
+
+        Ret.Large[I] = (U8)Class;
+    }
+
+    return Ret;
+}
+
+constexpr SizeTables Tables = MakeTables();
+
+static_assert(Tables.Sizes[ClassCount - 1] == MaxSmall, "the size classes have to end at MaxSmall");
+
+CTU_INLINE U32 ClassOf(size_t Size)
+{
+    return Size <= 1024 ? Tables.Small[(Size + 15) >> 4] : Tables.Large[(Size + 127) >> 7];
+}
+
+//the system side, memory is mapped once and then only ever released and reused
+namespace System
+{
+    void* Map(U64 Size)
+    {
+#if OS_WINDOWS
+        return VirtualAlloc(nullptr, Size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+        void* Ret = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return Ret == MAP_FAILED ? nullptr : Ret;
+#endif
+    }
+
+    //map Size bytes starting on a page, Size has to be a multiple of PageSize
+    Byte* MapPages(U64 Size)
+    {
+#if OS_WINDOWS
+        //windows always lines allocations up to 64k
+        return (Byte*)Map(Size);
+#else
+        Byte* Ret = (Byte*)Map(Size + PageSize);
+
+        if(Ret == nullptr)
+            return nullptr;
+
+        //trim the ends so the start lines up with a page
+        const U64 Front = (PageSize - ((U64)Ret & (PageSize - 1))) & (PageSize - 1);
+
+        if(Front != 0)
+            munmap(Ret, Front);
+
+        if(PageSize - Front != 0)
+            munmap(Ret + Front + Size, PageSize - Front);
+
+        return Ret + Front;
+#endif
+    }
+
+    //the pages stay reserved but have no memory behind them
+    void Release(void* Ptr, U64 Size)
+    {
+#if OS_WINDOWS
+        VirtualFree(Ptr, Size, MEM_DECOMMIT);
+#else
+        madvise(Ptr, Size, MADV_DONTNEED);
+#endif
+    }
+
+    //released pages need committing again on windows, everywhere else touching them is enough
+    void Reuse(void* Ptr, U64 Size)
+    {
+#if OS_WINDOWS
+        VirtualAlloc(Ptr, Size, MEM_COMMIT, PAGE_READWRITE);
+#else
+        (void)Ptr;
+        (void)Size;
+#endif
+    }
+}
+
+enum class SpanState : U8
+{
+    InUse,
+    Free
+};
+
+struct Span
+{
+    //the first page number and how many pages
+    U64 Start;
+    U64 Pages;
+
+    //neighbours in a free list or a central list
+    Span* Next;
+    Span* Prev;
+
+    //free objects in a span owned by a central list
+    void* Objects;
+    U32 Allocated;
+
+    //0 for big allocations and free spans
+    U8 Class;
+    SpanState State;
+
+    //the pages have been given back to the system
+    bool Released;
+
+    CTU_INLINE Byte* Address() const { return (Byte*)(Start << PageShift); }
+    CTU_INLINE U64 Bytes() const { return Pages << PageShift; }
+};
+
+//circular lists with a sentinel so nothing needs a null check
+namespace List
+{
+    CTU_INLINE void Init(Span* Head) { Head->Next = Head->Prev = Head; }
+    CTU_INLINE bool Empty(const Span* Head) { return Head->Next == Head; }
+
+    CTU_INLINE void Push(Span* Head, Span* Item)
+    {
+        Item->Next = Head->Next;
+        Item->Prev = Head;
+        Head->Next->Prev = Item;
+        Head->Next = Item;
+    }
+
+    CTU_INLINE void Remove(Span* Item)
+    {
+        Item->Prev->Next = Item->Next;
+        Item->Next->Prev = Item->Prev;
+        Item->Next = Item->Prev = nullptr;
+    }
+}
+
+/**
+ * finds the span a page belongs to. a 2 level radix tree over 48 bit addresses, the
+ * root is static and leaves are mapped the first time a page in their range is used.
+ * entries are only written with the page heap lock held, reading is safe without it
+ * for any page that belongs to memory the caller owns
+ */
+namespace PageMap
+{
+    constexpr U64 AddressBits = 48;
+    constexpr U64 LeafBits = 18;
+    constexpr U64 RootBits = AddressBits - PageShift - LeafBits;
+
+    Span** Root[1 << RootBits];
+
+    CTU_INLINE Span* Get(U64 Page)
+    {
+        Span** Leaf = Root[Page >> LeafBits];
+        return Leaf != nullptr ? Leaf[Page & ((1 << LeafBits) - 1)] : nullptr;
+    }
+
+    void Set(U64 Page, Span* Item)
+    {
+        ASSERT((Page >> (LeafBits + RootBits)) == 0, "CachingAllocator only handles 48 bit addresses");
+
+        Span**& Leaf = Root[Page >> LeafBits];
+
+        if(Leaf == nullptr)
+        {
+            Leaf = (Span**)System::Map(sizeof(Span*) << LeafBits);
+            ASSERT(Leaf != nullptr, "CachingAllocator ran out of memory");
+        }
+
+        Leaf[Page & ((1 << LeafBits) - 1)] = Item;
+    }
+
+    //free spans and big allocations only need their ends mapped
+    void SetEnds(Span* Item)
+    {
+        Set(Item->Start, Item);
+        Set(Item->Start + Item->Pages - 1, Item);
+    }
+
+    //any page of a span with objects in it can be looked up
+    void SetAll(Span* Item)
+    {
+        for(U64 I = 0; I < Item->Pages; I++)
+            Set(Item->Start + I, Item);
+    }
+}
+
+//spans with a free list kept in the page heap
+constexpr U64 ListedPages = 128;
+
+//grow by at least this much so small requests dont map a page at a time
+constexpr U64 GrowPages = 128;
+
+//once this much free memory is sitting in the page heap release it down to half
+constexpr U64 ReleaseAbove = 32 * 1024 * 1024;
+
+struct PageHeap
+{
+    PageHeap()
+        : Mapped(0)
+        , FreeBytes(0)
+        , ReleasedBytes(0)
+        , SpareSpans(nullptr)
+        , MetaCursor(nullptr)
+        , MetaEnd(nullptr)
+    {
+        for(U64 I = 0; I <= ListedPages; I++)
+            List::Init(&Free[I]);
+    }
+
+    Mutex Lock;
+
+    //Free[N] has spans N pages long, Free[0] has everything longer than ListedPages
+    Span Free[ListedPages + 1];
+
+    U64 Mapped;
+    U64 FreeBytes;
+    U64 ReleasedBytes;
+
+    //span structs are never given back, just reused
+    Span* SpareSpans;
+    Byte* MetaCursor;
+    Byte* MetaEnd;
+
+    Span* NewMeta(U64 Start, U64 Pages)
+    {
+        Span* Ret = SpareSpans;
+
+        if(Ret != nullptr)
+        {
+            SpareSpans = Ret->Next;
+        }
+        else
+        {
+            if(MetaCursor + sizeof(Span) > MetaEnd)
+            {
+                MetaCursor = (Byte*)System::Map(64 * 1024);
+                ASSERT(MetaCursor != nullptr, "CachingAllocator ran out of memory");
+
+                MetaEnd = MetaCursor + 64 * 1024;
+            }
+
+            Ret = (Span*)MetaCursor;
+            MetaCursor += sizeof(Span);
+        }
+
+        memset((void*)Ret, 0, sizeof(Span));
+
+        Ret->Start = Start;
+        Ret->Pages = Pages;
+
+        return Ret;
+    }
+
+    void DeleteMeta(Span* Item)
+    {
+        Item->Next = SpareSpans;
+        SpareSpans = Item;
+    }
+
+    void PushFree(Span* Item)
+    {
+        Item->State = SpanState::Free;
+        Item->Class = 0;
+        Item->Objects = nullptr;
+
+        List::Push(Item->Pages <= ListedPages ? &Free[Item->Pages] : &Free[0], Item);
+
+        (Item->Released ? ReleasedBytes : FreeBytes) += Item->Bytes();
+    }
+
+    void RemoveFree(Span* Item)
+    {
+        List::Remove(Item);
+        (Item->Released ? ReleasedBytes : FreeBytes) -= Item->Bytes();
+    }
+
+    //take Pages off the front of a free span and put the rest back
+    Span* Carve(Span* Item, U64 Pages)
+    {
+        RemoveFree(Item);
+
+        if(Item->Pages > Pages)
+        {
+            Span* Rest = NewMeta(Item->Start + Pages, Item->Pages - Pages);
+            Rest->Released = Item->Released;
+
+            Item->Pages = Pages;
+
+            PageMap::SetEnds(Rest);
+            PushFree(Rest);
+        }
+
+        if(Item->Released)
+        {
+            System::Reuse(Item->Address(), Item->Bytes());
+            Item->Released = false;
+        }
+
+        Item->State = SpanState::InUse;
+        PageMap::SetEnds(Item);
+
+        return Item;
+    }
+
+    Span* New(U64 Pages)
+    {
+        for(U64 I = Pages; I <= ListedPages; I++)
+        {
+            if(!List::Empty(&Free[I]))
+                return Carve(Free[I].Next, Pages);
+        }
+
+        //the smallest big span that fits, the lowest address if theres a tie
+        Span* Best = nullptr;
+
+        for(Span* Current = Free[0].Next; Current != &Free[0]; Current = Current->Next)
+        {
+            if(Current->Pages < Pages)
+                continue;
+
+            if(Best == nullptr || Current->Pages < Best->Pages || (Current->Pages == Best->Pages && Current->Start < Best->Start))
+                Best = Current;
+        }
+
+        if(Best != nullptr)
+            return Carve(Best, Pages);
+
+        Grow(Pages);
+
+        return New(Pages);
+    }
+
+    void Grow(U64 Pages)
+    {
+        const U64 Amount = Pages < GrowPages ? GrowPages : Pages;
+
+        Byte* Memory = System::MapPages(Amount << PageShift);
+        ASSERT(Memory != nullptr, "CachingAllocator ran out of memory");
+
+        Mapped += Amount << PageShift;
+
+        Span* Made = NewMeta((U64)Memory >> PageShift, Amount);
+        Made->State = SpanState::InUse;
+        PageMap::SetEnds(Made);
+
+        //mappings are often next to each other so this joins them up
+        Delete(Made);
+    }
+
+    //join a free neighbour onto Item
+    void Absorb(Span* Item, Span* Other)
+    {
+        RemoveFree(Other);
+
+        //a joined span is only released if all of it is
+        if(Other->Released)
+            System::Reuse(Other->Address(), Other->Bytes());
+
+        if(Other->Start < Item->Start)
+            Item->Start = Other->Start;
+
+        Item->Pages += Other->Pages;
+
+        DeleteMeta(Other);
+    }
+
+    void Delete(Span* Item)
+    {
+        Item->Released = false;
+
+        Span* Left = PageMap::Get(Item->Start - 1);
+        if(Left != nullptr && Left->State == SpanState::Free)
+            Absorb(Item, Left);
+
+        Span* Right = PageMap::Get(Item->Start + Item->Pages);
+        if(Right != nullptr && Right->State == SpanState::Free)
+            Absorb(Item, Right);
+
+        PageMap::SetEnds(Item);
+        PushFree(Item);
+
+        if(FreeBytes > ReleaseAbove)
+            ReleaseDown(ReleaseAbove / 2);
+    }
+
+    //give the biggest free spans back to the system until only Target bytes are left
+    void ReleaseDown(U64 Target)
+    {
+        for(U64 I = 0; I <= ListedPages && FreeBytes > Target; I++)
+        {
+            //the big list first then from the longest listed spans down
+            Span* Head = &Free[I == 0 ? 0 : ListedPages + 1 - I];
+
+            for(Span* Current = Head->Next; Current != Head && FreeBytes > Target; Current = Current->Next)
+            {
+                if(Current->Released)
+                    continue;
+
+                System::Release(Current->Address(), Current->Bytes());
+
+                Current->Released = true;
+                FreeBytes -= Current->Bytes();
+                ReleasedBytes += Current->Bytes();
+            }
+        }
+    }
+};
+
+//how many full batches each class keeps ready to hand to another thread
+constexpr U32 TransferSlots = 64;
+
+struct CentralList
+{
+    CentralList() : Class(0), Used(0)
+    {
+        List::Init(&Available);
+    }
+
+    Mutex Lock;
+
+    U32 Class;
+
+    //spans with free objects in them
+    Span Available;
+
+    //batches of exactly Tables.Batch[Class] objects
+    void* Slots[TransferSlots];
+    U32 Used;
+};
+
+struct Globals
+{
+    Globals()
+    {
+        for(U32 I = 0; I < ClassCount; I++)
+            Central[I].Class = I;
+    }
+
+    PageHeap Heap;
+    CentralList Central[ClassCount];
+};
+
+//nothing here is ever destroyed so memory can be freed during static destruction
+Globals& State()
+{
+    alignas(Globals) static Byte Storage[sizeof(Globals)];
+    static Globals* Ret = new (Storage) Globals();
+
+    return *Ret;
+}
+
+void Populate(CentralList& From)
+{
+    const U32 Size = Tables.Sizes[From.Class];
+
+    Span* Made;
+
+    {
+        PageHeap& Heap = State().Heap;
+        ScopeLock Guard(Heap.Lock);
+
+        Made = Heap.New(Tables.Pages[From.Class]);
+        Made->Class = (U8)From.Class;
+        PageMap::SetAll(Made);
+    }
+
+    //thread the objects together in address order
+    Byte* Start = Made->Address();
+    const U64 Count = Made->Bytes() / Size;
+
+    for(U64 I = 0; I + 1 < Count; I++)
+        *(void**)(Start + I * Size) = Start + (I + 1) * Size;
+
+    *(void**)(Start + (Count - 1) * Size) = nullptr;
+
+    Made->Objects = Start;
+    Made->Allocated = 0;
+
+    List::Push(&From.Available, Made);
+}
+
+//take up to Amount objects, the central lock has to be held
+U32 RemoveRange(CentralList& From, U32 Amount, void*& Head)
+{
+    if(Amount == Tables.Batch[From.Class] && From.Used > 0)
+    {
+        Head = From.Slots[--From.Used];
+        return Amount;
+    }
+
+    U32 Count = 0;
+    Head = nullptr;
+
+    while(Count < Amount)
+    {
+        if(List::Empty(&From.Available))
+            Populate(From);
+
+        Span* Current = From.Available.Next;
+
+        while(Current->Objects != nullptr && Count < Amount)
+        {
+            void* Item = Current->Objects;
+            Current->Objects = *(void**)Item;
+            Current->Allocated++;
+
+            *(void**)Item = Head;
+            Head = Item;
+            Count++;
+        }
+
+        if(Current->Objects == nullptr)
+            List::Remove(Current);
+    }
+
+    return Count;
+}
+
+//the central lock has to be held
+void ReturnObject(CentralList& Into, void* Item)
+{
+    Span* Owner = PageMap::Get((U64)Item >> PageShift);
+
+    if(Owner->Objects == nullptr)
+        List::Push(&Into.Available, Owner);
+
+    *(void**)Item = Owner->Objects;
+    Owner->Objects = Item;
+
+    //a span with nothing handed out goes back to the page heap
+    if(--Owner->Allocated == 0)
+    {
+        List::Remove(Owner);
+
+        PageHeap& Heap = State().Heap;
+        ScopeLock Guard(Heap.Lock);
+
+        Heap.Delete(Owner);
+    }
+}
+
+void InsertRange(CentralList& Into, void* Head, U32 Amount)
+{
+    ScopeLock Guard(Into.Lock);
+
+    if(Amount == Tables.Batch[Into.Class] && Into.Used < TransferSlots)
+    {
+        Into.Slots[Into.Used++] = Head;
+        return;
+    }
+
+    while(Head != nullptr)
+    {
+        void* Next = *(void**)Head;
+        ReturnObject(Into, Head);
+        Head = Next;
+    }
+}
+
+struct ThreadCache
+{
+    struct FreeList
+    {
+        void* Head;
+        U32 Length;
+    };
+
+    FreeList Lists[ClassCount];
+
+    //anything freed after this threads cache was destroyed goes straight to the central lists
+    bool Dead;
+
+    ~ThreadCache()
+    {
+        for(U32 I = 1; I < ClassCount; I++)
+        {
+            if(Lists[I].Length != 0)
+                InsertRange(State().Central[I], Lists[I].Head, Lists[I].Length);
+
+            Lists[I] = { nullptr, 0 };
+        }
+
+        Dead = true;
+    }
+};
+
+thread_local ThreadCache Cache;
+
+void* AllocSmall(U32 Class)
+{
+    ThreadCache& Local = Cache;
+    CentralList& Central = State().Central[Class];
+
+    if(Local.Dead)
+    {
+        ScopeLock Guard(Central.Lock);
+
+        void* Head;
+        RemoveRange(Central, 1, Head);
+
+        return Head;
+    }
+
+    ThreadCache::FreeList& Items = Local.Lists[Class];
+
+    void* Head;
+    U32 Count;
+
+    {
+        ScopeLock Guard(Central.Lock);
+        Count = RemoveRange(Central, Tables.Batch[Class], Head);
+    }
+
+    Items.Head = *(void**)Head;
+    Items.Length = Count - 1;
+
+    return Head;
+}
+
+//the cache has twice a batch so hand one back
+void Overflow(ThreadCache::FreeList& Items, U32 Class)
+{
+    const U32 Batch = Tables.Batch[Class];
+
+    void* Head = Items.Head;
+    void* Tail = Head;
+
+    for(U32 I = 1; I < Batch; I++)
+        Tail = *(void**)Tail;
+
+    Items.Head = *(void**)Tail;
+    Items.Length -= Batch;
+
+    *(void**)Tail = nullptr;
+
+    InsertRange(State().Central[Class], Head, Batch);
+}
+
+void* AllocLarge(size_t Size)
+{
+    const U64 Pages = (Size + PageSize - 1) >> PageShift;
+
+    PageHeap& Heap = State().Heap;
+    ScopeLock Guard(Heap.Lock);
+
+    return Heap.New(Pages)->Address();
+}
+
+}
+
+void* Cthulhu::Memory::CachedAlloc(size_t Size)
+{
+    if(Size > MaxSmall)
+        return AllocLarge(Size);
+
+    const U32 Class = ClassOf(Size);
+    ThreadCache::FreeList& Items = Cache.Lists[Class];
+
+    void* Ret = Items.Head;
+
+    if(Ret == nullptr)
+        return AllocSmall(Class);
+
+    Items.Head = *(void**)Ret;
+    Items.Length--;
+
+    return Ret;
+}
+
+void Cthulhu::Memory::CachedFree(void* Ptr)
+{
+    if(Ptr == nullptr)
+        return;
+
+    Span* Owner = PageMap::Get((U64)Ptr >> PageShift);
+    ASSERT(Owner != nullptr && Owner->State == SpanState::InUse, "CachedFree was given memory that didnt come from CachedAlloc");
+
+    const U32 Class = Owner->Class;
+
+    if(Class == 0)
+    {
+        PageHeap& Heap = State().Heap;
+        ScopeLock Guard(Heap.Lock);
+
+        Heap.Delete(Owner);
+        return;
+    }
+
+    ThreadCache& Local = Cache;
+
+    if(Local.Dead)
+    {
+        *(void**)Ptr = nullptr;
+        InsertRange(State().Central[Class], Ptr, 1);
+        return;
+    }
+
+    ThreadCache::FreeList& Items = Local.Lists[Class];
+
+    *(void**)Ptr = Items.Head;
+    Items.Head = Ptr;
+
+    if(++Items.Length > Tables.Batch[Class] * 2)
+        Overflow(Items, Class);
+}
+
+size_t Cthulhu::Memory::CachedSize(const void* Ptr)
+{
+    Span* Owner = PageMap::Get((U64)Ptr >> PageShift);
+
+    return Owner->Class != 0 ? Tables.Sizes[Owner->Class] : Owner->Bytes();
+}
+
+void* Cthulhu::Memory::CachedRealloc(void* Ptr, size_t Size)
+{
+    if(Ptr == nullptr)
+        return CachedAlloc(Size);
+
+    if(Size == 0)
+    {
+        CachedFree(Ptr);
+        return nullptr;
+    }
+
+    //stay put if it still fits and shrinking wouldnt save much
+    const size_t Current = CachedSize(Ptr);
+
+    if(Size <= Current && Size >= Current / 2)
+        return Ptr;
+
+    void* Ret = CachedAlloc(Size);
+    memcpy(Ret, Ptr, Size < Current ? Size : Current);
+    CachedFree(Ptr);
+
+    return Ret;
+}
+
+void Cthulhu::Memory::ReleaseFreeMemory()
+{
+    PageHeap& Heap = State().Heap;
+    ScopeLock Guard(Heap.Lock);
+
+    Heap.ReleaseDown(0);
+}
+
+CachedStats Cthulhu::Memory::CachedAllocStats()
+{
+    PageHeap& Heap = State().Heap;
+    ScopeLock Guard(Heap.Lock);
+
+    return { Heap.Mapped, Heap.FreeBytes, Heap.ReleasedBytes };
+}
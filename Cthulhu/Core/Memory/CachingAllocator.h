@@ -0,0 +1,101 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stddef.h>
+
+#include "Meta/Aliases.h"
+//U64
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+/**
+ * @brief a general purpose allocator with a cache for every thread
+ *
+ * @description small requests are rounded up to one of about 40 size classes. every
+ *              thread keeps a free list for each class so most allocations and frees
+ *              never take a lock. when a thread has too many or too few it trades a
+ *              whole batch with the central list for that class, full batches are kept
+ *              as they are in a transfer cache so moving them between threads is cheap.
+ *
+ *              the central lists carve objects out of spans, runs of 8k pages that come
+ *              from a page heap. big requests get a span of their own. the page heap maps
+ *              memory from the system and gives freed pages back once too much of it is
+ *              sitting unused, ReleaseFreeMemory gives back everything it can.
+ *
+ *              building with the meson option caching_allocator makes Memory::Alloc,
+ *              Realloc, Free and AllocSize use this instead of malloc. it can be used
+ *              directly either way but memory from here can only go back here
+ *
+ * @code{.cpp}
+ *
+ * void* Block = Memory::CachedAlloc(100);
+ * Block = Memory::CachedRealloc(Block, 200);
+ * Memory::CachedFree(Block);
+ *
+ * @endcode
+ */
+void* CachedAlloc(size_t Size);
+
+/**
+ * @brief resize memory from CachedAlloc keeping what fits
+ *
+ * @param Ptr null behaves like CachedAlloc
+ * @param Size 0 frees Ptr and returns null
+ */
+void* CachedRealloc(void* Ptr, size_t Size);
+
+/**
+ * @brief give back memory from CachedAlloc or CachedRealloc, null does nothing
+ */
+void CachedFree(void* Ptr);
+
+/**
+ * @brief how many bytes Ptr can actually hold, at least as many as were asked for
+ */
+size_t CachedSize(const void* Ptr);
+
+/**
+ * @brief give every free page in the page heap back to the system
+ *
+ * @description memory in thread caches and partly used spans stays where it is
+ */
+void ReleaseFreeMemory();
+
+/**
+ * @brief what the caching allocator is holding onto
+ */
+struct CachedStats
+{
+    ///bytes mapped from the system in total
+    U64 Mapped;
+
+    ///bytes in free spans that are still backed by memory
+    U64 Free;
+
+    ///bytes in free spans that have been given back to the system
+    U64 Released;
+};
+
+CachedStats CachedAllocStats();
+
+}
+
+}
@@ -0,0 +1,329 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+
+#include "FrameAllocator.h"
+
+#include "Pages.h"
+//Memory::ReservePages Memory::CommitPages Memory::UnmapPages
+
+#include "Tracking.h"
+//CTU_TRACK_CONTAINER
+
+using namespace Cthulhu;
+using namespace Cthulhu::Memory;
+
+namespace
+{
+
+//memory is committed this much at a time so a buffer doesnt need a system call every page
+constexpr U64 CommitStep = 1024 * 1024;
+
+U64 Frame = 0;
+
+//the most any thread allocated in a frame that has finished
+U64 SharedHighWater = 0;
+
+//bumped by ResetHighWater so every thread knows to forget its own
+U64 HighWaterEpoch = 0;
+
+//allocations that didnt fit in a buffer, freed when the buffer resets
+struct Spill
+{
+    Spill* Next;
+    U64 Size;
+};
+
+struct Buffer
+{
+    Byte* Start;
+    Byte* Cursor;
+    Byte* Committed;
+    Spill* Spilled;
+    U64 SpilledBytes;
+
+    U64 Used() const { return (Cursor - Start) + SpilledBytes; }
+};
+
+CTU_INLINE Byte* AlignUp(Byte* Ptr, U64 Align)
+{
+    return (Byte*)(((U64)Ptr + Align - 1) & ~(Align - 1));
+}
+
+void RaiseShared(U64 Used)
+{
+    U64 Peak = __atomic_load_n(&SharedHighWater, __ATOMIC_RELAXED);
+    while(Used > Peak && !__atomic_compare_exchange_n(&SharedHighWater, &Peak, Used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+struct FrameBuffers
+{
+    //both buffers share one reservation, made the first time the thread allocates
+    Byte* Range;
+    Buffer Buffers[2];
+
+    //the frame the thread last allocated in
+    U64 Seen;
+
+    U64 HighWater;
+    U64 Epoch;
+
+    ~FrameBuffers()
+    {
+        if(Range == nullptr)
+            return;
+
+        Reset(Buffers[0]);
+        Reset(Buffers[1]);
+
+        UnmapPages(Range, FrameBufferSize * 2);
+    }
+
+    void Reserve()
+    {
+        Range = (Byte*)ReservePages(FrameBufferSize * 2);
+        ASSERT(Range != nullptr, "Frame allocator ran out of address space");
+
+        for(U32 I = 0; I < 2; I++)
+        {
+            Byte* Start = Range + FrameBufferSize * I;
+            Buffers[I] = { Start, Start, Start, nullptr, 0 };
+        }
+    }
+
+    //called before the cursor moves back so the high water mark sees the peak
+    void Note(const Buffer& Which)
+    {
+        const U64 Used = Which.Used();
+
+        if(Used > HighWater)
+            HighWater = Used;
+
+        RaiseShared(Used);
+    }
+
+    void Reset(Buffer& Which)
+    {
+        Note(Which);
+
+#ifdef CTU_DEBUG
+        //anything still reading this frames memory gets obvious garbage
+        memset(Which.Start, 0xDD, Which.Cursor - Which.Start);
+#endif
+
+        Which.Cursor = Which.Start;
+
+        for(Spill* Current = Which.Spilled; Current != nullptr;)
+        {
+            Spill* Next = Current->Next;
+            delete[] (Byte*)Current;
+            Current = Next;
+        }
+
+        Which.Spilled = nullptr;
+        Which.SpilledBytes = 0;
+    }
+
+    //the buffer for the frame the program is on now, resetting whatever has expired
+    Buffer& Current()
+    {
+        if(Range == nullptr)
+            Reserve();
+
+        const U64 Now = CurrentFrame();
+
+        if(Now != Seen)
+        {
+            //skipping frames means last frames buffer is out of date too
+            if(Now - Seen >= 2)
+                Reset(Buffers[(Now + 1) & 1]);
+
+            Reset(Buffers[Now & 1]);
+            Seen = Now;
+        }
+
+        const U64 Latest = __atomic_load_n(&HighWaterEpoch, __ATOMIC_RELAXED);
+        if(Latest != Epoch)
+        {
+            HighWater = 0;
+            Epoch = Latest;
+        }
+
+        return Buffers[Now & 1];
+    }
+
+    bool Owns(const void* Ptr) const
+    {
+        for(const Buffer& Which : Buffers)
+        {
+            if(Ptr >= Which.Start && Ptr <= Which.Cursor)
+                return true;
+
+            for(Spill* Current = Which.Spilled; Current != nullptr; Current = Current->Next)
+            {
+                if(Ptr > Current && Ptr < (Byte*)Current + Current->Size)
+                    return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+thread_local FrameBuffers Local;
+
+void* SpillOver(Buffer& Into, U64 Size, U64 Align)
+{
+    const U64 Total = sizeof(Spill) + Size + Align;
+
+    CTU_TRACK_CONTAINER(Arena);
+    Spill* Made = (Spill*)new Byte[Total];
+    Made->Next = Into.Spilled;
+    Made->Size = Total;
+
+    Into.Spilled = Made;
+    Into.SpilledBytes += Size;
+
+    return AlignUp((Byte*)(Made + 1), Align);
+}
+
+//make sure everything up to Until has memory behind it, false if that is past the end of the buffer
+bool CommitUpTo(Buffer& Into, Byte* Until)
+{
+    if(Until <= Into.Committed)
+        return true;
+
+    if(Until > Into.Start + FrameBufferSize)
+        return false;
+
+    Byte* Wanted = Into.Start + ((Until - Into.Start + CommitStep - 1) & ~(CommitStep - 1));
+
+    if(Wanted > Into.Start + FrameBufferSize)
+        Wanted = Into.Start + FrameBufferSize;
+
+    const bool Committed = CommitPages(Into.Committed, Wanted - Into.Committed);
+    ASSERT(Committed, "Frame allocator ran out of memory");
+    (void)Committed;
+
+    Into.Committed = Wanted;
+
+    return true;
+}
+
+}
+
+U64 Cthulhu::Memory::CurrentFrame()
+{
+    return __atomic_load_n(&Frame, __ATOMIC_RELAXED);
+}
+
+U64 Cthulhu::Memory::NextFrame()
+{
+    return __atomic_add_fetch(&Frame, 1, __ATOMIC_RELAXED);
+}
+
+void* Cthulhu::Memory::FrameAllocator::Allocate(U64 Size, U64 Align)
+{
+    ASSERT((Align & (Align - 1)) == 0, "Frame alignment has to be a power of 2");
+
+    Buffer& Into = Local.Current();
+    Byte* Start = AlignUp(Into.Cursor, Align);
+
+    if(!CommitUpTo(Into, Start + Size))
+        return SpillOver(Into, Size, Align);
+
+    Into.Cursor = Start + Size;
+
+    return Start;
+}
+
+void Cthulhu::Memory::FrameAllocator::Deallocate(void* Ptr, U64 Size, U64 Align)
+{
+    if(Ptr == nullptr)
+        return;
+
+    Buffer& Into = Local.Current();
+    ASSERT(Local.Owns(Ptr), "Frame memory was given back on another thread or after its frame ended");
+
+    if(Ptr >= Into.Start && (Byte*)Ptr + Size == Into.Cursor)
+    {
+        Local.Note(Into);
+        Into.Cursor = (Byte*)Ptr;
+    }
+}
+
+void* Cthulhu::Memory::FrameAllocator::Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align)
+{
+    if(Ptr == nullptr)
+        return Allocate(NewSize, Align);
+
+    Buffer& Into = Local.Current();
+    ASSERT(Local.Owns(Ptr), "Frame memory was resized on another thread or after its frame ended");
+
+    //the newest allocation can just move the cursor
+    if(Ptr >= Into.Start && (Byte*)Ptr + OldSize == Into.Cursor && CommitUpTo(Into, (Byte*)Ptr + NewSize))
+    {
+        if(NewSize < OldSize)
+            Local.Note(Into);
+
+        Into.Cursor = (Byte*)Ptr + NewSize;
+        return Ptr;
+    }
+
+    if(NewSize <= OldSize)
+        return Ptr;
+
+    void* Ret = Allocate(NewSize, Align);
+    memcpy(Ret, Ptr, OldSize);
+
+    return Ret;
+}
+
+FrameStats Cthulhu::Memory::FrameAllocator::Stats() const
+{
+    if(Local.Range == nullptr)
+        return { CurrentFrame(), 0, 0, 0 };
+
+    Buffer& Now = Local.Current();
+    const U64 Used = Now.Used();
+
+    return {
+        Local.Seen,
+        Used,
+        (U64)(Local.Buffers[0].Committed - Local.Buffers[0].Start) + (U64)(Local.Buffers[1].Committed - Local.Buffers[1].Start),
+        Used > Local.HighWater ? Used : Local.HighWater
+    };
+}
+
+U64 Cthulhu::Memory::FrameAllocator::HighWater() const
+{
+    const U64 Shared = __atomic_load_n(&SharedHighWater, __ATOMIC_RELAXED);
+    const U64 Mine = Stats().HighWater;
+
+    return Mine > Shared ? Mine : Shared;
+}
+
+void Cthulhu::Memory::FrameAllocator::ResetHighWater()
+{
+    __atomic_add_fetch(&HighWaterEpoch, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&SharedHighWater, 0, __ATOMIC_RELAXED);
+}
+
+FrameAllocator& Cthulhu::Memory::Frames()
+{
+    static FrameAllocator Instance;
+    return Instance;
+}
@@ -0,0 +1,203 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
+#include "Meta/Aliases.h"
+//U64
+
+#include "Allocator.h"
+//Memory::Allocator Memory::DefaultAlign
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+///how much address space each of a threads two frame buffers reserves, only what is used takes memory
+constexpr U64 FrameBufferSize = 256ULL * 1024 * 1024;
+
+/**
+ * @brief the frame the program is on, starts at 0
+ */
+U64 CurrentFrame();
+
+/**
+ * @brief move every thread on to the next frame
+ *
+ * @description the graphics main loop calls this on every tick just before it sends
+ *              MainLoopEvent::Tick. anything else with a loop of its own can call it
+ *              once per iteration instead. threads reset their frame buffers the next
+ *              time they allocate so this is a single atomic add
+ *
+ * @return U64 the new frame
+ */
+U64 NextFrame();
+
+/**
+ * @brief what the frame allocator has done on one thread
+ */
+struct FrameStats
+{
+    ///the frame these are for
+    U64 Frame;
+
+    ///bytes allocated this frame including alignment padding
+    U64 Used;
+
+    ///bytes of memory behind both buffers right now
+    U64 Committed;
+
+    ///the most bytes allocated in a single frame so far
+    U64 HighWater;
+};
+
+/**
+ * @brief hands out memory that lives until the end of the next frame
+ *
+ * @description every thread gets two linear buffers and frames take turns using them,
+ *              so whatever is allocated during a frame is still there for the whole of
+ *              the frame after it and is thrown away once the frame after that starts
+ *              allocating. allocating is bumping a cursor and nothing needs freeing, the
+ *              reset happens by itself when NextFrame is called.
+ *
+ *              there is only one frame allocator, get it with Memory::Frames. it is
+ *              scoped so containers using it skip destroying trivial items. memory has
+ *              to stay on the thread that allocated it since the other threads buffers
+ *              can reset at any time. buffers only hand out FrameBufferSize each, a
+ *              frame that needs more spills onto the heap until its buffer resets.
+ *
+ *              in debug builds freed buffers are filled with 0xDD and giving memory back
+ *              or resizing it asserts when it isnt in the threads live buffers. wrap
+ *              pointers that are kept around in a FramePtr to have every use checked
+ *
+ * @code{.cpp}
+ *
+ * void Simulate()
+ * {
+ *     //gone by the time the frame after next starts
+ *     Array<Contact> Contacts(Memory::Frames());
+ *     String Label(Memory::Frames());
+ *
+ *     FindContacts(Contacts);
+ * }
+ *
+ * @endcode
+ */
+struct FrameAllocator final : Allocator
+{
+    FrameAllocator()
+        : Allocator(true)
+    {}
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /**
+     * @brief get Size bytes aligned to Align from the calling threads buffer for this frame
+     */
+    virtual void* Allocate(U64 Size, U64 Align = DefaultAlign) override;
+
+    /**
+     * @brief give back memory, only the newest allocation this frame can be reused
+     */
+    virtual void Deallocate(void* Ptr, U64 Size, U64 Align = DefaultAlign) override;
+
+    /**
+     * @brief resize memory, the newest allocation this frame grows in place
+     */
+    virtual void* Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align = DefaultAlign) override;
+
+    /**
+     * @brief what the calling thread has allocated
+     */
+    FrameStats Stats() const;
+
+    /**
+     * @brief the most any thread has allocated in a single frame
+     *
+     * @description other threads are counted once their frames finish, the calling
+     *              threads current frame is counted as well
+     */
+    U64 HighWater() const;
+
+    /**
+     * @brief start counting high water marks again from now on every thread
+     */
+    void ResetHighWater();
+};
+
+/**
+ * @brief the frame allocator every thread shares
+ */
+FrameAllocator& Frames();
+
+/**
+ * @brief a pointer into frame memory that remembers which frame it came from
+ *
+ * @description in debug builds every use asserts that the frame it came from hasnt
+ *              been thrown away yet. in release builds it is as cheap as the pointer
+ *
+ * @code{.cpp}
+ *
+ * Memory::FramePtr<Path> Route = Memory::Frames().New<Path>();
+ * Memory::NextFrame();
+ * Route->Length; //fine, last frames memory is still there
+ * Memory::NextFrame();
+ * Route->Length; //asserts
+ *
+ * @endcode
+ *
+ * @tparam T what it points to
+ */
+template<typename T>
+struct FramePtr
+{
+    FramePtr(T* InPtr = nullptr)
+        : Ptr(InPtr)
+        , Born(CurrentFrame())
+    {}
+
+    ///true while the memory is still there
+    CTU_INLINE bool Live() const { return CurrentFrame() - Born <= 1; }
+
+    ///the frame it came from
+    CTU_INLINE U64 Frame() const { return Born; }
+
+    CTU_INLINE T* Get() const
+    {
+        ASSERT(Live(), "A pointer from the frame allocator was used after its frame ended");
+        return Ptr;
+    }
+
+    CTU_INLINE T* operator->() const { return Get(); }
+    CTU_INLINE T& operator*() const { return *Get(); }
+
+    CTU_INLINE bool operator==(decltype(nullptr)) const { return Ptr == nullptr; }
+    CTU_INLINE bool operator!=(decltype(nullptr)) const { return Ptr != nullptr; }
+
+private:
+    T* Ptr;
+    U64 Born;
+};
+
+}
+
+}
@@ -24,6 +24,20 @@
 #   include <malloc.h>
 #endif
 
+#if CC_MSVC
+#   include <xmmintrin.h>
+#endif
+
+//the meson option caching_allocator swaps malloc out for the caching allocator
+#if CTU_CACHING_ALLOCATOR
+#   include "CachingAllocator.h"
+#endif
+
+//the meson option allocation_tracking records everything that goes through here
+#if CTU_TRACK_ALLOCATIONS
+#   include "Tracking.h"
+#endif
+
 #pragma once
 
 namespace Cthulhu
@@ -152,9 +166,15 @@ namespace Memory
      * @return CTU_INLINE* Realloc 
      */
     template<typename T>
-    CTU_INLINE T* Realloc(T* Data, U32 NewLen) 
+    CTU_INLINE T* Realloc(T* Data, size_t NewLen) 
     { 
+#if CTU_TRACK_ALLOCATIONS
+        return (T*)TrackedRealloc((void*)Data, NewLen);
+#elif CTU_CACHING_ALLOCATOR
+        return (T*)CachedRealloc((void*)Data, NewLen);
+#else
         return (T*)realloc((void*)Data, NewLen); 
+#endif
     }
 
     /**
@@ -165,9 +185,15 @@ namespace Memory
      * @return CTU_INLINE* Alloc 
      */
     template<typename T>
-    CTU_INLINE T* Alloc(U32 Len) 
+    CTU_INLINE T* Alloc(size_t Len) 
     { 
+#if CTU_TRACK_ALLOCATIONS
+        return (T*)TrackedAlloc(Len);
+#elif CTU_CACHING_ALLOCATOR
+        return (T*)CachedAlloc(Len);
+#else
         return (T*)malloc(Len); 
+#endif
     }
 
     /**
@@ -180,7 +206,96 @@ namespace Memory
     template<typename T>
     CTU_INLINE void Free(T* Data) 
     { 
+#if CTU_TRACK_ALLOCATIONS
+        TrackedFree((void*)Data);
+#elif CTU_CACHING_ALLOCATOR
+        CachedFree((void*)Data);
+#else
         free((void*)Data); 
+#endif
+    }
+
+    /**
+     * @brief allocate memory lined up to more than malloc gives
+     *
+     * @description Align has to be a power of 2, anything under pointer alignment is
+     *              rounded up to it. memory from here can only go back to AlignedFree,
+     *              it never goes through the caching allocator
+     *
+     * @code{.cpp}
+     *
+     * //a cache line each so threads writing to them dont slow each other down
+     * Counter* Counters = Memory::AlignedAlloc<Counter>(sizeof(Counter) * Threads, 64);
+     * Memory::AlignedFree(Counters);
+     *
+     * @endcode
+     *
+     * @return T* null if there wasnt enough memory
+     */
+    template<typename T>
+    CTU_INLINE T* AlignedAlloc(size_t Len, size_t Align)
+    {
+        if(Align < sizeof(void*))
+            Align = sizeof(void*);
+
+#if OS_WINDOWS
+        void* Ret = _aligned_malloc(Len, Align);
+#else
+        void* Ret = nullptr;
+        if(posix_memalign(&Ret, Align, Len) != 0)
+            Ret = nullptr;
+#endif
+
+#if CTU_TRACK_ALLOCATIONS
+        TrackAllocation(Ret, Len);
+#endif
+
+        return (T*)Ret;
+    }
+
+    /**
+     * @brief give back memory from AlignedAlloc, null does nothing
+     */
+    template<typename T>
+    CTU_INLINE void AlignedFree(T* Data)
+    {
+#if CTU_TRACK_ALLOCATIONS
+        TrackFree((void*)Data);
+#endif
+
+#if OS_WINDOWS
+        _aligned_free((void*)Data);
+#else
+        free((void*)Data);
+#endif
+    }
+
+    ///what a prefetched line is going to be used for
+    enum class PrefetchFor
+    {
+        Read,
+        Write,
+    };
+
+    /**
+     * @brief start pulling the cache line holding Ptr in so it is ready when it is used
+     *
+     * @description only a hint, it never faults even on a bad pointer. it only helps
+     *              when the address is known well before it is read, like the next node
+     *              in a chain or an item a few iterations ahead in a random walk
+     */
+    template<typename T>
+    CTU_INLINE void Prefetch(const T* Ptr, PrefetchFor For = PrefetchFor::Read)
+    {
+#if CC_MSVC
+        (void)For;
+        _mm_prefetch((const char*)Ptr, _MM_HINT_T0);
+#else
+        if(For == PrefetchFor::Write)
+            __builtin_prefetch((const void*)Ptr, 1, 3);
+        else
+            __builtin_prefetch((const void*)Ptr, 0, 3);
+#endif
     }
 
     /**
@@ -232,7 +347,9 @@ namespace Memory
     template<typename T>
     U32 AllocSize(T* Block)
     {
-#if OS_WINDOWS
+#if CTU_CACHING_ALLOCATOR
+        return (U32)CachedSize((const void*)Block);
+#elif OS_WINDOWS
         return _msize((void*)Block);
 #elif OS_LINUX
         return malloc_usable_size((void*)Block);
@@ -0,0 +1,455 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Pages.h"
+
+#include "Tracking.h"
+//Memory::TrackAllocation Memory::TrackFree
+
+#include "Meta/Assert.h"
+//ASSERT
+
+#if OS_WINDOWS
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+#if OS_LINUX
+#   include <sys/syscall.h>
+#endif
+
+using namespace Cthulhu;
+using namespace Cthulhu::Memory;
+
+namespace
+{
+
+CTU_INLINE bool Has(PageFlags Flags, PageFlags Which)
+{
+    return (Flags & Which) != PageFlags::None;
+}
+
+CTU_INLINE U64 RoundUp(U64 Size, U64 To)
+{
+    return (Size + To - 1) & ~(To - 1);
+}
+
+//huge page mappings are rounded to huge pages at both ends so map and unmap agree
+U64 MappedSize(U64 Size, PageFlags Flags)
+{
+    return RoundUp(Size == 0 ? 1 : Size, Has(Flags, PageFlags::HugePages) ? HugePageSize : PageSize());
+}
+
+#if OS_LINUX
+//from linux/mempolicy.h, which isnt always installed
+constexpr int PolicyBind = 2;
+constexpr unsigned PolicyMove = (1 << 1);
+#endif
+
+#if !OS_WINDOWS
+
+//reserved ranges dont count against overcommit limits until they are committed
+#   ifdef MAP_NORESERVE
+constexpr int NoReserve = MAP_NORESERVE;
+#   else
+constexpr int NoReserve = 0;
+#   endif
+
+void* MapAnonymous(U64 Size, int Extra)
+{
+    void* Ret = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | Extra, -1, 0);
+    return Ret == MAP_FAILED ? nullptr : Ret;
+}
+
+//map Size bytes lined up to Align by mapping extra and trimming both ends
+Byte* MapAligned(U64 Size, U64 Align)
+{
+    Byte* Ret = (Byte*)MapAnonymous(Size + Align, 0);
+
+    if(Ret == nullptr)
+        return nullptr;
+
+    const U64 Front = RoundUp((U64)Ret, Align) - (U64)Ret;
+
+    if(Front != 0)
+        munmap(Ret, Front);
+
+    if(Align - Front != 0)
+        munmap(Ret + Front + Size, Align - Front);
+
+    return Ret + Front;
+}
+
+#endif
+
+//touch every page so they are faulted in on the node they were bound to
+void Touch(void* Ptr, U64 Size)
+{
+    const U64 Step = PageSize();
+
+    for(U64 I = 0; I < Size; I += Step)
+        ((volatile Byte*)Ptr)[I] = 0;
+}
+
+}
+
+U64 Cthulhu::Memory::PageSize()
+{
+#if OS_WINDOWS
+    static const U64 Size = []{
+        SYSTEM_INFO Info;
+        GetSystemInfo(&Info);
+        return (U64)Info.dwPageSize;
+    }();
+#else
+    static const U64 Size = (U64)sysconf(_SC_PAGESIZE);
+#endif
+
+    return Size;
+}
+
+void* Cthulhu::Memory::MapPages(U64 Size, PageFlags Flags, U32 Node)
+{
+    Size = MappedSize(Size, Flags);
+
+    //binding has to happen before the pages are touched so populating waits until after
+    const bool Bind = Node != AnyNode;
+    const bool Populate = Has(Flags, PageFlags::Populate);
+
+    void* Ret = nullptr;
+
+#if OS_WINDOWS
+    const DWORD Type = MEM_RESERVE | MEM_COMMIT;
+
+    //large pages need a privilege most accounts dont have so this fails quietly without it
+    if(Has(Flags, PageFlags::HugePages) && GetLargePageMinimum() != 0 && Size % GetLargePageMinimum() == 0)
+    {
+        Ret = Bind
+            ? VirtualAllocExNuma(GetCurrentProcess(), nullptr, Size, Type | MEM_LARGE_PAGES, PAGE_READWRITE, Node)
+            : VirtualAlloc(nullptr, Size, Type | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+
+    if(Ret == nullptr)
+    {
+        Ret = Bind
+            ? VirtualAllocExNuma(GetCurrentProcess(), nullptr, Size, Type, PAGE_READWRITE, Node)
+            : VirtualAlloc(nullptr, Size, Type, PAGE_READWRITE);
+    }
+
+    if(Ret == nullptr)
+        return nullptr;
+#else
+    if(Has(Flags, PageFlags::HugePages))
+    {
+#   ifdef MAP_HUGETLB
+        //only works if the system has huge pages reserved
+        Ret = MapAnonymous(Size, MAP_HUGETLB | (Populate && !Bind ? MAP_POPULATE : 0));
+#   endif
+
+        //otherwise line it up so transparent huge pages can back it
+        if(Ret == nullptr)
+        {
+            Ret = MapAligned(Size, HugePageSize);
+
+#   ifdef MADV_HUGEPAGE
+            if(Ret != nullptr)
+                madvise(Ret, Size, MADV_HUGEPAGE);
+#   endif
+        }
+    }
+    else
+    {
+#   ifdef MAP_POPULATE
+        Ret = MapAnonymous(Size, Populate && !Bind ? MAP_POPULATE : 0);
+#   else
+        Ret = MapAnonymous(Size, 0);
+#   endif
+    }
+
+    if(Ret == nullptr)
+        return nullptr;
+
+    if(Bind)
+        BindToNode(Ret, Size, Node);
+#endif
+
+    if(Populate)
+        Touch(Ret, Size);
+
+    TrackAllocation(Ret, Size);
+
+    return Ret;
+}
+
+void Cthulhu::Memory::UnmapPages(void* Ptr, U64 Size, PageFlags Flags)
+{
+    if(Ptr == nullptr)
+        return;
+
+    TrackFree(Ptr);
+
+#if OS_WINDOWS
+    (void)Size;
+    (void)Flags;
+    VirtualFree(Ptr, 0, MEM_RELEASE);
+#else
+    munmap(Ptr, MappedSize(Size, Flags));
+#endif
+}
+
+void* Cthulhu::Memory::ReservePages(U64 Size)
+{
+    Size = MappedSize(Size, PageFlags::None);
+
+#if OS_WINDOWS
+    return VirtualAlloc(nullptr, Size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* Ret = mmap(nullptr, Size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | NoReserve, -1, 0);
+    return Ret == MAP_FAILED ? nullptr : Ret;
+#endif
+}
+
+bool Cthulhu::Memory::CommitPages(void* Ptr, U64 Size)
+{
+    const U64 Page = PageSize();
+    Byte* Start = (Byte*)((U64)Ptr & ~(Page - 1));
+    const U64 Length = RoundUp((U64)Ptr + Size, Page) - (U64)Start;
+
+#if OS_WINDOWS
+    return VirtualAlloc(Start, Length, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(Start, Length, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void Cthulhu::Memory::DecommitPages(void* Ptr, U64 Size)
+{
+    const U64 Page = PageSize();
+    Byte* Start = (Byte*)RoundUp((U64)Ptr, Page);
+    Byte* End = (Byte*)(((U64)Ptr + Size) & ~(Page - 1));
+
+    if(End <= Start)
+        return;
+
+#if OS_WINDOWS
+    VirtualFree(Start, End - Start, MEM_DECOMMIT);
+#else
+    //mapping over the top drops the pages and the commit charge in one go
+    mmap(Start, End - Start, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | NoReserve, -1, 0);
+#endif
+}
+
+U32 Cthulhu::Memory::NodeCount()
+{
+    static const U32 Count = []{
+#if OS_WINDOWS
+        ULONG Highest = 0;
+        return GetNumaHighestNodeNumber(&Highest) ? (U32)Highest + 1 : 1U;
+#elif OS_LINUX
+        //a list of ranges like 0-3,5 so the last number is the highest node
+        FILE* Online = fopen("/sys/devices/system/node/online", "r");
+
+        if(Online == nullptr)
+            return 1U;
+
+        U32 Highest = 0;
+        U32 Current = 0;
+        int Letter;
+
+        while((Letter = fgetc(Online)) != EOF)
+        {
+            if(Letter >= '0' && Letter <= '9')
+            {
+                Current = Current * 10 + (U32)(Letter - '0');
+            }
+            else
+            {
+                Highest = Current > Highest ? Current : Highest;
+                Current = 0;
+            }
+        }
+
+        fclose(Online);
+
+        Highest = Current > Highest ? Current : Highest;
+
+        return Highest + 1;
+#else
+        return 1U;
+#endif
+    }();
+
+    return Count;
+}
+
+U32 Cthulhu::Memory::LocalNode()
+{
+    if(NodeCount() == 1)
+        return 0;
+
+#if OS_WINDOWS
+    PROCESSOR_NUMBER Processor;
+    GetCurrentProcessorNumberEx(&Processor);
+
+    USHORT Node = 0;
+    return GetNumaProcessorNodeEx(&Processor, &Node) ? (U32)Node : 0U;
+#elif OS_LINUX
+    unsigned Cpu = 0;
+    unsigned Node = 0;
+    return syscall(SYS_getcpu, &Cpu, &Node, nullptr) == 0 ? (U32)Node : 0U;
+#else
+    return 0;
+#endif
+}
+
+bool Cthulhu::Memory::BindToNode(void* Ptr, U64 Size, U32 Node)
+{
+    if(Node >= NodeCount())
+        return false;
+
+    if(NodeCount() == 1)
+        return true;
+
+#if OS_LINUX
+    //one word of mask covers every node we can name
+    if(Node >= 64)
+        return false;
+
+    const U64 Page = PageSize();
+    const U64 Start = (U64)Ptr & ~(Page - 1);
+    const U64 End = RoundUp((U64)Ptr + Size, Page);
+
+    unsigned long Mask = 1UL << Node;
+
+    //the kernel reads one less bit than it is told to
+    return syscall(SYS_mbind, Start, End - Start, PolicyBind, &Mask, sizeof(Mask) * 8 + 1, PolicyMove) == 0;
+#else
+    //windows picks the node when memory is mapped, everything else has no numa api
+    (void)Ptr;
+    (void)Size;
+    return false;
+#endif
+}
+
+bool Cthulhu::Memory::Advise(void* Ptr, U64 Size, Advice How)
+{
+    const U64 Page = PageSize();
+    Byte* Start = (Byte*)((U64)Ptr & ~(Page - 1));
+    const U64 Length = RoundUp((U64)Ptr + Size, Page) - (U64)Start;
+
+#if OS_WINDOWS
+    switch(How)
+    {
+    case Advice::WillNeed:
+    {
+        WIN32_MEMORY_RANGE_ENTRY Range = { Start, Length };
+        return PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0) != 0;
+    }
+    case Advice::DontNeed:
+        //resetting keeps the pages mapped but lets the system throw the contents away
+        return VirtualAlloc(Start, Length, MEM_RESET, PAGE_READWRITE) != nullptr;
+    case Advice::Normal:
+        return true;
+    default:
+        return false;
+    }
+#else
+    int Native;
+
+    switch(How)
+    {
+    case Advice::Normal: Native = MADV_NORMAL; break;
+    case Advice::Sequential: Native = MADV_SEQUENTIAL; break;
+    case Advice::Random: Native = MADV_RANDOM; break;
+    case Advice::WillNeed: Native = MADV_WILLNEED; break;
+    case Advice::DontNeed: Native = MADV_DONTNEED; break;
+#   ifdef MADV_HUGEPAGE
+    case Advice::HugePages: Native = MADV_HUGEPAGE; break;
+    case Advice::NoHugePages: Native = MADV_NOHUGEPAGE; break;
+#   endif
+    default: return false;
+    }
+
+    return madvise(Start, Length, Native) == 0;
+#endif
+}
+
+bool Cthulhu::Memory::PageAllocator::Mapped(U64 Size, U64 Align) const
+{
+    return Size >= MinMapped && Align <= PageSize();
+}
+
+void* Cthulhu::Memory::PageAllocator::Allocate(U64 Size, U64 Align)
+{
+    if(!Mapped(Size, Align))
+        return Heap().Allocate(Size, Align);
+
+    void* Ret = MapPages(Size, Flags, Node);
+    ASSERT(Ret != nullptr, "PageAllocator ran out of memory");
+
+    return Ret;
+}
+
+void Cthulhu::Memory::PageAllocator::Deallocate(void* Ptr, U64 Size, U64 Align)
+{
+    if(!Mapped(Size, Align))
+        return Heap().Deallocate(Ptr, Size, Align);
+
+    UnmapPages(Ptr, Size, Flags);
+}
+
+void* Cthulhu::Memory::PageAllocator::Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align)
+{
+    if(Ptr == nullptr)
+        return Allocate(NewSize, Align);
+
+    const bool WasMapped = Mapped(OldSize, Align);
+    const bool NowMapped = Mapped(NewSize, Align);
+
+    if(!WasMapped && !NowMapped)
+        return Heap().Reallocate(Ptr, OldSize, NewSize, Align);
+
+    //the pages already there might be enough
+    if(WasMapped && NowMapped && MappedSize(NewSize, Flags) == MappedSize(OldSize, Flags))
+        return Ptr;
+
+#if OS_LINUX
+    //the kernel can move the pages rather than copying them, huge pages would lose their alignment
+    if(WasMapped && NowMapped && !Has(Flags, PageFlags::HugePages))
+    {
+        void* Ret = mremap(Ptr, MappedSize(OldSize, Flags), MappedSize(NewSize, Flags), MREMAP_MAYMOVE);
+
+        if(Ret != MAP_FAILED)
+        {
+            TrackFree(Ptr);
+            TrackAllocation(Ret, MappedSize(NewSize, Flags));
+
+            return Ret;
+        }
+    }
+#endif
+
+    void* Ret = Allocate(NewSize, Align);
+    //Memory::Copy only takes 32 bit lengths and these can be far bigger
+    memcpy(Ret, Ptr, OldSize < NewSize ? OldSize : NewSize);
+    Deallocate(Ptr, OldSize, Align);
+
+    return Ret;
+}
@@ -0,0 +1,219 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U32 U64
+
+#include "Allocator.h"
+//Memory::Allocator
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+///the size of a huge page on every platform that has them in the default setup
+constexpr U64 HugePageSize = 2 * 1024 * 1024;
+
+///let the system pick the numa node, which is usually whichever first touches a page
+constexpr U32 AnyNode = ~0U;
+
+enum class PageFlags : U32
+{
+    None = 0,
+
+    /**
+     * back the pages with 2mb pages so big tables take far fewer tlb entries. reserved
+     * huge pages are tried first, then transparent huge pages, then normal pages, so
+     * asking never fails just because the system has none set up
+     */
+    HugePages = (1 << 0),
+
+    ///fault every page in now rather than on first touch
+    Populate = (1 << 1),
+};
+
+//Traits/Flags.h would catch every enum in scope, plain enums like AsciiClass included
+CTU_INLINE constexpr PageFlags operator|(PageFlags Left, PageFlags Right) { return (PageFlags)((U32)Left | (U32)Right); }
+CTU_INLINE constexpr PageFlags operator&(PageFlags Left, PageFlags Right) { return (PageFlags)((U32)Left & (U32)Right); }
+
+/**
+ * @brief the size of a normal page
+ */
+U64 PageSize();
+
+/**
+ * @brief map fresh zeroed pages straight from the system
+ *
+ * @description Size is rounded up to a whole page, or a whole huge page if HugePages is
+ *              set. the result is lined up to the same size. when Node is set the pages
+ *              are bound to that numa node before they are touched
+ *
+ * @code{.cpp}
+ *
+ * //a big lookup table on the node this thread is running on
+ * U64* Table = (U64*)Memory::MapPages(1 << 30, Memory::PageFlags::HugePages, Memory::LocalNode());
+ * Memory::UnmapPages(Table, 1 << 30, Memory::PageFlags::HugePages);
+ *
+ * @endcode
+ *
+ * @return void* null if the system is out of memory or address space
+ */
+void* MapPages(U64 Size, PageFlags Flags = PageFlags::None, U32 Node = AnyNode);
+
+/**
+ * @brief give back pages from MapPages, Size and Flags have to be what they were mapped with
+ *
+ * @description also gives back a whole range from ReservePages, committed or not
+ */
+void UnmapPages(void* Ptr, U64 Size, PageFlags Flags = PageFlags::None);
+
+/**
+ * @brief claim a range of address space without any memory behind it
+ *
+ * @description touching the range faults until it is committed with CommitPages.
+ *              reserving costs nothing but address space so ranges far bigger than
+ *              the machines memory are fine. give it back with UnmapPages
+ *
+ * @code{.cpp}
+ *
+ * //room for 64gb that only uses memory as it is committed
+ * Byte* Range = (Byte*)Memory::ReservePages(64ULL << 30);
+ * Memory::CommitPages(Range, 1 << 20);
+ * Range[0] = 1;
+ *
+ * Memory::DecommitPages(Range, 1 << 20);
+ * Memory::UnmapPages(Range, 64ULL << 30);
+ *
+ * @endcode
+ *
+ * @return void* null if there isnt enough address space
+ */
+void* ReservePages(U64 Size);
+
+/**
+ * @brief back part of a reserved range with zeroed memory
+ *
+ * @description Ptr and Size are widened to whole pages
+ *
+ * @return bool false if the system is out of memory
+ */
+bool CommitPages(void* Ptr, U64 Size);
+
+/**
+ * @brief give the memory behind part of a reserved range back, the addresses stay reserved
+ *
+ * @description only pages entirely inside the range are given back. committing them
+ *              again later gives zeroed pages
+ */
+void DecommitPages(void* Ptr, U64 Size);
+
+/**
+ * @brief how many numa nodes the machine has, 1 on machines without numa
+ */
+U32 NodeCount();
+
+/**
+ * @brief the numa node the calling thread is running on right now
+ */
+U32 LocalNode();
+
+/**
+ * @brief keep pages on one numa node, moving any that are already somewhere else
+ *
+ * @description does nothing when there is only one node
+ *
+ * @return bool false if the node doesnt exist or the system refused
+ */
+bool BindToNode(void* Ptr, U64 Size, U32 Node);
+
+///how memory is about to be used, for Advise
+enum class Advice
+{
+    Normal,
+
+    ///read front to back so read further ahead
+    Sequential,
+
+    ///read all over the place so dont bother reading ahead
+    Random,
+
+    ///going to be used soon, start faulting it in
+    WillNeed,
+
+    ///not needed any more, the pages read as zero afterwards
+    DontNeed,
+
+    ///prefer transparent huge pages for the range
+    HugePages,
+
+    ///never use transparent huge pages for the range
+    NoHugePages,
+};
+
+/**
+ * @brief tell the system how a range of pages is going to be used
+ *
+ * @description the range is widened to whole pages
+ *
+ * @return bool false if the system doesnt support the advice or refused it
+ */
+bool Advise(void* Ptr, U64 Size, Advice How);
+
+/**
+ * @brief an allocator that maps big blocks straight from the system with page flags
+ *        and a numa node
+ *
+ * @description anything under MinMapped goes to the heap instead so containers that
+ *              also make small allocations can still use it. meant for a few big
+ *              blocks like the storage of a large Array or Binary
+ *
+ * @code{.cpp}
+ *
+ * Memory::PageAllocator Huge(Memory::PageFlags::HugePages, Memory::LocalNode());
+ * Array<U64> Table(Huge);
+ *
+ * @endcode
+ */
+struct PageAllocator final : Allocator
+{
+    ///smaller allocations go to the heap rather than taking whole pages
+    static constexpr U64 MinMapped = 64 * 1024;
+
+    PageAllocator(PageFlags InFlags = PageFlags::None, U32 InNode = AnyNode)
+        : Flags(InFlags)
+        , Node(InNode)
+    {}
+
+    virtual void* Allocate(U64 Size, U64 Align = DefaultAlign) override;
+    virtual void Deallocate(void* Ptr, U64 Size, U64 Align = DefaultAlign) override;
+    virtual void* Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align = DefaultAlign) override;
+
+private:
+    bool Mapped(U64 Size, U64 Align) const;
+
+    PageFlags Flags;
+    U32 Node;
+};
+
+}
+
+}
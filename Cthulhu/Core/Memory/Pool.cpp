@@ -0,0 +1,368 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Pool.h"
+
+#include "Meta/Assert.h"
+//ASSERT
+
+#include "Core/Types/Mutex.h"
+//Mutex ScopeLock
+
+#include "Memory.h"
+//Memory::AlignedAlloc Memory::AlignedFree
+
+#include "Tracking.h"
+//CTU_TRACK_CONTAINER Memory::TagScope
+
+#ifndef CTU_POOL_THREAD_CACHE
+#   define CTU_POOL_THREAD_CACHE 1
+#endif
+
+using namespace Cthulhu;
+using namespace Cthulhu::Memory;
+using Cthulhu::Memory::Private::Slab;
+
+namespace
+{
+
+//slabs are aligned to their size so a block can find its slab by masking its address
+Byte* AllocSlab(U32 Size)
+{
+    //slabs are shared by everything using the pool so they get a tag of their own
+    CTU_TRACK_CONTAINER(Pool);
+    return Memory::AlignedAlloc<Byte>(Size, Size);
+}
+
+void FreeSlab(Slab* Which)
+{
+    Memory::AlignedFree(Which);
+}
+
+//empty out a slab so it can be handed out from the start again
+void ResetSlab(Slab* Which)
+{
+    Which->FreeList = nullptr;
+    Which->Next = (Byte*)(Which + 1);
+    Which->Used = 0;
+}
+
+}
+
+Cthulhu::Memory::SlabPool::SlabPool(U32 BlockSize, U32 Align, U32 InSlabSize)
+    : Available(nullptr)
+    , Spare(nullptr)
+    , Newest(nullptr)
+    , Count(0)
+    , Slabs(0)
+{
+    ASSERT((Align & (Align - 1)) == 0 && Align <= CacheLine, "SlabPool alignment has to be a power of 2 no bigger than a cache line");
+
+    //every free block holds the next one in the free list
+    const U32 Size = BlockSize < sizeof(void*) ? (U32)sizeof(void*) : BlockSize;
+    BlockStride = (Size + Align - 1) & ~(Align - 1);
+
+    const U64 Smallest = sizeof(Slab) + BlockStride * 8ULL;
+
+    SlabSize = CacheLine * 2;
+    while(SlabSize < InSlabSize || SlabSize < Smallest)
+        SlabSize *= 2;
+}
+
+Cthulhu::Memory::SlabPool::~SlabPool()
+{
+    for(Slab* Current = Newest; Current != nullptr;)
+    {
+        Slab* Older = Current->Older;
+        FreeSlab(Current);
+        Current = Older;
+    }
+}
+
+Slab* Cthulhu::Memory::SlabPool::AddSlab()
+{
+    Slab* Made = Spare;
+
+    if(Made != nullptr)
+    {
+        Spare = nullptr;
+    }
+    else
+    {
+        Made = (Slab*)AllocSlab(SlabSize);
+        ASSERT(Made != nullptr, "SlabPool ran out of memory");
+
+        Made->Capacity = (SlabSize - sizeof(Slab)) / BlockStride;
+
+        Made->Older = Newest;
+        Made->Newer = nullptr;
+
+        if(Newest != nullptr)
+            Newest->Newer = Made;
+
+        Newest = Made;
+        Slabs++;
+    }
+
+    ResetSlab(Made);
+
+    Made->Prev = nullptr;
+    Made->After = nullptr;
+    Made->Listed = true;
+
+    Available = Made;
+
+    return Made;
+}
+
+void Cthulhu::Memory::SlabPool::Unlist(Slab* Full)
+{
+    if(Full->Prev != nullptr)
+        Full->Prev->After = Full->After;
+    else
+        Available = Full->After;
+
+    if(Full->After != nullptr)
+        Full->After->Prev = Full->Prev;
+
+    Full->Listed = false;
+}
+
+void Cthulhu::Memory::SlabPool::Changed(Slab* Owner)
+{
+    //the front slab stays even when its empty so a single block going back and forth
+    //never leaves the fast path, it only goes once another slab takes its place
+    if(Owner->Listed)
+    {
+        if(Owner->Used == 0 && Owner != Available)
+            Retire(Owner);
+
+        return;
+    }
+
+    //a slab that was full goes to the front so the block just freed is the next one used
+    Slab* Front = Available;
+
+    Owner->Prev = nullptr;
+    Owner->After = Front;
+    Owner->Listed = true;
+
+    Available = Owner;
+
+    if(Front != nullptr)
+    {
+        Front->Prev = Owner;
+
+        if(Front->Used == 0)
+            Retire(Front);
+    }
+}
+
+void Cthulhu::Memory::SlabPool::Retire(Slab* Empty)
+{
+    Unlist(Empty);
+
+    //one empty slab is kept as the spare, any more than that go back to the system
+    if(Spare == nullptr)
+    {
+        ResetSlab(Empty);
+        Spare = Empty;
+        return;
+    }
+
+    if(Empty->Newer != nullptr)
+        Empty->Newer->Older = Empty->Older;
+    else
+        Newest = Empty->Older;
+
+    if(Empty->Older != nullptr)
+        Empty->Older->Newer = Empty->Newer;
+
+    FreeSlab(Empty);
+    Slabs--;
+}
+
+namespace
+{
+
+constexpr U32 ClassSize = 16;
+constexpr U32 Classes = MaxPoolBlock / ClassSize;
+
+//how many blocks move between a thread cache and the shared pool at once
+constexpr U32 Batch = 32;
+
+CTU_INLINE U32 ClassOf(U32 Size)
+{
+    return Size == 0 ? 0 : (Size - 1) / ClassSize;
+}
+
+struct SharedPool
+{
+    SharedPool(U32 Size)
+        : Blocks(Size, DefaultAlign, 64 * 1024)
+    {}
+
+    Mutex Lock;
+    SlabPool Blocks;
+};
+
+//the pools live forever so anything freed during static destruction still has somewhere to go
+SharedPool* Pools()
+{
+    alignas(SharedPool) static Byte Storage[Classes][sizeof(SharedPool)];
+
+    static SharedPool* All = [] {
+        for(U32 I = 0; I < Classes; I++)
+            new (Storage[I]) SharedPool((I + 1) * ClassSize);
+
+        return (SharedPool*)Storage;
+    }();
+
+    return All;
+}
+
+#if CTU_POOL_THREAD_CACHE
+
+/**
+ * free blocks this thread can hand out without taking a lock, linked through their
+ * first pointer the same way a slabs free list is. when a thread exits they all go back
+ */
+struct ThreadCache
+{
+    void* Heads[Classes];
+    U32 Counts[Classes];
+
+    //anything freed after this threads cache was destroyed goes straight to the pools
+    bool Dead;
+
+    ~ThreadCache()
+    {
+        for(U32 I = 0; I < Classes; I++)
+            Flush(I, Counts[I]);
+
+        Dead = true;
+    }
+
+    void Flush(U32 Class, U32 Amount)
+    {
+        if(Amount == 0)
+            return;
+
+        SharedPool& Into = Pools()[Class];
+        ScopeLock Guard(Into.Lock);
+
+        for(U32 I = 0; I < Amount; I++)
+        {
+            void* Block = Heads[Class];
+            Heads[Class] = *(void**)Block;
+            Into.Blocks.Free(Block);
+        }
+
+        Counts[Class] -= Amount;
+    }
+
+    void* Refill(U32 Class)
+    {
+        SharedPool& From = Pools()[Class];
+        ScopeLock Guard(From.Lock);
+
+        //the shared pools keep their slabs until exit so the leak report skips them
+        TagScope Scope(Tags::Lifetime);
+
+        //keep 1 to return and put the rest in the cache
+        for(U32 I = 1; I < Batch; I++)
+        {
+            void* Block = From.Blocks.Alloc();
+            *(void**)Block = Heads[Class];
+            Heads[Class] = Block;
+        }
+
+        Counts[Class] += Batch - 1;
+
+        return From.Blocks.Alloc();
+    }
+};
+
+thread_local ThreadCache Cache;
+
+#endif
+
+}
+
+void* Cthulhu::Memory::PoolAlloc(U32 Size)
+{
+    if(Size > MaxPoolBlock)
+        return new Byte[Size];
+
+    const U32 Class = ClassOf(Size);
+
+#if CTU_POOL_THREAD_CACHE
+    ThreadCache& Local = Cache;
+
+    if(!Local.Dead)
+    {
+        void* Ret = Local.Heads[Class];
+
+        if(Ret == nullptr)
+            return Local.Refill(Class);
+
+        Local.Heads[Class] = *(void**)Ret;
+        Local.Counts[Class]--;
+
+        return Ret;
+    }
+#endif
+
+    SharedPool& From = Pools()[Class];
+    ScopeLock Guard(From.Lock);
+    TagScope Scope(Tags::Lifetime);
+
+    return From.Blocks.Alloc();
+}
+
+void Cthulhu::Memory::PoolFree(void* Block, U32 Size)
+{
+    if(Block == nullptr)
+        return;
+
+    if(Size > MaxPoolBlock)
+    {
+        delete[] (Byte*)Block;
+        return;
+    }
+
+    const U32 Class = ClassOf(Size);
+
+#if CTU_POOL_THREAD_CACHE
+    ThreadCache& Local = Cache;
+
+    if(!Local.Dead)
+    {
+        *(void**)Block = Local.Heads[Class];
+        Local.Heads[Class] = Block;
+
+        //a thread that only frees hands most of what it collects back
+        if(++Local.Counts[Class] >= Batch * 2)
+            Local.Flush(Class, Batch);
+
+        return;
+    }
+#endif
+
+    SharedPool& Into = Pools()[Class];
+    ScopeLock Guard(Into.Lock);
+
+    Into.Blocks.Free(Block);
+}
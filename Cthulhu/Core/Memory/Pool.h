@@ -0,0 +1,290 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <new>
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//Byte U32 U64
+
+#include "Core/Traits/Forward.h"
+//Forward
+
+#include "Allocator.h"
+//Memory::DefaultAlign
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+///slabs and their headers start on a cache line so neighbouring slabs never share one
+constexpr U64 CacheLine = 64;
+
+///the biggest block the shared pools hand out, anything bigger goes to the heap
+constexpr U32 MaxPoolBlock = 256;
+
+namespace Private
+{
+    /**
+     * sits at the start of every slab and takes up the first cache line.
+     * blocks are handed out from the free list first then by bumping Next, so a new
+     * slab never has to be threaded into a free list up front
+     */
+    struct alignas(CacheLine) Slab
+    {
+        //neighbours in the list of slabs with free blocks
+        Slab* Prev;
+        Slab* After;
+
+        //neighbours in the list of every slab so the pool can free full ones
+        Slab* Older;
+        Slab* Newer;
+
+        void* FreeList;
+        Byte* Next;
+
+        U32 Used;
+        U32 Capacity;
+
+        bool Listed;
+    };
+}
+
+/**
+ * @brief hands out fixed size blocks from slabs with a free list each
+ *
+ * @description every slab is SlabSize bytes and aligned to SlabSize, so freeing a block
+ *              finds its slab by masking the pointer and never has to search. slabs with
+ *              free blocks are kept in a list, the front one is always used first so
+ *              allocation is taking the head of one free list. the front slab is kept
+ *              even when it empties and one more empty slab is kept spare, so churn
+ *              doesnt keep asking the system for memory. other empty slabs are given back.
+ *
+ *              a SlabPool is only safe to use from one thread at a time, see PoolNew
+ *              for pools that any thread can use
+ *
+ * @code{.cpp}
+ *
+ * Memory::SlabPool Nodes(sizeof(Node), alignof(Node));
+ *
+ * void* Block = Nodes.Alloc();
+ * Nodes.Free(Block);
+ *
+ * @endcode
+ */
+struct SlabPool
+{
+    /**
+     * @param BlockSize how big every block is, rounded up to fit a pointer
+     * @param Align has to be a power of 2 no bigger than a cache line
+     * @param SlabSize rounded up to a power of 2 that fits at least 8 blocks
+     */
+    SlabPool(U32 BlockSize, U32 Align = DefaultAlign, U32 SlabSize = 16 * 1024);
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    /**
+     * @brief frees every slab, anything still allocated is gone without being destroyed
+     */
+    ~SlabPool();
+
+    /**
+     * @brief get a block, never null
+     */
+    CTU_INLINE void* Alloc()
+    {
+        Private::Slab* From = Available;
+
+        if(From == nullptr)
+            From = AddSlab();
+
+        void* Ret = From->FreeList;
+
+        if(Ret != nullptr)
+        {
+            From->FreeList = *(void**)Ret;
+        }
+        else
+        {
+            Ret = From->Next;
+            From->Next += BlockStride;
+        }
+
+        Count++;
+
+        if(++From->Used == From->Capacity)
+            Unlist(From);
+
+        return Ret;
+    }
+
+    /**
+     * @brief give back a block that came from this pool
+     */
+    CTU_INLINE void Free(void* Block)
+    {
+        Private::Slab* Owner = SlabOf(Block);
+
+        *(void**)Block = Owner->FreeList;
+        Owner->FreeList = Block;
+
+        Count--;
+
+        //a full slab has space again or a slab has nothing left in it
+        if(Owner->Used-- == Owner->Capacity || Owner->Used == 0)
+            Changed(Owner);
+    }
+
+    /**
+     * @brief how many blocks are handed out right now
+     */
+    U64 Used() const { return Count; }
+
+    /**
+     * @brief how many bytes of slabs the pool is holding onto
+     */
+    U64 Reserved() const { return Slabs * (U64)SlabSize; }
+
+    /**
+     * @brief how far apart blocks are, at least the block size asked for
+     */
+    U32 Stride() const { return BlockStride; }
+
+private:
+    CTU_INLINE Private::Slab* SlabOf(void* Block) const
+    {
+        return (Private::Slab*)((U64)Block & ~((U64)SlabSize - 1));
+    }
+
+    Private::Slab* AddSlab();
+    void Unlist(Private::Slab* Full);
+    void Changed(Private::Slab* Owner);
+    void Retire(Private::Slab* Empty);
+
+    //slabs with at least 1 free block, the front one is allocated from
+    Private::Slab* Available;
+
+    //an empty slab kept back for when the next one is needed
+    Private::Slab* Spare;
+
+    //the newest slab in the list of all of them, including the spare
+    Private::Slab* Newest;
+
+    U64 Count;
+    U64 Slabs;
+
+    U32 BlockStride;
+    U32 SlabSize;
+};
+
+/**
+ * @brief a SlabPool for one type
+ *
+ * @code{.cpp}
+ *
+ * Memory::Pool<Node> Nodes;
+ *
+ * Node* Item = Nodes.New(Key, Value);
+ * Nodes.Delete(Item);
+ *
+ * @endcode
+ */
+template<typename T>
+struct Pool : SlabPool
+{
+    Pool(U32 SlabSize = 16 * 1024)
+        : SlabPool(sizeof(T), alignof(T), SlabSize)
+    {}
+
+    template<typename... TArgs>
+    CTU_INLINE T* New(TArgs&&... Args)
+    {
+        return new (Alloc()) T(Forward<TArgs>(Args)...);
+    }
+
+    CTU_INLINE void Delete(T* Item)
+    {
+        Item->~T();
+        Free(Item);
+    }
+};
+
+/**
+ * @brief get a block from the pool shared by everything Size bytes or smaller
+ *
+ * @description there is a shared pool for every 16 bytes of size up to MaxPoolBlock,
+ *              anything bigger comes from new. each thread keeps a small cache of free
+ *              blocks for every size so most calls never take the pools lock, a block
+ *              can be freed on any thread no matter which one allocated it.
+ *
+ *              the thread caches can be turned off by building with CTU_POOL_THREAD_CACHE=0,
+ *              then every call takes the lock
+ *
+ * @param Size the same size has to be passed to PoolFree
+ * @return void* aligned to DefaultAlign, never null
+ */
+void* PoolAlloc(U32 Size);
+
+/**
+ * @brief give back a block from PoolAlloc
+ *
+ * @param Block null does nothing
+ * @param Size the size that was passed to PoolAlloc
+ */
+void PoolFree(void* Block, U32 Size);
+
+/**
+ * @brief allocate and construct a T from the shared pools
+ *
+ * @description this is what Map and Rope use for their nodes
+ *
+ * @code{.cpp}
+ *
+ * Node* Item = Memory::PoolNew<Node>(Key, Value);
+ * Memory::PoolDelete(Item);
+ *
+ * @endcode
+ */
+template<typename T, typename... TArgs>
+CTU_INLINE T* PoolNew(TArgs&&... Args)
+{
+    static_assert(alignof(T) <= DefaultAlign, "PoolNew only handles types aligned to DefaultAlign or less");
+
+    return new (PoolAlloc(sizeof(T))) T(Forward<TArgs>(Args)...);
+}
+
+/**
+ * @brief destroy and free something from PoolNew
+ */
+template<typename T>
+CTU_INLINE void PoolDelete(T* Item)
+{
+    if(Item == nullptr)
+        return;
+
+    Item->~T();
+    PoolFree(Item, sizeof(T));
+}
+
+}
+
+}
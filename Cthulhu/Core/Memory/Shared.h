@@ -13,146 +13,606 @@
  *  limitations under the License.
  */
 
+#include <new>
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
 #include "Meta/Aliases.h"
+//Byte U32
+
+#include "Core/Types/Atomic.h"
+//Atomic<T>
+
+#include "Core/Traits/Forward.h"
+//Forward
+
 #include "Deleter.h"
+//Deleter
 
 #pragma once
 
 namespace Cthulhu
 {
 
+template<typename T, bool ThreadSafe> struct Shared;
+template<typename T, bool ThreadSafe> struct Weak;
+
 namespace Private
 {
+    template<typename T, bool ThreadSafe> struct SharedMaker;
 
-template<typename T>
-struct SharedContent
-{
-    T* Content;
-    U64 Refs;
-};
+    template<bool ThreadSafe>
+    struct RefCount;
+
+    template<>
+    struct RefCount<true>
+    {
+        RefCount(U32 Initial) : Value(Initial) {}
+
+        //a new reference cant be the one that frees anything so no ordering is needed
+        CTU_INLINE void Increment() { Value.Add(1, MemoryOrder::Relaxed); }
+
+        //true when that was the last reference, everything the other owners wrote has to be visible by then
+        CTU_INLINE bool Decrement() { return Value.Sub(1, MemoryOrder::AcquireRelease) == 1; }
 
+        //add a reference only if there still is one, used to turn a weak reference into a strong one
+        CTU_INLINE bool IncrementIfAlive()
+        {
+            U32 Now = Value.Load(MemoryOrder::Relaxed);
+
+            while(Now != 0)
+            {
+                if(Value.CompareExchange(Now, Now + 1, MemoryOrder::AcquireRelease))
+                    return true;
+            }
+
+            return false;
+        }
+
+        CTU_INLINE U32 Load() const { return Value.Load(MemoryOrder::Relaxed); }
+
+        //true when this is the only reference left, seeing that means nothing else can add one
+        CTU_INLINE bool Last() const { return Value.Load(MemoryOrder::Acquire) == 1; }
+
+    private:
+        Atomic<U32> Value;
+    };
+
+    template<>
+    struct RefCount<false>
+    {
+        RefCount(U32 Initial) : Value(Initial) {}
+
+        CTU_INLINE void Increment() { Value++; }
+        CTU_INLINE bool Decrement() { return --Value == 0; }
+
+        CTU_INLINE bool IncrementIfAlive()
+        {
+            if(Value == 0)
+                return false;
+
+            Value++;
+            return true;
+        }
+
+        CTU_INLINE U32 Load() const { return Value; }
+        CTU_INLINE bool Last() const { return Value == 1; }
+
+    private:
+        U32 Value;
+    };
+
+    /**
+     * every Shared points at one of these. while there are strong references the weak
+     * count has one extra reference for all of them, so the block itself goes away
+     * once the object is gone and the last Weak lets go
+     */
+    template<bool ThreadSafe>
+    struct ControlBlock
+    {
+        ControlBlock(U32 InitialRefs = 1, bool InIntrusive = false)
+            : Strong(InitialRefs)
+            , Weak(1)
+            , Intrusive(InIntrusive)
+        {}
+
+        ControlBlock(const ControlBlock&) = delete;
+        ControlBlock& operator=(const ControlBlock&) = delete;
+
+        virtual ~ControlBlock() {}
+
+        CTU_INLINE void Acquire() { Strong.Increment(); }
+
+        CTU_INLINE void Release()
+        {
+            if(Strong.Decrement())
+                Expire();
+        }
+
+        //false for blocks that are part of their object, the object and the counts go together
+        //so nothing could watch it. a Shared of a base class hides that from the type system
+        CTU_INLINE bool AcquireWeak()
+        {
+            ASSERT(!Intrusive, "Sharable objects cant have weak references");
+
+            if(Intrusive)
+                return false;
+
+            Weak.Increment();
+            return true;
+        }
+
+        CTU_INLINE void ReleaseWeak()
+        {
+            //without any Weak left this is the last reference so the atomic subtract can be skipped
+            if(Weak.Last() || Weak.Decrement())
+                delete this;
+        }
+
+        //the last strong reference is gone, destroy the object
+        virtual void Expire() = 0;
+
+        RefCount<ThreadSafe> Strong;
+        RefCount<ThreadSafe> Weak;
+
+        //the block is a Sharable object
+        const bool Intrusive;
+    };
+
+    //for objects that were made on their own and handed to a Shared
+    template<typename T, typename TDeleter, bool ThreadSafe>
+    struct PointerBlock final : ControlBlock<ThreadSafe>
+    {
+        PointerBlock(T* InContent)
+            : Content(InContent)
+        {}
+
+        virtual void Expire() override
+        {
+            TDeleter::Delete(Content);
+            this->ReleaseWeak();
+        }
+
+        T* Content;
+    };
+
+    //for objects made by MakeShared, the object lives right after the counts
+    template<typename T, bool ThreadSafe>
+    struct InlineBlock final : ControlBlock<ThreadSafe>
+    {
+        template<typename... TArgs>
+        InlineBlock(TArgs&&... Args)
+        {
+            new (Storage) T(Forward<TArgs>(Args)...);
+        }
+
+        CTU_INLINE T* Get() { return (T*)Storage; }
+
+        virtual void Expire() override
+        {
+            Get()->~T();
+            this->ReleaseWeak();
+        }
+
+        alignas(T) Byte Storage[sizeof(T)];
+    };
+
+    //objects deriving from Sharable are their own control block
+    template<typename T, bool ThreadSafe>
+    CTU_INLINE ControlBlock<ThreadSafe>* BlockFor(T* Content, ControlBlock<ThreadSafe>* Intrusive)
+    {
+        Intrusive->Acquire();
+        return Intrusive;
+    }
+
+    template<typename T, bool ThreadSafe>
+    CTU_INLINE ControlBlock<ThreadSafe>* BlockFor(T* Content, const void*)
+    {
+        return new PointerBlock<T, Deleter<T>, ThreadSafe>(Content);
+    }
 } //Private
 
-template<typename T, typename TDeleter = Deleter<T>>
+/**
+ * @brief a pointer to an object that is destroyed when the last Shared pointing at it goes
+ *
+ * @description copies share a reference count, the object is destroyed by whichever copy
+ *              lets go last. with ThreadSafe set the count is atomic so copies can be made
+ *              and dropped on any thread, LocalShared skips the atomics for objects that
+ *              never leave one thread.
+ *
+ *              MakeShared puts the count and the object in one allocation so prefer it
+ *              over handing in a pointer made with new. moving a Shared never touches the
+ *              count. Weak can watch the object without keeping it alive, and types that
+ *              derive from Sharable keep their count inside themselves
+ *
+ * @code{.cpp}
+ *
+ * Shared<Texture> Atlas = MakeShared<Texture>(1024, 1024);
+ * Shared<Texture> Copy = Atlas; //both point at the same texture
+ *
+ * Weak<Texture> Watcher = Atlas;
+ *
+ * if(Shared<Texture> Still = Watcher.Lock())
+ *     Still->Upload();
+ *
+ * @endcode
+ *
+ * @tparam T what it points to
+ * @tparam ThreadSafe whether the reference count is atomic
+ */
+template<typename T, bool ThreadSafe = true>
 struct Shared
 {
-    Shared(T* InContent)
-        : Content(new SharedContent<T>({ Content, 1 }))
+    Shared()
+        : Content(nullptr)
+        , Control(nullptr)
+    {}
+
+    Shared(decltype(nullptr))
+        : Shared()
+    {}
+
+    /**
+     * @brief take ownership of an object made with new
+     *
+     * @description a Sharable object can be handed in any number of times since the
+     *              count lives in the object, anything else can only be handed in once
+     */
+    explicit Shared(T* InContent)
+        : Content(InContent)
+        , Control(InContent ? Private::BlockFor<T, ThreadSafe>(InContent, InContent) : nullptr)
     {}
 
-    T* Take()
+    /**
+     * @brief take ownership of an object that TDeleter knows how to destroy
+     *
+     * @code{.cpp}
+     *
+     * auto Data = Shared<Byte>::Adopt<Freeer<Byte>>(Memory::Alloc<Byte>(256));
+     *
+     * @endcode
+     */
+    template<typename TDeleter>
+    static Shared Adopt(T* InContent)
     {
-        //increment the refs here so that even once all shared pointers go out of scope
-        //it doesnt trigger the deleter so the pointer is still valid
-        Content->Refs++;
-        return Content->Content;
+        return Shared(InContent, InContent ? new Private::PointerBlock<T, TDeleter, ThreadSafe>(InContent) : nullptr);
     }
 
-    Shared(const Shared& Other)
+    CTU_INLINE Shared(const Shared& Other)
+        : Content(Other.Content)
+        , Control(Other.Control)
     {
-        Content = Other.Content;
-        Content->Refs++;
+        if(Control)
+            Control->Acquire();
     }
 
-    Shared(const Shared* Other)
+    CTU_INLINE Shared(Shared&& Other)
+        : Content(Other.Content)
+        , Control(Other.Control)
     {
-        Content = Other->Content;
-        Content->Refs++;
+        Other.Content = nullptr;
+        Other.Control = nullptr;
     }
 
-    const T operator*() const { *Content->Content; }
-    T operator*() { return *Content->Content; }
+    ///a Shared of a derived type can be used as a Shared of its base
+    template<typename TOther>
+    CTU_INLINE Shared(const Shared<TOther, ThreadSafe>& Other)
+        : Content(Other.Content)
+        , Control(Other.Control)
+    {
+        if(Control)
+            Control->Acquire();
+    }
 
-    const T* operator->() const { return Content->Content; }
-    T* operator->() { return Content->Content; }
+    template<typename TOther>
+    CTU_INLINE Shared(Shared<TOther, ThreadSafe>&& Other)
+        : Content(Other.Content)
+        , Control(Other.Control)
+    {
+        Other.Content = nullptr;
+        Other.Control = nullptr;
+    }
 
-    ~Shared()
+    Shared& operator=(const Shared& Other)
     {
-        if(--Content->Refs == 0)
-        {
-            TDeleter::Delete(Content->Content);
-            delete Content;
-        }
+        Shared(Other).Swap(*this);
+        return *this;
     }
 
-    Shared(const Shared&&) = delete;
+    Shared& operator=(Shared&& Other)
+    {
+        Shared((Shared&&)Other).Swap(*this);
+        return *this;
+    }
+
+    CTU_INLINE ~Shared()
+    {
+        if(Control)
+            Control->Release();
+    }
+
+    /**
+     * @brief let go of the object and point at nothing
+     */
+    void Reset()
+    {
+        Shared().Swap(*this);
+    }
+
+    CTU_INLINE void Swap(Shared& Other)
+    {
+        T* TempContent = Content;
+        Private::ControlBlock<ThreadSafe>* TempControl = Control;
+
+        Content = Other.Content;
+        Control = Other.Control;
+
+        Other.Content = TempContent;
+        Other.Control = TempControl;
+    }
+
+    CTU_INLINE T* Get() const { return Content; }
+
+    CTU_INLINE T& operator*() const { ASSERT(Valid(), "Attempting to deref a null pointer"); return *Content; }
+    CTU_INLINE T* operator->() const { ASSERT(Valid(), "Attempting to deref a null pointer"); return Content; }
+
+    CTU_INLINE bool Valid() const { return Content != nullptr; }
+    CTU_INLINE operator bool() const { return Content != nullptr; }
+
+    /**
+     * @brief how many Shared point at the object, only a hint when other threads have copies
+     */
+    CTU_INLINE U32 Refs() const { return Control ? Control->Strong.Load() : 0; }
+
+    template<typename TOther>
+    CTU_INLINE bool operator==(const Shared<TOther, ThreadSafe>& Other) const { return Content == Other.Get(); }
+
+    template<typename TOther>
+    CTU_INLINE bool operator!=(const Shared<TOther, ThreadSafe>& Other) const { return Content != Other.Get(); }
 
 private:
-    Private::SharedContent<T>* Content;
+    template<typename, bool> friend struct Shared;
+    template<typename, bool> friend struct Weak;
+
+    template<typename, bool> friend struct Private::SharedMaker;
+
+    //takes over a reference that has already been counted
+    CTU_INLINE Shared(T* InContent, Private::ControlBlock<ThreadSafe>* InControl)
+        : Content(InContent)
+        , Control(InControl)
+    {}
+
+    T* Content;
+    Private::ControlBlock<ThreadSafe>* Control;
 };
 
-template<typename T>
-struct Sharable
+/**
+ * @brief watches an object owned by Shared without keeping it alive
+ *
+ * @description Lock gives a Shared to the object if it is still around. the object can
+ *              be destroyed while there are Weak pointing at it, only the small block with
+ *              the counts stays until the last Weak goes. objects deriving from Sharable
+ *              cant be watched since their counts go with them, doing it through a Shared
+ *              of one of their base classes asserts and leaves the Weak empty
+ *
+ * @code{.cpp}
+ *
+ * struct Node
+ * {
+ *     Array<Shared<Node>> Children;
+ *     Weak<Node> Parent; //doesnt keep the parent alive so there is no cycle
+ * };
+ *
+ * @endcode
+ */
+template<typename T, bool ThreadSafe = true>
+struct Weak
 {
-    Sharable()
-        : Contnet(new Content({ this, 1 }))
+    Weak()
+        : Content(nullptr)
+        , Control(nullptr)
     {}
 
-    Shared<T> SharedThis() const { return Content; }
+    template<typename TOther>
+    Weak(const Shared<TOther, ThreadSafe>& Other)
+        : Content(Other.Content)
+        , Control(Other.Control)
+    {
+        static_assert(!__is_base_of(Private::ControlBlock<ThreadSafe>, TOther), "Sharable objects cant have weak references");
 
-private:
-    Private::SharedContent<T>* Content;
-};
+        //a base class of a Sharable object gets past the check above, watch nothing instead
+        if(Control && !Control->AcquireWeak())
+        {
+            Content = nullptr;
+            Control = nullptr;
+        }
+    }
 
-}
+    CTU_INLINE Weak(const Weak& Other)
+        : Content(Other.Content)
+        , Control(Other.Control)
+    {
+        if(Control)
+            Control->AcquireWeak();
+    }
 
-#if 0
+    CTU_INLINE Weak(Weak&& Other)
+        : Content(Other.Content)
+        , Control(Other.Control)
+    {
+        Other.Content = nullptr;
+        Other.Control = nullptr;
+    }
 
-//TODO: document
+    Weak& operator=(const Weak& Other)
+    {
+        Weak(Other).Swap(*this);
+        return *this;
+    }
 
-namespace Cthulhu
-{
+    Weak& operator=(Weak&& Other)
+    {
+        Weak((Weak&&)Other).Swap(*this);
+        return *this;
+    }
 
-template<typename T>
-class SharedContent
-{
-    U32 Refs;
+    CTU_INLINE ~Weak()
+    {
+        if(Control)
+            Control->ReleaseWeak();
+    }
+
+    /**
+     * @brief get a Shared to the object, or an empty one if it has been destroyed
+     */
+    Shared<T, ThreadSafe> Lock() const
+    {
+        if(Control && Control->Strong.IncrementIfAlive())
+            return Shared<T, ThreadSafe>(Content, Control);
+
+        return Shared<T, ThreadSafe>();
+    }
+
+    /**
+     * @brief true once the object is gone, a false result can be out of date straight away on another thread
+     */
+    CTU_INLINE bool Expired() const { return Control == nullptr || Control->Strong.Load() == 0; }
+
+    CTU_INLINE void Swap(Weak& Other)
+    {
+        T* TempContent = Content;
+        Private::ControlBlock<ThreadSafe>* TempControl = Control;
+
+        Content = Other.Content;
+        Control = Other.Control;
+
+        Other.Content = TempContent;
+        Other.Control = TempControl;
+    }
+
+private:
     T* Content;
+    Private::ControlBlock<ThreadSafe>* Control;
 };
 
 /**
- * 
+ * @brief a base for types that keep their own reference count
+ *
+ * @description a Sharable object needs no separate block for its count, so a Shared can
+ *              be made from a plain pointer to it at any time including from inside its
+ *              own methods with SharedThis. it is deleted with delete when the last Shared
+ *              goes so it has to have been made with new or MakeShared. copying the object
+ *              doesnt copy the count
+ *
+ * @code{.cpp}
+ *
+ * struct Connection : Sharable<Connection>
+ * {
+ *     void Start() { Loop.Watch(SharedThis()); }
+ * };
+ *
+ * Shared<Connection> Client = MakeShared<Connection>();
+ * Client->Start();
+ *
+ * @endcode
+ *
+ * @tparam T the type deriving from this
+ * @tparam ThreadSafe whether the reference count is atomic
  */
-template<typename T>
-class SharedPtr
+template<typename T, bool ThreadSafe = true>
+struct Sharable : Private::ControlBlock<ThreadSafe>
 {
-    /**Shared content
-     * should never be null
+    /**
+     * @brief a Shared to this object, it has to already be owned by a Shared or have been made with new
+     */
+    Shared<T, ThreadSafe> SharedThis() { return Shared<T, ThreadSafe>(static_cast<T*>(this)); }
+
+    /**
+     * @brief how many Shared point at this object
      */
-    SharedContent<T>* Content;
-public:
-    SharedPtr(T* Item)
-        : Content(new SharedContent<T>{1, Item})
+    CTU_INLINE U32 Refs() const { return this->Strong.Load(); }
+
+protected:
+    //nothing owns the object until the first Shared is made from it
+    Sharable()
+        : Private::ControlBlock<ThreadSafe>(0, true)
     {}
 
-    SharedPtr(const SharedPtr& Other)
-        : Content(Other.Content)
-    {
-        Content->Refs++;
-    }
+    Sharable(const Sharable&)
+        : Private::ControlBlock<ThreadSafe>(0, true)
+    {}
 
-    SharedPtr(const SharedPtr* Other)
-        : Content(Other->Content)
+    Sharable& operator=(const Sharable&) { return *this; }
+
+private:
+    //the count lives in the object so they go together
+    virtual void Expire() override
     {
-        Content->Refs++;
+        delete static_cast<T*>(this);
     }
+};
 
-    ~SharedPtr()
+namespace Private
+{
+    template<typename T, bool ThreadSafe>
+    struct SharedMaker
     {
-        Content->Refs--;
-        if(Content->Refs <= 0)
+        //Sharable objects carry their own count so they only need the object itself
+        template<typename... TArgs>
+        static Shared<T, ThreadSafe> Make(ControlBlock<ThreadSafe>*, TArgs&&... Args)
         {
-            delete Content->Content;
-            delete Content;
+            return Shared<T, ThreadSafe>(new T(Forward<TArgs>(Args)...));
         }
-    }
 
-    T operator*() const { return *Content->Content; }
-    T* operator->() const { return Content->Content; }
+        template<typename... TArgs>
+        static Shared<T, ThreadSafe> Make(const void*, TArgs&&... Args)
+        {
+            auto* Block = new InlineBlock<T, ThreadSafe>(Forward<TArgs>(Args)...);
+            return Shared<T, ThreadSafe>(Block->Get(), Block);
+        }
+    };
+}
 
-    int Refs() const { return Content->Refs; }
-};
+/**
+ * @brief make an object and its reference count in one allocation, see MakeShared
+ */
+template<typename T, bool ThreadSafe, typename... TArgs>
+CTU_INLINE Shared<T, ThreadSafe> MakeSharedWith(TArgs&&... Args)
+{
+    return Private::SharedMaker<T, ThreadSafe>::Make((T*)nullptr, Forward<TArgs>(Args)...);
+}
 
+/**
+ * @brief make an object owned by a Shared with one allocation for the object and its count
+ *
+ * @code{.cpp}
+ *
+ * Shared<String> Name = MakeShared<String>("cthulhu");
+ *
+ * @endcode
+ */
+template<typename T, typename... TArgs>
+CTU_INLINE Shared<T> MakeShared(TArgs&&... Args)
+{
+    return MakeSharedWith<T, true>(Forward<TArgs>(Args)...);
 }
 
-#endif
\ No newline at end of file
+///a Shared that skips the atomics, for objects that stay on one thread
+template<typename T>
+using LocalShared = Shared<T, false>;
+
+template<typename T>
+using LocalWeak = Weak<T, false>;
+
+/**
+ * @brief MakeShared for a LocalShared
+ */
+template<typename T, typename... TArgs>
+CTU_INLINE LocalShared<T> MakeLocalShared(TArgs&&... Args)
+{
+    return MakeSharedWith<T, false>(Forward<TArgs>(Args)...);
+}
+
+}
@@ -0,0 +1,729 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Tracking.h"
+
+#include "Memory.h"
+//Memory::Alloc Memory::Realloc Memory::Free
+
+#include "Core/Types/Mutex.h"
+//Mutex ScopeLock
+
+#if CTU_TRACK_ALLOCATIONS
+#   if OS_WINDOWS
+#       include <windows.h>
+#   else
+#       include <execinfo.h>
+#       include <unistd.h>
+#   endif
+#endif
+
+using namespace Cthulhu;
+
+Memory::Tag Memory::Tags::Untagged("Untagged");
+Memory::Tag Memory::Tags::Array("Array");
+Memory::Tag Memory::Tags::String("String");
+Memory::Tag Memory::Tags::Map("Map");
+Memory::Tag Memory::Tags::Block("Block");
+Memory::Tag Memory::Tags::Binary("Binary");
+Memory::Tag Memory::Tags::Pool("Pool");
+Memory::Tag Memory::Tags::Arena("Arena");
+Memory::Tag Memory::Tags::Lifetime("Lifetime", false);
+
+namespace
+{
+
+Memory::Tag Everything("Everything");
+
+}
+
+#if CTU_TRACK_ALLOCATIONS
+
+thread_local Memory::Tag* Memory::Private::CurrentTag = nullptr;
+thread_local bool Memory::Private::ExplicitTag = false;
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+//the only thing allowed to touch the counters inside a tag
+struct TagCounter
+{
+    static void Add(Tag& Into, U64 Size)
+    {
+        const U64 Now = __atomic_add_fetch(&Into.LiveBytes, Size, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&Into.LiveCount, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&Into.TotalBytes, Size, __ATOMIC_RELAXED);
+
+        U64 Peak = __atomic_load_n(&Into.PeakBytes, __ATOMIC_RELAXED);
+        while(Now > Peak && !__atomic_compare_exchange_n(&Into.PeakBytes, &Peak, Now, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    }
+
+    static void Remove(Tag& From, U64 Size)
+    {
+        __atomic_sub_fetch(&From.LiveBytes, Size, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&From.LiveCount, 1, __ATOMIC_RELAXED);
+    }
+
+    static bool NeedsListing(const Tag& Which)
+    {
+        return !__atomic_load_n(&Which.Listed, __ATOMIC_ACQUIRE);
+    }
+
+    static void List(Tag& Which, Tag*& Head)
+    {
+        if(Which.Listed)
+            return;
+
+        Which.Link = Head;
+        Head = &Which;
+        __atomic_store_n(&Which.Listed, true, __ATOMIC_RELEASE);
+    }
+};
+
+}
+
+}
+
+namespace
+{
+
+constexpr U32 MaxFrames = 24;
+
+//every live allocation, stacks are only kept for sampled ones
+struct Record
+{
+    void* Ptr;
+    U64 Size;
+    Memory::Tag* Owner;
+    Record* Next;
+
+    void** Frames;
+    U32 Depth;
+};
+
+constexpr U32 ShardCount = 64;
+
+//records are spread over shards by address so threads rarely wait on each other
+struct Shard
+{
+    Mutex Lock;
+
+    Record** Buckets{nullptr};
+    U64 BucketCount{0};
+    U64 Count{0};
+
+    Record* Spare{nullptr};
+};
+
+struct Tracker
+{
+    Tracker()
+    {
+#if CC_MSVC
+        atexit(ReportAtExit);
+#endif
+    }
+
+    Shard Shards[ShardCount];
+
+    //guards the tag list
+    Mutex TagLock;
+    Memory::Tag* Tags{nullptr};
+
+    U64 SampleThreshold{1024 * 1024};
+    bool LeakReport{true};
+
+    static void ReportAtExit();
+};
+
+//never destroyed so frees during static destruction still find their records
+Tracker& State()
+{
+    alignas(Tracker) static Byte Storage[sizeof(Tracker)];
+    static Tracker* Ret = new (Storage) Tracker();
+
+    return *Ret;
+}
+
+/**
+ * nothing in here can go through Memory::Alloc or new or it would track itself,
+ * the raw versions are what Memory::Alloc uses when tracking is disabled
+ */
+void* RawAlloc(size_t Size)
+{
+#if CTU_CACHING_ALLOCATOR
+    return Memory::CachedAlloc(Size);
+#else
+    return malloc(Size);
+#endif
+}
+
+void* RawRealloc(void* Ptr, size_t Size)
+{
+#if CTU_CACHING_ALLOCATOR
+    return Memory::CachedRealloc(Ptr, Size);
+#else
+    return realloc(Ptr, Size);
+#endif
+}
+
+void RawFree(void* Ptr)
+{
+#if CTU_CACHING_ALLOCATOR
+    Memory::CachedFree(Ptr);
+#else
+    free(Ptr);
+#endif
+}
+
+CTU_INLINE U64 HashPointer(const void* Ptr)
+{
+    return ((U64)Ptr >> 4) * 0x9E3779B97F4A7C15ULL;
+}
+
+CTU_INLINE Shard& ShardOf(const void* Ptr)
+{
+    return State().Shards[HashPointer(Ptr) >> 58];
+}
+
+CTU_INLINE U64 BucketOf(const Shard& In, const void* Ptr)
+{
+    //the top bits picked the shard so use the bottom ones here
+    return HashPointer(Ptr) & (In.BucketCount - 1);
+}
+
+void Rehash(Shard& In)
+{
+    const U64 NewCount = In.BucketCount == 0 ? 256 : In.BucketCount * 2;
+    Record** NewBuckets = (Record**)calloc(NewCount, sizeof(Record*));
+
+    if(NewBuckets == nullptr)
+        return;
+
+    Record** Old = In.Buckets;
+    const U64 OldCount = In.BucketCount;
+
+    In.Buckets = NewBuckets;
+    In.BucketCount = NewCount;
+
+    for(U64 I = 0; I < OldCount; I++)
+    {
+        Record* Current = Old[I];
+
+        while(Current != nullptr)
+        {
+            Record* Next = Current->Next;
+            const U64 Index = BucketOf(In, Current->Ptr);
+
+            Current->Next = In.Buckets[Index];
+            In.Buckets[Index] = Current;
+
+            Current = Next;
+        }
+    }
+
+    free(Old);
+}
+
+U32 CaptureStack(void** Frames)
+{
+#if OS_WINDOWS
+    return CaptureStackBackTrace(2, MaxFrames, Frames, nullptr);
+#else
+    const int Depth = backtrace(Frames, MaxFrames);
+    return Depth < 0 ? 0 : (U32)Depth;
+#endif
+}
+
+Memory::Tag& CurrentOwner()
+{
+    Memory::Tag* Ret = Memory::Private::CurrentTag;
+    return Ret != nullptr ? *Ret : Memory::Tags::Untagged;
+}
+
+void Insert(void* Ptr, U64 Size)
+{
+    Tracker& Track = State();
+    Memory::Tag& Owner = CurrentOwner();
+
+    //stacks are captured outside the lock, they are by far the slowest part
+    void* Stack[MaxFrames];
+    U32 Depth = 0;
+
+    if(Size >= Track.SampleThreshold)
+        Depth = CaptureStack(Stack);
+
+    if(Memory::TagCounter::NeedsListing(Owner))
+    {
+        ScopeLock Guard(Track.TagLock);
+        Memory::TagCounter::List(Owner, Track.Tags);
+    }
+
+    Memory::TagCounter::Add(Owner, Size);
+    Memory::TagCounter::Add(Everything, Size);
+
+    Shard& In = ShardOf(Ptr);
+    ScopeLock Guard(In.Lock);
+
+    if(In.Count >= In.BucketCount)
+        Rehash(In);
+
+    Record* Item = In.Spare;
+
+    if(Item != nullptr)
+        In.Spare = Item->Next;
+    else
+        Item = (Record*)malloc(sizeof(Record));
+
+    //running out of memory for bookkeeping just means this one isnt tracked
+    if(Item == nullptr || In.BucketCount == 0)
+    {
+        free(Item);
+        Memory::TagCounter::Remove(Owner, Size);
+        Memory::TagCounter::Remove(Everything, Size);
+        return;
+    }
+
+    Item->Ptr = Ptr;
+    Item->Size = Size;
+    Item->Owner = &Owner;
+    Item->Frames = nullptr;
+    Item->Depth = 0;
+
+    if(Depth != 0)
+    {
+        Item->Frames = (void**)malloc(sizeof(void*) * Depth);
+
+        if(Item->Frames != nullptr)
+        {
+            memcpy(Item->Frames, Stack, sizeof(void*) * Depth);
+            Item->Depth = Depth;
+        }
+    }
+
+    const U64 Index = BucketOf(In, Ptr);
+    Item->Next = In.Buckets[Index];
+    In.Buckets[Index] = Item;
+    In.Count++;
+}
+
+//unlink the record for Ptr without touching any counters, null if it isnt tracked
+Record* Detach(void* Ptr)
+{
+    Shard& In = ShardOf(Ptr);
+    ScopeLock Guard(In.Lock);
+
+    if(In.BucketCount == 0)
+        return nullptr;
+
+    Record** Link = &In.Buckets[BucketOf(In, Ptr)];
+
+    while(*Link != nullptr && (*Link)->Ptr != Ptr)
+        Link = &(*Link)->Next;
+
+    //memory from before tracking knew about it or from a foreign allocator
+    if(*Link == nullptr)
+        return nullptr;
+
+    Record* Item = *Link;
+    *Link = Item->Next;
+    In.Count--;
+
+    return Item;
+}
+
+//put a detached record back where it was
+void Reattach(Record* Item)
+{
+    Shard& In = ShardOf(Item->Ptr);
+    ScopeLock Guard(In.Lock);
+
+    //buckets only ever grow so there is always somewhere to put it back
+    const U64 Index = BucketOf(In, Item->Ptr);
+    Item->Next = In.Buckets[Index];
+    In.Buckets[Index] = Item;
+    In.Count++;
+}
+
+//take the bytes of a detached record off its tag and keep the record for reuse
+void Release(Record* Item)
+{
+    Memory::TagCounter::Remove(*Item->Owner, Item->Size);
+    Memory::TagCounter::Remove(Everything, Item->Size);
+
+    Shard& In = ShardOf(Item->Ptr);
+    ScopeLock Guard(In.Lock);
+
+    free(Item->Frames);
+
+    Item->Next = In.Spare;
+    In.Spare = Item;
+}
+
+void Erase(void* Ptr)
+{
+    Record* Item = Detach(Ptr);
+
+    if(Item != nullptr)
+        Release(Item);
+}
+
+//copies of the biggest sampled records so they can be printed without holding any locks
+struct Sample
+{
+    U64 Size;
+    const char* Owner;
+    void* Frames[MaxFrames];
+    U32 Depth;
+};
+
+constexpr U32 MaxSamples = 32;
+
+//Reported leaves out allocations whose tag is skipped by the leak report
+U32 CollectSamples(Sample* Into, bool Reported)
+{
+    U32 Count = 0;
+
+    for(Shard& In : State().Shards)
+    {
+        ScopeLock Guard(In.Lock);
+
+        for(U64 I = 0; I < In.BucketCount; I++)
+        {
+            for(Record* Item = In.Buckets[I]; Item != nullptr; Item = Item->Next)
+            {
+                if(Item->Depth == 0 || (Reported && !Item->Owner->Reported))
+                    continue;
+
+                //keep the list sorted biggest first and drop whatever falls off the end
+                U32 Slot = Count < MaxSamples ? Count++ : MaxSamples;
+
+                while(Slot > 0 && Into[Slot - 1].Size < Item->Size)
+                {
+                    if(Slot < MaxSamples)
+                        Into[Slot] = Into[Slot - 1];
+
+                    Slot--;
+                }
+
+                if(Slot >= MaxSamples)
+                    continue;
+
+                Into[Slot].Size = Item->Size;
+                Into[Slot].Owner = Item->Owner->Name;
+                Into[Slot].Depth = Item->Depth;
+                memcpy(Into[Slot].Frames, Item->Frames, sizeof(void*) * Item->Depth);
+            }
+        }
+    }
+
+    return Count;
+}
+
+void WriteTags(FILE* Out)
+{
+    fprintf(Out, "%-24s %16s %16s %12s %16s\n", "tag", "live", "peak", "count", "total");
+
+    const Memory::Tag& All = Everything;
+    fprintf(Out, "%-24s %16llu %16llu %12llu %16llu\n", All.Name,
+        (unsigned long long)All.Live(), (unsigned long long)All.Peak(),
+        (unsigned long long)All.Count(), (unsigned long long)All.Total()
+    );
+
+    for(const Memory::Tag* Item = Memory::FirstTag(); Item != nullptr; Item = Item->Next())
+    {
+        fprintf(Out, "%-24s %16llu %16llu %12llu %16llu\n", Item->Name,
+            (unsigned long long)Item->Live(), (unsigned long long)Item->Peak(),
+            (unsigned long long)Item->Count(), (unsigned long long)Item->Total()
+        );
+    }
+}
+
+void WriteSamples(FILE* Out, const Sample* Samples, U32 Count)
+{
+    for(U32 I = 0; I < Count; I++)
+    {
+        fprintf(Out, "\n%llu bytes tagged %s\n", (unsigned long long)Samples[I].Size, Samples[I].Owner);
+        fflush(Out);
+
+#if OS_WINDOWS
+        for(U32 J = 0; J < Samples[I].Depth; J++)
+            fprintf(Out, "    %p\n", Samples[I].Frames[J]);
+#else
+        //writes straight to the descriptor so symbolizing doesnt need to allocate through us
+        backtrace_symbols_fd(Samples[I].Frames, (int)Samples[I].Depth, fileno(Out));
+#endif
+    }
+}
+
+void Tracker::ReportAtExit()
+{
+    Tracker& Track = State();
+
+    if(!Track.LeakReport || Everything.Count() == 0)
+        return;
+
+    //whatever is in tags like Lifetime was meant to be around until the end
+    U64 Count = Everything.Count(),
+        Live = Everything.Live();
+
+    for(const Memory::Tag* Item = Memory::FirstTag(); Item != nullptr; Item = Item->Next())
+    {
+        if(Item->Reported)
+            continue;
+
+        Count -= Item->Count();
+        Live -= Item->Live();
+    }
+
+    if(Count == 0)
+        return;
+
+    fprintf(stderr, "\n%llu allocations totalling %llu bytes were still live at exit\n\n",
+        (unsigned long long)Count, (unsigned long long)Live
+    );
+
+    WriteTags(stderr);
+
+    //big enough that it shouldnt live on the stack of whatever is exiting
+    Sample* Samples = (Sample*)malloc(sizeof(Sample) * MaxSamples);
+
+    if(Samples != nullptr)
+    {
+        WriteSamples(stderr, Samples, CollectSamples(Samples, true));
+        free(Samples);
+    }
+}
+
+#if !CC_MSVC
+//the fini array runs after every atexit handler and static destructor, even ones registered
+//before the tracker existed, so anything they free is gone by the time this reports
+__attribute__((destructor)) void ReportLast()
+{
+    Tracker::ReportAtExit();
+}
+#endif
+
+}
+
+void* Cthulhu::Memory::TrackedAlloc(size_t Size)
+{
+    void* Ret = RawAlloc(Size);
+
+    if(Ret != nullptr)
+        Insert(Ret, Size);
+
+    return Ret;
+}
+
+void* Cthulhu::Memory::TrackedRealloc(void* Ptr, size_t Size)
+{
+    if(Ptr == nullptr)
+        return TrackedAlloc(Size);
+
+    //taken out first so no other thread can be handed Ptr while its record is still there
+    Record* Old = Detach(Ptr);
+
+    void* Ret = RawRealloc(Ptr, Size);
+
+    //a failed realloc leaves the old block where it was
+    if(Ret == nullptr && Size != 0)
+    {
+        if(Old != nullptr)
+            Reattach(Old);
+
+        return nullptr;
+    }
+
+    //the grown block keeps whatever tag is active now rather than its old one
+    if(Old != nullptr)
+        Release(Old);
+
+    if(Ret != nullptr)
+        Insert(Ret, Size);
+
+    return Ret;
+}
+
+void Cthulhu::Memory::TrackedFree(void* Ptr)
+{
+    if(Ptr == nullptr)
+        return;
+
+    Erase(Ptr);
+    RawFree(Ptr);
+}
+
+void Cthulhu::Memory::TrackAllocation(void* Ptr, size_t Size)
+{
+    if(Ptr != nullptr)
+        Insert(Ptr, Size);
+}
+
+void Cthulhu::Memory::TrackFree(void* Ptr)
+{
+    if(Ptr != nullptr)
+        Erase(Ptr);
+}
+
+void Cthulhu::Memory::SetSampleThreshold(U64 Bytes)
+{
+    State().SampleThreshold = Bytes;
+}
+
+void Cthulhu::Memory::SetLeakReport(bool Enabled)
+{
+    State().LeakReport = Enabled;
+}
+
+const Memory::Tag* Cthulhu::Memory::FirstTag()
+{
+    Tracker& Track = State();
+    ScopeLock Guard(Track.TagLock);
+
+    return Track.Tags;
+}
+
+bool Cthulhu::Memory::Snapshot(const char* Path)
+{
+    Sample* Samples = (Sample*)malloc(sizeof(Sample) * MaxSamples);
+
+    if(Samples == nullptr)
+        return false;
+
+    const U32 Count = CollectSamples(Samples, false);
+
+    FILE* Out = fopen(Path, "w");
+
+    if(Out == nullptr)
+    {
+        free(Samples);
+        return false;
+    }
+
+    WriteTags(Out);
+    WriteSamples(Out, Samples, Count);
+
+    free(Samples);
+
+    return fclose(Out) == 0;
+}
+
+/**
+ * global new and delete go through the tracker too so containers that use new[] are
+ * counted. the aligned versions are left alone, they are paired with each other
+ */
+void* operator new(size_t Size)
+{
+    void* Ret = Memory::TrackedAlloc(Size == 0 ? 1 : Size);
+
+    if(Ret == nullptr)
+        abort();
+
+    return Ret;
+}
+
+void* operator new[](size_t Size)
+{
+    return operator new(Size);
+}
+
+void* operator new(size_t Size, const std::nothrow_t&) noexcept
+{
+    return Memory::TrackedAlloc(Size == 0 ? 1 : Size);
+}
+
+void* operator new[](size_t Size, const std::nothrow_t&) noexcept
+{
+    return Memory::TrackedAlloc(Size == 0 ? 1 : Size);
+}
+
+void operator delete(void* Ptr) noexcept
+{
+    Memory::TrackedFree(Ptr);
+}
+
+void operator delete[](void* Ptr) noexcept
+{
+    Memory::TrackedFree(Ptr);
+}
+
+void operator delete(void* Ptr, size_t) noexcept
+{
+    Memory::TrackedFree(Ptr);
+}
+
+void operator delete[](void* Ptr, size_t) noexcept
+{
+    Memory::TrackedFree(Ptr);
+}
+
+void operator delete(void* Ptr, const std::nothrow_t&) noexcept
+{
+    Memory::TrackedFree(Ptr);
+}
+
+void operator delete[](void* Ptr, const std::nothrow_t&) noexcept
+{
+    Memory::TrackedFree(Ptr);
+}
+
+#else
+
+//everything is a no op so code using the api builds either way
+
+void* Cthulhu::Memory::TrackedAlloc(size_t Size)
+{
+    return Memory::Alloc<void>(Size);
+}
+
+void* Cthulhu::Memory::TrackedRealloc(void* Ptr, size_t Size)
+{
+    return Memory::Realloc(Ptr, Size);
+}
+
+void Cthulhu::Memory::TrackedFree(void* Ptr)
+{
+    Memory::Free(Ptr);
+}
+
+void Cthulhu::Memory::SetSampleThreshold(U64) {}
+
+void Cthulhu::Memory::SetLeakReport(bool) {}
+
+const Memory::Tag* Cthulhu::Memory::FirstTag()
+{
+    return nullptr;
+}
+
+bool Cthulhu::Memory::Snapshot(const char*)
+{
+    return false;
+}
+
+#endif
+
+const Memory::Tag& Cthulhu::Memory::TrackedTotals()
+{
+    return Everything;
+}
@@ -0,0 +1,266 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stddef.h>
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U64
+
+#pragma once
+
+#ifndef CTU_TRACK_ALLOCATIONS
+#   define CTU_TRACK_ALLOCATIONS 0
+#endif
+
+namespace Cthulhu
+{
+
+namespace Memory
+{
+
+///true when the library was built with the meson option allocation_tracking
+constexpr bool TrackingEnabled = CTU_TRACK_ALLOCATIONS;
+
+/**
+ * @brief a named bucket that allocations are counted against
+ *
+ * @description every tracked allocation belongs to the tag that was active on its
+ *              thread when it was made, frees are counted against the same tag even
+ *              if they happen somewhere else. tags are meant to be globals, they are
+ *              listed the first time something is counted against them
+ *
+ * @code{.cpp}
+ *
+ * Memory::Tag Textures("Textures");
+ *
+ * void Load()
+ * {
+ *     Memory::TagScope Scope(Textures);
+ *     //everything allocated here is counted against Textures
+ * }
+ *
+ * @endcode
+ */
+struct Tag
+{
+    constexpr Tag(const char* InName, bool InReported = true)
+        : Name(InName)
+        , Reported(InReported)
+    {}
+
+    Tag(const Tag&) = delete;
+    Tag& operator=(const Tag&) = delete;
+
+    ///the name shown in snapshots and leak reports
+    const char* Name;
+
+    ///false for memory that is meant to last until exit, the leak report leaves it out
+    const bool Reported;
+
+    ///bytes allocated against this tag that are still live
+    U64 Live() const { return __atomic_load_n(&LiveBytes, __ATOMIC_RELAXED); }
+
+    ///the most bytes that were ever live at once
+    U64 Peak() const { return __atomic_load_n(&PeakBytes, __ATOMIC_RELAXED); }
+
+    ///how many allocations are still live
+    U64 Count() const { return __atomic_load_n(&LiveCount, __ATOMIC_RELAXED); }
+
+    ///every byte ever allocated against this tag
+    U64 Total() const { return __atomic_load_n(&TotalBytes, __ATOMIC_RELAXED); }
+
+    ///the next tag that has been used, null at the end
+    const Tag* Next() const { return Link; }
+
+private:
+    friend struct TagCounter;
+
+    U64 LiveBytes{0};
+    U64 PeakBytes{0};
+    U64 LiveCount{0};
+    U64 TotalBytes{0};
+
+    Tag* Link{nullptr};
+    bool Listed{false};
+};
+
+namespace Tags
+{
+    ///anything allocated with no tag active
+    extern Tag Untagged;
+
+    extern Tag Array;
+    extern Tag String;
+    extern Tag Map;
+    extern Tag Block;
+    extern Tag Binary;
+    extern Tag Pool;
+    extern Tag Arena;
+
+    ///caches that are kept until the program exits on purpose, like the shared pools
+    ///and the atom table, these never show up in the leak report
+    extern Tag Lifetime;
+}
+
+namespace Private
+{
+#if CTU_TRACK_ALLOCATIONS
+    extern thread_local Tag* CurrentTag;
+    extern thread_local bool ExplicitTag;
+#endif
+}
+
+/**
+ * @brief count everything allocated on this thread against a tag until the scope ends
+ *
+ * @description scopes nest, the innermost one wins. when tracking is disabled this
+ *              does nothing and compiles away
+ */
+struct TagScope
+{
+#if CTU_TRACK_ALLOCATIONS
+    CTU_INLINE TagScope(Tag& Which)
+        : Previous(Private::CurrentTag)
+        , WasExplicit(Private::ExplicitTag)
+    {
+        Private::CurrentTag = &Which;
+        Private::ExplicitTag = true;
+    }
+
+    CTU_INLINE ~TagScope()
+    {
+        Private::CurrentTag = Previous;
+        Private::ExplicitTag = WasExplicit;
+    }
+
+private:
+    Tag* Previous;
+    bool WasExplicit;
+#else
+    CTU_INLINE TagScope(Tag&) {}
+#endif
+
+public:
+    TagScope(const TagScope&) = delete;
+    TagScope& operator=(const TagScope&) = delete;
+};
+
+/**
+ * @brief the tag containers use for their own storage
+ *
+ * @description only takes effect when nothing has set a TagScope, so user tags say
+ *              who owns the memory and container tags fill in everything else
+ */
+struct ContainerScope
+{
+#if CTU_TRACK_ALLOCATIONS
+    CTU_INLINE ContainerScope(Tag& Which)
+        : Previous(Private::CurrentTag)
+    {
+        if(!Private::ExplicitTag)
+            Private::CurrentTag = &Which;
+    }
+
+    CTU_INLINE ~ContainerScope()
+    {
+        Private::CurrentTag = Previous;
+    }
+
+private:
+    Tag* Previous;
+#else
+    CTU_INLINE ContainerScope(Tag&) {}
+#endif
+
+public:
+    ContainerScope(const ContainerScope&) = delete;
+    ContainerScope& operator=(const ContainerScope&) = delete;
+};
+
+#if CTU_TRACK_ALLOCATIONS
+#   define CTU_TRACK_CONTAINER(Name) Cthulhu::Memory::ContainerScope TrackContainer(Cthulhu::Memory::Tags::Name)
+#else
+#   define CTU_TRACK_CONTAINER(Name)
+#endif
+
+/**
+ * @brief allocate memory and record it against the current tag
+ *
+ * @description Memory::Alloc, Realloc and Free use these when tracking is enabled and
+ *              so does global new and delete. memory comes from wherever Memory::Alloc
+ *              would normally get it
+ */
+void* TrackedAlloc(size_t Size);
+void* TrackedRealloc(void* Ptr, size_t Size);
+void TrackedFree(void* Ptr);
+
+/**
+ * @brief record memory that came from somewhere else, like an aligned or mapped block
+ *
+ * @description does nothing when tracking is disabled. every recorded pointer has to
+ *              be forgotten before it is given back
+ */
+#if CTU_TRACK_ALLOCATIONS
+void TrackAllocation(void* Ptr, size_t Size);
+void TrackFree(void* Ptr);
+#else
+CTU_INLINE void TrackAllocation(void*, size_t) {}
+CTU_INLINE void TrackFree(void*) {}
+#endif
+
+/**
+ * @brief capture a call stack for every allocation at least this big
+ *
+ * @description defaults to 1mb, 0 captures every allocation which is slow but
+ *              finds everything
+ */
+void SetSampleThreshold(U64 Bytes);
+
+/**
+ * @brief print what is still live when the program exits, on by default
+ */
+void SetLeakReport(bool Enabled);
+
+/**
+ * @brief every tag that has had something counted against it
+ *
+ * @code{.cpp}
+ *
+ * for(const Memory::Tag* Item = Memory::FirstTag(); Item; Item = Item->Next())
+ *     printf("%s %llu\n", Item->Name, Item->Live());
+ *
+ * @endcode
+ */
+const Tag* FirstTag();
+
+/**
+ * @brief counters across every tag
+ */
+const Tag& TrackedTotals();
+
+/**
+ * @brief write every tag and the biggest live sampled allocations with their call
+ *        stacks to a file
+ *
+ * @return bool false if tracking is disabled or the file couldnt be written
+ */
+bool Snapshot(const char* Path);
+
+}
+
+}
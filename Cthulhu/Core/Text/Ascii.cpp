@@ -0,0 +1,168 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Ascii.h"
+
+#if SIMD_SSE2
+#   include <emmintrin.h>
+#elif SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+using namespace Cthulhu;
+
+namespace
+{
+
+#if SIMD_SSE2
+
+using Vec = __m128i;
+
+CTU_INLINE Vec Load(const char* Text) { return _mm_loadu_si128((const __m128i*)Text); }
+CTU_INLINE void Store(char* Into, Vec Block) { _mm_storeu_si128((__m128i*)Into, Block); }
+CTU_INLINE Vec Splat(char C) { return _mm_set1_epi8(C); }
+
+//signed compares are fine since everything past 127 is negative and never in range
+CTU_INLINE Vec InRange(Vec Block, char First, char Last)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(Block, Splat(First - 1)), _mm_cmplt_epi8(Block, Splat(Last + 1)));
+}
+
+CTU_INLINE Vec FlipCase(Vec Block, Vec Mask) { return _mm_xor_si128(Block, _mm_and_si128(Mask, Splat(0x20))); }
+CTU_INLINE bool AllEqual(Vec Left, Vec Right) { return _mm_movemask_epi8(_mm_cmpeq_epi8(Left, Right)) == 0xFFFF; }
+
+#elif SIMD_NEON
+
+using Vec = uint8x16_t;
+
+CTU_INLINE Vec Load(const char* Text) { return vld1q_u8((const U8*)Text); }
+CTU_INLINE void Store(char* Into, Vec Block) { vst1q_u8((U8*)Into, Block); }
+CTU_INLINE Vec Splat(char C) { return vdupq_n_u8((U8)C); }
+
+CTU_INLINE Vec InRange(Vec Block, char First, char Last)
+{
+    return vandq_u8(vcgeq_u8(Block, Splat(First)), vcleq_u8(Block, Splat(Last)));
+}
+
+CTU_INLINE Vec FlipCase(Vec Block, Vec Mask) { return veorq_u8(Block, vandq_u8(Mask, Splat(0x20))); }
+
+CTU_INLINE bool AllEqual(Vec Left, Vec Right)
+{
+    const uint8x8_t Narrow = vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(Left, Right)), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(Narrow), 0) == ~0ULL;
+}
+
+#endif
+
+//flip the case of every character between First and Last, which is either A-Z or a-z
+void MapCase(const char* From, char* Into, U32 Len, char First, char Last)
+{
+    U32 I = 0;
+
+#if SIMD_SSE2 || SIMD_NEON
+    for(; I + 16 <= Len; I += 16)
+    {
+        const Vec Block = Load(From + I);
+        Store(Into + I, FlipCase(Block, InRange(Block, First, Last)));
+    }
+#endif
+
+    for(; I < Len; I++)
+        Into[I] = (First <= From[I] && From[I] <= Last) ? (char)(From[I] ^ 0x20) : From[I];
+}
+
+}
+
+void Cthulhu::Utils::ToUpper(char* Text, U32 Len)
+{
+    MapCase(Text, Text, Len, 'a', 'z');
+}
+
+void Cthulhu::Utils::ToLower(char* Text, U32 Len)
+{
+    MapCase(Text, Text, Len, 'A', 'Z');
+}
+
+void Cthulhu::Utils::ToUpper(const char* From, char* Into, U32 Len)
+{
+    MapCase(From, Into, Len, 'a', 'z');
+}
+
+void Cthulhu::Utils::ToLower(const char* From, char* Into, U32 Len)
+{
+    MapCase(From, Into, Len, 'A', 'Z');
+}
+
+I32 Cthulhu::Utils::CompareNoCase(StringView Left, StringView Right)
+{
+    const U32 Len = Left.Len() < Right.Len() ? Left.Len() : Right.Len();
+
+    for(U32 I = 0; I < Len; I++)
+    {
+        const U8 L = (U8)ToLower(Left[I]);
+        const U8 R = (U8)ToLower(Right[I]);
+
+        if(L != R)
+            return L < R ? -1 : 1;
+    }
+
+    if(Left.Len() == Right.Len())
+        return 0;
+
+    return Left.Len() < Right.Len() ? -1 : 1;
+}
+
+bool Cthulhu::Utils::EqualsNoCase(StringView Left, StringView Right)
+{
+    if(Left.Len() != Right.Len())
+        return false;
+
+    const char* L = Left.Data();
+    const char* R = Right.Data();
+    const U32 Len = Left.Len();
+
+    U32 I = 0;
+
+#if SIMD_SSE2 || SIMD_NEON
+    for(; I + 16 <= Len; I += 16)
+    {
+        const Vec LBlock = Load(L + I);
+        const Vec RBlock = Load(R + I);
+
+        if(!AllEqual(FlipCase(LBlock, InRange(LBlock, 'A', 'Z')), FlipCase(RBlock, InRange(RBlock, 'A', 'Z'))))
+            return false;
+    }
+#endif
+
+    for(; I < Len; I++)
+        if(ToLower(L[I]) != ToLower(R[I]))
+            return false;
+
+    return true;
+}
+
+U32 Cthulhu::Utils::HashNoCase(StringView Text)
+{
+    //fnv-1a over the lowercase characters
+    U32 Ret = 2166136261u;
+
+    for(char C : Text)
+    {
+        Ret ^= (U8)ToLower(C);
+        Ret *= 16777619u;
+    }
+
+    return Ret;
+}
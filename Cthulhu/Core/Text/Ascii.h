@@ -0,0 +1,191 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U8 U32 I32
+
+#include "Core/Collections/StringView.h"
+//StringView
+
+#include "Scan.h"
+//CharSet
+
+#pragma once
+
+namespace Cthulhu::Consts
+{
+    //the character sets every classifier is built from, the Consts functions in CthulhuString.h hand these out as StaticStrings
+    constexpr StringView WhitespaceSet = " \n\r\t\x0b\x0c";
+    constexpr StringView UpperCaseSet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    constexpr StringView LowerCaseSet = "abcdefghijklmnopqrstuvwxyz";
+    constexpr StringView OctDigitsSet = "01234567";
+    constexpr StringView HexDigitsSet = "0123456789abcdefABCDEF";
+    constexpr StringView DigitsSet = "0123456789";
+    constexpr StringView PunctuationSet = "!\"#$%&\'()*+,-./:;<=>?@[\\]^_`{|}~";
+    constexpr StringView NewlinesSet = "\n\r";
+}
+
+namespace Cthulhu::Private
+{
+    enum AsciiClass : U8
+    {
+        AsciiSpace = (1 << 0),
+        AsciiUpper = (1 << 1),
+        AsciiLower = (1 << 2),
+        AsciiDigit = (1 << 3),
+        AsciiHex = (1 << 4),
+        AsciiPunctuation = (1 << 5),
+        AsciiNewline = (1 << 6),
+        AsciiPrintable = (1 << 7),
+    };
+
+    struct AsciiTable
+    {
+        U8 Flags[256];
+    };
+
+    constexpr AsciiTable BuildAsciiTable()
+    {
+        AsciiTable Ret = {};
+
+        auto Mark = [&Ret](StringView Set, U8 Flag) {
+            for(char C : Set)
+                Ret.Flags[(U8)C] |= Flag;
+        };
+
+        Mark(Consts::WhitespaceSet, AsciiSpace | AsciiPrintable);
+        Mark(Consts::UpperCaseSet, AsciiUpper | AsciiPrintable);
+        Mark(Consts::LowerCaseSet, AsciiLower | AsciiPrintable);
+        Mark(Consts::DigitsSet, AsciiDigit | AsciiPrintable);
+        Mark(Consts::HexDigitsSet, AsciiHex);
+        Mark(Consts::PunctuationSet, AsciiPunctuation | AsciiPrintable);
+        Mark(Consts::NewlinesSet, AsciiNewline);
+
+        return Ret;
+    }
+
+    //one lookup per character instead of searching a string
+    constexpr AsciiTable AsciiClasses = BuildAsciiTable();
+
+    constexpr CharSet WhitespaceChars = Consts::WhitespaceSet;
+
+    CTU_INLINE constexpr bool HasClass(char C, U8 Flags) { return (AsciiClasses.Flags[(U8)C] & Flags) != 0; }
+}
+
+namespace Cthulhu::Utils
+{
+    CTU_INLINE constexpr bool IsSpace(char C) { return Private::HasClass(C, Private::AsciiSpace); }
+    CTU_INLINE constexpr bool IsUpper(char C) { return Private::HasClass(C, Private::AsciiUpper); }
+    CTU_INLINE constexpr bool IsLower(char C) { return Private::HasClass(C, Private::AsciiLower); }
+    CTU_INLINE constexpr bool IsNum(char C) { return Private::HasClass(C, Private::AsciiDigit); }
+    CTU_INLINE constexpr bool IsHex(char C) { return Private::HasClass(C, Private::AsciiHex); }
+    CTU_INLINE constexpr bool IsAlpha(char C) { return Private::HasClass(C, Private::AsciiUpper | Private::AsciiLower); }
+    CTU_INLINE constexpr bool IsAlnum(char C) { return Private::HasClass(C, Private::AsciiUpper | Private::AsciiLower | Private::AsciiDigit); }
+    CTU_INLINE constexpr bool IsPunctuation(char C) { return Private::HasClass(C, Private::AsciiPunctuation); }
+    CTU_INLINE constexpr bool IsPrintable(char C) { return Private::HasClass(C, Private::AsciiPrintable); }
+    CTU_INLINE constexpr bool IsNewline(char C) { return Private::HasClass(C, Private::AsciiNewline); }
+    CTU_INLINE constexpr bool IsEOF(char C) { return C == (char)-1 || C == '\0'; }
+
+    //flipping bit 5 switches the case of an ascii letter
+    CTU_INLINE constexpr char ToUpper(char C) { return IsLower(C) ? (char)(C ^ 0x20) : C; }
+    CTU_INLINE constexpr char ToLower(char C) { return IsUpper(C) ? (char)(C ^ 0x20) : C; }
+
+    /**
+     * @brief change the case of ascii letters in place, 16 characters at a time
+     *
+     * @description anything that isnt an ascii letter is left alone so utf-8 text stays valid
+     */
+    void ToUpper(char* Text, U32 Len);
+    void ToLower(char* Text, U32 Len);
+
+    /**
+     * @brief copy text while changing the case of its ascii letters
+     *
+     * @param From the text to copy
+     * @param Into where to write it, must have space for Len characters. can be the same as From
+     * @param Len how many characters to copy
+     */
+    void ToUpper(const char* From, char* Into, U32 Len);
+    void ToLower(const char* From, char* Into, U32 Len);
+
+    /**
+     * @brief compare text ignoring the case of ascii letters
+     *
+     * @return I32 less than 0 if Left sorts first, 0 if they are the same and more than 0 if Right sorts first
+     */
+    I32 CompareNoCase(StringView Left, StringView Right);
+
+    /**
+     * @brief check if text is the same ignoring the case of ascii letters
+     *
+     * @code{.cpp}
+     *
+     * Utils::EqualsNoCase("Content-Length", "content-length"); // true
+     *
+     * @endcode
+     */
+    bool EqualsNoCase(StringView Left, StringView Right);
+
+    /**
+     * @brief hash text so that strings that are EqualsNoCase hash the same
+     */
+    U32 HashNoCase(StringView Text);
+
+    /**
+     * @brief remove characters in a set from the start of some text
+     *
+     * @return StringView a view into Text without the characters, nothing is copied
+     */
+    CTU_INLINE constexpr StringView TrimStart(StringView Text, const CharSet& Set = Private::WhitespaceChars)
+    {
+        U32 Front = 0;
+
+        while(Front < Text.Len() && Set.Has(Text[Front]))
+            Front++;
+
+        return Text.SubView(Front, Text.Len() - Front);
+    }
+
+    /**
+     * @brief remove characters in a set from the end of some text
+     */
+    CTU_INLINE constexpr StringView TrimEnd(StringView Text, const CharSet& Set = Private::WhitespaceChars)
+    {
+        U32 Back = Text.Len();
+
+        while(Back > 0 && Set.Has(Text[Back - 1]))
+            Back--;
+
+        return Text.SubView(0, Back);
+    }
+
+    /**
+     * @brief remove characters in a set from both ends of some text
+     *
+     * @code{.cpp}
+     *
+     * Utils::TrimAny("  value\r\n"); // "value"
+     * Utils::TrimAny("--[x]--", "-[]"); // "x"
+     *
+     * @endcode
+     */
+    CTU_INLINE constexpr StringView TrimAny(StringView Text, const CharSet& Set = Private::WhitespaceChars)
+    {
+        return TrimEnd(TrimStart(Text, Set), Set);
+    }
+}
@@ -0,0 +1,646 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Diff.h"
+
+#include "Core/Math/Math.h"
+//Math::Min Math::Max
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy Memory::Set
+
+#include "Scan.h"
+//Utils::FindByte Utils::CommonPrefix Utils::CommonSuffix
+
+using namespace Cthulhu;
+
+namespace
+{
+
+/*================================================================*/
+/*              edit scripts                                      */
+/*================================================================*/
+
+//add a run to the end of a script, merging it with the last run where possible
+void AddEdit(Array<Edit>& Into, EditKind Kind, U32 Old, U32 New, U32 Length)
+{
+    if(Length == 0)
+        return;
+
+    if(Into.Len() != 0)
+    {
+        Edit& Last = Into[Into.Len() - 1];
+
+        if(Last.Kind == Kind && Last.Old + (Kind != EditKind::Insert ? Last.Length : 0) == Old &&
+            Last.New + (Kind != EditKind::Delete ? Last.Length : 0) == New)
+        {
+            Last.Length += Length;
+            return;
+        }
+    }
+
+    //the array only grows by a fixed amount on its own so double it here
+    if(Into.Len() + 1 >= Into.RealSize())
+        Into.Reserve(Into.Len());
+
+    Into.Append({ Kind, Old, New, Length });
+}
+
+/*================================================================*/
+/*              myers diff                                        */
+/*================================================================*/
+
+struct DiffContext
+{
+    const U32* Old;
+    const U32* New;
+
+    //marks every item that isnt part of the common subsequence
+    U8* OldChanged;
+    U8* NewChanged;
+
+    //furthest x reached on each diagonal from the front and from the back
+    I32* Forward;
+    I32* Backward;
+
+    //past this many edits a sub problem stops looking for the best split
+    I32 Expensive;
+};
+
+CTU_INLINE U32 CommonIdPrefix(const U32* Old, const U32* New, U32 Len)
+{
+    return Utils::CommonPrefix((const char*)Old, (const char*)New, Len * sizeof(U32)) / sizeof(U32);
+}
+
+CTU_INLINE U32 CommonIdSuffix(const U32* Old, const U32* New, U32 Len)
+{
+    return Utils::CommonSuffix((const char*)Old, (const char*)New, Len * sizeof(U32)) / sizeof(U32);
+}
+
+//find where the shortest path through Old[0, N) and New[0, M) crosses the middle
+//the path is walked from both ends at once and the split is wherever they meet
+//returns false if there wasnt a useful split, the caller then treats it as a full replace
+bool FindSplit(const DiffContext& Ctx, const U32* A, I32 N, const U32* B, I32 M, I32& SplitX, I32& SplitY)
+{
+    const I32 MaxD = (N + M + 1) / 2;
+    const I32 Offset = MaxD + 1;
+    const I32 Length = (2 * MaxD) + 3;
+
+    //-1 marks diagonals that havent been reached yet
+    I32* F = Ctx.Forward;
+    I32* R = Ctx.Backward;
+
+    Memory::Set(F, 0xFF, Length * sizeof(I32));
+    Memory::Set(R, 0xFF, Length * sizeof(I32));
+
+    F[Offset + 1] = 0;
+    R[Offset + 1] = 0;
+
+    const I32 Delta = N - M;
+
+    //when the difference in length is odd the paths can only meet on a forward step
+    const bool Front = (Delta & 1) != 0;
+
+    //diagonals that ran off the edge of the grid are trimmed from both ends of the sweep
+    I32 FStart = 0, FEnd = 0, RStart = 0, REnd = 0;
+
+    for(I32 D = 0; D < MaxD; D++)
+    {
+        for(I32 K = -D + FStart; K <= D - FEnd; K += 2)
+        {
+            const I32 Index = Offset + K;
+
+            I32 X = (K == -D || (K != D && F[Index - 1] < F[Index + 1])) ? F[Index + 1] : F[Index - 1] + 1;
+            I32 Y = X - K;
+
+            while(X < N && Y < M && A[X] == B[Y])
+            {
+                X++;
+                Y++;
+            }
+
+            F[Index] = X;
+
+            if(X > N)
+            {
+                FEnd += 2;
+            }
+            else if(Y > M)
+            {
+                FStart += 2;
+            }
+            else if(Front)
+            {
+                const I32 Other = Offset + Delta - K;
+
+                if(Other >= 0 && Other < Length && R[Other] != -1 && X >= N - R[Other])
+                {
+                    SplitX = X;
+                    SplitY = Y;
+                    return true;
+                }
+            }
+        }
+
+        for(I32 K = -D + RStart; K <= D - REnd; K += 2)
+        {
+            const I32 Index = Offset + K;
+
+            I32 X = (K == -D || (K != D && R[Index - 1] < R[Index + 1])) ? R[Index + 1] : R[Index - 1] + 1;
+            I32 Y = X - K;
+
+            while(X < N && Y < M && A[N - X - 1] == B[M - Y - 1])
+            {
+                X++;
+                Y++;
+            }
+
+            R[Index] = X;
+
+            if(X > N)
+            {
+                REnd += 2;
+            }
+            else if(Y > M)
+            {
+                RStart += 2;
+            }
+            else if(!Front)
+            {
+                const I32 Other = Offset + Delta - K;
+
+                if(Other >= 0 && Other < Length && F[Other] != -1 && F[Other] >= N - X)
+                {
+                    SplitX = F[Other];
+                    SplitY = F[Other] - (Other - Offset);
+                    return true;
+                }
+            }
+        }
+
+        if(D >= Ctx.Expensive)
+        {
+            //give up on the best split and take the forward point that got furthest
+            I32 Best = -1;
+
+            for(I32 K = -D; K <= D; K += 2)
+            {
+                const I32 X = F[Offset + K];
+                const I32 Y = X - K;
+
+                if(X >= 0 && X <= N && Y >= 0 && Y <= M && X + Y > Best && X + Y < N + M)
+                {
+                    Best = X + Y;
+                    SplitX = X;
+                    SplitY = Y;
+                }
+            }
+
+            return Best > 0;
+        }
+    }
+
+    return false;
+}
+
+void Compare(const DiffContext& Ctx, U32 XLo, U32 XHi, U32 YLo, U32 YHi)
+{
+    //skip what the ends have in common before searching
+    const U32 Prefix = CommonIdPrefix(Ctx.Old + XLo, Ctx.New + YLo, Math::Min(XHi - XLo, YHi - YLo));
+    XLo += Prefix;
+    YLo += Prefix;
+
+    const U32 Shorter = Math::Min(XHi - XLo, YHi - YLo);
+    const U32 Suffix = CommonIdSuffix(Ctx.Old + XHi - Shorter, Ctx.New + YHi - Shorter, Shorter);
+    XHi -= Suffix;
+    YHi -= Suffix;
+
+    if(XLo == XHi || YLo == YHi)
+    {
+        Memory::Set(Ctx.OldChanged + XLo, 1, XHi - XLo);
+        Memory::Set(Ctx.NewChanged + YLo, 1, YHi - YLo);
+        return;
+    }
+
+    I32 X, Y;
+
+    if(!FindSplit(Ctx, Ctx.Old + XLo, (I32)(XHi - XLo), Ctx.New + YLo, (I32)(YHi - YLo), X, Y))
+    {
+        Memory::Set(Ctx.OldChanged + XLo, 1, XHi - XLo);
+        Memory::Set(Ctx.NewChanged + YLo, 1, YHi - YLo);
+        return;
+    }
+
+    Compare(Ctx, XLo, XLo + X, YLo, YLo + Y);
+    Compare(Ctx, XLo + X, XHi, YLo + Y, YHi);
+}
+
+//diff two id sequences and append the script to Into with every index offset by the bases
+void DiffInto(Array<Edit>& Into, const U32* Old, U32 OldLen, const U32* New, U32 NewLen, bool Minimal, U32 IdLimit, U32 OldBase, U32 NewBase)
+{
+    const U32 Total = OldLen + NewLen;
+
+    U8* Changed = new U8[Total + 1];
+    Memory::Set(Changed, 0, Total + 1);
+
+    U8* OldChanged = Changed;
+    U8* NewChanged = Changed + OldLen;
+
+    //an item with no equal on the other side can never be kept so it is marked up front
+    //and the search only runs over what is left, like gnu diff discarding unmatched lines
+    const U32* A = Old;
+    const U32* B = New;
+    U32 N = OldLen, M = NewLen;
+
+    U32* Kept = nullptr;
+    U8* KeptChanged = Changed;
+
+    if(IdLimit != 0)
+    {
+        U8* Sides = new U8[IdLimit];
+        Memory::Set(Sides, 0, IdLimit);
+
+        for(U32 I = 0; I < OldLen; I++)
+            Sides[Old[I]] |= 1;
+
+        for(U32 J = 0; J < NewLen; J++)
+            Sides[New[J]] |= 2;
+
+        //the kept ids followed by where each came from
+        Kept = new U32[Total * 2 + 1];
+        U32* From = Kept + Total;
+
+        N = 0;
+        for(U32 I = 0; I < OldLen; I++)
+        {
+            if(Sides[Old[I]] == 3)
+            {
+                Kept[N] = Old[I];
+                From[N++] = I;
+            }
+            else
+            {
+                OldChanged[I] = 1;
+            }
+        }
+
+        M = 0;
+        for(U32 J = 0; J < NewLen; J++)
+        {
+            if(Sides[New[J]] == 3)
+            {
+                Kept[N + M] = New[J];
+                From[N + M++] = J;
+            }
+            else
+            {
+                NewChanged[J] = 1;
+            }
+        }
+
+        delete[] Sides;
+
+        A = Kept;
+        B = Kept + N;
+
+        KeptChanged = new U8[N + M + 1];
+        Memory::Set(KeptChanged, 0, N + M + 1);
+    }
+
+    //one diagonal for every possible edit either side of the middle plus some slack
+    const U32 Diagonals = N + M + 5;
+    I32* Diagonal = new I32[Diagonals * 2];
+
+    //gnu diff uses roughly the square root of the input with a floor of 4096
+    U32 Bits = 0;
+    while((1ULL << Bits) <= N + M)
+        Bits++;
+
+    DiffContext Ctx;
+    Ctx.Old = A;
+    Ctx.New = B;
+    Ctx.OldChanged = KeptChanged;
+    Ctx.NewChanged = KeptChanged + N;
+    Ctx.Forward = Diagonal;
+    Ctx.Backward = Diagonal + Diagonals;
+    Ctx.Expensive = Minimal ? 0x7FFFFFFF : (I32)Math::Max<U32>(4096, 1U << (Bits / 2));
+
+    Compare(Ctx, 0, N, 0, M);
+
+    delete[] Diagonal;
+
+    if(Kept)
+    {
+        const U32* From = Kept + Total;
+
+        for(U32 I = 0; I < N + M; I++)
+        {
+            if(KeptChanged[I])
+                (I < N ? OldChanged : NewChanged)[From[I]] = 1;
+        }
+
+        delete[] KeptChanged;
+        delete[] Kept;
+    }
+
+    //changed items become deletes and inserts, deletes first, everything else is kept
+    U32 I = 0, J = 0;
+
+    while(I < OldLen || J < NewLen)
+    {
+        const U32 StartI = I, StartJ = J;
+
+        if(I < OldLen && OldChanged[I])
+        {
+            while(I < OldLen && OldChanged[I])
+                I++;
+
+            AddEdit(Into, EditKind::Delete, OldBase + StartI, NewBase + J, I - StartI);
+        }
+        else if(J < NewLen && NewChanged[J])
+        {
+            while(J < NewLen && NewChanged[J])
+                J++;
+
+            AddEdit(Into, EditKind::Insert, OldBase + I, NewBase + StartJ, J - StartJ);
+        }
+        else
+        {
+            while(I < OldLen && J < NewLen && !OldChanged[I] && !NewChanged[J])
+            {
+                I++;
+                J++;
+            }
+
+            AddEdit(Into, EditKind::Keep, OldBase + StartI, NewBase + StartJ, I - StartI);
+        }
+    }
+
+    delete[] Changed;
+}
+
+/*================================================================*/
+/*              lines                                             */
+/*================================================================*/
+
+//every line keeps its newline so a last line without one never equals a line with one
+Array<StringView> SplitLines(StringView Text)
+{
+    U32 Count = 0;
+
+    for(U32 I = 0; I < Text.Len(); I++)
+    {
+        I += Utils::FindByte(Text.Data() + I, Text.Len() - I, '\n');
+        Count++;
+    }
+
+    Array<StringView> Ret(Count);
+    U32 Line = 0;
+
+    for(U32 I = 0; I < Text.Len();)
+    {
+        const U32 End = Math::Min(I + Utils::FindByte(Text.Data() + I, Text.Len() - I, '\n') + 1, Text.Len());
+
+        Ret[Line++] = StringView(Text.Data() + I, End - I);
+        I = End;
+    }
+
+    return Ret;
+}
+
+U64 HashLine(StringView Line)
+{
+    const char* Text = Line.Data();
+    U32 Len = Line.Len();
+
+    U64 Ret = 0x9E3779B97F4A7C15ULL ^ Len;
+
+    for(; Len >= 8; Text += 8, Len -= 8)
+    {
+        U64 Word;
+        Memory::Copy(Text, (char*)&Word, 8);
+
+        Ret = (Ret ^ Word) * 0xFF51AFD7ED558CCDULL;
+        Ret ^= Ret >> 32;
+    }
+
+    U64 Tail = 0;
+    Memory::Copy(Text, (char*)&Tail, Len);
+
+    Ret = (Ret ^ Tail) * 0xC4CEB9FE1A85EC53ULL;
+
+    return Ret ^ (Ret >> 29);
+}
+
+/*================================================================*/
+/*              unified output                                    */
+/*================================================================*/
+
+//ranges are 1 based, an empty range names the line before it
+void WriteRange(TextWriter& Out, U32 Start, U32 Count)
+{
+    if(Count == 0)
+    {
+        WriteTo(Out, Start);
+        Out.Write(",0", 2);
+        return;
+    }
+
+    WriteTo(Out, Start + 1);
+
+    if(Count != 1)
+    {
+        Out.Write(',');
+        WriteTo(Out, Count);
+    }
+}
+
+void WriteLine(TextWriter& Out, char Prefix, StringView Line)
+{
+    Out.Write(Prefix);
+    Out.Write(Line);
+
+    if(Line.Len() == 0 || Line[Line.Len() - 1] != '\n')
+        Out.Write("\n\\ No newline at end of file\n");
+}
+
+void WriteLines(TextWriter& Out, char Prefix, const Array<StringView>& Lines, U32 Start, U32 Count)
+{
+    for(U32 I = Start; I < Start + Count; I++)
+        WriteLine(Out, Prefix, Lines[I]);
+}
+
+}
+
+/*================================================================*/
+/*              Cthulhu::Utils diffs                              */
+/*================================================================*/
+
+Array<Edit> Cthulhu::Utils::DiffIds(const U32* Old, U32 OldLen, const U32* New, U32 NewLen, bool Minimal, U32 IdLimit)
+{
+    Array<Edit> Ret;
+
+    DiffInto(Ret, Old, OldLen, New, NewLen, Minimal, IdLimit, 0, 0);
+
+    return Ret;
+}
+
+TextDiff Cthulhu::Utils::DiffLines(StringView Old, StringView New, bool Minimal)
+{
+    TextDiff Ret = { SplitLines(Old), SplitLines(New), Array<Edit>() };
+
+    const U32 OldCount = Ret.OldLines.Len();
+    const U32 NewCount = Ret.NewLines.Len();
+
+    //lines that line up inside the common prefix of the texts are equal without hashing them
+    const U32 PrefixBytes = Utils::CommonPrefix(Old.Data(), New.Data(), Math::Min(Old.Len(), New.Len()));
+
+    U32 Prefix = 0, Used = 0;
+
+    while(Prefix < Math::Min(OldCount, NewCount))
+    {
+        const U32 Line = Ret.OldLines[Prefix].Len();
+
+        if(Used + Line > PrefixBytes || Ret.NewLines[Prefix].Len() != Line)
+            break;
+
+        Used += Line;
+        Prefix++;
+    }
+
+    //the same from the back without reaching into the prefix
+    const U32 Shorter = Math::Min(Old.Len(), New.Len()) - Used;
+    const U32 SuffixBytes = Utils::CommonSuffix(Old.Data() + Old.Len() - Shorter, New.Data() + New.Len() - Shorter, Shorter);
+
+    U32 Suffix = 0;
+    Used = 0;
+
+    while(Prefix + Suffix < Math::Min(OldCount, NewCount))
+    {
+        const U32 Line = Ret.OldLines[OldCount - Suffix - 1].Len();
+
+        if(Used + Line > SuffixBytes || Ret.NewLines[NewCount - Suffix - 1].Len() != Line)
+            break;
+
+        Used += Line;
+        Suffix++;
+    }
+
+    AddEdit(Ret.Edits, EditKind::Keep, 0, 0, Prefix);
+
+    //only the lines in between are hashed and given ids
+    const U32 OldMiddle = OldCount - Prefix - Suffix;
+    const U32 NewMiddle = NewCount - Prefix - Suffix;
+
+    if(OldMiddle + NewMiddle != 0)
+    {
+        Private::TokenTable Table(OldMiddle + NewMiddle);
+
+        auto LineAt = [&](U32 Index) {
+            return Index < OldMiddle ? Ret.OldLines[Prefix + Index] : Ret.NewLines[Prefix + Index - OldMiddle];
+        };
+
+        for(U32 I = 0; I < OldMiddle + NewMiddle; I++)
+        {
+            const StringView Line = LineAt(I);
+
+            Table.Intern(HashLine(Line), I, [&](U32 Other) { return LineAt(Other) == Line; });
+        }
+
+        DiffInto(Ret.Edits, Table.Ids, OldMiddle, Table.Ids + OldMiddle, NewMiddle, Minimal, Table.Count(), Prefix, Prefix);
+    }
+
+    AddEdit(Ret.Edits, EditKind::Keep, OldCount - Suffix, NewCount - Suffix, Suffix);
+
+    return Ret;
+}
+
+void Cthulhu::Utils::WriteUnifiedDiff(TextWriter& Out, const TextDiff& Diff, StringView OldName, StringView NewName, U32 Context)
+{
+    if(!Diff.Changed())
+        return;
+
+    Out.Write("--- ", 4);
+    Out.Write(OldName);
+    Out.Write("\n+++ ", 5);
+    Out.Write(NewName);
+    Out.Write('\n');
+
+    const Array<Edit>& Edits = Diff.Edits;
+
+    for(U32 First = 0; First < Edits.Len(); First++)
+    {
+        if(Edits[First].Kind == EditKind::Keep)
+            continue;
+
+        //extend the hunk while the unchanged gaps are small enough for the context to touch
+        U32 Last = First;
+
+        while(Last + 1 < Edits.Len())
+        {
+            const Edit& Next = Edits[Last + 1];
+
+            if(Next.Kind != EditKind::Keep)
+                Last++;
+            else if(Last + 2 < Edits.Len() && Next.Length <= Context * 2)
+                Last += 2;
+            else
+                break;
+        }
+
+        const U32 Lead = First > 0 ? Math::Min(Context, Edits[First - 1].Length) : 0;
+        const U32 Trail = Last + 1 < Edits.Len() ? Math::Min(Context, Edits[Last + 1].Length) : 0;
+
+        const Edit& End = Edits[Last];
+        const U32 OldStart = Edits[First].Old - Lead;
+        const U32 NewStart = Edits[First].New - Lead;
+        const U32 OldEnd = End.Old + (End.Kind != EditKind::Insert ? End.Length : 0) + Trail;
+        const U32 NewEnd = End.New + (End.Kind != EditKind::Delete ? End.Length : 0) + Trail;
+
+        Out.Write("@@ -", 4);
+        WriteRange(Out, OldStart, OldEnd - OldStart);
+        Out.Write(" +", 2);
+        WriteRange(Out, NewStart, NewEnd - NewStart);
+        Out.Write(" @@\n", 4);
+
+        WriteLines(Out, ' ', Diff.OldLines, OldStart, Lead);
+
+        for(U32 I = First; I <= Last; I++)
+        {
+            const Edit& Current = Edits[I];
+
+            if(Current.Kind == EditKind::Keep)
+                WriteLines(Out, ' ', Diff.OldLines, Current.Old, Current.Length);
+            else if(Current.Kind == EditKind::Delete)
+                WriteLines(Out, '-', Diff.OldLines, Current.Old, Current.Length);
+            else
+                WriteLines(Out, '+', Diff.NewLines, Current.New, Current.Length);
+        }
+
+        WriteLines(Out, ' ', Diff.OldLines, OldEnd - Trail, Trail);
+
+        First = Last;
+    }
+}
+
+String Cthulhu::Utils::UnifiedDiff(StringView Old, StringView New, StringView OldName, StringView NewName, U32 Context)
+{
+    const TextDiff Diff = DiffLines(Old, New);
+
+    BufferWriter Out;
+    WriteUnifiedDiff(Out, Diff, OldName, NewName, Context);
+
+    return Out.Take();
+}
@@ -0,0 +1,274 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U8 U32 U64
+
+#include "Core/Collections/Array.h"
+//Array<T>
+
+#include "Core/Collections/StringView.h"
+//StringView
+
+#include "Core/Math/Hash.h"
+//Utils::Hash
+
+#include "TextWriter.h"
+//TextWriter
+
+#pragma once
+
+namespace Cthulhu
+{
+
+/**
+ * @brief what an Edit does to the old sequence
+ */
+enum class EditKind : U8
+{
+    ///the items are in both sequences
+    Keep,
+
+    ///the items are only in the old sequence
+    Delete,
+
+    ///the items are only in the new sequence
+    Insert
+};
+
+/**
+ * @brief a run of items that are all kept, deleted or inserted
+ *
+ * @description an edit script is a list of these in order. applying it means
+ *              walking the old sequence, copying Keep runs, skipping Delete runs
+ *              and splicing in Insert runs from the new sequence. a Delete
+ *              always comes before an Insert at the same place
+ */
+struct Edit
+{
+    EditKind Kind;
+
+    ///where the run starts in the old sequence, for an insert this is where it goes
+    U32 Old;
+
+    ///where the run starts in the new sequence, for a delete this is where it would have been
+    U32 New;
+
+    ///how many items the run covers
+    U32 Length;
+};
+
+/**
+ * @brief the lines of two texts and the edits between them
+ *
+ * @description the lines are views into the texts that were diffed so they
+ *              have to outlive this. every line includes its newline, only
+ *              the last line of a text might not have one
+ */
+struct TextDiff
+{
+    Array<StringView> OldLines;
+    Array<StringView> NewLines;
+    Array<Edit> Edits;
+
+    /**
+     * @brief if the texts had any differences at all
+     */
+    CTU_INLINE bool Changed() const
+    {
+        return Edits.Len() > 1 || (Edits.Len() == 1 && Edits[0].Kind != EditKind::Keep);
+    }
+};
+
+namespace Private
+{
+    //hands out the same id to equal items so the diff itself only compares integers
+    struct TokenTable
+    {
+        TokenTable(U32 Count)
+            : Ids(new U32[Count + 1])
+            , Mask(15)
+        {
+            //at most half full so probes stay short
+            while(Mask < Count * 2)
+                Mask = (Mask * 2) + 1;
+
+            Slots = new Slot[Mask + 1];
+        }
+
+        TokenTable(const TokenTable&) = delete;
+        TokenTable& operator=(const TokenTable&) = delete;
+
+        ~TokenTable()
+        {
+            delete[] Slots;
+            delete[] Ids;
+        }
+
+        /**
+         * @brief get the id for an item, equal items get the same id
+         *
+         * @param Hash the hash of the item
+         * @param Index where the item is, items have to be interned in order starting at 0
+         * @param Equal called with the Index of an earlier item with the same hash
+         */
+        template<typename TEqual>
+        CTU_INLINE U32 Intern(U64 Hash, U32 Index, TEqual Equal)
+        {
+            //weak hashes like the ones for integers are spread out first,
+            //the top half picks the slot and the bottom half is kept to filter compares
+            const U64 Mixed = Hash * 0x9E3779B97F4A7C15ULL;
+            const U32 Check = (U32)Mixed;
+
+            for(U32 I = (U32)(Mixed >> 32) & Mask;; I = (I + 1) & Mask)
+            {
+                Slot& Current = Slots[I];
+
+                if(Current.Index == Unused)
+                {
+                    Current = { Check, Index };
+                    return Ids[Index] = Next++;
+                }
+
+                if(Current.Check == Check && Equal(Current.Index))
+                    return Ids[Index] = Ids[Current.Index];
+            }
+        }
+
+        ///how many different ids have been handed out, every id is below this
+        CTU_INLINE U32 Count() const { return Next; }
+
+        ///the id of every item interned so far in order
+        U32* Ids;
+
+    private:
+        static constexpr U32 Unused = 0xFFFFFFFF;
+
+        //the id lives in Ids so a slot is only 8 bytes and more of the table stays in cache
+        struct Slot
+        {
+            U32 Check;
+            U32 Index = Unused;
+        };
+
+        Slot* Slots;
+        U32 Mask;
+        U32 Next = 0;
+    };
+}
+
+namespace Utils
+{
+    /**
+     * @brief find the shortest edit script between two sequences of ids
+     *
+     * @description this is Myers O(ND) diff using the linear space middle snake so memory
+     *              stays proportional to the input no matter how different it is. the
+     *              common start and end of every sub problem is skipped 16 bytes at a time
+     *              before searching. when the edit distance gets huge the search gives up on
+     *              being minimal and splits at the furthest point it reached, the same as
+     *              gnu diff does, unless Minimal is set
+     *
+     * @param Old the old sequence
+     * @param OldLen how many ids are in Old
+     * @param New the new sequence
+     * @param NewLen how many ids are in New
+     * @param Minimal always find the shortest script even if it takes a long time
+     * @param IdLimit if every id is below this then ids that are only in one sequence
+     *                are thrown out before searching, which is what keeps mostly rewritten
+     *                inputs fast. 0 means the ids could be anything
+     * @return Array<Edit> the edit script, empty if both sequences are empty
+     */
+    Array<Edit> DiffIds(const U32* Old, U32 OldLen, const U32* New, U32 NewLen, bool Minimal = false, U32 IdLimit = 0);
+
+    /**
+     * @brief find the shortest edit script between two arrays
+     *
+     * @description every item is given an id first by bucketing on Utils::Hash and
+     *              comparing with == so the diff only ever compares integers
+     *
+     * @code{.cpp}
+     *
+     * Array<I64> Old = { 1, 2, 3, 4 };
+     * Array<I64> New = { 1, 3, 4, 5 };
+     *
+     * Array<Edit> Edits = Utils::Diff(Old, New);
+     * // { Keep 1, Delete 1, Keep 2, Insert 1 }
+     *
+     * @endcode
+     */
+    template<typename T>
+    Array<Edit> Diff(const Array<T>& Old, const Array<T>& New, bool Minimal = false)
+    {
+        const U32 OldLen = Old.Len();
+        const U32 Total = OldLen + New.Len();
+
+        Private::TokenTable Table(Total);
+
+        for(U32 I = 0; I < Total; I++)
+        {
+            const T& Item = I < OldLen ? Old[I] : New[I - OldLen];
+
+            Table.Intern(Hash(Item), I, [&](U32 Other) {
+                return (Other < OldLen ? Old[Other] : New[Other - OldLen]) == Item;
+            });
+        }
+
+        return DiffIds(Table.Ids, OldLen, Table.Ids + OldLen, Total - OldLen, Minimal, Table.Count());
+    }
+
+    /**
+     * @brief diff two texts line by line
+     *
+     * @description the common start and end of both texts are skipped a byte
+     *              at a time before any lines are hashed, so small changes to
+     *              large files only do work around the changes
+     *
+     * @param Old the old text
+     * @param New the new text
+     * @param Minimal always find the shortest script even if it takes a long time
+     * @return TextDiff the lines of both texts and the edits between them
+     */
+    TextDiff DiffLines(StringView Old, StringView New, bool Minimal = false);
+
+    /**
+     * @brief write a diff in the unified format that diff -u and patch use
+     *
+     * @param Out where to write the diff
+     * @param Diff the diff to write
+     * @param OldName the name on the --- line
+     * @param NewName the name on the +++ line
+     * @param Context how many unchanged lines to show around each change
+     */
+    void WriteUnifiedDiff(TextWriter& Out, const TextDiff& Diff, StringView OldName, StringView NewName, U32 Context = 3);
+
+    /**
+     * @brief diff two texts into the unified format
+     *
+     * @code{.cpp}
+     *
+     * String Patch = Utils::UnifiedDiff(OldConfig, NewConfig, "old/config.ini", "new/config.ini");
+     *
+     * @endcode
+     *
+     * @return String the diff or an empty string if the texts are the same
+     */
+    String UnifiedDiff(StringView Old, StringView New, StringView OldName = "a", StringView NewName = "b", U32 Context = 3);
+}
+
+}
@@ -0,0 +1,948 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdlib.h>
+//strtod strtof
+
+#include "Float.h"
+#include "FloatTables.h"
+
+#include "Integer.h"
+//Utils::IntegerToChars
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy
+
+using namespace Cthulhu;
+using namespace Cthulhu::Private;
+
+namespace
+{
+
+/*================================================================*/
+/*              128 bit helpers                                   */
+/*================================================================*/
+
+struct U128
+{
+    U64 Low;
+    U64 High;
+};
+
+CTU_INLINE U128 Multiply(U64 Left, U64 Right)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 Product = (unsigned __int128)Left * Right;
+    return { (U64)Product, (U64)(Product >> 64) };
+#else
+    const U64 LeftLow = Left & 0xFFFFFFFF, LeftHigh = Left >> 32;
+    const U64 RightLow = Right & 0xFFFFFFFF, RightHigh = Right >> 32;
+
+    const U64 LowLow = LeftLow * RightLow;
+    const U64 LowHigh = LeftLow * RightHigh;
+    const U64 HighLow = LeftHigh * RightLow;
+    const U64 HighHigh = LeftHigh * RightHigh;
+
+    const U64 Middle = (LowLow >> 32) + (LowHigh & 0xFFFFFFFF) + (HighLow & 0xFFFFFFFF);
+
+    return { (LowLow & 0xFFFFFFFF) | (Middle << 32), HighHigh + (LowHigh >> 32) + (HighLow >> 32) + (Middle >> 32) };
+#endif
+}
+
+CTU_INLINE U32 LeadingZeros(U64 Num)
+{
+#if CC_MSVC
+    unsigned long Index;
+    _BitScanReverse64(&Index, Num);
+    return 63 - Index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(Num);
+#else
+    U32 Ret = 0;
+    while(!(Num & (1ULL << 63))) { Num <<= 1; Ret++; }
+    return Ret;
+#endif
+}
+
+template<typename TTo, typename TFrom>
+CTU_INLINE TTo BitCast(TFrom From)
+{
+    static_assert(sizeof(TTo) == sizeof(TFrom));
+    TTo Ret;
+    Memory::Copy((const Byte*)&From, (Byte*)&Ret, sizeof(TTo));
+    return Ret;
+}
+
+/*================================================================*/
+/*              shortest digits with Ryu                          */
+/*================================================================*/
+
+//the value is Mantissa * 10^Exponent
+struct Decimal
+{
+    U64 Mantissa;
+    I32 Exponent;
+};
+
+//ceil(log2(5^Num)) or 1 when Num is 0
+CTU_INLINE I32 Pow5Bits(I32 Num) { return (I32)(((U32)Num * 1217359) >> 19) + 1; }
+
+//floor(log10(2^Num))
+CTU_INLINE U32 Log10Pow2(I32 Num) { return ((U32)Num * 78913) >> 18; }
+
+//floor(log10(5^Num))
+CTU_INLINE U32 Log10Pow5(I32 Num) { return ((U32)Num * 732923) >> 20; }
+
+template<typename T>
+CTU_INLINE U32 Pow5Factor(T Num)
+{
+    U32 Ret = 0;
+
+    while(Num % 5 == 0)
+    {
+        Num /= 5;
+        Ret++;
+    }
+
+    return Ret;
+}
+
+template<typename T>
+CTU_INLINE bool MultipleOfPow5(T Num, U32 Pow) { return Pow5Factor(Num) >= Pow; }
+
+template<typename T>
+CTU_INLINE bool MultipleOfPow2(T Num, U32 Pow) { return (Num & (((T)1 << Pow) - 1)) == 0; }
+
+constexpr I32 DoubleMantissaBits = 52;
+constexpr I32 DoubleBias = 1023;
+constexpr I32 DoublePow5InvBits = 125;
+constexpr I32 DoublePow5Bits = 125;
+
+constexpr I32 FloatMantissaBits = 23;
+constexpr I32 FloatBias = 127;
+constexpr I32 FloatPow5InvBits = 59;
+constexpr I32 FloatPow5Bits = 61;
+
+//(Num * Mul) >> Shift where Mul is a 128 bit number and Shift is more than 64
+CTU_INLINE U64 MulShift64(U64 Num, const U64* Mul, I32 Shift)
+{
+    const U128 Low = Multiply(Num, Mul[0]);
+    const U128 High = Multiply(Num, Mul[1]);
+
+    const U64 SumLow = High.Low + Low.High;
+    const U64 SumHigh = High.High + (SumLow < High.Low);
+
+    const I32 Dist = Shift - 64;
+
+    return (SumLow >> Dist) | (SumHigh << (64 - Dist));
+}
+
+//(Num * Mul) >> Shift where Mul is a 64 bit number and Shift is more than 32
+CTU_INLINE U32 MulShift32(U32 Num, U64 Mul, I32 Shift)
+{
+    const U64 Low = (U64)Num * (U32)Mul;
+    const U64 High = (U64)Num * (U32)(Mul >> 32);
+
+    return (U32)(((Low >> 32) + High) >> (Shift - 32));
+}
+
+//integers below 2^53 are their own shortest representation, just without the trailing zeros
+bool SmallInteger(U64 Mantissa, U32 Exponent, Decimal& Out)
+{
+    const U64 Whole = (1ULL << DoubleMantissaBits) | Mantissa;
+    const I32 Shift = (I32)Exponent - DoubleBias - DoubleMantissaBits;
+
+    if(Shift > 0 || Shift < -DoubleMantissaBits)
+        return false;
+
+    const U64 Fraction = Whole & ((1ULL << -Shift) - 1);
+
+    if(Fraction != 0)
+        return false;
+
+    Out = { Whole >> -Shift, 0 };
+
+    while(Out.Mantissa % 10 == 0)
+    {
+        Out.Mantissa /= 10;
+        Out.Exponent++;
+    }
+
+    return true;
+}
+
+Decimal ShortestDouble(U64 IeeeMantissa, U32 IeeeExponent)
+{
+    I32 E2;
+    U64 M2;
+
+    if(IeeeExponent == 0)
+    {
+        //subnormal, the 2 extra bits make space for the halfway points
+        E2 = 1 - DoubleBias - DoubleMantissaBits - 2;
+        M2 = IeeeMantissa;
+    }
+    else
+    {
+        E2 = (I32)IeeeExponent - DoubleBias - DoubleMantissaBits - 2;
+        M2 = (1ULL << DoubleMantissaBits) | IeeeMantissa;
+    }
+
+    //when the mantissa is even the bounds round to it so they are included
+    const bool AcceptBounds = (M2 & 1) == 0;
+
+    const U64 MV = 4 * M2;
+
+    //the gap below is half the size at the bottom of each exponent
+    const U32 MMShift = IeeeMantissa != 0 || IeeeExponent <= 1;
+
+    U64 VR, VP, VM;
+    I32 E10;
+
+    bool VMIsTrailingZeros = false;
+    bool VRIsTrailingZeros = false;
+
+    if(E2 >= 0)
+    {
+        const U32 Q = Log10Pow2(E2) - (E2 > 3);
+        E10 = (I32)Q;
+
+        const I32 K = DoublePow5InvBits + Pow5Bits(Q) - 1;
+        const I32 I = -E2 + (I32)Q + K;
+
+        VR = MulShift64(4 * M2, DoublePow5InvSplit[Q], I);
+        VP = MulShift64(4 * M2 + 2, DoublePow5InvSplit[Q], I);
+        VM = MulShift64(4 * M2 - 1 - MMShift, DoublePow5InvSplit[Q], I);
+
+        //only small powers can leave the whole product divisible
+        if(Q <= 21)
+        {
+            if(MV % 5 == 0)
+                VRIsTrailingZeros = MultipleOfPow5(MV, Q);
+            else if(AcceptBounds)
+                VMIsTrailingZeros = MultipleOfPow5(MV - 1 - MMShift, Q);
+            else
+                VP -= MultipleOfPow5(MV + 2, Q);
+        }
+    }
+    else
+    {
+        const U32 Q = Log10Pow5(-E2) - (-E2 > 1);
+        E10 = (I32)Q + E2;
+
+        const I32 I = -E2 - (I32)Q;
+        const I32 K = Pow5Bits(I) - DoublePow5Bits;
+        const I32 J = (I32)Q - K;
+
+        VR = MulShift64(4 * M2, DoublePow5Split[I], J);
+        VP = MulShift64(4 * M2 + 2, DoublePow5Split[I], J);
+        VM = MulShift64(4 * M2 - 1 - MMShift, DoublePow5Split[I], J);
+
+        if(Q <= 1)
+        {
+            //MV has at least Q trailing zero bits so VR is exact
+            VRIsTrailingZeros = true;
+
+            if(AcceptBounds)
+                VMIsTrailingZeros = MMShift == 1;
+            else
+                VP--;
+        }
+        else if(Q < 63)
+        {
+            VRIsTrailingZeros = MultipleOfPow2(MV, Q);
+        }
+    }
+
+    //now drop digits while the bounds still have different prefixes
+    I32 Removed = 0;
+    U8 LastRemovedDigit = 0;
+    U64 Output;
+
+    if(VMIsTrailingZeros || VRIsTrailingZeros)
+    {
+        //the rare case where ties have to be handled exactly
+        while(VP / 10 > VM / 10)
+        {
+            VMIsTrailingZeros &= VM % 10 == 0;
+            VRIsTrailingZeros &= LastRemovedDigit == 0;
+            LastRemovedDigit = (U8)(VR % 10);
+            VR /= 10;
+            VP /= 10;
+            VM /= 10;
+            Removed++;
+        }
+
+        if(VMIsTrailingZeros)
+        {
+            while(VM % 10 == 0)
+            {
+                VRIsTrailingZeros &= LastRemovedDigit == 0;
+                LastRemovedDigit = (U8)(VR % 10);
+                VR /= 10;
+                VP /= 10;
+                VM /= 10;
+                Removed++;
+            }
+        }
+
+        //round half to even
+        if(VRIsTrailingZeros && LastRemovedDigit == 5 && VR % 2 == 0)
+            LastRemovedDigit = 4;
+
+        Output = VR + ((VR == VM && (!AcceptBounds || !VMIsTrailingZeros)) || LastRemovedDigit >= 5);
+    }
+    else
+    {
+        bool RoundUp = false;
+
+        //most numbers lose at least 2 digits so try that first
+        if(VP / 100 > VM / 100)
+        {
+            RoundUp = VR % 100 >= 50;
+            VR /= 100;
+            VP /= 100;
+            VM /= 100;
+            Removed += 2;
+        }
+
+        while(VP / 10 > VM / 10)
+        {
+            RoundUp = VR % 10 >= 5;
+            VR /= 10;
+            VP /= 10;
+            VM /= 10;
+            Removed++;
+        }
+
+        Output = VR + (VR == VM || RoundUp);
+    }
+
+    return { Output, E10 + Removed };
+}
+
+Decimal ShortestFloat(U32 IeeeMantissa, U32 IeeeExponent)
+{
+    I32 E2;
+    U32 M2;
+
+    if(IeeeExponent == 0)
+    {
+        E2 = 1 - FloatBias - FloatMantissaBits - 2;
+        M2 = IeeeMantissa;
+    }
+    else
+    {
+        E2 = (I32)IeeeExponent - FloatBias - FloatMantissaBits - 2;
+        M2 = (1U << FloatMantissaBits) | IeeeMantissa;
+    }
+
+    const bool AcceptBounds = (M2 & 1) == 0;
+
+    const U32 MV = 4 * M2;
+    const U32 MP = 4 * M2 + 2;
+    const U32 MMShift = IeeeMantissa != 0 || IeeeExponent <= 1;
+    const U32 MM = 4 * M2 - 1 - MMShift;
+
+    U32 VR, VP, VM;
+    I32 E10;
+
+    bool VMIsTrailingZeros = false;
+    bool VRIsTrailingZeros = false;
+    U8 LastRemovedDigit = 0;
+
+    if(E2 >= 0)
+    {
+        const U32 Q = Log10Pow2(E2);
+        E10 = (I32)Q;
+
+        const I32 K = FloatPow5InvBits + Pow5Bits(Q) - 1;
+        const I32 I = -E2 + (I32)Q + K;
+
+        VR = MulShift32(MV, FloatPow5InvSplit[Q], I);
+        VP = MulShift32(MP, FloatPow5InvSplit[Q], I);
+        VM = MulShift32(MM, FloatPow5InvSplit[Q], I);
+
+        if(Q != 0 && (VP - 1) / 10 <= VM / 10)
+        {
+            //the loop below wont run so the digit it would have removed is needed now
+            const I32 L = FloatPow5InvBits + Pow5Bits(Q - 1) - 1;
+            LastRemovedDigit = (U8)(MulShift32(MV, FloatPow5InvSplit[Q - 1], -E2 + (I32)Q - 1 + L) % 10);
+        }
+
+        if(Q <= 9)
+        {
+            if(MV % 5 == 0)
+                VRIsTrailingZeros = MultipleOfPow5(MV, Q);
+            else if(AcceptBounds)
+                VMIsTrailingZeros = MultipleOfPow5(MM, Q);
+            else
+                VP -= MultipleOfPow5(MP, Q);
+        }
+    }
+    else
+    {
+        const U32 Q = Log10Pow5(-E2);
+        E10 = (I32)Q + E2;
+
+        const I32 I = -E2 - (I32)Q;
+        const I32 K = Pow5Bits(I) - FloatPow5Bits;
+        I32 J = (I32)Q - K;
+
+        VR = MulShift32(MV, FloatPow5Split[I], J);
+        VP = MulShift32(MP, FloatPow5Split[I], J);
+        VM = MulShift32(MM, FloatPow5Split[I], J);
+
+        if(Q != 0 && (VP - 1) / 10 <= VM / 10)
+        {
+            J = (I32)Q - 1 - (Pow5Bits(I + 1) - FloatPow5Bits);
+            LastRemovedDigit = (U8)(MulShift32(MV, FloatPow5Split[I + 1], J) % 10);
+        }
+
+        if(Q <= 1)
+        {
+            VRIsTrailingZeros = true;
+
+            if(AcceptBounds)
+                VMIsTrailingZeros = MMShift == 1;
+            else
+                VP--;
+        }
+        else if(Q < 31)
+        {
+            VRIsTrailingZeros = MultipleOfPow2(MV, Q - 1);
+        }
+    }
+
+    I32 Removed = 0;
+    U32 Output;
+
+    if(VMIsTrailingZeros || VRIsTrailingZeros)
+    {
+        while(VP / 10 > VM / 10)
+        {
+            VMIsTrailingZeros &= VM % 10 == 0;
+            VRIsTrailingZeros &= LastRemovedDigit == 0;
+            LastRemovedDigit = (U8)(VR % 10);
+            VR /= 10;
+            VP /= 10;
+            VM /= 10;
+            Removed++;
+        }
+
+        if(VMIsTrailingZeros)
+        {
+            while(VM % 10 == 0)
+            {
+                VRIsTrailingZeros &= LastRemovedDigit == 0;
+                LastRemovedDigit = (U8)(VR % 10);
+                VR /= 10;
+                VP /= 10;
+                VM /= 10;
+                Removed++;
+            }
+        }
+
+        if(VRIsTrailingZeros && LastRemovedDigit == 5 && VR % 2 == 0)
+            LastRemovedDigit = 4;
+
+        Output = VR + ((VR == VM && (!AcceptBounds || !VMIsTrailingZeros)) || LastRemovedDigit >= 5);
+    }
+    else
+    {
+        while(VP / 10 > VM / 10)
+        {
+            LastRemovedDigit = (U8)(VR % 10);
+            VR /= 10;
+            VP /= 10;
+            VM /= 10;
+            Removed++;
+        }
+
+        Output = VR + (VR == VM || LastRemovedDigit >= 5);
+    }
+
+    return { Output, E10 + Removed };
+}
+
+/*================================================================*/
+/*              writing the digits out                            */
+/*================================================================*/
+
+U32 WriteSpecial(bool Negative, bool Nan, char* Into)
+{
+    char* Cursor = Into;
+
+    if(Nan)
+    {
+        Memory::Copy("nan", Cursor, 3);
+        return 3;
+    }
+
+    if(Negative)
+        *Cursor++ = '-';
+
+    Memory::Copy("inf", Cursor, 3);
+    return (U32)(Cursor - Into) + 3;
+}
+
+//write Value like javascript does, in full when its reasonably sized and with an exponent otherwise
+U32 WriteDecimal(bool Negative, Decimal Value, char* Into)
+{
+    char Digits[Utils::MaxIntegerChars];
+    const U32 Count = Utils::IntegerToChars(Value.Mantissa, Digits);
+
+    char* Cursor = Into;
+
+    if(Negative)
+        *Cursor++ = '-';
+
+    //where the decimal point goes relative to the first digit
+    const I32 Point = (I32)Count + Value.Exponent;
+
+    if((I32)Count <= Point && Point <= 21)
+    {
+        Memory::Copy(Digits, Cursor, Count);
+        Cursor += Count;
+
+        for(I32 I = Count; I < Point; I++)
+            *Cursor++ = '0';
+    }
+    else if(0 < Point && Point <= 21)
+    {
+        Memory::Copy(Digits, Cursor, Point);
+        Cursor += Point;
+        *Cursor++ = '.';
+        Memory::Copy(Digits + Point, Cursor, Count - Point);
+        Cursor += Count - Point;
+    }
+    else if(-6 < Point && Point <= 0)
+    {
+        *Cursor++ = '0';
+        *Cursor++ = '.';
+
+        for(I32 I = Point; I < 0; I++)
+            *Cursor++ = '0';
+
+        Memory::Copy(Digits, Cursor, Count);
+        Cursor += Count;
+    }
+    else
+    {
+        *Cursor++ = Digits[0];
+
+        if(Count > 1)
+        {
+            *Cursor++ = '.';
+            Memory::Copy(Digits + 1, Cursor, Count - 1);
+            Cursor += Count - 1;
+        }
+
+        I32 Exponent = Point - 1;
+
+        *Cursor++ = 'e';
+        *Cursor++ = Exponent < 0 ? '-' : '+';
+
+        if(Exponent < 0)
+            Exponent = -Exponent;
+
+        if(Exponent >= 100)
+            *Cursor++ = (char)('0' + (Exponent / 100));
+
+        if(Exponent >= 10)
+            *Cursor++ = (char)('0' + ((Exponent / 10) % 10));
+
+        *Cursor++ = (char)('0' + (Exponent % 10));
+    }
+
+    return (U32)(Cursor - Into);
+}
+
+/*================================================================*/
+/*              correctly rounded parsing with Eisel-Lemire       */
+/*================================================================*/
+
+template<typename T> struct FloatTraits;
+
+template<>
+struct FloatTraits<F64>
+{
+    using Bits = U64;
+
+    static constexpr I32 MantissaBits = 52;
+    static constexpr I32 MinExponent = -1023;
+    static constexpr I32 InfinitePower = 0x7FF;
+    static constexpr I64 SmallestPow10 = -342;
+    static constexpr I64 LargestPow10 = 308;
+    static constexpr I64 MinRoundToEven = -4;
+    static constexpr I64 MaxRoundToEven = 23;
+
+    //the range where the mantissa and power of 10 are both exact so a single multiply is correctly rounded
+    static constexpr I64 MaxExactPow10 = 22;
+    static constexpr U64 MaxExactMantissa = 1ULL << 53;
+
+    static F64 ExactPow10(I64 Pow)
+    {
+        constexpr F64 Powers[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        return Powers[Pow];
+    }
+
+    static F64 Fallback(const char* Text) { return strtod(Text, nullptr); }
+};
+
+template<>
+struct FloatTraits<F32>
+{
+    using Bits = U32;
+
+    static constexpr I32 MantissaBits = 23;
+    static constexpr I32 MinExponent = -127;
+    static constexpr I32 InfinitePower = 0xFF;
+    static constexpr I64 SmallestPow10 = -65;
+    static constexpr I64 LargestPow10 = 38;
+    static constexpr I64 MinRoundToEven = -17;
+    static constexpr I64 MaxRoundToEven = 10;
+
+    static constexpr I64 MaxExactPow10 = 10;
+    static constexpr U64 MaxExactMantissa = 1ULL << 24;
+
+    static F32 ExactPow10(I64 Pow)
+    {
+        constexpr F32 Powers[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+        return Powers[Pow];
+    }
+
+    static F32 Fallback(const char* Text) { return strtof(Text, nullptr); }
+};
+
+//the mantissa and biased exponent of a float before its packed
+struct AdjustedMantissa
+{
+    U64 Mantissa;
+    I32 Power2;
+};
+
+//Mantissa * 10^Pow10 rounded to the nearest float
+//the paper proves the 128 bit product is always enough when the mantissa is exact
+template<typename T>
+AdjustedMantissa EiselLemire(I64 Pow10, U64 Mantissa)
+{
+    using Traits = FloatTraits<T>;
+
+    if(Mantissa == 0 || Pow10 < Traits::SmallestPow10)
+        return { 0, 0 };
+
+    if(Pow10 > Traits::LargestPow10)
+        return { 0, Traits::InfinitePower };
+
+    const U32 Zeros = LeadingZeros(Mantissa);
+    Mantissa <<= Zeros;
+
+    const U64* Power = Pow5_128[Pow10 + 342];
+
+    //only look at the low half of the power when the high half leaves the result ambiguous
+    constexpr U64 PrecisionMask = 0xFFFFFFFFFFFFFFFF >> (Traits::MantissaBits + 3);
+
+    U128 Product = Multiply(Mantissa, Power[0]);
+
+    if((Product.High & PrecisionMask) == PrecisionMask)
+    {
+        const U128 Second = Multiply(Mantissa, Power[1]);
+
+        Product.Low += Second.High;
+
+        if(Second.High > Product.Low)
+            Product.High++;
+    }
+
+    const I32 UpperBit = (I32)(Product.High >> 63);
+    const I32 Shift = UpperBit + 64 - Traits::MantissaBits - 3;
+
+    AdjustedMantissa Ret;
+    Ret.Mantissa = Product.High >> Shift;
+
+    //floor(log2(10^Pow10)) + 63
+    const I32 Power2 = (I32)(((152170 + 65536) * Pow10) >> 16) + 63;
+    Ret.Power2 = Power2 + UpperBit - (I32)Zeros - Traits::MinExponent;
+
+    if(Ret.Power2 <= 0)
+    {
+        //subnormal
+        if(-Ret.Power2 + 1 >= 64)
+            return { 0, 0 };
+
+        Ret.Mantissa >>= -Ret.Power2 + 1;
+        Ret.Mantissa += Ret.Mantissa & 1;
+        Ret.Mantissa >>= 1;
+
+        //rounding up can carry into the smallest normal number
+        Ret.Power2 = Ret.Mantissa < (1ULL << Traits::MantissaBits) ? 0 : 1;
+
+        return Ret;
+    }
+
+    //exactly halfway between two floats needs to round to the even one instead of up
+    if(Product.Low <= 1 && Pow10 >= Traits::MinRoundToEven && Pow10 <= Traits::MaxRoundToEven && (Ret.Mantissa & 3) == 1)
+    {
+        if((Ret.Mantissa << Shift) == Product.High)
+            Ret.Mantissa &= ~1ULL;
+    }
+
+    Ret.Mantissa += Ret.Mantissa & 1;
+    Ret.Mantissa >>= 1;
+
+    if(Ret.Mantissa >= (2ULL << Traits::MantissaBits))
+    {
+        Ret.Mantissa = 1ULL << Traits::MantissaBits;
+        Ret.Power2++;
+    }
+
+    Ret.Mantissa &= ~(1ULL << Traits::MantissaBits);
+
+    if(Ret.Power2 >= Traits::InfinitePower)
+        return { 0, Traits::InfinitePower };
+
+    return Ret;
+}
+
+template<typename T>
+T Pack(bool Negative, AdjustedMantissa Value)
+{
+    using Traits = FloatTraits<T>;
+    using Bits = typename Traits::Bits;
+
+    Bits Ret = (Bits)(Value.Mantissa & ((1ULL << Traits::MantissaBits) - 1));
+    Ret |= (Bits)Value.Power2 << Traits::MantissaBits;
+    Ret |= (Bits)Negative << (sizeof(Bits) * 8 - 1);
+
+    return BitCast<T>(Ret);
+}
+
+CTU_INLINE bool IsDigit(char C) { return '0' <= C && C <= '9'; }
+
+CTU_INLINE char LowerCase(char C) { return ('A' <= C && C <= 'Z') ? C + 32 : C; }
+
+//match a word without caring about case
+bool MatchWord(const char* Text, const char* End, const char* Word)
+{
+    for(; *Word; Word++, Text++)
+        if(Text == End || LowerCase(*Text) != *Word)
+            return false;
+
+    return true;
+}
+
+template<typename T>
+U32 ParseDecimal(const char* Text, U32 Len, T& Out)
+{
+    using Traits = FloatTraits<T>;
+
+    const char* Cursor = Text;
+    const char* End = Text + Len;
+
+    bool Negative = false;
+
+    if(Cursor != End && (*Cursor == '-' || *Cursor == '+'))
+        Negative = *Cursor++ == '-';
+
+    if(MatchWord(Cursor, End, "nan"))
+    {
+        Out = BitCast<T>((typename Traits::Bits)~0ULL >> 1);
+        return (U32)(Cursor - Text) + 3;
+    }
+
+    if(MatchWord(Cursor, End, "inf"))
+    {
+        Out = Pack<T>(Negative, { 0, Traits::InfinitePower });
+        return (U32)(Cursor - Text) + (MatchWord(Cursor, End, "infinity") ? 8 : 3);
+    }
+
+    //up to 19 digits always fit, anything past that only moves the exponent
+    U64 Mantissa = 0;
+    I64 Exponent = 0;
+    U32 Significant = 0;
+    bool Truncated = false;
+    bool AnyDigits = false;
+
+    for(; Cursor != End && IsDigit(*Cursor); Cursor++)
+    {
+        AnyDigits = true;
+
+        if(Significant < 19)
+        {
+            Mantissa = (Mantissa * 10) + (*Cursor - '0');
+            Significant += Mantissa != 0;
+        }
+        else
+        {
+            Exponent++;
+            Truncated |= *Cursor != '0';
+        }
+    }
+
+    if(Cursor != End && *Cursor == '.')
+    {
+        Cursor++;
+
+        for(; Cursor != End && IsDigit(*Cursor); Cursor++)
+        {
+            AnyDigits = true;
+
+            if(Significant < 19)
+            {
+                Mantissa = (Mantissa * 10) + (*Cursor - '0');
+                Significant += Mantissa != 0;
+                Exponent--;
+            }
+            else
+            {
+                Truncated |= *Cursor != '0';
+            }
+        }
+    }
+
+    if(!AnyDigits)
+        return 0;
+
+    //only consume the exponent if its actually followed by digits
+    if(Cursor != End && (*Cursor == 'e' || *Cursor == 'E'))
+    {
+        const char* Look = Cursor + 1;
+        bool NegativeExponent = false;
+
+        if(Look != End && (*Look == '-' || *Look == '+'))
+            NegativeExponent = *Look++ == '-';
+
+        if(Look != End && IsDigit(*Look))
+        {
+            I64 Written = 0;
+
+            for(; Look != End && IsDigit(*Look); Look++)
+                if(Written < 100000)
+                    Written = (Written * 10) + (*Look - '0');
+
+            Exponent += NegativeExponent ? -Written : Written;
+            Cursor = Look;
+        }
+    }
+
+    const U32 Consumed = (U32)(Cursor - Text);
+
+    //the mantissa and power are both exact so a single operation rounds correctly
+    if(!Truncated && Mantissa <= Traits::MaxExactMantissa && -Traits::MaxExactPow10 <= Exponent && Exponent <= Traits::MaxExactPow10)
+    {
+        T Value = (T)Mantissa;
+
+        if(Exponent < 0)
+            Value = Value / Traits::ExactPow10(-Exponent);
+        else
+            Value = Value * Traits::ExactPow10(Exponent);
+
+        Out = Negative ? -Value : Value;
+        return Consumed;
+    }
+
+    AdjustedMantissa Value = EiselLemire<T>(Exponent, Mantissa);
+
+    //the digits that were cut off could push the result either way,
+    //if rounding the mantissa up lands on a different float we cant tell which one it is
+    if(Truncated && Mantissa != 0)
+    {
+        const AdjustedMantissa Above = EiselLemire<T>(Exponent, Mantissa + 1);
+
+        if(Above.Mantissa != Value.Mantissa || Above.Power2 != Value.Power2)
+        {
+            char Stack[128];
+            char* Copy = Consumed < sizeof(Stack) ? Stack : new char[Consumed + 1];
+
+            Memory::Copy(Text, Copy, Consumed);
+            Copy[Consumed] = '\0';
+
+            Out = Traits::Fallback(Copy);
+
+            if(Copy != Stack)
+                delete[] Copy;
+
+            return Consumed;
+        }
+    }
+
+    Out = Pack<T>(Negative, Value);
+    return Consumed;
+}
+
+}
+
+/*================================================================*/
+/*              Cthulhu::Utils::FloatToChars                      */
+/*================================================================*/
+
+U32 Cthulhu::Utils::FloatToChars(F32 Num, char* Into)
+{
+    const U32 Bits = BitCast<U32>(Num);
+
+    const bool Negative = Bits >> 31;
+    const U32 IeeeMantissa = Bits & ((1U << FloatMantissaBits) - 1);
+    const U32 IeeeExponent = (Bits >> FloatMantissaBits) & 0xFF;
+
+    if(IeeeExponent == 0xFF)
+        return WriteSpecial(Negative, IeeeMantissa != 0, Into);
+
+    if(IeeeExponent == 0 && IeeeMantissa == 0)
+        return WriteDecimal(Negative, { 0, 0 }, Into);
+
+    return WriteDecimal(Negative, ShortestFloat(IeeeMantissa, IeeeExponent), Into);
+}
+
+U32 Cthulhu::Utils::FloatToChars(F64 Num, char* Into)
+{
+    const U64 Bits = BitCast<U64>(Num);
+
+    const bool Negative = Bits >> 63;
+    const U64 IeeeMantissa = Bits & ((1ULL << DoubleMantissaBits) - 1);
+    const U32 IeeeExponent = (U32)((Bits >> DoubleMantissaBits) & 0x7FF);
+
+    if(IeeeExponent == 0x7FF)
+        return WriteSpecial(Negative, IeeeMantissa != 0, Into);
+
+    if(IeeeExponent == 0 && IeeeMantissa == 0)
+        return WriteDecimal(Negative, { 0, 0 }, Into);
+
+    Decimal Value;
+
+    if(!SmallInteger(IeeeMantissa, IeeeExponent, Value))
+        Value = ShortestDouble(IeeeMantissa, IeeeExponent);
+
+    return WriteDecimal(Negative, Value, Into);
+}
+
+/*================================================================*/
+/*              Cthulhu::Utils::FloatFromChars                    */
+/*================================================================*/
+
+U32 Cthulhu::Utils::FloatFromChars(const char* Text, U32 Len, F32& Out)
+{
+    return ParseDecimal(Text, Len, Out);
+}
+
+U32 Cthulhu::Utils::FloatFromChars(const char* Text, U32 Len, F64& Out)
+{
+    return ParseDecimal(Text, Len, Out);
+}
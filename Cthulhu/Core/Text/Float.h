@@ -0,0 +1,71 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Aliases.h"
+//U32 F32 F64
+
+#pragma once
+
+namespace Cthulhu::Utils
+{
+
+/**
+ * @brief the most characters FloatToChars will ever write
+ */
+constexpr U32 MaxFloatChars = 32;
+
+/**
+ * @brief write the shortest text that parses back to exactly the same float
+ *
+ * @description the digits are found with the Ryu algorithm so this never has to
+ *              fall back to big integers or try multiple precisions like "%.17g" does.
+ *              numbers with a magnitude between 1e-7 and 1e21 are written out in full,
+ *              everything else uses an exponent. infinity is written as "inf" and
+ *              nan as "nan"
+ *
+ * @code{.cpp}
+ *
+ * char Buffer[Utils::MaxFloatChars];
+ *
+ * U32 Len = Utils::FloatToChars(0.1, Buffer);     // "0.1"
+ * Len = Utils::FloatToChars(1e300, Buffer);       // "1e+300"
+ * Len = Utils::FloatToChars(0.1f, Buffer);        // "0.1" rather than "0.10000000149011612"
+ *
+ * @endcode
+ *
+ * @param Num the float to write
+ * @param Into where to write the text, must have space for at least MaxFloatChars characters
+ * @return U32 how many characters were written, no null terminator is written
+ */
+U32 FloatToChars(F32 Num, char* Into);
+U32 FloatToChars(F64 Num, char* Into);
+
+/**
+ * @brief parse a float and round it correctly
+ *
+ * @description accepts [+-]digits[.digits][(e|E)[+-]digits] as well as inf, infinity and nan.
+ *              the Eisel-Lemire algorithm is used which handles nearly every input with
+ *              a single 128 bit multiply, inputs with more than 19 significant digits that
+ *              sit right on a rounding boundary fall back to the c library
+ *
+ * @param Text the text to parse, does not need to be null terminated
+ * @param Len the length of Text
+ * @param Out where the parsed value is written
+ * @return U32 how many characters were parsed or 0 if Text doesnt start with a number
+ */
+U32 FloatFromChars(const char* Text, U32 Len, F32& Out);
+U32 FloatFromChars(const char* Text, U32 Len, F64& Out);
+
+}
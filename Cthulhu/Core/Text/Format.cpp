@@ -0,0 +1,289 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+//snprintf
+
+#include "Format.h"
+
+#include "Core/Math/Math.h"
+//Math::Max Math::Min
+
+#include "Float.h"
+//Utils::FloatToChars
+
+#include "Integer.h"
+//Utils::IntegerToChars Utils::HexToChars
+
+using namespace Cthulhu;
+using namespace Cthulhu::Private;
+
+/*================================================================*/
+/*              Cthulhu::Private argument writers                 */
+/*================================================================*/
+
+namespace
+{
+
+//write Body with the padding a spec asks for
+//Prefix is the sign or base marker that zero padding has to go after
+void WritePadded(TextWriter& Sink, const FormatSpec& Spec, char DefaultAlign, const char* Prefix, U32 PrefixLen, const char* Body, U32 BodyLen)
+{
+    const U32 Len = PrefixLen + BodyLen;
+    const char Align = Spec.Align ? Spec.Align : DefaultAlign;
+
+    if(Spec.Width <= Len)
+    {
+        Sink.Write(Prefix, PrefixLen);
+        Sink.Write(Body, BodyLen);
+        return;
+    }
+
+    const U32 Padding = Spec.Width - Len;
+
+    switch(Align)
+    {
+    case '<':
+        Sink.Write(Prefix, PrefixLen);
+        Sink.Write(Body, BodyLen);
+        Sink.Write(Spec.Fill, Padding);
+        break;
+    case '^':
+        Sink.Write(Spec.Fill, Padding / 2);
+        Sink.Write(Prefix, PrefixLen);
+        Sink.Write(Body, BodyLen);
+        Sink.Write(Spec.Fill, Padding - (Padding / 2));
+        break;
+    case '=':
+        Sink.Write(Prefix, PrefixLen);
+        Sink.Write(Spec.Fill, Padding);
+        Sink.Write(Body, BodyLen);
+        break;
+    default:
+        Sink.Write(Spec.Fill, Padding);
+        Sink.Write(Prefix, PrefixLen);
+        Sink.Write(Body, BodyLen);
+        break;
+    }
+}
+
+void WriteInteger(TextWriter& Sink, const FormatSpec& Spec, U64 Magnitude, bool Negative)
+{
+    //64 binary digits is the longest an integer can get
+    char Buffer[64];
+    char* End = Buffer + sizeof(Buffer);
+    char* Cursor = End;
+
+    switch(Spec.Type)
+    {
+    case 'x': case 'X':
+        Cursor = Buffer;
+        End = Buffer + Utils::HexToChars(Magnitude, Buffer, Spec.Type == 'X');
+        break;
+    case 'b':
+    case 'o':
+    {
+        const U32 Shift = Spec.Type == 'b' ? 1 : 3;
+        const U64 Mask = (1ULL << Shift) - 1;
+
+        do
+        {
+            *--Cursor = (char)('0' + (Magnitude & Mask));
+            Magnitude >>= Shift;
+        }
+        while(Magnitude != 0);
+        break;
+    }
+    default:
+        Cursor = Buffer;
+        End = Buffer + Utils::IntegerToChars(Magnitude, Buffer);
+        break;
+    }
+
+    const char Sign = Negative ? '-' : '+';
+
+    WritePadded(Sink, Spec, '>', &Sign, (Negative || Spec.Plus) ? 1 : 0, Cursor, (U32)(End - Cursor));
+}
+
+void WriteFloat(TextWriter& Sink, const FormatSpec& Spec, F64 Value, bool Single)
+{
+    char Buffer[512];
+    char* Text = Buffer;
+    int Len;
+
+    //1 / -0 is -inf so this keeps the sign of -0
+    const bool Negative = Value < 0 || (Value == 0 && 1 / Value < 0);
+    const F64 Magnitude = Negative ? -Value : Value;
+
+    if(!Spec.Type && Spec.Precision == 0xFFFF)
+    {
+        //no precision was asked for so write the shortest text that round trips
+        Len = Single
+            ? Utils::FloatToChars((F32)Magnitude, Buffer)
+            : Utils::FloatToChars(Magnitude, Buffer);
+    }
+    else
+    {
+        char Format[16];
+
+        const char Type = Spec.Type ? Spec.Type : 'g';
+        const int Precision = Spec.Precision != 0xFFFF ? Spec.Precision : 6;
+
+        snprintf(Format, sizeof(Format), "%%.%d%c", Precision, Type);
+
+        Len = snprintf(Buffer, sizeof(Buffer), Format, Magnitude);
+
+        //big values or precisions dont fit on the stack, snprintf said how much room they need
+        if(Len >= (int)sizeof(Buffer))
+        {
+            Text = new char[Len + 1];
+            snprintf(Text, Len + 1, Format, Magnitude);
+        }
+    }
+
+    const char Sign = Negative ? '-' : '+';
+
+    WritePadded(Sink, Spec, '>', &Sign, (Negative || Spec.Plus) ? 1 : 0, Text, (U32)Len);
+
+    if(Text != Buffer)
+        delete[] Text;
+}
+
+void WriteText(TextWriter& Sink, const FormatSpec& Spec, const char* Text, U32 Len)
+{
+    if(Spec.Precision != 0xFFFF)
+        Len = Math::Min(Len, (U32)Spec.Precision);
+
+    WritePadded(Sink, Spec, '<', "", 0, Text, Len);
+}
+
+}
+
+void Cthulhu::Private::WriteFormatArg(TextWriter& Sink, const FormatArg& Arg, const FormatSpec& Spec)
+{
+    switch(Arg.Kind)
+    {
+    case FormatKind::Signed:
+        if(Spec.Type == 'c')
+        {
+            const char C = (char)Arg.Signed;
+            WriteText(Sink, Spec, &C, 1);
+        }
+        else
+        {
+            //negate as unsigned so the smallest I64 doesnt overflow
+            const bool Negative = Arg.Signed < 0;
+            WriteInteger(Sink, Spec, Negative ? 0 - (U64)Arg.Signed : (U64)Arg.Signed, Negative);
+        }
+        break;
+
+    case FormatKind::Unsigned:
+        if(Spec.Type == 'c')
+        {
+            const char C = (char)Arg.Unsigned;
+            WriteText(Sink, Spec, &C, 1);
+        }
+        else
+        {
+            WriteInteger(Sink, Spec, Arg.Unsigned, false);
+        }
+        break;
+
+    case FormatKind::Float:
+        WriteFloat(Sink, Spec, Arg.Float, Arg.Single);
+        break;
+
+    case FormatKind::Bool:
+        if(Spec.Type && Spec.Type != 's')
+            WriteInteger(Sink, Spec, Arg.Bool ? 1 : 0, false);
+        else
+            WriteText(Sink, Spec, Arg.Bool ? "true" : "false", Arg.Bool ? 4 : 5);
+        break;
+
+    case FormatKind::Char:
+        if(Spec.Type && Spec.Type != 'c')
+            WriteInteger(Sink, Spec, (U8)Arg.Char, false);
+        else
+            WriteText(Sink, Spec, &Arg.Char, 1);
+        break;
+
+    case FormatKind::Text:
+        WriteText(Sink, Spec, Arg.Text.Data, Arg.Text.Len);
+        break;
+
+    case FormatKind::Custom:
+        if(Spec.Width == 0 && Spec.Precision == 0xFFFF)
+        {
+            Arg.Custom.Write(Sink, Arg.Custom.Object);
+        }
+        else
+        {
+            //padding needs the length up front so render it on the side first
+            BufferWriter Temp;
+
+            Arg.Custom.Write(Temp, Arg.Custom.Object);
+            WriteText(Sink, Spec, Temp.Data, Temp.Length);
+        }
+        break;
+    }
+}
+
+/*================================================================*/
+/*              Cthulhu::Private::RenderFormat                    */
+/*================================================================*/
+
+void Cthulhu::Private::RenderFormat(TextWriter& Sink, const char* Str, const FormatField* Fields, U32 FieldCount, const FormatArg* Args, U32 ArgCount)
+{
+    for(U32 I = 0; I < FieldCount; I++)
+    {
+        const FormatField& Field = Fields[I];
+
+        Sink.Write(Str + Field.Offset, Field.Length);
+
+        if(Field.Arg != NoFormatArg)
+            WriteFormatArg(Sink, Args[Field.Arg], Field.Spec);
+    }
+}
+
+void Cthulhu::Private::RenderFormat(TextWriter& Sink, const char* Str, U32 Len, const FormatArg* Args, U32 ArgCount)
+{
+    FormatCursor Cursor = {};
+    FormatField Field = {};
+
+    while(ParseField(Str, Len, Cursor, Field))
+    {
+        Sink.Write(Str + Field.Offset, Field.Length);
+
+        if(Field.Arg == NoFormatArg)
+            continue;
+
+        if(Field.Arg >= ArgCount)
+        {
+            ASSERT_NO_ENTRY("Format string refers to an argument that doesnt exist");
+            continue;
+        }
+
+        ASSERT(SpecAllowed(Field.Spec.Type, Args[Field.Arg].Kind), "Format spec type doesnt match the type of its argument");
+
+        WriteFormatArg(Sink, Args[Field.Arg], Field.Spec);
+    }
+
+    //whatever couldnt be parsed is written as it is
+    if(Cursor.Error != FormatError::None)
+    {
+        ASSERT_NO_ENTRY("Invalid format string");
+        Sink.Write(Str + Field.Offset, Len - Field.Offset);
+    }
+}
@@ -0,0 +1,640 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Aliases.h"
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+
+#include "Core/Collections/CthulhuString.h"
+//String Utils::ToString
+
+#include "TextWriter.h"
+//TextWriter BufferWriter StringWriter FixedWriter WriteTo
+
+#include "Core/Traits/Traits.h"
+//True False
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy
+
+#pragma once
+
+/**
+ * @brief mark a string literal as a format string that is checked at compile time
+ *
+ * @description the literal is wrapped in a type so Format can parse it inside
+ * a constant expression. mistakes such as a missing argument, an unclosed brace
+ * or a hex spec on a float are then compile errors instead of garbage output
+ *
+ * @code{.cpp}
+ *
+ * String Log = Format(FMT("{} took {}ms"), Name, Millis);
+ *
+ * Format(FMT("{} took {}ms"), Name);
+ * // fails to compile: the format string needs a different amount of arguments
+ *
+ * @endcode
+ */
+#define FMT(Text) [] { \
+    struct FormatLiteral : Cthulhu::Private::FormatLiteralBase \
+    { \
+        static constexpr const char* Get() { return Text; } \
+        static constexpr Cthulhu::U32 Len() { return sizeof(Text) - 1; } \
+    }; \
+    return FormatLiteral{}; \
+}()
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+
+struct FormatLiteralBase {};
+
+/**
+ * @brief what kind of value an argument is, used to check specs
+ */
+enum class FormatKind : U8
+{
+    Signed,
+    Unsigned,
+    Float,
+    Bool,
+    Char,
+    Text,
+    Custom
+};
+
+/**
+ * @brief the parsed form of everything after the : in a placeholder
+ *
+ * @description [[Fill]Align][+][0][Width][.Precision][Type]
+ */
+struct FormatSpec
+{
+    char Fill = ' ';
+    char Align = '\0'; ///< '<', '>', '^', '=' (pad after the sign) or '\0' for the default of the type
+    char Type = '\0'; ///< 'd', 'x', 'X', 'b', 'o', 'f', 'e', 's', 'c' or '\0'
+    bool Plus = false;
+    U16 Width = 0;
+    U16 Precision = 0xFFFF; ///< 0xFFFF when there is no precision
+};
+
+/**
+ * @brief a run of literal text followed by an optional argument
+ */
+struct FormatField
+{
+    U32 Offset = 0;
+    U32 Length = 0;
+    U32 Arg = 0xFFFFFFFF; ///< 0xFFFFFFFF when this field is only literal text
+    FormatSpec Spec = {};
+};
+
+enum class FormatError : U8
+{
+    None,
+    UnclosedBrace,
+    UnmatchedBrace,
+    BadSpec,
+    BadIndex,
+    MixedIndexing,
+    ArgCount,
+    TypeMismatch
+};
+
+constexpr U32 NoFormatArg = 0xFFFFFFFF;
+
+constexpr bool IsFormatDigit(char C) { return '0' <= C && C <= '9'; }
+
+constexpr bool SpecAllowed(char Type, FormatKind Kind)
+{
+    switch(Type)
+    {
+    case '\0':
+        return true;
+    case 'd': case 'x': case 'X': case 'b': case 'o':
+        return Kind == FormatKind::Signed || Kind == FormatKind::Unsigned || Kind == FormatKind::Char || Kind == FormatKind::Bool;
+    case 'f': case 'e':
+        return Kind == FormatKind::Float;
+    case 's':
+        return Kind == FormatKind::Text || Kind == FormatKind::Bool || Kind == FormatKind::Custom;
+    case 'c':
+        return Kind == FormatKind::Char || Kind == FormatKind::Signed || Kind == FormatKind::Unsigned;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief the state carried between fields while parsing a format string
+ */
+struct FormatCursor
+{
+    U32 Pos = 0;
+    U32 NextArg = 0;
+    bool Automatic = false;
+    bool Manual = false;
+    FormatError Error = FormatError::None;
+};
+
+/**
+ * @brief parse the next field from a format string
+ *
+ * @description this is shared by the compile time and runtime paths so both
+ *              accept exactly the same syntax
+ *
+ * @param Str the format string
+ * @param Len the length of the format string
+ * @param Cursor where to start parsing, this is advanced past the field
+ * @param Out the field that was parsed
+ * @return true if a field was parsed
+ * @return false if the end of the string was reached or there was an error
+ */
+constexpr bool ParseField(const char* Str, U32 Len, FormatCursor& Cursor, FormatField& Out)
+{
+    if(Cursor.Pos >= Len || Cursor.Error != FormatError::None)
+        return false;
+
+    Out = FormatField{};
+    Out.Offset = Cursor.Pos;
+
+    //literal text up until the next placeholder
+    while(Cursor.Pos < Len)
+    {
+        const char C = Str[Cursor.Pos];
+
+        if(C == '{' || C == '}')
+        {
+            //escaped braces end the literal run with the brace included
+            if(Cursor.Pos + 1 < Len && Str[Cursor.Pos + 1] == C)
+            {
+                Out.Length = Cursor.Pos + 1 - Out.Offset;
+                Cursor.Pos += 2;
+                return true;
+            }
+
+            if(C == '}')
+            {
+                Cursor.Error = FormatError::UnmatchedBrace;
+                return false;
+            }
+
+            break;
+        }
+
+        Cursor.Pos++;
+    }
+
+    Out.Length = Cursor.Pos - Out.Offset;
+
+    if(Cursor.Pos >= Len)
+        return true;
+
+    //skip the {
+    Cursor.Pos++;
+
+    if(Cursor.Pos < Len && IsFormatDigit(Str[Cursor.Pos]))
+    {
+        U32 Index = 0;
+
+        while(Cursor.Pos < Len && IsFormatDigit(Str[Cursor.Pos]))
+            Index = (Index * 10) + (Str[Cursor.Pos++] - '0');
+
+        Out.Arg = Index;
+        Cursor.Manual = true;
+    }
+    else
+    {
+        Out.Arg = Cursor.NextArg++;
+        Cursor.Automatic = true;
+    }
+
+    if(Cursor.Automatic && Cursor.Manual)
+    {
+        Cursor.Error = FormatError::MixedIndexing;
+        return false;
+    }
+
+    if(Cursor.Pos < Len && Str[Cursor.Pos] == ':')
+    {
+        Cursor.Pos++;
+
+        FormatSpec& Spec = Out.Spec;
+
+        auto IsAlign = [](char C) { return C == '<' || C == '>' || C == '^'; };
+
+        if(Cursor.Pos + 1 < Len && IsAlign(Str[Cursor.Pos + 1]) && Str[Cursor.Pos] != '}')
+        {
+            Spec.Fill = Str[Cursor.Pos];
+            Spec.Align = Str[Cursor.Pos + 1];
+            Cursor.Pos += 2;
+        }
+        else if(Cursor.Pos < Len && IsAlign(Str[Cursor.Pos]))
+        {
+            Spec.Align = Str[Cursor.Pos++];
+        }
+
+        if(Cursor.Pos < Len && Str[Cursor.Pos] == '+')
+        {
+            Spec.Plus = true;
+            Cursor.Pos++;
+        }
+
+        if(Cursor.Pos < Len && Str[Cursor.Pos] == '0' && Spec.Align == '\0')
+        {
+            Spec.Fill = '0';
+            Spec.Align = '=';
+            Cursor.Pos++;
+        }
+
+        while(Cursor.Pos < Len && IsFormatDigit(Str[Cursor.Pos]))
+            Spec.Width = (U16)((Spec.Width * 10) + (Str[Cursor.Pos++] - '0'));
+
+        if(Cursor.Pos < Len && Str[Cursor.Pos] == '.')
+        {
+            Cursor.Pos++;
+
+            if(Cursor.Pos >= Len || !IsFormatDigit(Str[Cursor.Pos]))
+            {
+                Cursor.Error = FormatError::BadSpec;
+                return false;
+            }
+
+            Spec.Precision = 0;
+
+            while(Cursor.Pos < Len && IsFormatDigit(Str[Cursor.Pos]))
+                Spec.Precision = (U16)((Spec.Precision * 10) + (Str[Cursor.Pos++] - '0'));
+        }
+
+        if(Cursor.Pos < Len && Str[Cursor.Pos] != '}')
+            Spec.Type = Str[Cursor.Pos++];
+    }
+
+    if(Cursor.Pos >= Len)
+    {
+        Cursor.Error = FormatError::UnclosedBrace;
+        return false;
+    }
+
+    if(Str[Cursor.Pos] != '}')
+    {
+        Cursor.Error = FormatError::BadSpec;
+        return false;
+    }
+
+    Cursor.Pos++;
+
+    return true;
+}
+
+//an upper bound on the amount of fields a format string can have
+constexpr U32 MaxFormatFields(const char* Str, U32 Len)
+{
+    U32 Ret = 1;
+
+    for(U32 I = 0; I < Len; I++)
+        if(Str[I] == '{' || Str[I] == '}')
+            Ret++;
+
+    return Ret;
+}
+
+template<U32 N>
+struct FormatProgram
+{
+    FormatField Fields[N] = {};
+    U32 Count = 0;
+    FormatError Error = FormatError::None;
+};
+
+template<U32 N, U32 ArgCount>
+constexpr FormatProgram<N> CompileFormat(const char* Str, U32 Len, const FormatKind (&Kinds)[ArgCount + 1])
+{
+    FormatProgram<N> Ret = {};
+    FormatCursor Cursor = {};
+    FormatField Field = {};
+
+    while(ParseField(Str, Len, Cursor, Field))
+    {
+        if(Field.Arg != NoFormatArg)
+        {
+            if(Field.Arg >= ArgCount)
+            {
+                Ret.Error = FormatError::BadIndex;
+                return Ret;
+            }
+
+            if(!SpecAllowed(Field.Spec.Type, Kinds[Field.Arg]))
+            {
+                Ret.Error = FormatError::TypeMismatch;
+                return Ret;
+            }
+        }
+
+        Ret.Fields[Ret.Count++] = Field;
+    }
+
+    if(Cursor.Error != FormatError::None)
+        Ret.Error = Cursor.Error;
+    else if(Cursor.Automatic && Cursor.NextArg != ArgCount)
+        Ret.Error = FormatError::ArgCount;
+
+    return Ret;
+}
+
+/**
+ * @brief a single argument with its type erased
+ */
+struct FormatArg
+{
+    FormatKind Kind;
+
+    ///if a Float was an F32, so the shortest text is for the F32 and not the F64 it was widened to
+    bool Single;
+
+    union
+    {
+        I64 Signed;
+        U64 Unsigned;
+        F64 Float;
+        bool Bool;
+        char Char;
+        struct { const char* Data; U32 Len; } Text;
+        struct { const void* Object; void(*Write)(TextWriter&, const void*); } Custom;
+    };
+};
+
+template<typename T> struct FormatKindOf { static constexpr FormatKind Value = FormatKind::Custom; };
+
+template<> struct FormatKindOf<I8> { static constexpr FormatKind Value = FormatKind::Signed; };
+template<> struct FormatKindOf<I16> { static constexpr FormatKind Value = FormatKind::Signed; };
+template<> struct FormatKindOf<I32> { static constexpr FormatKind Value = FormatKind::Signed; };
+template<> struct FormatKindOf<I64> { static constexpr FormatKind Value = FormatKind::Signed; };
+template<> struct FormatKindOf<long> { static constexpr FormatKind Value = FormatKind::Signed; };
+template<> struct FormatKindOf<U8> { static constexpr FormatKind Value = FormatKind::Unsigned; };
+template<> struct FormatKindOf<U16> { static constexpr FormatKind Value = FormatKind::Unsigned; };
+template<> struct FormatKindOf<U32> { static constexpr FormatKind Value = FormatKind::Unsigned; };
+template<> struct FormatKindOf<U64> { static constexpr FormatKind Value = FormatKind::Unsigned; };
+template<> struct FormatKindOf<unsigned long> { static constexpr FormatKind Value = FormatKind::Unsigned; };
+template<> struct FormatKindOf<F32> { static constexpr FormatKind Value = FormatKind::Float; };
+template<> struct FormatKindOf<F64> { static constexpr FormatKind Value = FormatKind::Float; };
+template<> struct FormatKindOf<bool> { static constexpr FormatKind Value = FormatKind::Bool; };
+template<> struct FormatKindOf<char> { static constexpr FormatKind Value = FormatKind::Char; };
+template<> struct FormatKindOf<String> { static constexpr FormatKind Value = FormatKind::Text; };
+template<> struct FormatKindOf<const char*> { static constexpr FormatKind Value = FormatKind::Text; };
+template<> struct FormatKindOf<char*> { static constexpr FormatKind Value = FormatKind::Text; };
+template<U32 N> struct FormatKindOf<char[N]> { static constexpr FormatKind Value = FormatKind::Text; };
+
+//anything without a builtin fast path goes through WriteTo, or Utils::ToString if it doesnt have one
+template<typename T>
+CTU_INLINE FormatArg MakeFormatArg(const T& Value)
+{
+    FormatArg Ret;
+    Ret.Kind = FormatKind::Custom;
+    Ret.Custom.Object = &Value;
+    Ret.Custom.Write = [](TextWriter& Out, const void* Object) {
+        WriteItem(Out, *(const T*)Object);
+    };
+
+    return Ret;
+}
+
+#define FORMAT_ARG(Type, Member, ArgKind) \
+    template<> CTU_INLINE FormatArg MakeFormatArg(const Type& Value) \
+    { FormatArg Ret; Ret.Kind = FormatKind::ArgKind; Ret.Member = Value; return Ret; }
+
+FORMAT_ARG(I8, Signed, Signed)
+FORMAT_ARG(I16, Signed, Signed)
+FORMAT_ARG(I32, Signed, Signed)
+FORMAT_ARG(I64, Signed, Signed)
+FORMAT_ARG(long, Signed, Signed)
+FORMAT_ARG(U8, Unsigned, Unsigned)
+FORMAT_ARG(U16, Unsigned, Unsigned)
+FORMAT_ARG(U32, Unsigned, Unsigned)
+FORMAT_ARG(U64, Unsigned, Unsigned)
+FORMAT_ARG(unsigned long, Unsigned, Unsigned)
+FORMAT_ARG(bool, Bool, Bool)
+FORMAT_ARG(char, Char, Char)
+
+#undef FORMAT_ARG
+
+template<> CTU_INLINE FormatArg MakeFormatArg(const F32& Value)
+{
+    FormatArg Ret;
+    Ret.Kind = FormatKind::Float;
+    Ret.Single = true;
+    Ret.Float = Value;
+    return Ret;
+}
+
+template<> CTU_INLINE FormatArg MakeFormatArg(const F64& Value)
+{
+    FormatArg Ret;
+    Ret.Kind = FormatKind::Float;
+    Ret.Single = false;
+    Ret.Float = Value;
+    return Ret;
+}
+
+template<> CTU_INLINE FormatArg MakeFormatArg(const String& Value)
+{
+    FormatArg Ret;
+    Ret.Kind = FormatKind::Text;
+    Ret.Text.Data = Value.CStr();
+    Ret.Text.Len = Value.Len();
+    return Ret;
+}
+
+CTU_INLINE FormatArg MakeFormatArg(const char* Value)
+{
+    FormatArg Ret;
+    Ret.Kind = FormatKind::Text;
+    Ret.Text.Data = Value;
+    Ret.Text.Len = CString::Length(Value);
+    return Ret;
+}
+
+template<> CTU_INLINE FormatArg MakeFormatArg(char* const& Value)
+{
+    return MakeFormatArg((const char*)Value);
+}
+
+template<U32 N>
+CTU_INLINE FormatArg MakeFormatArg(const char (&Value)[N])
+{
+    FormatArg Ret;
+    Ret.Kind = FormatKind::Text;
+    Ret.Text.Data = Value;
+    Ret.Text.Len = CString::Length(Value);
+    return Ret;
+}
+
+/**
+ * @brief write a single argument with a spec applied
+ */
+void WriteFormatArg(TextWriter& Sink, const FormatArg& Arg, const FormatSpec& Spec);
+
+/**
+ * @brief render fields that were compiled ahead of time
+ */
+void RenderFormat(TextWriter& Sink, const char* Str, const FormatField* Fields, U32 FieldCount, const FormatArg* Args, U32 ArgCount);
+
+/**
+ * @brief parse and render a format string in the same pass
+ */
+void RenderFormat(TextWriter& Sink, const char* Str, U32 Len, const FormatArg* Args, U32 ArgCount);
+
+template<bool> struct FormatTag { using Type = False; };
+template<> struct FormatTag<true> { using Type = True; };
+
+//FMT() literals are checked at compile time, anything else is parsed at runtime
+template<typename T>
+struct IsFormatLiteral
+{
+    using Type = typename FormatTag<__is_base_of(FormatLiteralBase, T)>::Type;
+};
+
+CTU_INLINE const char* FormatText(const char* Fmt) { return Fmt; }
+CTU_INLINE const char* FormatText(const String& Fmt) { return Fmt.CStr(); }
+
+template<typename TFmt, typename... TArgs>
+CTU_INLINE void Render(True, TextWriter& Sink, TFmt, const TArgs&... Args)
+{
+    constexpr U32 ArgCount = sizeof...(TArgs);
+    //the extra kind keeps the array from being empty when there are no arguments
+    constexpr FormatKind Kinds[ArgCount + 1] = { FormatKindOf<TArgs>::Value..., FormatKind::Custom };
+    constexpr U32 FieldCount = MaxFormatFields(TFmt::Get(), TFmt::Len());
+    static constexpr FormatProgram<FieldCount> Program = CompileFormat<FieldCount, ArgCount>(TFmt::Get(), TFmt::Len(), Kinds);
+
+    static_assert(Program.Error != FormatError::UnclosedBrace, "Format string has a { that is never closed");
+    static_assert(Program.Error != FormatError::UnmatchedBrace, "Format string has a } without a matching {, use }} for a literal }");
+    static_assert(Program.Error != FormatError::BadSpec, "Format string has an invalid format spec");
+    static_assert(Program.Error != FormatError::BadIndex, "Format string refers to an argument that doesnt exist");
+    static_assert(Program.Error != FormatError::MixedIndexing, "Format string mixes {} and {N}");
+    static_assert(Program.Error != FormatError::ArgCount, "Format string needs a different amount of arguments");
+    static_assert(Program.Error != FormatError::TypeMismatch, "Format spec type doesnt match the type of its argument");
+
+    const FormatArg Packed[ArgCount + 1] = { MakeFormatArg(Args)..., FormatArg{} };
+
+    RenderFormat(Sink, TFmt::Get(), Program.Fields, Program.Count, Packed, ArgCount);
+}
+
+template<typename TFmt, typename... TArgs>
+CTU_INLINE void Render(False, TextWriter& Sink, const TFmt& Fmt, const TArgs&... Args)
+{
+    const FormatArg Packed[sizeof...(TArgs) + 1] = { MakeFormatArg(Args)..., FormatArg{} };
+    const char* Str = FormatText(Fmt);
+
+    RenderFormat(Sink, Str, CString::Length(Str), Packed, sizeof...(TArgs));
+}
+
+} // Private
+
+/**
+ * @brief format arguments into a new string
+ *
+ * @description the format string uses {} for the next argument or {N} for
+ * a specific one, each placeholder can have a spec after a colon
+ *
+ * {[Index][:[[Fill]Align][+][0][Width][.Precision][Type]]}
+ *
+ * Align is < > or ^, Type is one of d x X b o for integers, f e for floats,
+ * c for characters and s for text. {{ and }} are literal braces
+ *
+ * the string is rendered in one pass into a stack buffer and only touches the heap
+ * for the returned string, unless the output is longer than the stack buffer
+ *
+ * @code{.cpp}
+ *
+ * Format(FMT("{} took {}ms"), "Load", 25);
+ * // "Load took 25ms"
+ *
+ * Format(FMT("{:08.3f}|{:>6}|{:#x}"), 3.14159, "R", 255);
+ * // fails to compile, # isnt a valid spec
+ *
+ * Format(FMT("{:08.3f}|{:>6}|{:x}"), 3.14159, "R", 255);
+ * // "0003.142|     R|ff"
+ *
+ * @endcode
+ *
+ * if the format string isnt wrapped in FMT() it is parsed at runtime instead,
+ * with the same syntax but mistakes are only caught by asserts
+ *
+ * @param Fmt the format string
+ * @param Args the arguments to format
+ * @return String the formatted string
+ */
+template<typename TFmt, typename... TArgs>
+String Format(const TFmt& Fmt, const TArgs&... Args)
+{
+    BufferWriter Sink;
+
+    Private::Render(typename Private::IsFormatLiteral<TFmt>::Type{}, Sink, Fmt, Args...);
+
+    return Sink.Take();
+}
+
+/**
+ * @brief format arguments into a buffer the caller owns
+ *
+ * @description behaves like snprintf, the output is truncated to fit and
+ *              is always null terminated if Size is not 0. this never allocates
+ *              unless an argument only has a Utils::ToString and not a WriteTo
+ *
+ * @param Buffer the buffer to write into
+ * @param Size the size of the buffer including space for the null terminator
+ * @param Fmt the format string
+ * @param Args the arguments to format
+ * @return U32 the length the full output would have been, if this is >= Size
+ *             the output was truncated
+ */
+template<typename TFmt, typename... TArgs>
+U32 FormatTo(char* Buffer, U32 Size, const TFmt& Fmt, const TArgs&... Args)
+{
+    FixedWriter Sink(Buffer, Size);
+
+    Private::Render(typename Private::IsFormatLiteral<TFmt>::Type{}, Sink, Fmt, Args...);
+
+    Sink.Terminate();
+
+    return Sink.Total;
+}
+
+/**
+ * @brief format arguments onto the end of an existing string
+ *
+ * @description this writes directly into the strings allocation, so if the string
+ *              already has enough space (see String::Reserve) nothing is allocated
+ *
+ * @param Into the string to append to
+ * @param Fmt the format string
+ * @param Args the arguments to format
+ * @return String& Into
+ */
+template<typename TFmt, typename... TArgs>
+String& FormatInto(String& Into, const TFmt& Fmt, const TArgs&... Args)
+{
+    StringWriter Sink(Into);
+
+    Private::Render(typename Private::IsFormatLiteral<TFmt>::Type{}, Sink, Fmt, Args...);
+
+    Sink.Flush();
+
+    return Into;
+}
+
+} // Cthulhu
@@ -0,0 +1,413 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Integer.h"
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy
+
+#include "Core/Math/Bytes.h"
+//Math::ByteSwap
+
+using namespace Cthulhu;
+
+namespace
+{
+
+constexpr U64 Pow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+constexpr char DigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+CTU_INLINE U32 LeadingZeros(U64 Num)
+{
+#if CC_MSVC
+    unsigned long Index;
+    _BitScanReverse64(&Index, Num);
+    return 63 - Index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(Num);
+#else
+    U32 Ret = 0;
+    while(!(Num & (1ULL << 63))) { Num <<= 1; Ret++; }
+    return Ret;
+#endif
+}
+
+CTU_INLINE U32 TrailingZeros(U64 Num)
+{
+#if CC_MSVC
+    unsigned long Index;
+    _BitScanForward64(&Index, Num);
+    return Index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(Num);
+#else
+    U32 Ret = 0;
+    while(!(Num & 1)) { Num >>= 1; Ret++; }
+    return Ret;
+#endif
+}
+
+CTU_INLINE bool IsDigit(char C) { return '0' <= C && C <= '9'; }
+
+/*================================================================*/
+/*              SWAR digit parsing                                */
+/*================================================================*/
+
+//8 characters with the first one in the lowest byte
+CTU_INLINE U64 LoadEight(const char* Text)
+{
+    U64 Ret;
+    Memory::Copy((const Byte*)Text, (Byte*)&Ret, sizeof(U64));
+
+#if PLATFORM_BIG_ENDIAN
+    Ret = Math::ByteSwap(Ret);
+#endif
+
+    return Ret;
+}
+
+//the high bit of every byte that isnt a digit is set
+//carries only move upward so the lowest flagged byte is always right, the ones after it might not be
+CTU_INLINE U64 NonDigits(U64 Chunk)
+{
+    return ((Chunk + 0x4646464646464646) | (Chunk - 0x3030303030303030)) & 0x8080808080808080;
+}
+
+//turn 8 ascii digits into a number with 3 multiplies instead of 8
+CTU_INLINE U32 EightDigits(U64 Chunk)
+{
+    Chunk -= 0x3030303030303030;
+
+    //every byte pair becomes a number from 0 to 99
+    Chunk = (Chunk * 10) + (Chunk >> 8);
+
+    //then both halves of each 32 bit lane are merged
+    return (U32)(((Chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32)) +
+        ((Chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))) >> 32);
+}
+
+//parse the digits at the start of Text, nullptr means there werent any or they overflowed
+const char* ParseDigits(const char* Cursor, const char* End, U64& Out)
+{
+    const char* Start = Cursor;
+
+    //leading zeros dont count towards overflowing
+    while(Cursor != End && *Cursor == '0')
+        Cursor++;
+
+    U64 Value = 0;
+
+    //2 full chunks is 16 digits which cant overflow
+    for(U32 I = 0; I < 2 && End - Cursor >= 8; I++)
+    {
+        U64 Chunk = LoadEight(Cursor);
+        const U64 Mask = NonDigits(Chunk);
+
+        if(Mask == 0)
+        {
+            Value = (Value * 100000000) + EightDigits(Chunk);
+            Cursor += 8;
+            continue;
+        }
+
+        const U32 Count = TrailingZeros(Mask) / 8;
+
+        if(Count != 0)
+        {
+            //slide the digits to the top and fill the bottom with zeros
+            const U32 Shift = 64 - (Count * 8);
+            Chunk = (Chunk << Shift) | (0x3030303030303030 >> (64 - Shift));
+
+            Value = (Value * Pow10[Count]) + EightDigits(Chunk);
+            Cursor += Count;
+        }
+
+        break;
+    }
+
+    //anything left is either a short tail or long enough that it needs checking
+    for(; Cursor != End && IsDigit(*Cursor); Cursor++)
+    {
+        const U64 Digit = *Cursor - '0';
+
+        if(Value > (0xFFFFFFFFFFFFFFFF - Digit) / 10)
+            return nullptr;
+
+        Value = (Value * 10) + Digit;
+    }
+
+    if(Cursor == Start)
+        return nullptr;
+
+    Out = Value;
+    return Cursor;
+}
+
+CTU_INLINE I8 HexValue(char C)
+{
+    if('0' <= C && C <= '9')
+        return C - '0';
+
+    //setting bit 5 lowercases a letter
+    C |= 0x20;
+
+    if('a' <= C && C <= 'f')
+        return C - 'a' + 10;
+
+    return -1;
+}
+
+}
+
+/*================================================================*/
+/*              Cthulhu::Utils integer formatting                 */
+/*================================================================*/
+
+U32 Cthulhu::Utils::DecimalLength(U64 Num)
+{
+    //1233 / 4096 is just over log10(2) so this guesses from the bit width and then corrects
+    //0 is treated as 1 so it still has a digit
+    Num |= 1;
+
+    const U32 Bits = 64 - LeadingZeros(Num);
+    const U32 Guess = (Bits * 1233) >> 12;
+
+    return Guess + 1 - (Num < Pow10[Guess]);
+}
+
+U32 Cthulhu::Utils::IntegerToChars(U64 Num, char* Into)
+{
+    const U32 Len = DecimalLength(Num);
+    char* Cursor = Into + Len;
+
+    while(Num >= 100)
+    {
+        const U32 Pair = (U32)(Num % 100) * 2;
+        Num /= 100;
+
+        *--Cursor = DigitPairs[Pair + 1];
+        *--Cursor = DigitPairs[Pair];
+    }
+
+    if(Num >= 10)
+    {
+        *--Cursor = DigitPairs[(Num * 2) + 1];
+        *--Cursor = DigitPairs[Num * 2];
+    }
+    else
+    {
+        *--Cursor = (char)('0' + Num);
+    }
+
+    return Len;
+}
+
+U32 Cthulhu::Utils::IntegerToChars(I64 Num, char* Into)
+{
+    if(Num >= 0)
+        return IntegerToChars((U64)Num, Into);
+
+    *Into = '-';
+
+    //negate as unsigned so the smallest I64 doesnt overflow
+    return IntegerToChars(0 - (U64)Num, Into + 1) + 1;
+}
+
+U32 Cthulhu::Utils::HexToChars(U64 Num, char* Into, bool Upper)
+{
+    const char* Digits = Upper ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    const U32 Len = (64 - LeadingZeros(Num | 1) + 3) / 4;
+
+    for(U32 I = Len; I > 0; I--)
+    {
+        Into[I - 1] = Digits[Num & 15];
+        Num >>= 4;
+    }
+
+    return Len;
+}
+
+/*================================================================*/
+/*              Cthulhu::Utils integer parsing                    */
+/*================================================================*/
+
+U32 Cthulhu::Utils::IntegerFromChars(const char* Text, U32 Len, U64& Out)
+{
+    const char* Cursor = Text;
+    const char* End = Text + Len;
+
+    if(Cursor != End && *Cursor == '+')
+        Cursor++;
+
+    Cursor = ParseDigits(Cursor, End, Out);
+
+    return Cursor ? (U32)(Cursor - Text) : 0;
+}
+
+U32 Cthulhu::Utils::IntegerFromChars(const char* Text, U32 Len, I64& Out)
+{
+    const char* Cursor = Text;
+    const char* End = Text + Len;
+
+    bool Negative = false;
+
+    if(Cursor != End && (*Cursor == '-' || *Cursor == '+'))
+        Negative = *Cursor++ == '-';
+
+    U64 Magnitude;
+    Cursor = ParseDigits(Cursor, End, Magnitude);
+
+    //one more on the negative side because of twos complement
+    if(!Cursor || Magnitude > (1ULL << 63) - !Negative)
+        return 0;
+
+    Out = Negative ? (I64)(0 - Magnitude) : (I64)Magnitude;
+
+    return (U32)(Cursor - Text);
+}
+
+U32 Cthulhu::Utils::HexFromChars(const char* Text, U32 Len, U64& Out)
+{
+    const char* Cursor = Text;
+    const char* End = Text + Len;
+
+    if(End - Cursor > 2 && Cursor[0] == '0' && (Cursor[1] | 0x20) == 'x' && HexValue(Cursor[2]) >= 0)
+        Cursor += 2;
+
+    const char* Start = Cursor;
+
+    while(Cursor != End && *Cursor == '0')
+        Cursor++;
+
+    const char* First = Cursor;
+    U64 Value = 0;
+
+    for(I8 Digit; Cursor != End && (Digit = HexValue(*Cursor)) >= 0; Cursor++)
+        Value = (Value << 4) | (U64)Digit;
+
+    if(Cursor == Start || Cursor - First > 16)
+        return 0;
+
+    Out = Value;
+
+    return (U32)(Cursor - Text);
+}
+
+U32 Cthulhu::Utils::BitsFromChars(const char* Text, U32 Len, U64& Out)
+{
+    const char* Cursor = Text;
+    const char* End = Text + Len;
+
+    if(End - Cursor > 2 && Cursor[0] == '0' && (Cursor[1] | 0x20) == 'b' && (Cursor[2] == '0' || Cursor[2] == '1'))
+        Cursor += 2;
+
+    const char* Start = Cursor;
+
+    while(Cursor != End && *Cursor == '0')
+        Cursor++;
+
+    const char* First = Cursor;
+    U64 Value = 0;
+
+    for(; Cursor != End && (*Cursor == '0' || *Cursor == '1'); Cursor++)
+        Value = (Value << 1) | (U64)(*Cursor - '0');
+
+    if(Cursor == Start || Cursor - First > 64)
+        return 0;
+
+    Out = Value;
+
+    return (U32)(Cursor - Text);
+}
+
+/*================================================================*/
+/*              Cthulhu::Utils::ParseIntegers                     */
+/*================================================================*/
+
+Result<U32, U32> Cthulhu::Utils::ParseIntegers(const char* Text, U32 Len, Array<I64>& Into, const char* Delimiters)
+{
+    bool IsDelimiter[256] = {};
+
+    for(const char* D = Delimiters; *D; D++)
+        IsDelimiter[(U8)*D] = true;
+
+    //count the fields first so the array only has to grow once
+    U32 Fields = 1;
+
+    for(U32 I = 0; I < Len; I++)
+        Fields += IsDelimiter[(U8)Text[I]];
+
+    Into.Reserve(Fields + 1);
+
+    //blanks that are also delimiters have to stay delimiters
+    auto SkipBlanks = [](const char* Cursor, const char* End, const bool* IsDelimiter) {
+        while(Cursor != End && !IsDelimiter[(U8)*Cursor] && (*Cursor == ' ' || *Cursor == '\t' || *Cursor == '\r'))
+            Cursor++;
+
+        return Cursor;
+    };
+
+    const char* Cursor = Text;
+    const char* End = Text + Len;
+
+    U32 Count = 0;
+
+    while(Cursor != End)
+    {
+        const char* Field = Cursor;
+
+        Cursor = SkipBlanks(Cursor, End, IsDelimiter);
+
+        I64 Num;
+        const U32 Used = IntegerFromChars(Cursor, (U32)(End - Cursor), Num);
+
+        if(Used == 0)
+            return Fail<U32, U32>((U32)(Field - Text));
+
+        Cursor += Used;
+
+        Cursor = SkipBlanks(Cursor, End, IsDelimiter);
+
+        if(Cursor != End)
+        {
+            if(!IsDelimiter[(U8)*Cursor])
+                return Fail<U32, U32>((U32)(Field - Text));
+
+            Cursor++;
+        }
+
+        Into.Append(Num);
+        Count++;
+    }
+
+    return Pass<U32, U32>(Count);
+}
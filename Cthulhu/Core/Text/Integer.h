@@ -0,0 +1,143 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Aliases.h"
+//U32 U64 I64
+
+#include "Core/Collections/Array.h"
+//Array<T>
+
+#include "Core/Collections/Result.h"
+//Result<T, E>
+
+#pragma once
+
+namespace Cthulhu::Utils
+{
+
+/**
+ * @brief the most characters IntegerToChars will ever write, 20 digits and a sign
+ */
+constexpr U32 MaxIntegerChars = 21;
+
+/**
+ * @brief the most characters HexToChars will ever write
+ */
+constexpr U32 MaxHexChars = 16;
+
+/**
+ * @brief count the decimal digits in a number without dividing
+ *
+ * @param Num the number to measure
+ * @return U32 how many digits Num has, 0 has 1 digit
+ */
+U32 DecimalLength(U64 Num);
+
+/**
+ * @brief write an integer in decimal
+ *
+ * @description digits are written 2 at a time from a table of every pair
+ *              so only half as many divisions are needed
+ *
+ * @code{.cpp}
+ *
+ * char Buffer[Utils::MaxIntegerChars];
+ * U32 Len = Utils::IntegerToChars(-1234, Buffer); // "-1234", Len = 5
+ *
+ * @endcode
+ *
+ * @param Num the number to write
+ * @param Into where to write the digits, must have space for at least MaxIntegerChars characters
+ * @return U32 how many characters were written, no null terminator is written
+ */
+U32 IntegerToChars(U64 Num, char* Into);
+U32 IntegerToChars(I64 Num, char* Into);
+
+/**
+ * @brief write an integer in hex without a 0x prefix
+ *
+ * @param Num the number to write
+ * @param Into where to write the digits, must have space for at least MaxHexChars characters
+ * @param Upper use A-F rather than a-f
+ * @return U32 how many characters were written, no null terminator is written
+ */
+U32 HexToChars(U64 Num, char* Into, bool Upper = false);
+
+/**
+ * @brief parse a decimal integer
+ *
+ * @description accepts an optional sign then digits. 8 digits are checked and
+ *              converted at once with SWAR tricks when there is enough input left.
+ *              numbers that dont fit are rejected rather than wrapping around
+ *
+ * @param Text the text to parse, does not need to be null terminated
+ * @param Len the length of Text
+ * @param Out where the parsed number is written
+ * @return U32 how many characters were parsed or 0 if there was no number or it overflowed
+ */
+U32 IntegerFromChars(const char* Text, U32 Len, U64& Out);
+U32 IntegerFromChars(const char* Text, U32 Len, I64& Out);
+
+/**
+ * @brief parse a hex integer with an optional 0x prefix
+ *
+ * @param Text the text to parse, does not need to be null terminated
+ * @param Len the length of Text
+ * @param Out where the parsed number is written
+ * @return U32 how many characters were parsed or 0 if there was no number or it overflowed
+ */
+U32 HexFromChars(const char* Text, U32 Len, U64& Out);
+
+/**
+ * @brief parse a binary integer with an optional 0b prefix
+ *
+ * @param Text the text to parse, does not need to be null terminated
+ * @param Len the length of Text
+ * @param Out where the parsed number is written
+ * @return U32 how many characters were parsed or 0 if there was no number or it overflowed
+ */
+U32 BitsFromChars(const char* Text, U32 Len, U64& Out);
+
+/**
+ * @brief parse every integer in a buffer of delimited fields
+ *
+ * @description meant for bulk loading things like csv columns. the fields are counted
+ *              up front so Into only grows once. spaces, tabs and \r around a field are skipped
+ *
+ * @code{.cpp}
+ *
+ * Array<I64> Numbers;
+ * auto Parsed = Utils::ParseIntegers("1,2, 3\n4,5\n", 11, Numbers);
+ * // Parsed.Value() = 5, Numbers = { 1, 2, 3, 4, 5 }
+ *
+ * auto Bad = Utils::ParseIntegers("1,x,3", 5, Numbers);
+ * // Bad.Error() = 2, the offset of the field that couldnt be parsed
+ *
+ * @endcode
+ *
+ * @param Text the fields to parse
+ * @param Len the length of Text
+ * @param Into the array to append every number to
+ * @param Delimiters every character that ends a field, a delimiter at the very end is allowed
+ * @return Result<U32, U32> how many numbers were appended or the offset of the first bad field
+ */
+Result<U32, U32> ParseIntegers(const char* Text, U32 Len, Array<I64>& Into, const char* Delimiters = ",\n");
+
+CTU_INLINE Result<U32, U32> ParseIntegers(const String& Text, Array<I64>& Into, const char* Delimiters = ",\n")
+{
+    return ParseIntegers(Text.CStr(), Text.Len(), Into, Delimiters);
+}
+
+}
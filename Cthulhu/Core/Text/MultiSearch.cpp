@@ -0,0 +1,343 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "MultiSearch.h"
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy Memory::Set
+
+using namespace Cthulhu;
+
+/*================================================================*/
+/*              Cthulhu::MultiSearch constructors                 */
+/*================================================================*/
+
+Cthulhu::MultiSearch::MultiSearch(const Array<String>& Patterns)
+{
+    Compile(Patterns.Data(), Patterns.Len());
+}
+
+Cthulhu::MultiSearch::MultiSearch(std::initializer_list<String> Patterns)
+{
+    Compile(Patterns.begin(), (U32)Patterns.size());
+}
+
+Cthulhu::MultiSearch::~MultiSearch()
+{
+    delete[] Depths;
+    delete[] Terminals;
+    delete[] Outputs;
+    delete[] Fails;
+    delete[] EdgeStart;
+    delete[] EdgeTarget;
+    delete[] EdgeClass;
+    delete[] Table;
+}
+
+/*================================================================*/
+/*              Cthulhu::MultiSearch compilation                  */
+/*================================================================*/
+
+void Cthulhu::MultiSearch::Compile(const String* Patterns, U32 Count)
+{
+    PatternCount = Count;
+
+    //figure out which bytes are actually used so the alphabet can be squashed
+    Memory::Set(Classes, 0, sizeof(Classes));
+
+    U32 MaxStates = 1;
+
+    for(U32 I = 0; I < Count; I++)
+    {
+        const String& Pattern = Patterns[I];
+        MaxStates += Pattern.Len();
+
+        for(U32 J = 0; J < Pattern.Len(); J++)
+            Classes[(U8)Pattern.CStr()[J]] = 1;
+    }
+
+    ClassCount = 1;
+
+    for(U32 I = 0; I < 256; I++)
+        if(Classes[I])
+            Classes[I] = (U8)ClassCount++;
+
+    //build the trie, children are kept in sibling lists until we know how big it is
+    U32* FirstChild = new U32[MaxStates];
+    U32* NextSibling = new U32[MaxStates];
+    U8* StateClass = new U8[MaxStates];
+
+    Depths = new U32[MaxStates];
+    Terminals = new U32[MaxStates];
+
+    FirstChild[0] = NoState;
+    NextSibling[0] = NoState;
+    StateClass[0] = 0;
+    Depths[0] = 0;
+    Terminals[0] = NoState;
+
+    StateCount = 1;
+
+    for(U32 I = 0; I < Count; I++)
+    {
+        const String& Pattern = Patterns[I];
+
+        if(Pattern.IsEmpty())
+            continue;
+
+        U32 State = 0;
+
+        for(U32 J = 0; J < Pattern.Len(); J++)
+        {
+            const U8 Class = Classes[(U8)Pattern.CStr()[J]];
+
+            U32 Child = FirstChild[State];
+
+            while(Child != NoState && StateClass[Child] != Class)
+                Child = NextSibling[Child];
+
+            if(Child == NoState)
+            {
+                Child = StateCount++;
+
+                FirstChild[Child] = NoState;
+                StateClass[Child] = Class;
+                Depths[Child] = Depths[State] + 1;
+                Terminals[Child] = NoState;
+
+                NextSibling[Child] = FirstChild[State];
+                FirstChild[State] = Child;
+            }
+
+            State = Child;
+        }
+
+        //if a pattern was given twice keep the first one
+        if(Terminals[State] == NoState)
+            Terminals[State] = I;
+    }
+
+    Fails = new U32[StateCount];
+    Outputs = new U32[StateCount];
+
+    const bool Dense = ClassCount <= MaxDenseClasses;
+
+    Table = Dense ? new U32[StateCount * ClassCount] : nullptr;
+
+    //breadth first so every failure link points at a state that has already been finished
+    U32* Queue = new U32[StateCount];
+    U32 Head = 0,
+        Tail = 0;
+
+    Fails[0] = 0;
+    Outputs[0] = NoState;
+    Queue[Tail++] = 0;
+
+    if(Dense)
+        Memory::Set(Table, 0, sizeof(U32) * ClassCount);
+
+    while(Head < Tail)
+    {
+        const U32 State = Queue[Head++];
+
+        if(Dense && State != 0)
+        {
+            Memory::Copy(Table + (Fails[State] * ClassCount), Table + (State * ClassCount), sizeof(U32) * ClassCount);
+        }
+
+        for(U32 Child = FirstChild[State]; Child != NoState; Child = NextSibling[Child])
+        {
+            const U8 Class = StateClass[Child];
+            U32 Fail = 0;
+
+            if(State != 0 && Dense)
+            {
+                //the row of the parents fallback is already complete so this is a single step
+                Fail = Table[(Fails[State] * ClassCount) + Class];
+            }
+            else if(State != 0)
+            {
+                U32 Back = Fails[State];
+
+                for(;;)
+                {
+                    U32 Next = FirstChild[Back];
+
+                    while(Next != NoState && StateClass[Next] != Class)
+                        Next = NextSibling[Next];
+
+                    if(Next != NoState)
+                    {
+                        Fail = Next;
+                        break;
+                    }
+
+                    if(Back == 0)
+                        break;
+
+                    Back = Fails[Back];
+                }
+            }
+
+            Fails[Child] = Fail;
+            Outputs[Child] = Terminals[Child] != NoState ? Child : Outputs[Fail];
+
+            if(Dense)
+                Table[(State * ClassCount) + Class] = Child;
+
+            Queue[Tail++] = Child;
+        }
+    }
+
+    delete[] Queue;
+
+    if(Dense)
+    {
+        EdgeStart = nullptr;
+        EdgeTarget = nullptr;
+        EdgeClass = nullptr;
+    }
+    else
+    {
+        //flatten the sibling lists so each state owns a contiguous run of edges
+        EdgeStart = new U32[StateCount + 1];
+        EdgeTarget = new U32[StateCount];
+        EdgeClass = new U8[StateCount];
+
+        U32 Edge = 0;
+
+        for(U32 State = 0; State < StateCount; State++)
+        {
+            EdgeStart[State] = Edge;
+
+            for(U32 Child = FirstChild[State]; Child != NoState; Child = NextSibling[Child])
+            {
+                EdgeTarget[Edge] = Child;
+                EdgeClass[Edge] = StateClass[Child];
+                Edge++;
+            }
+        }
+
+        EdgeStart[StateCount] = Edge;
+    }
+
+    delete[] FirstChild;
+    delete[] NextSibling;
+    delete[] StateClass;
+}
+
+U32 Cthulhu::MultiSearch::Step(U32 State, U8 C) const
+{
+    const U8 Class = Classes[C];
+
+    if(Table)
+        return Table[(State * ClassCount) + Class];
+
+    //this byte isnt in any pattern so every prefix dies here
+    if(Class == 0)
+        return 0;
+
+    for(;;)
+    {
+        for(U32 Edge = EdgeStart[State]; Edge < EdgeStart[State + 1]; Edge++)
+        {
+            if(EdgeClass[Edge] == Class)
+                return EdgeTarget[Edge];
+        }
+
+        if(State == 0)
+            return 0;
+
+        State = Fails[State];
+    }
+}
+
+/*================================================================*/
+/*              Cthulhu::MultiSearch searching                    */
+/*================================================================*/
+
+Option<SearchMatch> Cthulhu::MultiSearch::Find(const char* Data, U32 Len) const
+{
+    SearchMatch Ret = { 0, 0, 0 };
+    bool Found = false;
+
+    Scan(Data, Len, [&](const SearchMatch& Match) {
+        Ret = Match;
+        Found = true;
+        return false;
+    });
+
+    return Found ? Some(Ret) : None<SearchMatch>();
+}
+
+Array<SearchMatch> Cthulhu::MultiSearch::FindAll(const char* Data, U32 Len) const
+{
+    Array<SearchMatch> Ret;
+
+    Scan(Data, Len, [&](const SearchMatch& Match) {
+        Ret.Append(Match);
+        return true;
+    });
+
+    return Ret;
+}
+
+U32 Cthulhu::MultiSearch::Count(const char* Data, U32 Len) const
+{
+    U32 Ret = 0;
+
+    Scan(Data, Len, [&](const SearchMatch&) {
+        Ret++;
+        return true;
+    });
+
+    return Ret;
+}
+
+String Cthulhu::MultiSearch::Replace(const char* Data, U32 Len, const Array<String>& Substitutes) const
+{
+    ASSERT(Substitutes.Len() >= PatternCount, "Every pattern needs a substitute");
+
+    //first pass only measures so the output is a single allocation
+    U32 Total = Len;
+
+    Scan(Data, Len, [&](const SearchMatch& Match) {
+        Total += Substitutes[Match.Pattern].Len();
+        Total -= Match.Length;
+        return true;
+    });
+
+    char* Result = new char[Total + 1];
+    char* Cursor = Result;
+    U32 Last = 0;
+
+    Scan(Data, Len, [&](const SearchMatch& Match) {
+        const String& Substitute = Substitutes[Match.Pattern];
+
+        Memory::Copy(Data + Last, Cursor, Match.Offset - Last);
+        Cursor += Match.Offset - Last;
+
+        Memory::Copy(Substitute.CStr(), Cursor, Substitute.Len());
+        Cursor += Substitute.Len();
+
+        Last = Match.Offset + Match.Length;
+        return true;
+    });
+
+    Memory::Copy(Data + Last, Cursor, Len - Last);
+    Result[Total] = '\0';
+
+    return String::FromPtr(Result, Total, Total);
+}
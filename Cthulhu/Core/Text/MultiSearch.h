@@ -0,0 +1,248 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Aliases.h"
+#include "Meta/Macros.h"
+
+#include "Core/Collections/Array.h"
+//Array<T> Option<T> String
+
+#pragma once
+
+namespace Cthulhu
+{
+
+/**
+ * @brief a single match found by a MultiSearch
+ */
+struct SearchMatch
+{
+    ///the index of the first character of the match
+    U32 Offset;
+
+    ///the length of the match in characters
+    U32 Length;
+
+    ///the index of the pattern that matched, in the order they were given
+    U32 Pattern;
+};
+
+/**
+ * @brief A compiled set of patterns that can all be searched for in a single pass
+ *
+ * @description the patterns are compiled into an Aho-Corasick automaton.
+ * when the patterns only use a small amount of distinct characters (which is
+ * nearly always the case for things like "{0}" or "$(Name)" tokens) the automaton
+ * is flattened into a dense DFA so every character of the input costs a single
+ * table lookup. otherwise the trie and its failure links are walked directly.
+ *
+ * matches are reported leftmost-longest and never overlap, which is what you want
+ * when replacing text
+ *
+ * @code{.cpp}
+ *
+ * MultiSearch Search = { "cat", "category", "dog" };
+ *
+ * auto Matches = Search.FindAll("category of dog");
+ * // { { 0, 8, 1 }, { 12, 3, 2 } }
+ *
+ * String Out = Search.Replace("cat and dog", { "feline", "?", "canine" });
+ * // "feline and canine"
+ *
+ * @endcode
+ */
+struct MultiSearch
+{
+    /**
+     * @brief compile a set of patterns
+     *
+     * @description empty patterns are ignored and can never match,
+     *              if a pattern is given twice the first index is reported
+     *
+     * @param Patterns the patterns to search for
+     */
+    MultiSearch(const Array<String>& Patterns);
+    MultiSearch(std::initializer_list<String> Patterns);
+
+    MultiSearch(const MultiSearch&) = delete;
+    MultiSearch& operator=(const MultiSearch&) = delete;
+
+    ~MultiSearch();
+
+    /**
+     * @brief find the leftmost-longest match in a buffer
+     *
+     * @param Data the buffer to search
+     * @param Len the length of the buffer
+     * @return Option<SearchMatch> the first match if there was one
+     */
+    Option<SearchMatch> Find(const char* Data, U32 Len) const;
+    Option<SearchMatch> Find(const String& Text) const { return Find(Text.CStr(), Text.Len()); }
+
+    /**
+     * @brief find every non-overlapping match in a buffer
+     *
+     * @param Data the buffer to search
+     * @param Len the length of the buffer
+     * @return Array<SearchMatch> every match in order of offset
+     */
+    Array<SearchMatch> FindAll(const char* Data, U32 Len) const;
+    Array<SearchMatch> FindAll(const String& Text) const { return FindAll(Text.CStr(), Text.Len()); }
+
+    /**
+     * @brief count the amount of non-overlapping matches in a buffer
+     *
+     * @param Data the buffer to search
+     * @param Len the length of the buffer
+     * @return U32 the amount of matches
+     */
+    U32 Count(const char* Data, U32 Len) const;
+    U32 Count(const String& Text) const { return Count(Text.CStr(), Text.Len()); }
+
+    /**
+     * @brief replace every match with the substitute for its pattern
+     *
+     * @description the input is scanned twice, once to figure out how long the
+     *              output will be and once to write it, so the result is built
+     *              in a single allocation
+     *
+     * @param Data the buffer to search
+     * @param Len the length of the buffer
+     * @param Substitutes a substitute for every pattern, indexed the same as the patterns
+     * @return String the buffer with every match replaced
+     */
+    String Replace(const char* Data, U32 Len, const Array<String>& Substitutes) const;
+    String Replace(const String& Text, const Array<String>& Substitutes) const
+    {
+        return Replace(Text.CStr(), Text.Len(), Substitutes);
+    }
+
+    /**
+     * @brief get the amount of patterns this search was compiled with
+     *
+     * @return U32 the amount of patterns
+     */
+    CTU_INLINE U32 Len() const { return PatternCount; }
+
+    /**
+     * @brief check if the patterns were compiled into a dense DFA
+     *
+     * @return true if every character is a single table lookup
+     * @return false if the search falls back to walking failure links
+     */
+    CTU_INLINE bool IsDense() const { return Table != nullptr; }
+
+    /**
+     * @brief the most distinct characters the patterns can use
+     *        before the search stops using a dense DFA
+     */
+    static constexpr U32 MaxDenseClasses = 64;
+
+private:
+
+    void Compile(const String* Patterns, U32 Count);
+
+    U32 Step(U32 State, U8 C) const;
+
+    /**
+     * @brief walk the automaton over a buffer and call Block with every leftmost-longest match
+     *
+     * @description a match can only be committed once no other match could start
+     *              before it, which is known as soon as the longest live prefix
+     *              starts after it or the text runs out. matches seen after the
+     *              candidate might overlap it so the walk starts again from the
+     *              root straight after each committed match
+     */
+    template<typename TBlock>
+    void Scan(const char* Data, U32 Len, TBlock&& Block) const
+    {
+        const U8* Text = (const U8*)Data;
+
+        U32 State = 0,
+            I = 0;
+
+        bool HasCandidate = false;
+        SearchMatch Candidate = { 0, 0, 0 };
+
+        while(I < Len || HasCandidate)
+        {
+            bool Final = I == Len;
+
+            if(!Final)
+            {
+                State = Step(State, Text[I]);
+                Final = HasCandidate && Candidate.Offset < I + 1 - Depths[State];
+            }
+
+            if(Final)
+            {
+                if(!Block(Candidate))
+                    return;
+
+                I = Candidate.Offset + Candidate.Length;
+                State = 0;
+                HasCandidate = false;
+
+                continue;
+            }
+
+            //outputs are chained longest first so only the first one can start earliest
+            const U32 Out = Outputs[State];
+
+            if(Out != NoState)
+            {
+                const U32 Length = Depths[Out],
+                          Start = I + 1 - Length;
+
+                if(!HasCandidate || Start < Candidate.Offset || (Start == Candidate.Offset && Length > Candidate.Length))
+                {
+                    Candidate = { Start, Length, Terminals[Out] };
+                    HasCandidate = true;
+                }
+            }
+
+            I++;
+        }
+    }
+
+    static constexpr U32 NoState = 0xFFFFFFFF;
+
+    //byte -> character class, class 0 is every byte that isnt in a pattern
+    U8 Classes[256];
+    U32 ClassCount;
+
+    U32 StateCount;
+    U32 PatternCount;
+
+    //length of the prefix each state represents
+    U32* Depths;
+
+    //pattern index if this state is the end of a pattern, otherwise NoState
+    U32* Terminals;
+
+    //the longest pattern that ends at this state (might be itself), otherwise NoState
+    U32* Outputs;
+
+    //sparse trie used when the alphabet is too big for a dense table
+    U32* Fails;
+    U32* EdgeStart;
+    U32* EdgeTarget;
+    U8* EdgeClass;
+
+    //StateCount * ClassCount transition table, only when dense
+    U32* Table;
+};
+
+} // Cthulhu
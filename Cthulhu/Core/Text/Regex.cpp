@@ -0,0 +1,1599 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Regex.h"
+
+#include "Scan.h"
+//CharSet Utils::FindAny Utils::FindPattern
+
+#include "Ascii.h"
+//Utils::IsNum Utils::IsAlnum Utils::IsSpace Utils::IsHex
+
+#include "Core/Collections/CthulhuString.h"
+//String
+
+#include "Core/Types/Atomic.h"
+//Atomic<T>
+
+using namespace Cthulhu;
+
+namespace
+{
+
+constexpr U32 Unbounded = 0xFFFFFFFF;
+constexpr U32 NoPosition = RegexMatch::NoPosition;
+
+//limits that keep a hostile pattern from using unbounded memory
+constexpr U32 MaxRepeat = 1000;
+constexpr U32 MaxDepth = 256;
+constexpr U32 MaxInstructions = 1 << 16;
+constexpr U32 MaxPrefix = 32;
+
+//the dfa cache is thrown away and rebuilt once it has this many transitions
+constexpr U32 MaxTransitions = 1 << 20;
+constexpr U32 MaxStates = 4096;
+
+//grow geometrically, Array only grows by a fixed amount
+template<typename T>
+T* Grow(Array<T>& Items, U32 Amount)
+{
+    if(Items.Len() + Amount >= Items.RealSize())
+        Items.Reserve(Items.RealSize() + Amount);
+
+    return Items.Extend(Amount);
+}
+
+template<typename T>
+CTU_INLINE U32 Push(Array<T>& Items, const T& Item)
+{
+    *Grow(Items, 1) = Item;
+    return Items.Len() - 1;
+}
+
+}
+
+namespace Cthulhu::Private
+{
+
+struct ByteSet
+{
+    U64 Bits[4];
+
+    CTU_INLINE bool Has(U8 C) const { return (Bits[C >> 6] >> (C & 63)) & 1; }
+    CTU_INLINE void Add(U8 C) { Bits[C >> 6] |= 1ULL << (C & 63); }
+
+    void AddRange(U8 First, U8 Last)
+    {
+        for(U32 C = First; C <= Last; C++)
+            Add((U8)C);
+    }
+
+    template<typename TPred>
+    void AddWhere(TPred Pred)
+    {
+        for(U32 C = 0; C < 256; C++)
+            if(Pred((char)C))
+                Add((U8)C);
+    }
+
+    void Merge(const ByteSet& Other)
+    {
+        for(U32 I = 0; I < 4; I++)
+            Bits[I] |= Other.Bits[I];
+    }
+
+    void Invert()
+    {
+        for(U32 I = 0; I < 4; I++)
+            Bits[I] = ~Bits[I];
+    }
+
+    U32 Count() const
+    {
+        U32 Ret = 0;
+
+        for(U32 C = 0; C < 256; C++)
+            Ret += Has((U8)C);
+
+        return Ret;
+    }
+
+    U8 Lowest() const
+    {
+        for(U32 C = 0; C < 256; C++)
+            if(Has((U8)C))
+                return (U8)C;
+
+        return 0;
+    }
+};
+
+enum class Op : U8
+{
+    //consume one byte if it is in Sets[X]
+    Set,
+
+    //try X first and then Y
+    Split,
+    Jump,
+
+    //write the current position to capture slot X
+    Save,
+
+    Begin,
+    End,
+    Match,
+};
+
+struct Inst
+{
+    Op Code;
+    U32 X;
+    U32 Y;
+};
+
+enum class Prefilter : U8
+{
+    None,
+
+    //every match starts with Prefix
+    Literal,
+
+    //every match starts with a byte in First
+    Set,
+};
+
+struct RegexProgram
+{
+    Atomic<U32> Refs;
+
+    Array<Inst> Code;
+    Array<ByteSet> Sets;
+
+    //2 per group, group 0 is the whole match
+    U32 Slots;
+
+    //bytes that every set treats the same share a class so dfa states need fewer transitions
+    U8 Classes[256];
+    U8 Representative[256];
+    U32 ClassCount;
+
+    Prefilter Filter;
+    String Prefix;
+    CharSet First;
+
+    //every byte a match can start with, unless it can match without consuming anything
+    ByteSet Starts;
+    bool StartsEmpty;
+
+    //where a thread started anywhere but the start of the text is before it consumes anything
+    Array<U32> Restart;
+
+    //a thread started anywhere but the start of the text matches straight away, or would at the end
+    bool RestartMatch;
+    bool RestartMatchAtEnd;
+
+    //the pattern is nothing but Prefix so searching is just FindPattern
+    bool IsLiteral;
+};
+
+struct SparseSet
+{
+    Array<U32> Dense;
+    Array<U32> Sparse;
+    U32 Count = 0;
+
+    SparseSet(U32 Size)
+        : Dense(Size)
+        , Sparse(Size)
+    {
+        for(U32 I = 0; I < Size; I++)
+            Sparse[I] = Dense[I] = 0;
+    }
+
+    CTU_INLINE bool Has(U32 Item) const
+    {
+        const U32 Index = Sparse[Item];
+        return Index < Count && Dense[Index] == Item;
+    }
+
+    CTU_INLINE U32 Add(U32 Item)
+    {
+        Sparse[Item] = Count;
+        Dense[Count] = Item;
+        return Count++;
+    }
+
+    CTU_INLINE void Clear() { Count = 0; }
+};
+
+struct DfaState
+{
+    //where its nfa states are in Dfa::Pcs
+    U32 First;
+    U32 Count;
+
+    //a match ends right before the next byte
+    bool Match;
+
+    //a match ends here if this is the end of the text
+    bool MatchAtEnd;
+
+    //nothing has been read yet so ^ still holds when working out MatchAtEnd,
+    //kept apart from the state with the same nfa states that isnt at the start
+    bool AtBegin;
+};
+
+struct Dfa
+{
+    //unanchored dfas start a new thread at every position
+    bool Unanchored;
+
+    Array<U32> Pcs;
+    Array<DfaState> States;
+
+    //States.Len() * ClassCount transitions, -1 until worked out
+    Array<I32> Next;
+
+    //open addressing from the hash of a set of pcs to a state
+    Array<I32> Table;
+
+    I32 Start = -1;
+    I32 StartAtBegin = -1;
+
+    //bumped every time the cache is thrown away so stale state indices can be spotted
+    U32 Generation = 0;
+
+    Dfa(bool InUnanchored)
+        : Unanchored(InUnanchored)
+        , Table(MaxStates * 2)
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        Pcs.Drop(Pcs.Len());
+        States.Drop(States.Len());
+        Next.Drop(Next.Len());
+
+        for(I32& Slot : Table)
+            Slot = -1;
+
+        Start = StartAtBegin = -1;
+        Generation++;
+    }
+};
+
+struct RegexCache
+{
+    Dfa Anchored;
+    Dfa Unanchored;
+
+    //nfa states reached while working out a closure
+    SparseSet Visited;
+
+    //the states a dfa state is made of
+    SparseSet Leaves;
+
+    Array<U32> Stack;
+
+    //pike vm thread lists with a copy of the capture slots for each thread
+    SparseSet Current;
+    SparseSet Upcoming;
+    Array<U32> CurrentSlots;
+    Array<U32> UpcomingSlots;
+
+    RegexCache(const RegexProgram& Program)
+        : Anchored(false)
+        , Unanchored(true)
+        , Visited(Program.Code.Len())
+        , Leaves(Program.Code.Len())
+        , Current(Program.Code.Len())
+        , Upcoming(Program.Code.Len())
+        , CurrentSlots(Program.Code.Len() * Program.Slots)
+        , UpcomingSlots(Program.Code.Len() * Program.Slots)
+    {}
+};
+
+}
+
+using namespace Cthulhu::Private;
+
+namespace
+{
+
+/*================================================================*/
+/*              parsing                                           */
+/*================================================================*/
+
+enum class NodeKind : U8
+{
+    Empty,
+    Set,
+    Begin,
+    End,
+    Concat,
+    Alternate,
+    Repeat,
+    Group,
+};
+
+struct Node
+{
+    NodeKind Kind;
+
+    //Concat and Alternate use both, Repeat and Group only use Left
+    U32 Left;
+    U32 Right;
+
+    U32 Min;
+    U32 Max;
+
+    //the set for Set and the group number for Group
+    U32 Index;
+
+    bool Greedy;
+};
+
+struct Parser
+{
+    StringView Pattern;
+    U32 Cursor;
+
+    Array<Node> Nodes;
+    Array<ByteSet>& Sets;
+    U32 Groups;
+
+    const char* Error;
+    U32 ErrorOffset;
+
+    Parser(StringView InPattern, Array<ByteSet>& InSets)
+        : Pattern(InPattern)
+        , Cursor(0)
+        , Sets(InSets)
+        , Groups(0)
+        , Error(nullptr)
+        , ErrorOffset(0)
+    {
+        //node 0 is always the empty pattern
+        Add({ NodeKind::Empty });
+    }
+
+    U32 Add(Node Item) { return Push(Nodes, Item); }
+
+    U32 Fail(const char* Message)
+    {
+        if(!Error)
+        {
+            Error = Message;
+            ErrorOffset = Cursor;
+        }
+
+        return 0;
+    }
+
+    CTU_INLINE bool AtEnd() const { return Cursor >= Pattern.Len(); }
+    CTU_INLINE char Peek() const { return Pattern[Cursor]; }
+
+    U32 AddSet(const ByteSet& Set)
+    {
+        Node Item = { NodeKind::Set };
+        Item.Index = Push(Sets, Set);
+        return Add(Item);
+    }
+
+    U32 ParseAlternate(U32 Depth)
+    {
+        U32 Left = ParseConcat(Depth);
+
+        while(!Error && !AtEnd() && Peek() == '|')
+        {
+            Cursor++;
+            const U32 Right = ParseConcat(Depth);
+            Left = Add({ NodeKind::Alternate, Left, Right });
+        }
+
+        return Left;
+    }
+
+    U32 ParseConcat(U32 Depth)
+    {
+        U32 Ret = 0;
+        bool Any = false;
+
+        while(!Error && !AtEnd() && Peek() != '|' && Peek() != ')')
+        {
+            const U32 Item = ParseRepeat(Depth);
+            Ret = Any ? Add({ NodeKind::Concat, Ret, Item }) : Item;
+            Any = true;
+        }
+
+        return Error ? 0 : Ret;
+    }
+
+    bool ParseCount(U32& Out)
+    {
+        const U32 Start = Cursor;
+        Out = 0;
+
+        for(; !AtEnd() && Utils::IsNum(Peek()); Cursor++)
+        {
+            //anything this big is rejected later so stop before it overflows
+            if(Out <= MaxRepeat)
+                Out = (Out * 10) + (Peek() - '0');
+        }
+
+        return Cursor != Start;
+    }
+
+    U32 ParseRepeat(U32 Depth)
+    {
+        U32 Item = ParseAtom(Depth);
+
+        while(!Error && !AtEnd())
+        {
+            U32 Min, Max;
+            const char C = Peek();
+
+            if(C == '*') { Min = 0; Max = Unbounded; Cursor++; }
+            else if(C == '+') { Min = 1; Max = Unbounded; Cursor++; }
+            else if(C == '?') { Min = 0; Max = 1; Cursor++; }
+            else if(C == '{')
+            {
+                Cursor++;
+
+                if(!ParseCount(Min))
+                    return Fail("expected a number after {");
+
+                Max = Min;
+
+                if(!AtEnd() && Peek() == ',')
+                {
+                    Cursor++;
+
+                    if(!AtEnd() && Peek() == '}')
+                        Max = Unbounded;
+                    else if(!ParseCount(Max))
+                        return Fail("expected a number or } after ,");
+                }
+
+                if(AtEnd() || Peek() != '}')
+                    return Fail("missing }");
+
+                Cursor++;
+
+                if(Min > MaxRepeat || (Max != Unbounded && Max > MaxRepeat))
+                    return Fail("repeat count is too big");
+
+                if(Max < Min)
+                    return Fail("repeat range is backwards");
+            }
+            else
+            {
+                break;
+            }
+
+            bool Greedy = true;
+
+            if(!AtEnd() && Peek() == '?')
+            {
+                Greedy = false;
+                Cursor++;
+            }
+
+            Item = Add({ NodeKind::Repeat, Item, 0, Min, Max, 0, Greedy });
+        }
+
+        return Item;
+    }
+
+    //the escape after a backslash, either one byte or a class like \d
+    bool ParseEscape(ByteSet& Into)
+    {
+        if(AtEnd())
+            return Fail("pattern ends with a \\"), false;
+
+        const char C = Pattern[Cursor++];
+
+        switch(C)
+        {
+        case 'd': case 'D': Into.AddWhere(Utils::IsNum); break;
+        case 'w': case 'W': Into.AddWhere([](char L) { return Utils::IsAlnum(L) || L == '_'; }); break;
+        case 's': case 'S': Into.AddWhere(Utils::IsSpace); break;
+        case 'n': Into.Add('\n'); return true;
+        case 'r': Into.Add('\r'); return true;
+        case 't': Into.Add('\t'); return true;
+        case 'f': Into.Add('\f'); return true;
+        case 'v': Into.Add('\v'); return true;
+        case '0': Into.Add('\0'); return true;
+        case 'x':
+        {
+            if(Cursor + 2 > Pattern.Len() || !Utils::IsHex(Pattern[Cursor]) || !Utils::IsHex(Pattern[Cursor + 1]))
+                return Fail("expected 2 hex digits after \\x"), false;
+
+            auto Value = [](char H) { return Utils::IsNum(H) ? H - '0' : (H | 0x20) - 'a' + 10; };
+            Into.Add((U8)((Value(Pattern[Cursor]) << 4) | Value(Pattern[Cursor + 1])));
+            Cursor += 2;
+
+            return true;
+        }
+        default:
+            //letters and digits are saved for future escapes, anything else is itself
+            if(Utils::IsAlnum(C))
+                return Cursor--, Fail("unknown escape"), false;
+
+            Into.Add((U8)C);
+            return true;
+        }
+
+        //the upper case class escapes are the negated forms
+        if(Utils::IsUpper(C))
+            Into.Invert();
+
+        return true;
+    }
+
+    //a single byte inside a class, \d and friends are merged straight into Set
+    bool ParseClassByte(ByteSet& Set, U8& Out, bool& IsByte)
+    {
+        const char C = Pattern[Cursor++];
+        IsByte = true;
+
+        if(C != '\\')
+        {
+            Out = (U8)C;
+            return true;
+        }
+
+        ByteSet Escaped = {};
+
+        if(!ParseEscape(Escaped))
+            return false;
+
+        if(Escaped.Count() == 1)
+        {
+            Out = Escaped.Lowest();
+            return true;
+        }
+
+        Set.Merge(Escaped);
+        IsByte = false;
+
+        return true;
+    }
+
+    U32 ParseClass()
+    {
+        ByteSet Set = {};
+        bool Negate = false;
+
+        if(!AtEnd() && Peek() == '^')
+        {
+            Negate = true;
+            Cursor++;
+        }
+
+        //a ] straight away is part of the class
+        bool First = true;
+
+        while(true)
+        {
+            if(AtEnd())
+                return Fail("missing ]");
+
+            if(Peek() == ']' && !First)
+            {
+                Cursor++;
+                break;
+            }
+
+            First = false;
+
+            U8 Low;
+            bool IsByte;
+
+            if(!ParseClassByte(Set, Low, IsByte))
+                return 0;
+
+            if(!IsByte)
+                continue;
+
+            if(Cursor + 1 < Pattern.Len() && Peek() == '-' && Pattern[Cursor + 1] != ']')
+            {
+                Cursor++;
+
+                U8 High;
+
+                if(!ParseClassByte(Set, High, IsByte))
+                    return 0;
+
+                if(!IsByte || High < Low)
+                    return Fail("invalid range in class");
+
+                Set.AddRange(Low, High);
+            }
+            else
+            {
+                Set.Add(Low);
+            }
+        }
+
+        if(Negate)
+            Set.Invert();
+
+        return AddSet(Set);
+    }
+
+    U32 ParseAtom(U32 Depth)
+    {
+        const char C = Pattern[Cursor++];
+
+        switch(C)
+        {
+        case '(':
+        {
+            if(Depth >= MaxDepth)
+                return Fail("pattern nests too deep");
+
+            bool Capturing = true;
+
+            if(!AtEnd() && Peek() == '?')
+            {
+                if(Cursor + 1 >= Pattern.Len() || Pattern[Cursor + 1] != ':')
+                    return Fail("unsupported group syntax");
+
+                Capturing = false;
+                Cursor += 2;
+            }
+
+            const U32 Group = Capturing ? ++Groups : 0;
+            const U32 Inner = ParseAlternate(Depth + 1);
+
+            if(Error)
+                return 0;
+
+            if(AtEnd() || Peek() != ')')
+                return Fail("missing )");
+
+            Cursor++;
+
+            if(!Capturing)
+                return Inner;
+
+            Node Item = { NodeKind::Group, Inner };
+            Item.Index = Group;
+
+            return Add(Item);
+        }
+        case '[':
+            return ParseClass();
+        case '.':
+        {
+            ByteSet Set = {};
+            Set.Add('\n');
+            Set.Invert();
+
+            return AddSet(Set);
+        }
+        case '^':
+            return Add({ NodeKind::Begin });
+        case '$':
+            return Add({ NodeKind::End });
+        case '*': case '+': case '?': case '{':
+            Cursor--;
+            return Fail("nothing to repeat");
+        case '\\':
+        {
+            ByteSet Set = {};
+
+            if(!ParseEscape(Set))
+                return 0;
+
+            return AddSet(Set);
+        }
+        default:
+        {
+            ByteSet Set = {};
+            Set.Add((U8)C);
+
+            return AddSet(Set);
+        }
+        }
+    }
+};
+
+//the items of a chain of Concat nodes in order, without recursing once per item
+void Flatten(const Array<Node>& Nodes, U32 Index, Array<U32>& Into)
+{
+    Array<U32> Rights;
+
+    while(Nodes[Index].Kind == NodeKind::Concat)
+    {
+        Push(Rights, Nodes[Index].Right);
+        Index = Nodes[Index].Left;
+    }
+
+    Push(Into, Index);
+
+    for(U32 I = Rights.Len(); I-- > 0;)
+        Push(Into, Rights[I]);
+}
+
+/*================================================================*/
+/*              compiling                                         */
+/*================================================================*/
+
+struct Compiler
+{
+    const Array<Node>& Nodes;
+    Array<Inst>& Code;
+    bool TooBig;
+
+    U32 Emit(Inst Item)
+    {
+        if(Code.Len() >= MaxInstructions)
+        {
+            TooBig = true;
+            return 0;
+        }
+
+        return Push(Code, Item);
+    }
+
+    void Patch(U32 At, U32 Body, U32 Exit, bool Greedy)
+    {
+        Code[At].X = Greedy ? Body : Exit;
+        Code[At].Y = Greedy ? Exit : Body;
+    }
+
+    void Compile(U32 Index)
+    {
+        if(TooBig)
+            return;
+
+        const Node Item = Nodes[Index];
+
+        switch(Item.Kind)
+        {
+        case NodeKind::Empty:
+            return;
+        case NodeKind::Set:
+            Emit({ Op::Set, Item.Index, 0 });
+            return;
+        case NodeKind::Begin:
+            Emit({ Op::Begin, 0, 0 });
+            return;
+        case NodeKind::End:
+            Emit({ Op::End, 0, 0 });
+            return;
+        case NodeKind::Group:
+            Emit({ Op::Save, Item.Index * 2, 0 });
+            Compile(Item.Left);
+            Emit({ Op::Save, (Item.Index * 2) + 1, 0 });
+            return;
+        case NodeKind::Concat:
+        {
+            Array<U32> Items;
+            Flatten(Nodes, Index, Items);
+
+            for(U32 Part : Items)
+                Compile(Part);
+
+            return;
+        }
+        case NodeKind::Alternate:
+        {
+            const U32 Split = Emit({ Op::Split, 0, 0 });
+            Compile(Item.Left);
+
+            const U32 Jump = Emit({ Op::Jump, 0, 0 });
+            const U32 Right = Code.Len();
+            Compile(Item.Right);
+
+            if(TooBig)
+                return;
+
+            Patch(Split, Split + 1, Right, true);
+            Code[Jump].X = Code.Len();
+
+            return;
+        }
+        case NodeKind::Repeat:
+        {
+            for(U32 I = 0; I < Item.Min; I++)
+                Compile(Item.Left);
+
+            if(Item.Max == Unbounded)
+            {
+                const U32 Loop = Emit({ Op::Split, 0, 0 });
+                Compile(Item.Left);
+                Emit({ Op::Jump, Loop, 0 });
+
+                if(!TooBig)
+                    Patch(Loop, Loop + 1, Code.Len(), Item.Greedy);
+
+                return;
+            }
+
+            //x{2,4} is xx(x(x)?)? where every optional part skips straight to the end
+            Array<U32> Splits;
+
+            for(U32 I = Item.Min; I < Item.Max && !TooBig; I++)
+            {
+                Push(Splits, Emit({ Op::Split, 0, 0 }));
+                Compile(Item.Left);
+            }
+
+            if(!TooBig)
+            {
+                for(U32 Split : Splits)
+                    Patch(Split, Split + 1, Code.Len(), Item.Greedy);
+            }
+
+            return;
+        }
+        }
+    }
+};
+
+//collect the literal every match has to start with
+void LiteralPrefix(const Array<Node>& Nodes, const Array<ByteSet>& Sets, U32 Index, String& Prefix, bool& Done)
+{
+    if(Done)
+        return;
+
+    const Node Item = Nodes[Index];
+
+    switch(Item.Kind)
+    {
+    case NodeKind::Empty:
+        return;
+    case NodeKind::Set:
+        if(Sets[Item.Index].Count() == 1 && Prefix.Len() < MaxPrefix)
+            Prefix += (char)Sets[Item.Index].Lowest();
+        else
+            Done = true;
+        return;
+    case NodeKind::Group:
+        LiteralPrefix(Nodes, Sets, Item.Left, Prefix, Done);
+        return;
+    case NodeKind::Concat:
+    {
+        Array<U32> Items;
+        Flatten(Nodes, Index, Items);
+
+        for(U32 Part : Items)
+            LiteralPrefix(Nodes, Sets, Part, Prefix, Done);
+
+        return;
+    }
+    case NodeKind::Repeat:
+        //only the first copy is certain to be there
+        if(Item.Min > 0)
+            LiteralPrefix(Nodes, Sets, Item.Left, Prefix, Done);
+
+        Done = true;
+        return;
+    default:
+        Done = true;
+        return;
+    }
+}
+
+/*================================================================*/
+/*              running                                           */
+/*================================================================*/
+
+//follow every instruction that doesnt consume anything, leaves are added to Into
+void Closure(const RegexProgram& Program, RegexCache& Cache, U32 Pc, bool AtBegin, bool AtEnd, SparseSet& Into)
+{
+    Array<U32>& Stack = Cache.Stack;
+    Push(Stack, Pc);
+
+    while(Stack.Len() > 0)
+    {
+        const U32 At = Stack.Pop();
+
+        if(Cache.Visited.Has(At))
+            continue;
+
+        Cache.Visited.Add(At);
+
+        const Inst Item = Program.Code[At];
+
+        switch(Item.Code)
+        {
+        case Op::Jump:
+            Push(Stack, Item.X);
+            break;
+        case Op::Split:
+            Push(Stack, Item.Y);
+            Push(Stack, Item.X);
+            break;
+        case Op::Save:
+            Push(Stack, At + 1);
+            break;
+        case Op::Begin:
+            if(AtBegin)
+                Push(Stack, At + 1);
+            break;
+        case Op::End:
+            //kept so the state can check it once it knows if the text has ended
+            if(AtEnd)
+                Push(Stack, At + 1);
+            else if(!Into.Has(At))
+                Into.Add(At);
+            break;
+        case Op::Set:
+        case Op::Match:
+            if(!Into.Has(At))
+                Into.Add(At);
+            break;
+        }
+    }
+}
+
+U32 HashLeaves(const SparseSet& Leaves)
+{
+    //order doesnt matter so the same set always hashes the same
+    U32 Ret = Leaves.Count;
+
+    for(U32 I = 0; I < Leaves.Count; I++)
+        Ret += (Leaves.Dense[I] + 1) * 2654435761U;
+
+    return Ret;
+}
+
+I32 Intern(const RegexProgram& Program, RegexCache& Cache, Dfa& Machine, bool AtBegin)
+{
+    const SparseSet& Leaves = Cache.Leaves;
+    const U32 Mask = Machine.Table.Len() - 1;
+
+    for(U32 Slot = (HashLeaves(Leaves) + AtBegin) & Mask;; Slot = (Slot + 1) & Mask)
+    {
+        const I32 Index = Machine.Table[Slot];
+
+        if(Index < 0)
+        {
+            if(Machine.States.Len() >= MaxStates || (Machine.States.Len() + 1) * Program.ClassCount > MaxTransitions)
+            {
+                //start again with an empty cache rather than growing forever
+                Machine.Reset();
+                return Intern(Program, Cache, Machine, AtBegin);
+            }
+
+            DfaState State = { Machine.Pcs.Len(), Leaves.Count, false, false, AtBegin };
+            U32* Pcs = Grow(Machine.Pcs, Leaves.Count);
+
+            for(U32 I = 0; I < Leaves.Count; I++)
+            {
+                Pcs[I] = Leaves.Dense[I];
+                State.Match |= Program.Code[Pcs[I]].Code == Op::Match;
+            }
+
+            //work out if the pending $ assertions would lead to a match
+            State.MatchAtEnd = State.Match;
+
+            if(!State.Match)
+            {
+                Cache.Visited.Clear();
+
+                for(U32 I = 0; I < State.Count && !State.MatchAtEnd; I++)
+                {
+                    const U32 Pc = Machine.Pcs[State.First + I];
+
+                    if(Program.Code[Pc].Code != Op::End)
+                        continue;
+
+                    //Leaves is in use so the closure goes into Upcoming which the vm only uses later
+                    Cache.Upcoming.Clear();
+                    Closure(Program, Cache, Pc, AtBegin, true, Cache.Upcoming);
+
+                    for(U32 J = 0; J < Cache.Upcoming.Count; J++)
+                        State.MatchAtEnd |= Program.Code[Cache.Upcoming.Dense[J]].Code == Op::Match;
+                }
+            }
+
+            I32* Next = Grow(Machine.Next, Program.ClassCount);
+
+            for(U32 I = 0; I < Program.ClassCount; I++)
+                Next[I] = -1;
+
+            Machine.Table[Slot] = (I32)Push(Machine.States, State);
+
+            return Machine.Table[Slot];
+        }
+
+        const DfaState& Existing = Machine.States[Index];
+
+        if(Existing.Count != Leaves.Count || Existing.AtBegin != AtBegin)
+            continue;
+
+        bool Same = true;
+
+        for(U32 I = 0; I < Existing.Count && Same; I++)
+            Same = Leaves.Has(Machine.Pcs[Existing.First + I]);
+
+        if(Same)
+            return Index;
+    }
+}
+
+I32 StartState(const RegexProgram& Program, RegexCache& Cache, Dfa& Machine, bool AtBegin)
+{
+    I32& Start = AtBegin ? Machine.StartAtBegin : Machine.Start;
+
+    if(Start >= 0)
+        return Start;
+
+    Cache.Visited.Clear();
+    Cache.Leaves.Clear();
+
+    //unanchored states only hold threads already in flight, new ones are added by Step
+    //so the usual start is empty. at the very start of the text ^ can match so the first
+    //thread is put in by hand
+    if(!Machine.Unanchored || AtBegin)
+        Closure(Program, Cache, 0, AtBegin, false, Cache.Leaves);
+
+    const I32 Ret = Intern(Program, Cache, Machine, AtBegin);
+
+    //interning might have reset the cache which clears both starts
+    (AtBegin ? Machine.StartAtBegin : Machine.Start) = Ret;
+
+    return Ret;
+}
+
+I32 Step(const RegexProgram& Program, RegexCache& Cache, Dfa& Machine, I32 From, U8 Class)
+{
+    const I32 Cached = Machine.Next[(From * Program.ClassCount) + Class];
+
+    if(Cached >= 0)
+        return Cached;
+
+    const U8 Byte = Program.Representative[Class];
+    const DfaState State = Machine.States[From];
+
+    Cache.Visited.Clear();
+    Cache.Leaves.Clear();
+
+    auto Advance = [&](U32 Pc) {
+        const Inst Item = Program.Code[Pc];
+
+        if(Item.Code == Op::Set && Program.Sets[Item.X].Has(Byte))
+            Closure(Program, Cache, Pc + 1, false, false, Cache.Leaves);
+    };
+
+    for(U32 I = 0; I < State.Count; I++)
+        Advance(Machine.Pcs[State.First + I]);
+
+    //a new thread starts at every byte, after the ones already running so they keep their priority
+    if(Machine.Unanchored)
+    {
+        for(U32 Pc : Program.Restart)
+            Advance(Pc);
+    }
+
+    const U32 Generation = Machine.Generation;
+    const I32 Ret = Intern(Program, Cache, Machine, false);
+
+    if(Generation == Machine.Generation)
+        Machine.Next[(From * Program.ClassCount) + Class] = Ret;
+
+    return Ret;
+}
+
+//the next place a match could start, or Len if there isnt one
+U32 NextCandidate(const RegexProgram& Program, const char* Text, U32 Len, U32 From)
+{
+    switch(Program.Filter)
+    {
+    case Prefilter::Literal:
+        return From + Utils::FindPattern(Text + From, Len - From, Program.Prefix);
+    case Prefilter::Set:
+        return From + Utils::FindAny(Text + From, Len - From, Program.First);
+    default:
+        return From;
+    }
+}
+
+//run the unanchored dfa to find out if there is a match, Begin is set to the last place nothing
+//was in flight so the leftmost match cant start before it
+bool EarliestEnd(const RegexProgram& Program, RegexCache& Cache, const char* Text, U32 Len, U32 From, U32& Begin)
+{
+    Begin = From;
+
+    //matching nothing at all counts as a match anywhere
+    if(Program.RestartMatch)
+        return true;
+
+    Dfa& Machine = Cache.Unanchored;
+    I32 State = StartState(Program, Cache, Machine, From == 0);
+
+    if(Machine.States[State].Match)
+        return true;
+
+    for(U32 I = From; I < Len;)
+    {
+        if(Machine.Start < 0)
+            StartState(Program, Cache, Machine, false);
+
+        if(State == Machine.Start)
+        {
+            //nothing is part way through a match so skip to where one could start
+            if(Program.Filter != Prefilter::None)
+            {
+                I = NextCandidate(Program, Text, Len, I);
+
+                if(I == Len)
+                    break;
+            }
+
+            Begin = I;
+        }
+
+        State = Step(Program, Cache, Machine, State, Program.Classes[(U8)Text[I++]]);
+
+        if(Machine.States[State].Match)
+            return true;
+    }
+
+    return Machine.States[State].MatchAtEnd || Program.RestartMatchAtEnd;
+}
+
+//add a vm thread and everything it reaches without consuming anything, Slots is the threads captures
+void AddThread(const RegexProgram& Program, RegexCache& Cache, SparseSet& List, Array<U32>& ListSlots, U32 Pc, U32 Pos, U32 Len, U32* Slots)
+{
+    //entries with the top bit set restore a slot once everything after a Save has been followed
+    constexpr U32 Restore = 0x80000000;
+
+    Array<U32>& Stack = Cache.Stack;
+    Push(Stack, Pc);
+
+    while(Stack.Len() > 0)
+    {
+        const U32 Entry = Stack.Pop();
+
+        if(Entry & Restore)
+        {
+            const U32 Old = Stack.Pop();
+            Slots[Entry & ~Restore] = Old;
+            continue;
+        }
+
+        if(List.Has(Entry))
+            continue;
+
+        const U32 Index = List.Add(Entry);
+        const Inst Item = Program.Code[Entry];
+
+        switch(Item.Code)
+        {
+        case Op::Jump:
+            Push(Stack, Item.X);
+            break;
+        case Op::Split:
+            Push(Stack, Item.Y);
+            Push(Stack, Item.X);
+            break;
+        case Op::Save:
+            Push(Stack, Slots[Item.X]);
+            Push(Stack, Item.X | Restore);
+            Slots[Item.X] = Pos;
+            Push(Stack, Entry + 1);
+            break;
+        case Op::Begin:
+            if(Pos == 0)
+                Push(Stack, Entry + 1);
+            break;
+        case Op::End:
+            if(Pos == Len)
+                Push(Stack, Entry + 1);
+            break;
+        case Op::Set:
+        case Op::Match:
+            for(U32 I = 0; I < Program.Slots; I++)
+                ListSlots[(Index * Program.Slots) + I] = Slots[I];
+            break;
+        }
+    }
+}
+
+//find the leftmost match starting at or after From with a pike vm, Out gets every capture slot
+bool Pike(const RegexProgram& Program, RegexCache& Cache, const char* Text, U32 Len, U32 From, U32* Out)
+{
+    SparseSet* Current = &Cache.Current;
+    SparseSet* Upcoming = &Cache.Upcoming;
+    Array<U32>* CurrentSlots = &Cache.CurrentSlots;
+    Array<U32>* UpcomingSlots = &Cache.UpcomingSlots;
+
+    U32 Fresh[MaxDepth * 2 + 2];
+    Array<U32> Large;
+
+    //programs with lots of groups dont fit on the stack
+    U32* Slots = Program.Slots <= MaxDepth * 2 + 2 ? Fresh : Grow(Large, Program.Slots);
+
+    bool Matched = false;
+    Current->Clear();
+
+    for(U32 Pos = From;; Pos++)
+    {
+        //with nothing in flight skip straight to the next byte a match could start with
+        if(!Matched && Current->Count == 0 && !Program.StartsEmpty)
+        {
+            while(Pos < Len && !Program.Starts.Has((U8)Text[Pos]))
+                Pos++;
+
+            if(Pos == Len)
+                break;
+        }
+
+        //new threads have the lowest priority so the leftmost match wins
+        if(!Matched)
+        {
+            for(U32 I = 0; I < Program.Slots; I++)
+                Slots[I] = NoPosition;
+
+            AddThread(Program, Cache, *Current, *CurrentSlots, 0, Pos, Len, Slots);
+        }
+
+        if(Current->Count == 0)
+            break;
+
+        Upcoming->Clear();
+
+        for(U32 T = 0; T < Current->Count; T++)
+        {
+            const U32 Pc = Current->Dense[T];
+            const Inst Item = Program.Code[Pc];
+            U32* ThreadSlots = &(*CurrentSlots)[T * Program.Slots];
+
+            if(Item.Code == Op::Match)
+            {
+                for(U32 I = 0; I < Program.Slots; I++)
+                    Out[I] = ThreadSlots[I];
+
+                //every thread after this one has a lower priority
+                Matched = true;
+                break;
+            }
+
+            if(Item.Code == Op::Set && Pos < Len && Program.Sets[Item.X].Has((U8)Text[Pos]))
+            {
+                for(U32 I = 0; I < Program.Slots; I++)
+                    Slots[I] = ThreadSlots[I];
+
+                AddThread(Program, Cache, *Upcoming, *UpcomingSlots, Pc + 1, Pos + 1, Len, Slots);
+            }
+        }
+
+        SparseSet* Swap = Current;
+        Current = Upcoming;
+        Upcoming = Swap;
+
+        Array<U32>* SwapSlots = CurrentSlots;
+        CurrentSlots = UpcomingSlots;
+        UpcomingSlots = SwapSlots;
+
+        if(Pos >= Len)
+            break;
+    }
+
+    return Matched;
+}
+
+void Retain(RegexProgram* Program)
+{
+    if(Program)
+        Program->Refs.Add(1, MemoryOrder::Relaxed);
+}
+
+void Release(RegexProgram* Program)
+{
+    if(Program && Program->Refs.Sub(1, MemoryOrder::AcquireRelease) == 1)
+        delete Program;
+}
+
+}
+
+/*================================================================*/
+/*              Cthulhu::Regex                                    */
+/*================================================================*/
+
+Cthulhu::Regex::Regex()
+    : Program(nullptr)
+    , Scratch(nullptr)
+{}
+
+Cthulhu::Regex::Regex(const Regex& Other)
+    : Program(Other.Program)
+    , Scratch(nullptr)
+{
+    Retain(Program);
+}
+
+Regex& Cthulhu::Regex::operator=(const Regex& Other)
+{
+    Retain(Other.Program);
+    Release(Program);
+
+    Program = Other.Program;
+
+    //the cache belongs to the old program
+    delete Scratch;
+    Scratch = nullptr;
+
+    return *this;
+}
+
+Cthulhu::Regex::~Regex()
+{
+    delete Scratch;
+    Release(Program);
+}
+
+RegexCache& Cthulhu::Regex::Cache() const
+{
+    if(!Scratch)
+        Scratch = new RegexCache(*Program);
+
+    return *Scratch;
+}
+
+Result<Regex, RegexError> Cthulhu::Regex::Compile(StringView Pattern)
+{
+    RegexProgram* Program = new RegexProgram();
+    Program->Refs.Store(1);
+
+    Parser Parse(Pattern, Program->Sets);
+    const U32 Root = Parse.AtEnd() ? 0 : Parse.ParseAlternate(0);
+
+    if(!Parse.Error && !Parse.AtEnd())
+        Parse.Fail("unmatched )");
+
+    if(Parse.Error)
+    {
+        delete Program;
+        return Fail<Regex, RegexError>({ Parse.ErrorOffset, Parse.Error });
+    }
+
+    //wrap everything in group 0
+    Compiler Emit = { Parse.Nodes, Program->Code, false };
+    Emit.Emit({ Op::Save, 0, 0 });
+    Emit.Compile(Root);
+    Emit.Emit({ Op::Save, 1, 0 });
+    Emit.Emit({ Op::Match, 0, 0 });
+
+    if(Emit.TooBig)
+    {
+        delete Program;
+        return Fail<Regex, RegexError>({ 0, "pattern is too big" });
+    }
+
+    Program->Slots = (Parse.Groups + 1) * 2;
+
+    //split the bytes into classes wherever any set changes its mind
+    bool Boundary[256] = {};
+
+    for(const Inst& Item : Program->Code)
+    {
+        if(Item.Code != Op::Set)
+            continue;
+
+        const ByteSet& Set = Program->Sets[Item.X];
+
+        for(U32 C = 1; C < 256; C++)
+            Boundary[C] |= Set.Has((U8)C) != Set.Has((U8)(C - 1));
+    }
+
+    U32 Class = 0;
+
+    for(U32 C = 0; C < 256; C++)
+    {
+        if(Boundary[C])
+            Class++;
+
+        if(C == 0 || Boundary[C])
+            Program->Representative[Class] = (U8)C;
+
+        Program->Classes[C] = (U8)Class;
+    }
+
+    Program->ClassCount = Class + 1;
+
+    //pick a prefilter
+    bool Done = false;
+    LiteralPrefix(Parse.Nodes, Program->Sets, Root, Program->Prefix, Done);
+
+    Program->IsLiteral = !Done && Parse.Groups == 0 && Program->Prefix.Len() > 0;
+    Program->Filter = Prefilter::None;
+
+    //the bytes a match can start with, from both the start of the text and anywhere else
+    RegexCache Scan = RegexCache(*Program);
+
+    for(U32 AtBegin = 0; AtBegin < 2; AtBegin++)
+    {
+        Scan.Visited.Clear();
+        Scan.Leaves.Clear();
+        Closure(*Program, Scan, 0, AtBegin, false, Scan.Leaves);
+
+        for(U32 I = 0; I < Scan.Leaves.Count; I++)
+        {
+            const Inst Item = Program->Code[Scan.Leaves.Dense[I]];
+
+            if(Item.Code == Op::Set)
+                Program->Starts.Merge(Program->Sets[Item.X]);
+            else
+                Program->StartsEmpty = true;
+        }
+    }
+
+    Scan.Visited.Clear();
+    Scan.Leaves.Clear();
+    Closure(*Program, Scan, 0, false, false, Scan.Leaves);
+
+    for(U32 I = 0; I < Scan.Leaves.Count; I++)
+        Push(Program->Restart, Scan.Leaves.Dense[I]);
+
+    const DfaState& Restart = Scan.Anchored.States[Intern(*Program, Scan, Scan.Anchored, false)];
+    Program->RestartMatch = Restart.Match;
+    Program->RestartMatchAtEnd = Restart.MatchAtEnd;
+
+    const U32 Count = Program->Starts.Count();
+
+    if(Program->Prefix.Len() >= 2)
+    {
+        Program->Filter = Prefilter::Literal;
+    }
+    else if(!Program->StartsEmpty && Count > 0 && Count <= CharSet::MaxSmall)
+    {
+        for(U32 C = 0; C < 256; C++)
+            if(Program->Starts.Has((U8)C))
+                Program->First.Add((char)C);
+
+        Program->Filter = Prefilter::Set;
+    }
+
+    Regex Ret;
+    Ret.Program = Program;
+
+    return Pass<Regex, RegexError>(Ret);
+}
+
+bool Cthulhu::Regex::Match(StringView Text) const
+{
+    if(!Program)
+        return false;
+
+    if(Program->IsLiteral)
+        return Text == StringView(Program->Prefix);
+
+    RegexCache& Machine = Cache();
+    Dfa& Anchored = Machine.Anchored;
+
+    I32 State = StartState(*Program, Machine, Anchored, true);
+
+    for(char C : Text)
+    {
+        State = Step(*Program, Machine, Anchored, State, Program->Classes[(U8)C]);
+
+        if(Anchored.States[State].Count == 0)
+            return false;
+    }
+
+    return Anchored.States[State].MatchAtEnd;
+}
+
+bool Cthulhu::Regex::Contains(StringView Text) const
+{
+    if(!Program)
+        return false;
+
+    if(Program->IsLiteral)
+        return Utils::FindPattern(Text.Data(), Text.Len(), Program->Prefix) != Text.Len();
+
+    U32 Begin;
+    return EarliestEnd(*Program, Cache(), Text.Data(), Text.Len(), 0, Begin);
+}
+
+Option<RegexMatch> Cthulhu::Regex::Find(StringView Text, U32 From) const
+{
+    if(!Program || From > Text.Len())
+        return None<RegexMatch>();
+
+    if(Program->IsLiteral)
+    {
+        const U32 Found = From + Utils::FindPattern(Text.Data() + From, Text.Len() - From, Program->Prefix);
+
+        if(Found == Text.Len())
+            return None<RegexMatch>();
+
+        return Some(RegexMatch{ Found, Program->Prefix.Len() });
+    }
+
+    RegexCache& Machine = Cache();
+    U32 Begin;
+
+    //the dfa is much cheaper so it rules out text without a match and narrows down where the vm starts
+    if(!EarliestEnd(*Program, Machine, Text.Data(), Text.Len(), From, Begin))
+        return None<RegexMatch>();
+
+    U32 Fresh[2];
+    Array<U32> Large;
+    U32* Slots = Program->Slots <= 2 ? Fresh : Grow(Large, Program->Slots);
+
+    if(!Pike(*Program, Machine, Text.Data(), Text.Len(), Begin, Slots))
+        return None<RegexMatch>();
+
+    return Some(RegexMatch{ Slots[0], Slots[1] - Slots[0] });
+}
+
+Array<RegexMatch> Cthulhu::Regex::FindAll(StringView Text) const
+{
+    Array<RegexMatch> Ret;
+
+    for(U32 From = 0; From <= Text.Len();)
+    {
+        const Option<RegexMatch> Found = Find(Text, From);
+
+        if(!Found)
+            break;
+
+        const RegexMatch Item = Found.Get();
+        Push(Ret, Item);
+
+        //empty matches would find themselves again forever
+        From = Item.End() + (Item.Length == 0);
+    }
+
+    return Ret;
+}
+
+bool Cthulhu::Regex::Capture(StringView Text, Array<RegexMatch>& Groups, U32 From) const
+{
+    if(!Program || From > Text.Len())
+        return false;
+
+    RegexCache& Machine = Cache();
+    U32 Begin;
+
+    if(!EarliestEnd(*Program, Machine, Text.Data(), Text.Len(), From, Begin))
+        return false;
+
+    Array<U32> Slots;
+    Grow(Slots, Program->Slots);
+
+    if(!Pike(*Program, Machine, Text.Data(), Text.Len(), Begin, Slots.Data()))
+        return false;
+
+    //whatever was in Groups from before is replaced rather than added to
+    Groups.Drop(Groups.Len());
+    RegexMatch* Into = Grow(Groups, Program->Slots / 2);
+
+    for(U32 I = 0; I < Program->Slots / 2; I++)
+    {
+        const U32 First = Slots[I * 2];
+        const U32 Last = Slots[(I * 2) + 1];
+
+        Into[I] = (First == NoPosition || Last == NoPosition) ? RegexMatch() : RegexMatch{ First, Last - First };
+    }
+
+    return true;
+}
+
+U32 Cthulhu::Regex::Groups() const
+{
+    return Program ? (Program->Slots / 2) - 1 : 0;
+}
@@ -0,0 +1,186 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U32
+
+#include "Core/Collections/StringView.h"
+//StringView
+
+#include "Core/Collections/Array.h"
+//Array<T>
+
+#include "Core/Collections/Option.h"
+//Option<T>
+
+#include "Core/Collections/Result.h"
+//Result<T, E>
+
+#pragma once
+
+namespace Cthulhu
+{
+
+namespace Private
+{
+    struct RegexProgram;
+    struct RegexCache;
+}
+
+/**
+ * @brief where a regex matched, or where a capture group matched
+ */
+struct RegexMatch
+{
+    //groups that didnt take part in a match have this as their offset
+    static constexpr U32 NoPosition = 0xFFFFFFFF;
+
+    U32 Offset = NoPosition;
+    U32 Length = 0;
+
+    CTU_INLINE bool Valid() const { return Offset != NoPosition; }
+    CTU_INLINE U32 End() const { return Offset + Length; }
+
+    /**
+     * @brief get the matched part of the text that was searched
+     */
+    CTU_INLINE StringView In(StringView Text) const { return Text.SubView(Offset, Length); }
+
+    CTU_INLINE bool operator==(const RegexMatch& Other) const { return Offset == Other.Offset && Length == Other.Length; }
+    CTU_INLINE bool operator!=(const RegexMatch& Other) const { return !(*this == Other); }
+};
+
+/**
+ * @brief why a pattern couldnt be compiled
+ */
+struct RegexError
+{
+    //where in the pattern the problem was found
+    U32 Offset;
+    const char* Message;
+};
+
+/**
+ * @brief a compiled regular expression that runs in linear time
+ *
+ * @description patterns are compiled to an nfa which is run as a lazily built dfa, so
+ *              every search is linear in the length of the text and there is no backtracking
+ *              to blow up. dfa states are only created when the text needs them and are cached
+ *              between searches. when a pattern starts with a literal or a small set of
+ *              characters candidates are found with a simd scan before the dfa runs at all.
+ *              once the dfa has found that there is a match the exact bounds and captures
+ *              come from a pike vm that only runs over the part of the text with the match
+ *
+ *              supported syntax is literals, . (anything but \n), [a-z] and [^a-z] classes,
+ *              \d \w \s and their negations, \n \r \t \f \v \0 \xHH, ^ and $ for the
+ *              start and end of the text, (groups), (?:non capturing groups), alternation
+ *              with | and the * + ? {n} {n,} {n,m} repeats, each with a lazy ? form.
+ *              matching is done on bytes so utf-8 literals work but . only matches one byte
+ *
+ *              each Regex has its own cache so it shouldnt be used from more than one thread
+ *              at once. copies share the compiled program and are cheap to make per thread
+ *
+ * @code{.cpp}
+ *
+ * auto Compiled = Regex::Compile("(\\w+)=(\\d+)");
+ * Regex Pattern = Compiled.Value();
+ *
+ * Pattern.Contains("x=1"); // true
+ * Pattern.Match("width=640"); // true, the whole text has to match
+ * Pattern.Find("a b=2").Get(); // { 2, 3 }
+ * Pattern.FindAll("a=1 b=2 c"); // { { 0, 3 }, { 4, 3 } }
+ *
+ * Array<RegexMatch> Groups;
+ * String Line = "height=480";
+ * Pattern.Capture(Line, Groups); // Groups[1].In(Line) == "height", Groups[2].In(Line) == "480"
+ *
+ * //raw buffers work the same way
+ * Byte Buffer[4096];
+ * U32 Read = File.ReadN(Buffer, sizeof(Buffer));
+ * Pattern.FindAll(StringView((const char*)Buffer, Read));
+ *
+ * @endcode
+ */
+struct Regex
+{
+    /**
+     * @brief a regex that never matches anything
+     */
+    Regex();
+
+    Regex(const Regex& Other);
+    Regex& operator=(const Regex& Other);
+
+    ~Regex();
+
+    /**
+     * @brief compile a pattern
+     *
+     * @return Result<Regex, RegexError> the regex or where and why the pattern was rejected
+     */
+    static Result<Regex, RegexError> Compile(StringView Pattern);
+
+    /**
+     * @brief check if the whole text matches
+     */
+    bool Match(StringView Text) const;
+
+    /**
+     * @brief check if any part of the text matches, this only ever runs the dfa
+     */
+    bool Contains(StringView Text) const;
+
+    /**
+     * @brief find the leftmost match
+     *
+     * @description when several matches start at the same place the one the pattern
+     *              prefers wins, so repeats are greedy unless they are lazy and alternation
+     *              prefers the left side
+     *
+     * @param From where to start looking, ^ still only matches at the very start of Text
+     */
+    Option<RegexMatch> Find(StringView Text, U32 From = 0) const;
+
+    /**
+     * @brief find every match that doesnt overlap the one before it
+     */
+    Array<RegexMatch> FindAll(StringView Text) const;
+
+    /**
+     * @brief find the leftmost match along with where each group matched
+     *
+     * @param Groups replaced with Groups() + 1 entries, the first is the whole match
+     * @return bool true if there was a match, Groups is left alone otherwise
+     */
+    bool Capture(StringView Text, Array<RegexMatch>& Groups, U32 From = 0) const;
+
+    /**
+     * @brief how many capturing groups the pattern has
+     */
+    U32 Groups() const;
+
+private:
+    Private::RegexCache& Cache() const;
+
+    Private::RegexProgram* Program;
+
+    //dfa states and vm threads, made the first time they are needed
+    mutable Private::RegexCache* Scratch;
+};
+
+}
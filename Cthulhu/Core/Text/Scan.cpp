@@ -0,0 +1,246 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Scan.h"
+
+#include "Core/Memory/Memory.h"
+//Memory::Compare
+
+#if SIMD_SSE2
+#   include <emmintrin.h>
+#elif SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+using namespace Cthulhu;
+
+namespace
+{
+
+CTU_INLINE U32 TrailingZeros(U64 Num)
+{
+#if CC_MSVC
+    unsigned long Index;
+    _BitScanForward64(&Index, Num);
+    return Index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(Num);
+#else
+    U32 Ret = 0;
+    while(!(Num & 1)) { Num >>= 1; Ret++; }
+    return Ret;
+#endif
+}
+
+CTU_INLINE U32 LeadingZeros(U64 Num)
+{
+#if CC_MSVC
+    unsigned long Index;
+    _BitScanReverse64(&Index, Num);
+    return 63 - Index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(Num);
+#else
+    U32 Ret = 0;
+    while(!(Num & (1ULL << 63))) { Num <<= 1; Ret++; }
+    return Ret;
+#endif
+}
+
+#if SIMD_SSE2
+
+using Vec = __m128i;
+
+CTU_INLINE Vec Load(const char* Text) { return _mm_loadu_si128((const __m128i*)Text); }
+CTU_INLINE Vec Splat(char C) { return _mm_set1_epi8(C); }
+CTU_INLINE Vec Equal(Vec Left, Vec Right) { return _mm_cmpeq_epi8(Left, Right); }
+CTU_INLINE Vec Or(Vec Left, Vec Right) { return _mm_or_si128(Left, Right); }
+CTU_INLINE Vec And(Vec Left, Vec Right) { return _mm_and_si128(Left, Right); }
+
+//one bit per byte
+CTU_INLINE U64 Mask(Vec Bytes) { return (U32)_mm_movemask_epi8(Bytes); }
+constexpr U32 BitsPerByte = 1;
+constexpr U64 ByteBits = 1;
+constexpr U64 AllBytes = 0xFFFF;
+
+#elif SIMD_NEON
+
+using Vec = uint8x16_t;
+
+CTU_INLINE Vec Load(const char* Text) { return vld1q_u8((const U8*)Text); }
+CTU_INLINE Vec Splat(char C) { return vdupq_n_u8((U8)C); }
+CTU_INLINE Vec Equal(Vec Left, Vec Right) { return vceqq_u8(Left, Right); }
+CTU_INLINE Vec Or(Vec Left, Vec Right) { return vorrq_u8(Left, Right); }
+CTU_INLINE Vec And(Vec Left, Vec Right) { return vandq_u8(Left, Right); }
+
+//neon has no movemask, narrowing each 16 bit lane by 4 leaves 4 bits per byte instead
+CTU_INLINE U64 Mask(Vec Bytes) { return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(Bytes), 4)), 0); }
+constexpr U32 BitsPerByte = 4;
+constexpr U64 ByteBits = 0xF;
+constexpr U64 AllBytes = 0xFFFFFFFFFFFFFFFF;
+
+#endif
+
+}
+
+U32 Cthulhu::Utils::FindByte(const char* Text, U32 Len, char Search)
+{
+    U32 I = 0;
+
+#if SIMD_SSE2 || SIMD_NEON
+    const Vec Needle = Splat(Search);
+
+    for(; I + 16 <= Len; I += 16)
+    {
+        if(const U64 Found = Mask(Equal(Load(Text + I), Needle)))
+            return I + (TrailingZeros(Found) / BitsPerByte);
+    }
+#endif
+
+    for(; I < Len; I++)
+        if(Text[I] == Search)
+            return I;
+
+    return Len;
+}
+
+U32 Cthulhu::Utils::FindAny(const char* Text, U32 Len, const CharSet& Set)
+{
+    if(Set.Len() == 1)
+        return FindByte(Text, Len, Set.Small[0]);
+
+    U32 I = 0;
+
+#if SIMD_SSE2 || SIMD_NEON
+    if(Set.Len() <= CharSet::MaxSmall)
+    {
+        //unused slots repeat the first character so they never add anything new
+        const Vec A = Splat(Set.Small[0]);
+        const Vec B = Splat(Set.Small[Set.Len() > 1 ? 1 : 0]);
+        const Vec C = Splat(Set.Small[Set.Len() > 2 ? 2 : 0]);
+        const Vec D = Splat(Set.Small[Set.Len() > 3 ? 3 : 0]);
+
+        for(; I + 16 <= Len; I += 16)
+        {
+            const Vec Block = Load(Text + I);
+
+            if(const U64 Found = Mask(Or(Or(Equal(Block, A), Equal(Block, B)), Or(Equal(Block, C), Equal(Block, D)))))
+                return I + (TrailingZeros(Found) / BitsPerByte);
+        }
+    }
+#endif
+
+    for(; I < Len; I++)
+        if(Set.Has(Text[I]))
+            return I;
+
+    return Len;
+}
+
+U32 Cthulhu::Utils::FindPattern(const char* Text, U32 Len, StringView Pattern)
+{
+    if(Pattern.IsEmpty())
+        return 0;
+
+    if(Pattern.Len() > Len)
+        return Len;
+
+    //a match cant start in the last Pattern.Len() - 1 characters
+    const U32 Last = Len - Pattern.Len() + 1;
+    const U32 Tail = Pattern.Len() - 1;
+
+    U32 I = 0;
+
+#if SIMD_SSE2 || SIMD_NEON
+    if(Tail > 0)
+    {
+        //only positions where both the first and last character line up get compared in full,
+        //which skips far more than the first character alone does on real text
+        const Vec First = Splat(Pattern[0]);
+        const Vec End = Splat(Pattern[Tail]);
+
+        for(; I + 16 <= Last; I += 16)
+        {
+            U64 Found = Mask(And(Equal(Load(Text + I), First), Equal(Load(Text + I + Tail), End)));
+
+            while(Found)
+            {
+                const U32 Offset = I + (TrailingZeros(Found) / BitsPerByte);
+
+                if(Memory::Compare(Text + Offset + 1, Pattern.Data() + 1, Tail - 1) == 0)
+                    return Offset;
+
+                //clear every bit that belongs to this byte
+                Found &= ~(ByteBits << (TrailingZeros(Found) & ~(BitsPerByte - 1)));
+            }
+        }
+    }
+#endif
+
+    for(; I < Last; I++)
+    {
+        I += FindByte(Text + I, Last - I, Pattern[0]);
+
+        if(I == Last)
+            break;
+
+        if(Memory::Compare(Text + I + 1, Pattern.Data() + 1, Tail) == 0)
+            return I;
+    }
+
+    return Len;
+}
+
+U32 Cthulhu::Utils::CommonPrefix(const char* Left, const char* Right, U32 Len)
+{
+    U32 I = 0;
+
+#if SIMD_SSE2 || SIMD_NEON
+    for(; I + 16 <= Len; I += 16)
+    {
+        const U64 Same = Mask(Equal(Load(Left + I), Load(Right + I)));
+
+        if(Same != AllBytes)
+            return I + (TrailingZeros(~Same) / BitsPerByte);
+    }
+#endif
+
+    while(I < Len && Left[I] == Right[I])
+        I++;
+
+    return I;
+}
+
+U32 Cthulhu::Utils::CommonSuffix(const char* Left, const char* Right, U32 Len)
+{
+    U32 I = 0;
+
+#if SIMD_SSE2 || SIMD_NEON
+    for(; I + 16 <= Len; I += 16)
+    {
+        const U32 Start = Len - I - 16;
+        const U64 Differ = ~Mask(Equal(Load(Left + Start), Load(Right + Start))) & AllBytes;
+
+        //the highest differing byte is the one closest to the end
+        if(Differ)
+            return I + 15 - ((63 - LeadingZeros(Differ)) / BitsPerByte);
+    }
+#endif
+
+    while(I < Len && Left[Len - I - 1] == Right[Len - I - 1])
+        I++;
+
+    return I;
+}
@@ -0,0 +1,126 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U8 U32 U64
+
+#include "Core/Collections/StringView.h"
+//StringView
+
+#pragma once
+
+namespace Cthulhu
+{
+
+/**
+ * @brief a set of characters that can be checked in constant time
+ *
+ * @description the first few characters are also kept in a list since
+ *              small sets can be scanned for 16 characters at a time
+ */
+struct CharSet
+{
+    constexpr CharSet()
+        : Bits{}
+        , Small{}
+        , Count(0)
+    {}
+
+    constexpr CharSet(StringView Chars)
+        : Bits{}
+        , Small{}
+        , Count(0)
+    {
+        for(char C : Chars)
+            Add(C);
+    }
+
+    constexpr CharSet(const char* Chars)
+        : CharSet(StringView(Chars))
+    {}
+
+    constexpr void Add(char C)
+    {
+        if(Has(C))
+            return;
+
+        Bits[(U8)C >> 6] |= 1ULL << ((U8)C & 63);
+
+        if(Count < MaxSmall)
+            Small[Count] = C;
+
+        Count++;
+    }
+
+    CTU_INLINE constexpr bool Has(char C) const
+    {
+        return (Bits[(U8)C >> 6] >> ((U8)C & 63)) & 1;
+    }
+
+    CTU_INLINE constexpr U32 Len() const { return Count; }
+
+    //sets this small are compared against every character directly
+    static constexpr U32 MaxSmall = 4;
+
+    U64 Bits[4];
+    char Small[MaxSmall];
+    U32 Count;
+};
+
+namespace Utils
+{
+    /**
+     * @brief find the first occurrence of a character, 16 characters are checked at a time
+     *
+     * @return U32 the index of the character or Len if it isnt there
+     */
+    U32 FindByte(const char* Text, U32 Len, char Search);
+
+    /**
+     * @brief find the first character that is in a set
+     *
+     * @return U32 the index of the character or Len if there isnt one
+     */
+    U32 FindAny(const char* Text, U32 Len, const CharSet& Set);
+
+    /**
+     * @brief find the first occurrence of a pattern
+     *
+     * @description candidates are found by scanning for the first character of the pattern
+     *              so this is fastest when that character is rare
+     *
+     * @return U32 the index of the pattern or Len if it isnt there
+     */
+    U32 FindPattern(const char* Text, U32 Len, StringView Pattern);
+
+    /**
+     * @brief count how many bytes at the start of two buffers are the same, 16 are compared at a time
+     *
+     * @return U32 the index of the first byte that differs or Len if they all match
+     */
+    U32 CommonPrefix(const char* Left, const char* Right, U32 Len);
+
+    /**
+     * @brief count how many bytes at the end of two buffers are the same, 16 are compared at a time
+     *
+     * @return U32 how many of the last bytes match, Len if they all do
+     */
+    U32 CommonSuffix(const char* Left, const char* Right, U32 Len);
+}
+
+}
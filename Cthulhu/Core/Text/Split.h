@@ -0,0 +1,296 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+#include "Meta/Assert.h"
+//CTU_INLINE ASSERT
+
+#include "Meta/Aliases.h"
+//U32
+
+#include "Core/Collections/StringView.h"
+//StringView
+
+#include "Scan.h"
+//CharSet Utils::FindByte Utils::FindAny Utils::FindPattern
+
+#pragma once
+
+namespace Cthulhu
+{
+
+template<typename> struct Array;
+
+/**
+ * @brief what a split does with the pieces it finds
+ */
+enum class SplitMode : U8
+{
+    //every piece is kept, even empty ones
+    Keep,
+
+    //empty pieces are skipped
+    SkipEmpty,
+
+    //a \r before each delimiter is removed and a delimiter at the very end doesnt start a new piece
+    Lines,
+};
+
+namespace Private
+{
+    //each finder returns the offset of the next delimiter or Len if there isnt one
+    struct ByteFinder
+    {
+        char Delimiter;
+
+        CTU_INLINE U32 Find(const char* Text, U32 Len) const { return Utils::FindByte(Text, Len, Delimiter); }
+        CTU_INLINE U32 Width() const { return 1; }
+    };
+
+    struct PatternFinder
+    {
+        StringView Pattern;
+
+        CTU_INLINE U32 Find(const char* Text, U32 Len) const { return Utils::FindPattern(Text, Len, Pattern); }
+        CTU_INLINE U32 Width() const { return Pattern.Len(); }
+    };
+
+    struct AnyFinder
+    {
+        CharSet Set;
+
+        CTU_INLINE U32 Find(const char* Text, U32 Len) const { return Utils::FindAny(Text, Len, Set); }
+        CTU_INLINE U32 Width() const { return 1; }
+    };
+
+    template<typename TPred>
+    struct PredicateFinder
+    {
+        TPred IsSeparator;
+
+        CTU_INLINE U32 Find(const char* Text, U32 Len) const
+        {
+            for(U32 I = 0; I < Len; I++)
+                if(IsSeparator(Text[I]))
+                    return I;
+
+            return Len;
+        }
+
+        CTU_INLINE U32 Width() const { return 1; }
+    };
+}
+
+/**
+ * @brief a lazy sequence of the pieces of some text between delimiters
+ *
+ * @description nothing is allocated or copied, each piece is a view into the
+ *              original text and the next delimiter is only searched for when
+ *              the iterator moves. this means the text has to outlive the range,
+ *              so splitting a temporary String in a range-for will dangle
+ *
+ * @code{.cpp}
+ *
+ * String Row = "a,b,,c";
+ *
+ * for(StringView Field : Row.Split(','))
+ *     ; // "a" "b" "" "c"
+ *
+ * Array<StringView> Fields = Row.Split(',', 2).Collect(); // { "a", "b,,c" }
+ *
+ * @endcode
+ *
+ * @tparam TFinder how delimiters are found
+ */
+template<typename TFinder>
+struct SplitRange
+{
+    SplitRange(StringView InText, TFinder InFinder, U32 InLimit, SplitMode InMode)
+        : Text(InText)
+        , Finder(InFinder)
+        , Limit(InLimit)
+        , Mode(InMode)
+    {
+        ASSERT(Finder.Width() != 0, "Trying to split on an empty pattern");
+    }
+
+    struct Iterator
+    {
+        Iterator(const SplitRange* InOwner)
+            : Owner(InOwner)
+            , Cursor(InOwner ? InOwner->Text.Data() : nullptr)
+            , Count(0)
+        {
+            if(Owner)
+                Advance();
+        }
+
+        CTU_INLINE StringView operator*() const { return Current; }
+
+        CTU_INLINE Iterator& operator++()
+        {
+            Advance();
+            return *this;
+        }
+
+        //every finished iterator is the same as end()
+        CTU_INLINE bool operator!=(const Iterator& Other) const
+        {
+            return Owner != Other.Owner || (Owner && Current.Data() != Other.Current.Data());
+        }
+
+    private:
+        void Advance()
+        {
+            while(Cursor)
+            {
+                const U32 Left = (U32)(Owner->Text.end() - Cursor);
+
+                if(Owner->Mode == SplitMode::Lines && Left == 0)
+                    break;
+
+                //the last piece allowed by the limit gets whatever is left
+                const U32 Found = (Owner->Limit && Count + 1 == Owner->Limit) ? Left : Owner->Finder.Find(Cursor, Left);
+
+                U32 Length = Found;
+
+                if(Owner->Mode == SplitMode::Lines && Found != Left && Found != 0 && Cursor[Found - 1] == '\r')
+                    Length--;
+
+                Current = StringView(Cursor, Length);
+                Cursor = Found == Left ? nullptr : Cursor + Found + Owner->Finder.Width();
+
+                if(Owner->Mode == SplitMode::SkipEmpty && Length == 0)
+                    continue;
+
+                Count++;
+                return;
+            }
+
+            Owner = nullptr;
+            Current = StringView();
+        }
+
+        const SplitRange* Owner;
+        const char* Cursor;
+        StringView Current;
+        U32 Count;
+    };
+
+    CTU_INLINE Iterator begin() const { return Iterator(this); }
+    CTU_INLINE Iterator end() const { return Iterator(nullptr); }
+
+    /**
+     * @brief copy every piece into an array
+     *
+     * @description this is the only part of splitting that allocates so it has to be asked for
+     */
+    template<typename TArray = Array<StringView>>
+    TArray Collect() const
+    {
+        TArray Ret;
+
+        for(StringView Piece : *this)
+            Ret.Append(Piece);
+
+        return Ret;
+    }
+
+    /**
+     * @brief count the pieces without storing them
+     */
+    U32 Count() const
+    {
+        U32 Ret = 0;
+
+        for(auto It = begin(); It != end(); ++It)
+            Ret++;
+
+        return Ret;
+    }
+
+private:
+    StringView Text;
+    TFinder Finder;
+    U32 Limit;
+    SplitMode Mode;
+};
+
+namespace Utils
+{
+    /**
+     * @brief split text on a character
+     *
+     * @param Text the text to split, must outlive the range
+     * @param Delimiter the character between pieces
+     * @param Limit the most pieces to make, the last piece has the rest of the text. 0 means no limit
+     */
+    CTU_INLINE SplitRange<Private::ByteFinder> Split(StringView Text, char Delimiter, U32 Limit = 0)
+    {
+        return { Text, { Delimiter }, Limit, SplitMode::Keep };
+    }
+
+    /**
+     * @brief split text on a pattern of one or more characters
+     */
+    CTU_INLINE SplitRange<Private::PatternFinder> Split(StringView Text, StringView Pattern, U32 Limit = 0)
+    {
+        return { Text, { Pattern }, Limit, SplitMode::Keep };
+    }
+
+    /**
+     * @brief split text on any character in a set
+     *
+     * @code{.cpp}
+     *
+     * Utils::SplitAny("a b\tc", " \t"); // "a" "b" "c"
+     *
+     * @endcode
+     */
+    CTU_INLINE SplitRange<Private::AnyFinder> SplitAny(StringView Text, const CharSet& Set, U32 Limit = 0)
+    {
+        return { Text, { Set }, Limit, SplitMode::Keep };
+    }
+
+    /**
+     * @brief split text into lines
+     *
+     * @description \n and \r\n both end a line, a newline at the end of the text
+     *              doesnt make an extra empty line and empty text has no lines
+     */
+    CTU_INLINE SplitRange<Private::ByteFinder> Lines(StringView Text)
+    {
+        return { Text, { '\n' }, 0, SplitMode::Lines };
+    }
+
+    /**
+     * @brief split text into the non empty runs between separator characters
+     *
+     * @code{.cpp}
+     *
+     * Utils::Tokenize("  let x =  1 ", Utils::IsSpace); // "let" "x" "=" "1"
+     *
+     * @endcode
+     *
+     * @param IsSeparator called with each character, returns true if it separates tokens
+     */
+    template<typename TPred>
+    CTU_INLINE SplitRange<Private::PredicateFinder<TPred>> Tokenize(StringView Text, TPred IsSeparator)
+    {
+        return { Text, { IsSeparator }, 0, SplitMode::SkipEmpty };
+    }
+}
+
+}
@@ -0,0 +1,195 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "TextWriter.h"
+
+#include "Core/Math/Math.h"
+//Math::Max Math::Min
+
+#include "Float.h"
+//Utils::FloatToChars
+
+#include "Integer.h"
+//Utils::IntegerToChars
+
+using namespace Cthulhu;
+
+/*================================================================*/
+/*              Cthulhu::TextWriter                               */
+/*================================================================*/
+
+void Cthulhu::TextWriter::WriteSlow(const char* Text, U32 Len)
+{
+    while(true)
+    {
+        //fill whatever space is left then ask for more, a flushing writer empties itself here
+        const U32 Part = Math::Min(Len, Capacity - Length);
+
+        Memory::Copy(Text, Data + Length, Part);
+        Length += Part;
+
+        Text += Part;
+        Len -= Part;
+
+        if(Len == 0 || !Grow(*this, Length + Len))
+            return;
+    }
+}
+
+void Cthulhu::TextWriter::FillSlow(char C, U32 Count)
+{
+    while(true)
+    {
+        const U32 Part = Math::Min(Count, Capacity - Length);
+
+        Memory::Set(Data + Length, C, Part);
+        Length += Part;
+
+        Count -= Part;
+
+        if(Count == 0 || !Grow(*this, Length + Count))
+            return;
+    }
+}
+
+/*================================================================*/
+/*              Cthulhu::BufferWriter                             */
+/*================================================================*/
+
+bool Cthulhu::BufferWriter::GrowHeap(TextWriter& Self, U32 Needed)
+{
+    BufferWriter& Writer = static_cast<BufferWriter&>(Self);
+
+    const U32 NewCapacity = Math::Max(Needed, Writer.Capacity * 2);
+
+    //one extra so Take can null terminate without growing again
+    char* Temp = new char[NewCapacity + 1];
+    Memory::Copy(Writer.Data, Temp, Writer.Length);
+
+    if(Writer.Data != Writer.Inline)
+        delete[] Writer.Data;
+
+    Writer.Data = Temp;
+    Writer.Capacity = NewCapacity;
+
+    return true;
+}
+
+String Cthulhu::BufferWriter::Take()
+{
+    Data[Length] = '\0';
+
+    const U32 Len = Length;
+    const U32 Size = Capacity;
+    char* Taken = Data;
+
+    Length = 0;
+    Total = 0;
+
+    if(Taken == Inline)
+        return String(Taken, Len);
+
+    Data = Inline;
+    Capacity = sizeof(Inline) - 1;
+
+    //the length is known so nulls written into the buffer stay in the string
+    return String::FromPtr(Taken, Len, Size);
+}
+
+/*================================================================*/
+/*              Cthulhu::StringWriter                             */
+/*================================================================*/
+
+Cthulhu::StringWriter::StringWriter(String& InInto)
+    : TextWriter(nullptr, 0, &GrowString)
+    , Into(&InInto)
+{
+    if(Into->Real == nullptr)
+        *Into = String();
+
+    Data = Into->Real + Into->Length;
+    Capacity = Into->Allocated - Into->Length;
+}
+
+bool Cthulhu::StringWriter::GrowString(TextWriter& Self, U32 Needed)
+{
+    StringWriter& Writer = static_cast<StringWriter&>(Self);
+    String& Into = *Writer.Into;
+
+    const U32 Base = Into.Length;
+
+    //pretend the text written so far is part of the string so growing keeps it
+    Into.Length = Base + Writer.Length;
+    Into.Grow(Base + Needed);
+    Into.Length = Base;
+
+    Writer.Data = Into.Real + Base;
+    Writer.Capacity = Into.Allocated - Base;
+
+    return true;
+}
+
+void Cthulhu::StringWriter::Flush()
+{
+    Into->Length += Length;
+    Into->Real[Into->Length] = '\0';
+
+    Data += Length;
+    Capacity -= Length;
+    Length = 0;
+}
+
+/*================================================================*/
+/*              Cthulhu::WriteTo                                  */
+/*================================================================*/
+
+void Cthulhu::WriteTo(TextWriter& Out, I64 Num)
+{
+    char Buffer[Utils::MaxIntegerChars];
+    Out.Write(Buffer, Utils::IntegerToChars(Num, Buffer));
+}
+
+void Cthulhu::WriteTo(TextWriter& Out, U64 Num)
+{
+    char Buffer[Utils::MaxIntegerChars];
+    Out.Write(Buffer, Utils::IntegerToChars(Num, Buffer));
+}
+
+void Cthulhu::WriteTo(TextWriter& Out, F32 Num)
+{
+    char Buffer[Utils::MaxFloatChars];
+    Out.Write(Buffer, Utils::FloatToChars(Num, Buffer));
+}
+
+void Cthulhu::WriteTo(TextWriter& Out, F64 Num)
+{
+    char Buffer[Utils::MaxFloatChars];
+    Out.Write(Buffer, Utils::FloatToChars(Num, Buffer));
+}
+
+void Cthulhu::WriteTo(TextWriter& Out, bool Val)
+{
+    if(Val)
+        Out.Write("true", 4);
+    else
+        Out.Write("false", 5);
+}
+
+void Cthulhu::WriteTo(TextWriter& Out, const String& Text)
+{
+    Out.Write('"');
+    Out.Write(Text.CStr(), Text.Len());
+    Out.Write('"');
+}
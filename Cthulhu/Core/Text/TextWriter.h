@@ -0,0 +1,328 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE
+
+#include "Meta/Aliases.h"
+//U32 I64 U64 F32 F64
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy Memory::Set
+
+#include "Core/Collections/CthulhuString.h"
+//String StringView StaticString FixedString
+
+#pragma once
+
+namespace Cthulhu
+{
+
+/**
+ * @brief somewhere text can be written to a piece at a time
+ *
+ * @description text is copied straight into Data while it fits, once it doesnt
+ *              Grow is asked for more space. a growable writer reallocates, a file
+ *              writer flushes what it has and a fixed buffer refuses so the rest is
+ *              truncated. Total always counts everything that was written so a
+ *              truncated writer still knows how much space it would have needed.
+ *
+ *              Grow is a plain function pointer rather than a virtual so the common
+ *              case of the text fitting is an inlined compare and a copy
+ *
+ * @code{.cpp}
+ *
+ * BufferWriter Out;
+ * WriteTo(Out, Names);
+ * Out.Write(" and ");
+ * WriteTo(Out, 25);
+ *
+ * String Text = Out.Take();
+ *
+ * @endcode
+ */
+struct TextWriter
+{
+    /**
+     * @brief make more space after Data + Length
+     *
+     * @param Self the writer that ran out of space
+     * @param Needed how many characters the writer would like to fit in total
+     * @return bool false if no more text can be written, otherwise there has to
+     *              be space for at least one more character
+     */
+    using GrowFunc = bool(*)(TextWriter& Self, U32 Needed);
+
+    TextWriter(char* InData, U32 InCapacity, GrowFunc InGrow)
+        : Data(InData)
+        , Length(0)
+        , Capacity(InCapacity)
+        , Total(0)
+        , Grow(InGrow)
+    {}
+
+    CTU_INLINE void Write(const char* Text, U32 Len)
+    {
+        Total += Len;
+
+        if(Len > Capacity - Length)
+            return WriteSlow(Text, Len);
+
+        Memory::Copy(Text, Data + Length, Len);
+        Length += Len;
+    }
+
+    CTU_INLINE void Write(char C, U32 Count = 1)
+    {
+        Total += Count;
+
+        if(Count > Capacity - Length)
+            return FillSlow(C, Count);
+
+        Memory::Set(Data + Length, C, Count);
+        Length += Count;
+    }
+
+    CTU_INLINE void Write(StringView Text) { Write(Text.Data(), Text.Len()); }
+
+    /**
+     * @brief the text that is currently buffered, for a flushing writer this is only the tail
+     */
+    CTU_INLINE StringView View() const { return { Data, Length }; }
+
+    char* Data;
+    U32 Length;
+    U32 Capacity;
+
+    ///everything that was written including anything truncated or flushed
+    U32 Total;
+
+    GrowFunc Grow;
+
+private:
+    void WriteSlow(const char* Text, U32 Len);
+    void FillSlow(char C, U32 Count);
+};
+
+/**
+ * @brief a writer that builds a new String
+ *
+ * @description the first 256 characters go into a buffer inside the writer
+ *              so short text never touches the heap until Take, after that
+ *              it grows geometrically
+ */
+struct BufferWriter : TextWriter
+{
+    BufferWriter()
+        : TextWriter(Inline, sizeof(Inline) - 1, &GrowHeap)
+    {}
+
+    BufferWriter(const BufferWriter&) = delete;
+    BufferWriter& operator=(const BufferWriter&) = delete;
+
+    ~BufferWriter()
+    {
+        if(Data != Inline)
+            delete[] Data;
+    }
+
+    /**
+     * @brief move everything written so far into a string and start again
+     *
+     * @description if the text already spilled onto the heap that allocation
+     *              becomes the string, otherwise the inline buffer is copied
+     */
+    String Take();
+
+    /**
+     * @brief forget everything written but keep any heap space for reuse
+     */
+    CTU_INLINE void Reset()
+    {
+        Length = 0;
+        Total = 0;
+    }
+
+private:
+    static bool GrowHeap(TextWriter& Self, U32 Needed);
+
+    char Inline[256];
+};
+
+/**
+ * @brief a writer that appends onto the end of an existing String
+ *
+ * @description text goes directly into the strings allocation, so if it
+ *              already has enough space (see String::Reserve) nothing is allocated.
+ *              the string only sees the new text once Flush is called, which
+ *              the destructor does
+ */
+struct StringWriter : TextWriter
+{
+    explicit StringWriter(String& Into);
+
+    StringWriter(const StringWriter&) = delete;
+    StringWriter& operator=(const StringWriter&) = delete;
+
+    ~StringWriter() { Flush(); }
+
+    /**
+     * @brief update the length of the string, writing can carry on afterwards
+     */
+    void Flush();
+
+private:
+    static bool GrowString(TextWriter& Self, U32 Needed);
+
+    String* Into;
+};
+
+/**
+ * @brief a writer over a buffer the caller owns that never allocates
+ *
+ * @description anything that doesnt fit is dropped, Total still counts it
+ *              so Truncated can tell when the buffer was too small
+ */
+struct FixedWriter : TextWriter
+{
+    /**
+     * @param Buffer the buffer to write into
+     * @param Size the size of Buffer including space for a null terminator
+     */
+    FixedWriter(char* Buffer, U32 Size)
+        : TextWriter(Size ? Buffer : &Spare, Size ? Size - 1 : 0, &GrowNone)
+    {}
+
+    CTU_INLINE bool Truncated() const { return Total > Length; }
+
+    /**
+     * @brief null terminate the buffer and return it
+     */
+    CTU_INLINE const char* Terminate()
+    {
+        Data[Length] = '\0';
+        return Data;
+    }
+
+private:
+    static bool GrowNone(TextWriter&, U32) { return false; }
+
+    //zero sized buffers still need somewhere to put the terminator
+    char Spare;
+};
+
+/**
+ * @brief a fixed writer with its buffer on the stack
+ *
+ * @code{.cpp}
+ *
+ * StackWriter<64> Out;
+ * WriteTo(Out, Position);
+ * puts(Out.Terminate());
+ *
+ * @endcode
+ *
+ * @tparam N the size of the buffer including the null terminator
+ */
+template<U32 N>
+struct StackWriter : FixedWriter
+{
+    StackWriter()
+        : FixedWriter(Buffer, N)
+    {}
+
+    StackWriter(const StackWriter&) = delete;
+    StackWriter& operator=(const StackWriter&) = delete;
+
+private:
+    char Buffer[N];
+};
+
+/**
+ * @brief write the text form of a value to a writer
+ *
+ * @description every type in the library that has a Utils::ToString also has a
+ *              WriteTo and ToString is a thin wrapper over it. containers write
+ *              their items straight into the same writer so dumping a large
+ *              structure is one pass with no strings made in between.
+ *              these live directly in the Cthulhu namespace so argument dependent
+ *              lookup finds them for containers of containers no matter which
+ *              header was included first. Strings are quoted like ToString does,
+ *              the other text types are written as is
+ */
+void WriteTo(TextWriter& Out, I64 Num);
+void WriteTo(TextWriter& Out, U64 Num);
+void WriteTo(TextWriter& Out, F32 Num);
+void WriteTo(TextWriter& Out, F64 Num);
+void WriteTo(TextWriter& Out, bool Val);
+void WriteTo(TextWriter& Out, const String& Text);
+
+CTU_INLINE void WriteTo(TextWriter& Out, I32 Num) { WriteTo(Out, (I64)Num); }
+CTU_INLINE void WriteTo(TextWriter& Out, U32 Num) { WriteTo(Out, (U64)Num); }
+CTU_INLINE void WriteTo(TextWriter& Out, long Num) { WriteTo(Out, (I64)Num); }
+CTU_INLINE void WriteTo(TextWriter& Out, unsigned long Num) { WriteTo(Out, (U64)Num); }
+
+CTU_INLINE void WriteTo(TextWriter& Out, char C) { Out.Write(C); }
+CTU_INLINE void WriteTo(TextWriter& Out, const char* Text) { Out.Write(StringView(Text)); }
+CTU_INLINE void WriteTo(TextWriter& Out, StringView Text) { Out.Write(Text); }
+CTU_INLINE void WriteTo(TextWriter& Out, const StaticString& Text) { Out.Write(Text.CStr(), Text.Len()); }
+
+template<U32 N>
+CTU_INLINE void WriteTo(TextWriter& Out, const FixedString<N>& Text) { Out.Write(Text.CStr(), N); }
+
+namespace Private
+{
+    //containers write their items through here so items that only have a ToString still work
+    template<typename T>
+    CTU_INLINE auto WriteItem(TextWriter& Out, const T& Item, int) -> decltype(WriteTo(Out, Item), void())
+    {
+        WriteTo(Out, Item);
+    }
+
+    template<typename T>
+    CTU_INLINE void WriteItem(TextWriter& Out, const T& Item, long)
+    {
+        const String Text = Utils::ToString(Item);
+        Out.Write(Text.CStr(), Text.Len());
+    }
+
+    template<typename T>
+    CTU_INLINE void WriteItem(TextWriter& Out, const T& Item)
+    {
+        WriteItem(Out, Item, 0);
+    }
+}
+
+namespace Utils
+{
+    /**
+     * @brief render anything with a WriteTo into a new string
+     *
+     * @code{.cpp}
+     *
+     * String Text = Utils::WriteToString(Names);
+     *
+     * @endcode
+     */
+    template<typename T>
+    String WriteToString(const T& Value)
+    {
+        BufferWriter Out;
+        Private::WriteItem(Out, Value);
+        return Out.Take();
+    }
+}
+
+}
@@ -0,0 +1,676 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Unicode.h"
+
+#include "Core/Memory/Memory.h"
+//Memory::Copy
+
+//x64 builds without -mssse3 still get the ssse3 validator, its just picked when the program starts
+#if !SIMD_SSSE3 && SIMD_SSE2 && (defined(__GNUC__) || defined(__clang__) || CC_MSVC)
+#   define UTF8_DISPATCH 1
+#else
+#   define UTF8_DISPATCH 0
+#endif
+
+#if SIMD_SSSE3 || UTF8_DISPATCH
+#   include <tmmintrin.h>
+#elif SIMD_SSE2
+#   include <emmintrin.h>
+#elif SIMD_NEON
+#   include <arm_neon.h>
+#endif
+
+#if UTF8_DISPATCH && CC_MSVC
+#   include <intrin.h>
+#endif
+
+#if UTF8_DISPATCH && !CC_MSVC
+#   define SIMD_INLINE CTU_INLINE __attribute__((target("ssse3")))
+#   define SIMD_TARGET __attribute__((target("ssse3")))
+#else
+#   define SIMD_INLINE CTU_INLINE
+#   define SIMD_TARGET
+#endif
+
+using namespace Cthulhu;
+
+namespace
+{
+
+constexpr U64 HighBits = 0x8080808080808080ULL;
+
+CTU_INLINE U64 LoadEight(const U8* Text)
+{
+    U64 Ret;
+    Memory::Copy(Text, (U8*)&Ret, sizeof(U64));
+    return Ret;
+}
+
+CTU_INLINE U32 PopCount(U64 Num)
+{
+#if CC_MSVC
+    return (U32)__popcnt64(Num);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(Num);
+#else
+    Num = Num - ((Num >> 1) & 0x5555555555555555ULL);
+    Num = (Num & 0x3333333333333333ULL) + ((Num >> 2) & 0x3333333333333333ULL);
+    return (U32)((((Num + (Num >> 4)) & 0x0F0F0F0F0F0F0F0FULL) * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+CTU_INLINE bool IsContinuation(U8 Byte) { return (Byte & 0xC0) == 0x80; }
+
+//the high bit of every continuation byte, bit 7 set and bit 6 clear
+CTU_INLINE U64 Continuations(U64 Chunk) { return Chunk & ~(Chunk << 1) & HighBits; }
+
+//the high bit of every byte that starts a 4 byte sequence, the top 4 bits are all set
+CTU_INLINE U64 FourByteLeads(U64 Chunk) { return Chunk & (Chunk << 1) & (Chunk << 2) & (Chunk << 3) & HighBits; }
+
+U32 DecodeAt(const U8* Text, const U8* End, C32& Out)
+{
+    const U8 Lead = *Text;
+    const U32 Left = (U32)(End - Text);
+
+    if(Lead < 0x80)
+    {
+        Out = Lead;
+        return 1;
+    }
+
+    //the second byte has a tighter range after some leads to rule out overlongs, surrogates and values over 0x10FFFF
+    if(0xC2 <= Lead && Lead <= 0xDF)
+    {
+        if(Left < 2 || !IsContinuation(Text[1]))
+            return 0;
+
+        Out = ((Lead & 0x1F) << 6) | (Text[1] & 0x3F);
+        return 2;
+    }
+
+    if(0xE0 <= Lead && Lead <= 0xEF)
+    {
+        const U8 Low = (Lead == 0xE0) ? 0xA0 : 0x80;
+        const U8 High = (Lead == 0xED) ? 0x9F : 0xBF;
+
+        if(Left < 3 || Text[1] < Low || Text[1] > High || !IsContinuation(Text[2]))
+            return 0;
+
+        Out = ((Lead & 0x0F) << 12) | ((Text[1] & 0x3F) << 6) | (Text[2] & 0x3F);
+        return 3;
+    }
+
+    if(0xF0 <= Lead && Lead <= 0xF4)
+    {
+        const U8 Low = (Lead == 0xF0) ? 0x90 : 0x80;
+        const U8 High = (Lead == 0xF4) ? 0x8F : 0xBF;
+
+        if(Left < 4 || Text[1] < Low || Text[1] > High || !IsContinuation(Text[2]) || !IsContinuation(Text[3]))
+            return 0;
+
+        Out = ((Lead & 0x07) << 18) | ((Text[1] & 0x3F) << 12) | ((Text[2] & 0x3F) << 6) | (Text[3] & 0x3F);
+        return 4;
+    }
+
+    return 0;
+}
+
+//zero extend 16 ascii bytes at once
+CTU_INLINE void WidenSixteen(const U8* Text, C16* Into)
+{
+#if SIMD_SSE2
+    const __m128i Bytes = _mm_loadu_si128((const __m128i*)Text);
+    _mm_storeu_si128((__m128i*)Into, _mm_unpacklo_epi8(Bytes, _mm_setzero_si128()));
+    _mm_storeu_si128((__m128i*)(Into + 8), _mm_unpackhi_epi8(Bytes, _mm_setzero_si128()));
+#elif SIMD_NEON
+    const uint8x16_t Bytes = vld1q_u8(Text);
+    vst1q_u16((uint16_t*)Into, vmovl_u8(vget_low_u8(Bytes)));
+    vst1q_u16((uint16_t*)(Into + 8), vmovl_high_u8(Bytes));
+#else
+    for(U32 I = 0; I < 16; I++)
+        Into[I] = Text[I];
+#endif
+}
+
+CTU_INLINE void WidenSixteen(const U8* Text, C32* Into)
+{
+#if SIMD_SSE2
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Bytes = _mm_loadu_si128((const __m128i*)Text);
+    const __m128i Low = _mm_unpacklo_epi8(Bytes, Zero);
+    const __m128i High = _mm_unpackhi_epi8(Bytes, Zero);
+    _mm_storeu_si128((__m128i*)Into, _mm_unpacklo_epi16(Low, Zero));
+    _mm_storeu_si128((__m128i*)(Into + 4), _mm_unpackhi_epi16(Low, Zero));
+    _mm_storeu_si128((__m128i*)(Into + 8), _mm_unpacklo_epi16(High, Zero));
+    _mm_storeu_si128((__m128i*)(Into + 12), _mm_unpackhi_epi16(High, Zero));
+#elif SIMD_NEON
+    const uint8x16_t Bytes = vld1q_u8(Text);
+    const uint16x8_t Low = vmovl_u8(vget_low_u8(Bytes));
+    const uint16x8_t High = vmovl_high_u8(Bytes);
+    vst1q_u32((uint32_t*)Into, vmovl_u16(vget_low_u16(Low)));
+    vst1q_u32((uint32_t*)(Into + 4), vmovl_high_u16(Low));
+    vst1q_u32((uint32_t*)(Into + 8), vmovl_u16(vget_low_u16(High)));
+    vst1q_u32((uint32_t*)(Into + 12), vmovl_high_u16(High));
+#else
+    for(U32 I = 0; I < 16; I++)
+        Into[I] = Text[I];
+#endif
+}
+
+template<typename TOut>
+void Widen(const U8* Text, U32 Len, TOut* Into)
+{
+    U32 I = 0;
+
+    for(; I + 16 <= Len; I += 16)
+        WidenSixteen(Text + I, Into + I);
+
+    for(; I < Len; I++)
+        Into[I] = Text[I];
+}
+
+//decode text that is already known to be valid
+template<typename TOut>
+TOut* DecodeValid(const U8* Text, const U8* End, TOut* Into)
+{
+    while(Text != End)
+    {
+        //widen runs of ascii 16 at a time
+        if(End - Text >= 16 && ((LoadEight(Text) | LoadEight(Text + 8)) & HighBits) == 0)
+        {
+            WidenSixteen(Text, Into);
+
+            Text += 16;
+            Into += 16;
+            continue;
+        }
+
+        C32 Point;
+        Text += DecodeAt(Text, End, Point);
+
+        //sizeof(TOut) is known at compile time so only one side of this is ever kept
+        if(sizeof(TOut) == sizeof(C16) && Point >= 0x10000)
+        {
+            Point -= 0x10000;
+            *Into++ = (TOut)(0xD800 + (Point >> 10));
+            *Into++ = (TOut)(0xDC00 + (Point & 0x3FF));
+        }
+        else
+        {
+            *Into++ = (TOut)Point;
+        }
+    }
+
+    return Into;
+}
+
+/*================================================================*/
+/*              simd validation                                   */
+/*================================================================*/
+
+#if SIMD_SSSE3 || SIMD_NEON || UTF8_DISPATCH
+
+#if SIMD_SSSE3 || UTF8_DISPATCH
+
+using Vec = __m128i;
+
+SIMD_INLINE Vec Load(const U8* Text) { return _mm_loadu_si128((const __m128i*)Text); }
+SIMD_INLINE Vec Splat(U8 Byte) { return _mm_set1_epi8((char)Byte); }
+SIMD_INLINE Vec Lookup(Vec Table, Vec Index) { return _mm_shuffle_epi8(Table, Index); }
+SIMD_INLINE Vec HighNibbles(Vec Bytes) { return _mm_and_si128(_mm_srli_epi16(Bytes, 4), Splat(0x0F)); }
+SIMD_INLINE Vec LowNibbles(Vec Bytes) { return _mm_and_si128(Bytes, Splat(0x0F)); }
+SIMD_INLINE Vec SaturatingSub(Vec Left, Vec Right) { return _mm_subs_epu8(Left, Right); }
+SIMD_INLINE Vec And(Vec Left, Vec Right) { return _mm_and_si128(Left, Right); }
+SIMD_INLINE Vec Or(Vec Left, Vec Right) { return _mm_or_si128(Left, Right); }
+SIMD_INLINE Vec Xor(Vec Left, Vec Right) { return _mm_xor_si128(Left, Right); }
+SIMD_INLINE bool AnySet(Vec Bytes) { return _mm_movemask_epi8(_mm_cmpeq_epi8(Bytes, _mm_setzero_si128())) != 0xFFFF; }
+SIMD_INLINE bool AllAscii(Vec Bytes) { return _mm_movemask_epi8(Bytes) == 0; }
+
+//the 16 bytes ending N bytes before the end of Current
+template<int N>
+SIMD_INLINE Vec Previous(Vec Current, Vec Last) { return _mm_alignr_epi8(Current, Last, 16 - N); }
+
+#else
+
+using Vec = uint8x16_t;
+
+CTU_INLINE Vec Load(const U8* Text) { return vld1q_u8(Text); }
+CTU_INLINE Vec Splat(U8 Byte) { return vdupq_n_u8(Byte); }
+CTU_INLINE Vec Lookup(Vec Table, Vec Index) { return vqtbl1q_u8(Table, Index); }
+CTU_INLINE Vec HighNibbles(Vec Bytes) { return vshrq_n_u8(Bytes, 4); }
+CTU_INLINE Vec LowNibbles(Vec Bytes) { return vandq_u8(Bytes, Splat(0x0F)); }
+CTU_INLINE Vec SaturatingSub(Vec Left, Vec Right) { return vqsubq_u8(Left, Right); }
+CTU_INLINE Vec And(Vec Left, Vec Right) { return vandq_u8(Left, Right); }
+CTU_INLINE Vec Or(Vec Left, Vec Right) { return vorrq_u8(Left, Right); }
+CTU_INLINE Vec Xor(Vec Left, Vec Right) { return veorq_u8(Left, Right); }
+CTU_INLINE bool AnySet(Vec Bytes) { return vmaxvq_u8(Bytes) != 0; }
+CTU_INLINE bool AllAscii(Vec Bytes) { return vmaxvq_u8(Bytes) < 0x80; }
+
+template<int N>
+CTU_INLINE Vec Previous(Vec Current, Vec Last) { return vextq_u8(Last, Current, 16 - N); }
+
+#endif
+
+/**
+ * every error in utf-8 shows up in the first 12 bits of a pair of bytes, which is the whole
+ * first byte and the high nibble of the second. each of those 3 nibbles looks up a set of
+ * errors it could be part of and a pair is only bad if all 3 agree. the one thing that
+ * needs more than 2 bytes is knowing a continuation is expected 2 or 3 bytes after a lead,
+ * those are checked separately and cancel out the TwoConts error where they are allowed
+ */
+constexpr U8 TooShort = 1 << 0;     // 11______ 0_______ or 11______ 11______
+constexpr U8 TooLong = 1 << 1;      // 0_______ 10______
+constexpr U8 Overlong3 = 1 << 2;    // 11100000 100_____
+constexpr U8 TooLarge = 1 << 3;     // 11110100 1001____ and everything bigger
+constexpr U8 Surrogate = 1 << 4;    // 11101101 101_____
+constexpr U8 Overlong2 = 1 << 5;    // 1100000_ 10______
+constexpr U8 TooLarge1000 = 1 << 6; // 11110101 1000____ and everything bigger
+constexpr U8 Overlong4 = 1 << 6;    // 11110000 1000____
+constexpr U8 TwoConts = 1 << 7;     // 10______ 10______
+constexpr U8 Carry = TooShort | TooLong | TwoConts;
+
+alignas(16) constexpr U8 FirstHighTable[16] = {
+    //0_______ ascii
+    TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+    //10______ continuation
+    TwoConts, TwoConts, TwoConts, TwoConts,
+    //1100____ and 1101____ two byte leads
+    TooShort | Overlong2,
+    TooShort,
+    //1110____ three byte lead
+    TooShort | Overlong3 | Surrogate,
+    //1111____ four byte lead
+    TooShort | TooLarge | TooLarge1000 | Overlong4
+};
+
+alignas(16) constexpr U8 FirstLowTable[16] = {
+    //____0000
+    Carry | Overlong3 | Overlong2 | Overlong4,
+    //____0001
+    Carry | Overlong2,
+    //____001_
+    Carry,
+    Carry,
+    //____0100
+    Carry | TooLarge,
+    //____0101 to ____1100
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    //____1101
+    Carry | TooLarge | TooLarge1000 | Surrogate,
+    //____111_
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000
+};
+
+alignas(16) constexpr U8 SecondHighTable[16] = {
+    //0_______ ascii
+    TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+    //1000____
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4,
+    //1001____
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge,
+    //101_____
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+    //11______ leads
+    TooShort, TooShort, TooShort, TooShort
+};
+
+//the last 3 bytes of a block cant start a sequence longer than what fits
+alignas(16) constexpr U8 IncompleteTable[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+struct Validator
+{
+    Vec Error;
+    Vec Last;
+    Vec LastIncomplete;
+
+    SIMD_INLINE void Check(Vec Block)
+    {
+        if(AllAscii(Block))
+        {
+            //ascii cant finish a sequence the last block started
+            Error = Or(Error, LastIncomplete);
+            LastIncomplete = Splat(0);
+            Last = Block;
+            return;
+        }
+
+        const Vec Prev1 = Previous<1>(Block, Last);
+
+        const Vec Special = And(And(
+            Lookup(Load(FirstHighTable), HighNibbles(Prev1)),
+            Lookup(Load(FirstLowTable), LowNibbles(Prev1))),
+            Lookup(Load(SecondHighTable), HighNibbles(Block)));
+
+        //only 111_____ is still above 0x80 after this, same for 1111____ 3 bytes back
+        const Vec ThirdByte = SaturatingSub(Previous<2>(Block, Last), Splat(0xE0 - 0x80));
+        const Vec FourthByte = SaturatingSub(Previous<3>(Block, Last), Splat(0xF0 - 0x80));
+        const Vec Expected = And(Or(ThirdByte, FourthByte), Splat(0x80));
+
+        Error = Or(Error, Xor(Expected, Special));
+
+        LastIncomplete = SaturatingSub(Block, Load(IncompleteTable));
+        Last = Block;
+    }
+};
+
+SIMD_TARGET bool ValidSimd(const U8* Text, U32 Len)
+{
+    Validator Check;
+    Check.Error = Check.Last = Check.LastIncomplete = Splat(0);
+    U32 I = 0;
+
+    for(; I + 16 <= Len; I += 16)
+        Check.Check(Load(Text + I));
+
+    //the tail is padded with zeros, a sequence cut off by the end then fails like any other short one
+    alignas(16) U8 Tail[16] = {};
+    Memory::Copy(Text + I, Tail, Len - I);
+    Check.Check(Load(Tail));
+
+    return !AnySet(Or(Check.Error, Check.LastIncomplete));
+}
+
+#endif
+
+#if UTF8_DISPATCH
+
+bool HasSSSE3()
+{
+#if CC_MSVC
+    int Info[4];
+    __cpuid(Info, 1);
+    return (Info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+const bool UseSSSE3 = HasSSSE3();
+
+#endif
+
+}
+
+/*================================================================*/
+/*              Cthulhu::Unicode                                  */
+/*================================================================*/
+
+bool Cthulhu::Unicode::IsAscii(const char* Text, U32 Len)
+{
+    const U8* Bytes = (const U8*)Text;
+    U64 Seen = 0;
+    U32 I = 0;
+
+    //or everything together and only look at the result once, the compiler vectorizes this
+    for(; I + 32 <= Len; I += 32)
+    {
+        Seen |= LoadEight(Bytes + I) | LoadEight(Bytes + I + 8) | LoadEight(Bytes + I + 16) | LoadEight(Bytes + I + 24);
+
+        if(Seen & HighBits)
+            return false;
+    }
+
+    for(; I < Len; I++)
+        Seen |= Bytes[I];
+
+    return (Seen & HighBits) == 0;
+}
+
+U32 Cthulhu::Unicode::ValidPrefix(const char* Text, U32 Len)
+{
+    const U8* Bytes = (const U8*)Text;
+    const U8* End = Bytes + Len;
+    const U8* Cursor = Bytes;
+
+    while(Cursor != End)
+    {
+        if(End - Cursor >= 8 && (LoadEight(Cursor) & HighBits) == 0)
+        {
+            Cursor += 8;
+            continue;
+        }
+
+        C32 Point;
+        const U32 Width = DecodeAt(Cursor, End, Point);
+
+        if(Width == 0)
+            break;
+
+        Cursor += Width;
+    }
+
+    return (U32)(Cursor - Bytes);
+}
+
+bool Cthulhu::Unicode::IsValid(const char* Text, U32 Len)
+{
+#if SIMD_SSSE3 || SIMD_NEON
+    return ValidSimd((const U8*)Text, Len);
+#elif UTF8_DISPATCH
+    return UseSSSE3 ? ValidSimd((const U8*)Text, Len) : ValidPrefix(Text, Len) == Len;
+#else
+    return ValidPrefix(Text, Len) == Len;
+#endif
+}
+
+U32 Cthulhu::Unicode::CountCodePoints(const char* Text, U32 Len)
+{
+    const U8* Bytes = (const U8*)Text;
+    U32 Tails = 0;
+    U32 I = 0;
+
+    for(; I + 8 <= Len; I += 8)
+        Tails += PopCount(Continuations(LoadEight(Bytes + I)));
+
+    for(; I < Len; I++)
+        Tails += IsContinuation(Bytes[I]);
+
+    return Len - Tails;
+}
+
+U32 Cthulhu::Unicode::Decode(const char* Text, U32 Len, C32& Out)
+{
+    if(Len == 0)
+        return 0;
+
+    return DecodeAt((const U8*)Text, (const U8*)Text + Len, Out);
+}
+
+U32 Cthulhu::Unicode::Encode(C32 Point, char* Into)
+{
+    const U32 Code = (U32)Point;
+
+    if(Code < 0x80)
+    {
+        Into[0] = (char)Code;
+        return 1;
+    }
+
+    if(Code < 0x800)
+    {
+        Into[0] = (char)(0xC0 | (Code >> 6));
+        Into[1] = (char)(0x80 | (Code & 0x3F));
+        return 2;
+    }
+
+    if(Code < 0x10000)
+    {
+        if(0xD800 <= Code && Code <= 0xDFFF)
+            return 0;
+
+        Into[0] = (char)(0xE0 | (Code >> 12));
+        Into[1] = (char)(0x80 | ((Code >> 6) & 0x3F));
+        Into[2] = (char)(0x80 | (Code & 0x3F));
+        return 3;
+    }
+
+    if(Code <= 0x10FFFF)
+    {
+        Into[0] = (char)(0xF0 | (Code >> 18));
+        Into[1] = (char)(0x80 | ((Code >> 12) & 0x3F));
+        Into[2] = (char)(0x80 | ((Code >> 6) & 0x3F));
+        Into[3] = (char)(0x80 | (Code & 0x3F));
+        return 4;
+    }
+
+    return 0;
+}
+
+Result<U32, U32> Cthulhu::Unicode::ToUTF16(const char* Text, U32 Len, Array<C16>& Into)
+{
+    const U8* Bytes = (const U8*)Text;
+
+    //pure ascii is just a widening copy
+    if(IsAscii(Text, Len))
+    {
+        Widen(Bytes, Len, Into.Extend(Len));
+
+        return Pass<U32, U32>(Len);
+    }
+
+    if(!IsValid(Text, Len))
+        return Fail<U32, U32>(ValidPrefix(Text, Len));
+
+    //every code point is one unit apart from the ones that need a surrogate pair
+    U32 Units = CountCodePoints(Text, Len);
+    U32 I = 0;
+
+    for(; I + 8 <= Len; I += 8)
+        Units += PopCount(FourByteLeads(LoadEight(Bytes + I)));
+
+    for(; I < Len; I++)
+        Units += Bytes[I] >= 0xF0;
+
+    DecodeValid(Bytes, Bytes + Len, Into.Extend(Units));
+
+    return Pass<U32, U32>(Units);
+}
+
+Result<U32, U32> Cthulhu::Unicode::ToUTF32(const char* Text, U32 Len, Array<C32>& Into)
+{
+    const U8* Bytes = (const U8*)Text;
+
+    if(IsAscii(Text, Len))
+    {
+        Widen(Bytes, Len, Into.Extend(Len));
+
+        return Pass<U32, U32>(Len);
+    }
+
+    if(!IsValid(Text, Len))
+        return Fail<U32, U32>(ValidPrefix(Text, Len));
+
+    const U32 Points = CountCodePoints(Text, Len);
+
+    DecodeValid(Bytes, Bytes + Len, Into.Extend(Points));
+
+    return Pass<U32, U32>(Points);
+}
+
+Result<String, U32> Cthulhu::Unicode::FromUTF16(const C16* Text, U32 Len)
+{
+    //work out the exact size first so the string is only allocated once
+    U32 Size = 0;
+
+    for(U32 I = 0; I < Len; I++)
+    {
+        const U16 Unit = (U16)Text[I];
+
+        if(Unit < 0x80)
+        {
+            Size += 1;
+        }
+        else if(Unit < 0x800)
+        {
+            Size += 2;
+        }
+        else if(Unit < 0xD800 || Unit > 0xDFFF)
+        {
+            Size += 3;
+        }
+        else if(Unit < 0xDC00 && I + 1 < Len && ((U16)Text[I + 1] & 0xFC00) == 0xDC00)
+        {
+            Size += 4;
+            I++;
+        }
+        else
+        {
+            return Fail<String, U32>(I);
+        }
+    }
+
+    char* Ret = new char[Size + 1];
+    char* Cursor = Ret;
+
+    for(U32 I = 0; I < Len; I++)
+    {
+        const U16 Unit = (U16)Text[I];
+
+        if(Unit < 0x80)
+        {
+            *Cursor++ = (char)Unit;
+            continue;
+        }
+
+        C32 Point = Unit;
+
+        if(0xD800 <= Unit && Unit <= 0xDBFF)
+            Point = 0x10000 + ((Unit - 0xD800) << 10) + ((U16)Text[++I] - 0xDC00);
+
+        Cursor += Encode(Point, Cursor);
+    }
+
+    *Cursor = '\0';
+
+    return Pass<String, U32>(String::FromPtr(Ret, Size, Size));
+}
+
+Result<String, U32> Cthulhu::Unicode::FromUTF32(const C32* Text, U32 Len)
+{
+    U32 Size = 0;
+
+    for(U32 I = 0; I < Len; I++)
+    {
+        const U32 Point = (U32)Text[I];
+
+        if(Point > 0x10FFFF || (0xD800 <= Point && Point <= 0xDFFF))
+            return Fail<String, U32>(I);
+
+        Size += 1 + (Point >= 0x80) + (Point >= 0x800) + (Point >= 0x10000);
+    }
+
+    char* Ret = new char[Size + 1];
+    char* Cursor = Ret;
+
+    for(U32 I = 0; I < Len; I++)
+        Cursor += Encode(Text[I], Cursor);
+
+    *Cursor = '\0';
+
+    return Pass<String, U32>(String::FromPtr(Ret, Size, Size));
+}
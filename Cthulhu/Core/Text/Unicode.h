@@ -0,0 +1,221 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Aliases.h"
+//U32 C16 C32
+
+#include "Core/Collections/Array.h"
+//Array<T>
+
+#include "Core/Collections/Result.h"
+//Result<T, E>
+
+#include "Core/Collections/CthulhuString.h"
+//String
+
+#pragma once
+
+namespace Cthulhu::Unicode
+{
+
+/**
+ * @brief the code point invalid input is decoded as
+ */
+constexpr C32 Replacement = 0xFFFD;
+
+/**
+ * @brief the most bytes a single code point takes in utf-8
+ */
+constexpr U32 MaxEncodedBytes = 4;
+
+/**
+ * @brief check if text is all ascii
+ *
+ * @description pure ascii is also valid utf-8 and needs no decoding, so checking this
+ *              first lets most text skip straight to a plain copy
+ */
+bool IsAscii(const char* Text, U32 Len);
+
+/**
+ * @brief check if text is valid utf-8
+ *
+ * @description rejects overlong encodings, surrogates, code points above 0x10FFFF and
+ *              truncated sequences. with ssse3 or neon 16 bytes are checked at a time
+ *              using lookup tables on the high and low nibbles of each byte pair, so
+ *              there are no branches on the contents of the text at all
+ *
+ * @code{.cpp}
+ *
+ * Unicode::IsValid("caf\xC3\xA9", 5); // true
+ * Unicode::IsValid("\xC0\xAF", 2); // false, an overlong '/'
+ *
+ * @endcode
+ */
+bool IsValid(const char* Text, U32 Len);
+
+/**
+ * @brief find where text stops being valid utf-8
+ *
+ * @return U32 the offset of the first invalid sequence, or Len if it is all valid
+ */
+U32 ValidPrefix(const char* Text, U32 Len);
+
+/**
+ * @brief count the code points in valid utf-8
+ *
+ * @description every byte that isnt a continuation byte starts a code point,
+ *              so this only has to count bytes and never decodes anything
+ */
+U32 CountCodePoints(const char* Text, U32 Len);
+
+/**
+ * @brief decode a single code point
+ *
+ * @param Text the text to decode from
+ * @param Len how much text there is
+ * @param Out where the code point is written
+ * @return U32 how many bytes were used or 0 if the text doesnt start with a valid sequence
+ */
+U32 Decode(const char* Text, U32 Len, C32& Out);
+
+/**
+ * @brief encode a single code point as utf-8
+ *
+ * @param Point the code point to encode
+ * @param Into where to write the bytes, must have space for at least MaxEncodedBytes
+ * @return U32 how many bytes were written or 0 if the code point is a surrogate or too big
+ */
+U32 Encode(C32 Point, char* Into);
+
+/**
+ * @brief convert utf-8 to utf-16
+ *
+ * @param Text the utf-8 to convert
+ * @param Len the length of Text
+ * @param Into the array to append the utf-16 to
+ * @return Result<U32, U32> how many units were appended or the offset of the first invalid byte
+ */
+Result<U32, U32> ToUTF16(const char* Text, U32 Len, Array<C16>& Into);
+
+/**
+ * @brief convert utf-8 to utf-32
+ *
+ * @param Text the utf-8 to convert
+ * @param Len the length of Text
+ * @param Into the array to append the code points to
+ * @return Result<U32, U32> how many code points were appended or the offset of the first invalid byte
+ */
+Result<U32, U32> ToUTF32(const char* Text, U32 Len, Array<C32>& Into);
+
+/**
+ * @brief convert utf-16 to utf-8
+ *
+ * @return Result<String, U32> the utf-8 or the index of the first unpaired surrogate
+ */
+Result<String, U32> FromUTF16(const C16* Text, U32 Len);
+
+/**
+ * @brief convert utf-32 to utf-8
+ *
+ * @return Result<String, U32> the utf-8 or the index of the first invalid code point
+ */
+Result<String, U32> FromUTF32(const C32* Text, U32 Len);
+
+CTU_INLINE bool IsAscii(const String& Text) { return IsAscii(Text.CStr(), Text.Len()); }
+CTU_INLINE bool IsValid(const String& Text) { return IsValid(Text.CStr(), Text.Len()); }
+CTU_INLINE U32 CountCodePoints(const String& Text) { return CountCodePoints(Text.CStr(), Text.Len()); }
+CTU_INLINE Result<U32, U32> ToUTF16(const String& Text, Array<C16>& Into) { return ToUTF16(Text.CStr(), Text.Len(), Into); }
+CTU_INLINE Result<U32, U32> ToUTF32(const String& Text, Array<C32>& Into) { return ToUTF32(Text.CStr(), Text.Len(), Into); }
+
+/**
+ * @brief walks the code points of some utf-8, invalid bytes come out as Replacement one at a time
+ */
+struct CodePointIterator
+{
+    CodePointIterator(const char* InCursor, const char* InEnd)
+        : Cursor(InCursor)
+        , End(InEnd)
+    {
+        Next();
+    }
+
+    CTU_INLINE C32 operator*() const { return Current; }
+
+    CTU_INLINE CodePointIterator& operator++()
+    {
+        Cursor += Width;
+        Next();
+        return *this;
+    }
+
+    CTU_INLINE bool operator!=(const CodePointIterator& Other) const { return Cursor != Other.Cursor; }
+
+    /**
+     * @brief where the current code point starts
+     */
+    CTU_INLINE const char* Position() const { return Cursor; }
+
+private:
+    CTU_INLINE void Next()
+    {
+        if(Cursor == End)
+            return;
+
+        //most text is ascii so dont bother calling out for it
+        if((U8)*Cursor < 0x80)
+        {
+            Current = *Cursor;
+            Width = 1;
+            return;
+        }
+
+        Width = Decode(Cursor, (U32)(End - Cursor), Current);
+
+        if(Width == 0)
+        {
+            Current = Replacement;
+            Width = 1;
+        }
+    }
+
+    const char* Cursor;
+    const char* End;
+    C32 Current = 0;
+    U32 Width = 0;
+};
+
+struct CodePointRange
+{
+    CTU_INLINE CodePointIterator begin() const { return CodePointIterator(Start, End); }
+    CTU_INLINE CodePointIterator end() const { return CodePointIterator(End, End); }
+
+    const char* Start;
+    const char* End;
+};
+
+/**
+ * @brief iterate over the code points of some utf-8
+ *
+ * @code{.cpp}
+ *
+ * for(C32 Point : Unicode::CodePoints(Text))
+ *     Process(Point);
+ *
+ * @endcode
+ */
+CTU_INLINE CodePointRange CodePoints(const char* Text, U32 Len) { return { Text, Text + Len }; }
+CTU_INLINE CodePointRange CodePoints(const String& Text) { return { Text.CStr(), Text.CStr() + Text.Len() }; }
+
+}
@@ -40,10 +40,10 @@ template<typename T>
 struct IsTriviallyDestructable : Private::TrivialDestructor<T> {};
 
 template<typename T>
-struct IsTriviallyCopyable : Or<__has_trivial_copy(T), IsPOD<T>> {};
+struct IsTriviallyCopyable : Or<__has_trivial_copy(T), IsPOD<T>::Value> {};
 
 template<typename T>
-struct IsTriviallyAssignable : Or<__has_trivial_assign(T), IsPOD<T>> {};
+struct IsTriviallyAssignable : Or<__has_trivial_assign(T), IsPOD<T>::Value> {};
 
 //check if a type is trivial
 //meaning it has a trivial destructor
@@ -60,7 +60,8 @@ struct AndValue<false, T...> : False {};
 template<typename TLeft, typename... TRight>
 struct And<TLeft, TRight...> : AndValue<TLeft::Value, TRight...> {};
 
+//nothing left to be false so everything was true
 template<>
-struct And<> : False {};
+struct And<> : True {};
 
 }
\ No newline at end of file
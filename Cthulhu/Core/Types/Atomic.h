@@ -0,0 +1,182 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//CTU_INLINE CC_MSVC
+
+#if CC_MSVC
+#   include <atomic>
+#endif
+
+#pragma once
+
+namespace Cthulhu
+{
+
+/**
+ * @brief how much ordering an atomic operation guarantees
+ *
+ * @description mirrors the c++11 memory orders, Relaxed only makes the
+ *              operation itself atomic, Acquire and Release pair up so
+ *              everything written before a Release store is visible after
+ *              an Acquire load that sees it
+ */
+enum class MemoryOrder
+{
+    Relaxed,
+    Acquire,
+    Release,
+    AcquireRelease,
+    Sequential
+};
+
+namespace Private
+{
+#if !CC_MSVC
+    constexpr int ToBuiltinOrder(MemoryOrder Order)
+    {
+        switch(Order)
+        {
+        case MemoryOrder::Relaxed: return __ATOMIC_RELAXED;
+        case MemoryOrder::Acquire: return __ATOMIC_ACQUIRE;
+        case MemoryOrder::Release: return __ATOMIC_RELEASE;
+        case MemoryOrder::AcquireRelease: return __ATOMIC_ACQ_REL;
+        default: return __ATOMIC_SEQ_CST;
+        }
+    }
+
+    //compare exchange failures cant have release semantics
+    constexpr int ToFailureOrder(MemoryOrder Order)
+    {
+        switch(Order)
+        {
+        case MemoryOrder::Relaxed: case MemoryOrder::Release: return __ATOMIC_RELAXED;
+        case MemoryOrder::Acquire: case MemoryOrder::AcquireRelease: return __ATOMIC_ACQUIRE;
+        default: return __ATOMIC_SEQ_CST;
+        }
+    }
+#else
+    constexpr std::memory_order ToStdOrder(MemoryOrder Order)
+    {
+        switch(Order)
+        {
+        case MemoryOrder::Relaxed: return std::memory_order_relaxed;
+        case MemoryOrder::Acquire: return std::memory_order_acquire;
+        case MemoryOrder::Release: return std::memory_order_release;
+        case MemoryOrder::AcquireRelease: return std::memory_order_acq_rel;
+        default: return std::memory_order_seq_cst;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief a value that can be safely read and written from multiple threads at once
+ *
+ * @description only works with integers and pointers, Add and Sub only make sense
+ *              for integers. every operation defaults to sequential consistency so
+ *              pass a weaker order where it matters
+ *
+ * @code{.cpp}
+ *
+ * Atomic<U32> Counter = 0;
+ *
+ * //on any thread
+ * Counter.Add(1);
+ *
+ * U32 Total = Counter.Load(MemoryOrder::Acquire);
+ *
+ * @endcode
+ *
+ * @tparam T the integer or pointer type to store
+ */
+template<typename T>
+struct Atomic
+{
+    Atomic() : Value() {}
+    Atomic(T Initial) : Value(Initial) {}
+
+    Atomic(const Atomic&) = delete;
+    Atomic& operator=(const Atomic&) = delete;
+
+#if !CC_MSVC
+    CTU_INLINE T Load(MemoryOrder Order = MemoryOrder::Sequential) const
+    {
+        return __atomic_load_n(&Value, Private::ToBuiltinOrder(Order));
+    }
+
+    CTU_INLINE void Store(T NewValue, MemoryOrder Order = MemoryOrder::Sequential)
+    {
+        __atomic_store_n(&Value, NewValue, Private::ToBuiltinOrder(Order));
+    }
+
+    /**
+     * @brief replace the value and return what it used to be
+     */
+    CTU_INLINE T Exchange(T NewValue, MemoryOrder Order = MemoryOrder::Sequential)
+    {
+        return __atomic_exchange_n(&Value, NewValue, Private::ToBuiltinOrder(Order));
+    }
+
+    /**
+     * @brief replace the value only if it is still Expected
+     *
+     * @param Expected what the value should be, updated to what it actually was on failure
+     * @param Desired what to replace it with
+     * @return bool true if the value was replaced
+     */
+    CTU_INLINE bool CompareExchange(T& Expected, T Desired, MemoryOrder Order = MemoryOrder::Sequential)
+    {
+        return __atomic_compare_exchange_n(&Value, &Expected, Desired, false, Private::ToBuiltinOrder(Order), Private::ToFailureOrder(Order));
+    }
+
+    /**
+     * @brief add to the value and return what it used to be
+     */
+    template<typename TDelta>
+    CTU_INLINE T Add(TDelta Delta, MemoryOrder Order = MemoryOrder::Sequential)
+    {
+        return __atomic_fetch_add(&Value, Delta, Private::ToBuiltinOrder(Order));
+    }
+
+    /**
+     * @brief subtract from the value and return what it used to be
+     */
+    template<typename TDelta>
+    CTU_INLINE T Sub(TDelta Delta, MemoryOrder Order = MemoryOrder::Sequential)
+    {
+        return __atomic_fetch_sub(&Value, Delta, Private::ToBuiltinOrder(Order));
+    }
+
+private:
+    T Value;
+#else
+    CTU_INLINE T Load(MemoryOrder Order = MemoryOrder::Sequential) const { return Value.load(Private::ToStdOrder(Order)); }
+    CTU_INLINE void Store(T NewValue, MemoryOrder Order = MemoryOrder::Sequential) { Value.store(NewValue, Private::ToStdOrder(Order)); }
+    CTU_INLINE T Exchange(T NewValue, MemoryOrder Order = MemoryOrder::Sequential) { return Value.exchange(NewValue, Private::ToStdOrder(Order)); }
+    CTU_INLINE bool CompareExchange(T& Expected, T Desired, MemoryOrder Order = MemoryOrder::Sequential) { return Value.compare_exchange_strong(Expected, Desired, Private::ToStdOrder(Order)); }
+
+    template<typename TDelta>
+    CTU_INLINE T Add(TDelta Delta, MemoryOrder Order = MemoryOrder::Sequential) { return Value.fetch_add(Delta, Private::ToStdOrder(Order)); }
+
+    template<typename TDelta>
+    CTU_INLINE T Sub(TDelta Delta, MemoryOrder Order = MemoryOrder::Sequential) { return Value.fetch_sub(Delta, Private::ToStdOrder(Order)); }
+
+private:
+    std::atomic<T> Value;
+#endif
+};
+
+}
@@ -14,14 +14,14 @@
  */
 
 #include "Errno.h"
-#include "Core/Collections/Array.h"
 
 using namespace Cthulhu;
 
 namespace
 {
 
-const Array<String> ErrnoStrings = {
+//constexpr so there is nothing to construct at startup
+constexpr StaticString ErrnoStrings[] = {
     "Not an error",
     "Operation not permitted",
     "No such file or directory",
@@ -158,7 +158,15 @@ const Array<String> ErrnoStrings = {
 
 }
 
-String ToString(Errno Err)
+void Cthulhu::WriteTo(TextWriter& Out, Errno Err)
 {
-    return ErrnoStrings.At((U32)Err).Or("Invalid error");
+    if((U32)Err < sizeof(ErrnoStrings) / sizeof(StaticString))
+        WriteTo(Out, ErrnoStrings[(U32)Err]);
+    else
+        Out.Write("Invalid error", 13);
+}
+
+String Cthulhu::ToString(Errno Err)
+{
+    return Utils::WriteToString(Err);
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 
 #include "Meta/Aliases.h"
 #include "Core/Collections/CthulhuString.h"
+#include "Core/Text/TextWriter.h"
 
 #pragma once
 
@@ -162,6 +163,14 @@ enum class Errno : U8
     NotRecoverable          = 131,
 };
 
+/**
+ * @brief write the message for an Errno
+ *
+ * @param Out where to write the message
+ * @param Err the errno to describe
+ */
+void WriteTo(TextWriter& Out, Errno Err);
+
 /**
  * @brief Turn an Errno into a string to print
  * 
@@ -0,0 +1,77 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Mutex.h"
+
+#if OS_WINDOWS
+#   include <windows.h>
+#endif
+
+using namespace Cthulhu;
+
+#if OS_WINDOWS
+
+static_assert(sizeof(void*) == sizeof(SRWLOCK), "SRWLOCK needs to fit in Mutex::Handle");
+
+Cthulhu::Mutex::Mutex()
+{
+    InitializeSRWLock((PSRWLOCK)&Handle);
+}
+
+Cthulhu::Mutex::~Mutex() {}
+
+void Cthulhu::Mutex::Lock()
+{
+    AcquireSRWLockExclusive((PSRWLOCK)&Handle);
+}
+
+void Cthulhu::Mutex::Unlock()
+{
+    ReleaseSRWLockExclusive((PSRWLOCK)&Handle);
+}
+
+bool Cthulhu::Mutex::TryLock()
+{
+    return TryAcquireSRWLockExclusive((PSRWLOCK)&Handle) != 0;
+}
+
+#else
+
+Cthulhu::Mutex::Mutex()
+{
+    pthread_mutex_init(&Handle, nullptr);
+}
+
+Cthulhu::Mutex::~Mutex()
+{
+    pthread_mutex_destroy(&Handle);
+}
+
+void Cthulhu::Mutex::Lock()
+{
+    pthread_mutex_lock(&Handle);
+}
+
+void Cthulhu::Mutex::Unlock()
+{
+    pthread_mutex_unlock(&Handle);
+}
+
+bool Cthulhu::Mutex::TryLock()
+{
+    return pthread_mutex_trylock(&Handle) == 0;
+}
+
+#endif
@@ -0,0 +1,95 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "Meta/Macros.h"
+//OS_WINDOWS CTU_INLINE
+
+#if !OS_WINDOWS
+#   include <pthread.h>
+#endif
+
+#pragma once
+
+namespace Cthulhu
+{
+
+/**
+ * @brief a lock that only one thread can hold at a time
+ *
+ * @description wraps an SRWLOCK on windows and a pthread mutex everywhere else,
+ *              use ScopeLock rather than calling Lock and Unlock directly
+ */
+struct Mutex
+{
+    Mutex();
+    ~Mutex();
+
+    Mutex(const Mutex&) = delete;
+    Mutex& operator=(const Mutex&) = delete;
+
+    void Lock();
+    void Unlock();
+
+    /**
+     * @brief take the lock if nobody else has it
+     *
+     * @return bool true if the lock was taken
+     */
+    bool TryLock();
+
+private:
+#if OS_WINDOWS
+    //an SRWLOCK is a single pointer, this avoids including windows.h everywhere
+    void* Handle;
+#else
+    pthread_mutex_t Handle;
+#endif
+};
+
+/**
+ * @brief holds a Mutex until it goes out of scope
+ *
+ * @code{.cpp}
+ *
+ * Mutex Lock;
+ *
+ * {
+ *     ScopeLock Guard(Lock);
+ *     //only one thread can be here at a time
+ * }
+ *
+ * @endcode
+ */
+struct ScopeLock
+{
+    CTU_INLINE ScopeLock(Mutex& InLock)
+        : Held(InLock)
+    {
+        Held.Lock();
+    }
+
+    CTU_INLINE ~ScopeLock()
+    {
+        Held.Unlock();
+    }
+
+    ScopeLock(const ScopeLock&) = delete;
+    ScopeLock& operator=(const ScopeLock&) = delete;
+
+private:
+    Mutex& Held;
+};
+
+}
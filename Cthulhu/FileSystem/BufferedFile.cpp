@@ -17,6 +17,9 @@
 
 #include "BufferedFile.h"
 
+#include "File.h"
+//Mode Private::ModeToString
+
 using namespace Cthulhu;
 using namespace Cthulhu::FileSystem;
 
@@ -30,6 +33,16 @@ BufferedFile::BufferedFile(const String& Name)
 #endif
 }
 
+BufferedFile::BufferedFile(const String& Name, Mode OpenMode)
+#if OS_LINUX || OS_APPLE
+    : Real(fopen(*Name, *Private::ModeToString(OpenMode)))
+#endif
+{
+#if OS_WINDOWS
+	fopen_s(&Real, *Name, *Private::ModeToString(OpenMode));
+#endif
+}
+
 BufferedFile::~BufferedFile()
 { 
     if (Real) 
@@ -68,4 +81,10 @@ U64 BufferedFile::Seek(U64 NewLocation)
 void BufferedFile::Write(Array<Byte> Data)
 {
     fwrite(Data.Data(), sizeof(Byte), Data.Len(), Real);
-}
\ No newline at end of file
+}
+
+void BufferedFile::Write(const Rope& Data)
+{
+    for(RopeChunk Chunk : Data)
+        fwrite(Chunk.Data, sizeof(Byte), Chunk.Length, Real);
+}
@@ -15,6 +15,7 @@
 
 #include <Core/Collections/CthulhuString.h>
 #include <Core/Collections/Array.h>
+#include <Core/Collections/Rope.h>
 
 #include "Core/Traits/IsPOD.h"
 
@@ -25,6 +26,9 @@
 namespace Cthulhu::FileSystem
 {
 
+//defined in File.h
+enum class Mode : U8;
+
 struct BufferedFile
 {
     /** 
@@ -32,6 +36,11 @@ struct BufferedFile
      */
     BufferedFile(const String& Name);
 
+    /**
+     * @brief open a file with a specific mode, the other constructor only reads
+     */
+    BufferedFile(const String& Name, Mode OpenMode);
+
     BufferedFile() 
         : Real(nullptr)
     {}
@@ -98,6 +107,11 @@ struct BufferedFile
 
     void Write(Array<Byte> Data);
 
+    /**
+     * @brief write every chunk of a rope straight to the file without flattening it first
+     */
+    void Write(const Rope& Data);
+
     BufferedFile& Claim(BufferedFile* Other)
     {
         Close();
@@ -0,0 +1,35 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "FileWriter.h"
+
+using namespace Cthulhu;
+using namespace Cthulhu::FileSystem;
+
+bool FileWriter::Flush()
+{
+    if(!Error && Length != 0 && fwrite(Data, 1, Length, Handle) != Length)
+        Error = true;
+
+    Length = 0;
+
+    return !Error;
+}
+
+bool FileWriter::Drain(TextWriter& Self, U32 Needed)
+{
+    //once the file has failed there is no point buffering anything else
+    return static_cast<FileWriter&>(Self).Flush();
+}
@@ -0,0 +1,81 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+//FILE
+
+#include <Core/Text/TextWriter.h>
+//TextWriter
+
+#include "BufferedFile.h"
+//BufferedFile
+
+#pragma once
+
+namespace Cthulhu::FileSystem
+{
+
+/**
+ * @brief a writer that streams text into a file
+ *
+ * @description text is gathered in a 4k buffer and handed to the file in
+ *              one write whenever it fills up, so writing a huge structure
+ *              never holds more than the buffer in memory. the destructor
+ *              flushes whatever is left
+ *
+ * @code{.cpp}
+ *
+ * BufferedFile Log("Dump.txt", Mode::Write);
+ * FileWriter Out(Log);
+ * WriteTo(Out, Everything);
+ *
+ * @endcode
+ */
+struct FileWriter : TextWriter
+{
+    explicit FileWriter(FILE* InHandle)
+        : TextWriter(Buffer, sizeof(Buffer), &Drain)
+        , Handle(InHandle)
+        , Error(InHandle == nullptr)
+    {}
+
+    explicit FileWriter(const BufferedFile& File)
+        : FileWriter(File.Handle())
+    {}
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    ~FileWriter() { Flush(); }
+
+    /**
+     * @brief hand everything buffered to the file
+     *
+     * @return bool false if any write to the file has failed so far
+     */
+    bool Flush();
+
+    CTU_INLINE bool Failed() const { return Error; }
+
+private:
+    static bool Drain(TextWriter& Self, U32 Needed);
+
+    FILE* Handle;
+    bool Error;
+
+    char Buffer[4096];
+};
+
+}
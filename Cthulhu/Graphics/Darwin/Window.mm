@@ -17,6 +17,8 @@
 #include "Internal/View.h"
 #include "Graphics/Darwin/Path.h"
 #include "Window.h"
+#include "Internal/Globals.h"
+#include "Core/Memory/FrameAllocator.h"
 
 using namespace Cthulhu;
 using namespace Cthulhu::Graphics;
@@ -270,6 +272,10 @@ Graphics::Point NSToPoint(NSPoint& Point)
 
     printf("%lf\n", RealDiff / 1000000);
 
+    //frame memory from two ticks ago goes before anything handles this one
+    Memory::NextFrame();
+    EventHandler(MainLoopEvent::Tick);
+
     Window->Tick(RealDiff / 1000000);
 }
 
@@ -128,6 +128,36 @@
 #   define CC_INTEL 0
 #endif
 
+/**This switch detects which simd instruction sets the compiler will let us use
+ * SIMD_SSE2 and SIMD_NEON are always there on x64 and arm64, SIMD_SSSE3 and up
+ * only show up when the build asks for them with -mssse3, -march or /arch:AVX
+ * so anything using them needs a fallback
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SIMD_SSE2 1
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#   define SIMD_SSSE3 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#   define SIMD_NEON 1
+#endif
+
+#ifndef SIMD_SSE2
+#   define SIMD_SSE2 0
+#endif
+
+#ifndef SIMD_SSSE3
+#   define SIMD_SSSE3 0
+#endif
+
+#ifndef SIMD_NEON
+#   define SIMD_NEON 0
+#endif
+
 #if defined(CTU_FORCEINLINE)
 #	  define CTU_INLINE ALWAYSINLINE
 #else
@@ -32,7 +32,7 @@
 using namespace Cthulhu;
 using namespace Cthulhu::System;
 
-U32 CoreCount()
+U32 Cthulhu::System::CoreCount()
 {
 #if OS_WINDOWS
     SYSTEM_INFO Info;
@@ -43,7 +43,7 @@ U32 CoreCount()
 #endif
 }
 
-U64 TotalRam()
+U64 Cthulhu::System::TotalRam()
 {
 #if !OS_WINDOWS
     const U32 Pages = sysconf(_SC_PHYS_PAGES),
@@ -58,18 +58,18 @@ U64 TotalRam()
 #endif
 }
 
-bool FunctionExists(const String& Name)
+bool Cthulhu::System::FunctionExists(const String& Name)
 {
     Array<String> Temp = { *Name };
     return system(*String("which {0} > /dev/null 2>&1").ArrayFormat(Temp));
 }
 
-bool HasCommandPromt()
+bool Cthulhu::System::HasCommandPromt()
 {
     return system(nullptr);
 }
 
-String Exec(const String& Command)
+String Cthulhu::System::Exec(const String& Command)
 {
 #if OS_WINDOWS
     FILE* Temp = _popen(*Command, "r");
@@ -94,7 +94,7 @@ String Exec(const String& Command)
     return Ret;
 }
 
-Option<String> CurrentDirectory()
+Option<String> Cthulhu::System::CurrentDirectory()
 {
     char* Path = new char[1024];
 
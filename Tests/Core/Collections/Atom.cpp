@@ -0,0 +1,151 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/Map.h>
+#include <Core/Collections/Atom.h>
+
+using namespace Cthulhu;
+
+void Equality()
+{
+    Atom A = "Position";
+    Atom B = String("Posi") + String("tion");
+    Atom C = "Velocity";
+
+    TEST(A == B);
+    TEST(A.CStr() == B.CStr());
+    TEST(A != C);
+    TEST(A.Hash() == B.Hash());
+    TEST(A.Len() == 8);
+    TEST(Utils::ToString(A) == "Position");
+
+    //only the first 3 characters
+    TEST(Atom("Position", 3) == Atom("Pos"));
+    TEST(Atom("Pos").CStr()[3] == '\0');
+
+    TEST(Atom() == Atom(""));
+    TEST(Atom().Len() == 0);
+}
+
+void Find()
+{
+    TEST(!Atom::Find("NeverInterned").Valid());
+
+    const U32 Before = Atom::Count();
+    TEST(!Atom::Find(String("AlsoNeverInterned")).Valid());
+    TEST(Atom::Count() == Before);
+
+    Atom Made = "NowInterned";
+    TEST(Atom::Find("NowInterned").Valid());
+    TEST(Atom::Find("NowInterned").Get() == Made);
+    TEST(Atom::Count() == Before + 1);
+
+    TEST(Atom::Find("").Valid());
+}
+
+void Keys()
+{
+    //Map.h was included first so this also checks the hash is found regardless of include order
+    Map<Atom, int> Offsets;
+    Offsets[Atom("X")] = 0;
+    Offsets[Atom("Y")] = 4;
+
+    TEST(Offsets[Atom("Y")] == 4);
+    TEST(Offsets.HasKey(Atom("X")));
+    TEST(!Offsets.HasKey(Atom("Z")));
+}
+
+void Growth()
+{
+    //enough to resize the table several times
+    char Buffer[32];
+
+    for(U32 I = 0; I < 20000; I++)
+    {
+        snprintf(Buffer, sizeof(Buffer), "grow%u", I);
+        Atom Made(Buffer);
+        TEST(Made.Len() > 4);
+    }
+
+    for(U32 I = 0; I < 20000; I++)
+    {
+        snprintf(Buffer, sizeof(Buffer), "grow%u", I);
+        auto Found = Atom::Find(Buffer);
+        TEST(Found.Valid());
+        TEST(Utils::ToString(Found.Get()) == Buffer);
+    }
+
+    //bigger than an arena chunk
+    static char Huge[100000];
+    for(U32 I = 0; I < sizeof(Huge) - 1; I++)
+        Huge[I] = 'a' + (I % 26);
+
+    TEST(Atom(Huge) == Atom(Huge));
+    TEST(Atom(Huge).Len() == sizeof(Huge) - 1);
+}
+
+constexpr U32 ThreadCount = 8;
+constexpr U32 PerThread = 5000;
+
+const char* Seen[ThreadCount][PerThread];
+
+void* Worker(void* Arg)
+{
+    const U32 Index = (U32)(size_t)Arg;
+    char Buffer[32];
+
+    //every thread interns the same names in a different order
+    for(U32 I = 0; I < PerThread; I++)
+    {
+        const U32 Name = ((I * 7919) + (Index * 613)) % PerThread;
+        snprintf(Buffer, sizeof(Buffer), "thread%u", Name);
+        Seen[Index][Name] = Atom(Buffer).CStr();
+    }
+
+    return nullptr;
+}
+
+void Threads()
+{
+    pthread_t Handles[ThreadCount];
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Worker, (void*)(size_t)I);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+
+    //every thread has to have gotten the same atom for the same name
+    for(U32 Name = 0; Name < PerThread; Name++)
+    {
+        for(U32 I = 1; I < ThreadCount; I++)
+            TEST(Seen[I][Name] == Seen[0][Name]);
+    }
+}
+
+int main()
+{
+    Equality();
+    Find();
+    Keys();
+    Growth();
+    Threads();
+}
@@ -0,0 +1,194 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/CompressedStringTable.h>
+#include <Core/Text/Format.h>
+
+using namespace Cthulhu;
+
+U64 State = 0x9E3779B97F4A7C15ULL;
+
+U32 Random(U32 Limit)
+{
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return (U32)(State % Limit);
+}
+
+String MakeUrl(U32 I)
+{
+    static const char* Hosts[] = { "example.com", "images.example.com", "api.example.org", "cdn.static.net" };
+    static const char* Dirs[] = { "users", "products", "search", "assets/js", "assets/css" };
+
+    return Format(FMT("https://{}/{}/{}?page={}"), Hosts[I % 4], Dirs[(I / 4) % 5], I * 7919, I % 13);
+}
+
+void Urls()
+{
+    Array<String> Texts;
+
+    for(U32 I = 0; I < 2000; I++)
+        Texts.Append(MakeUrl(I));
+
+    Array<StringView> Sample;
+
+    for(U32 I = 0; I < Texts.Len(); I += 3)
+        Sample.Append(StringView(Texts[I]));
+
+    CompressedStringTable Table(Sample);
+    TEST(Table.Symbols() > 0 && Table.Symbols() <= 255);
+
+    for(U32 I = 0; I < Texts.Len(); I++)
+        TEST(Table.Add(Texts[I]) == I);
+
+    TEST(Table.Len() == Texts.Len());
+
+    //urls like these should at least halve
+    TEST(Table.MemoryUsed() * 2 < Table.OriginalBytes());
+
+    for(U32 I = 0; I < Texts.Len(); I++)
+    {
+        TEST(Table.Get(I) == Texts[I]);
+        TEST(Table.Length(I) == Texts[I].Len());
+        TEST(Table.Equals(I, Texts[I]));
+        TEST(!Table.Equals(I, Texts[(I + 1) % Texts.Len()]));
+        TEST(Table.StartsWith(I, "https://"));
+        TEST(Table.StartsWith(I, Texts[I]));
+        TEST(Table.StartsWith(I, ""));
+        TEST(!Table.StartsWith(I, "http://"));
+        TEST(!Table.StartsWith(I, Texts[I] + String("?")));
+
+        //every prefix length, including ones that end inside a symbol
+        const U32 Cut = Random(Texts[I].Len() + 1);
+        TEST(Table.StartsWith(I, StringView(Texts[I].CStr(), Cut)));
+    }
+
+    const U32 Again = Table.Add(Texts[5]);
+    TEST(Table.Equal(5, Again));
+    TEST(!Table.Equal(5, 6));
+}
+
+void Writers()
+{
+    Array<StringView> Sample;
+    Sample.Append(StringView("hello world"));
+    Sample.Append(StringView("hello there"));
+
+    CompressedStringTable Table(Sample);
+    const U32 Index = Table.Add("hello world, hello there");
+
+    BufferWriter Out;
+    Out.Write("> ");
+    Table.DecompressTo(Index, Out);
+    TEST(Out.Take() == "> hello world, hello there");
+
+    //a buffer too small for the fast path still gets as much as fits
+    StackWriter<10> Small;
+    Table.DecompressTo(Index, Small);
+    TEST(Small.Truncated());
+    TEST(String(Small.Terminate()) == "hello wor");
+    TEST(Small.Total == 24);
+
+    String Into = "text: ";
+    {
+        StringWriter Appender(Into);
+        Table.DecompressTo(Index, Appender);
+    }
+    TEST(Into == "text: hello world, hello there");
+}
+
+void Unusual()
+{
+    //nothing to train on means every byte is escaped but it all still works
+    CompressedStringTable Empty{ Array<StringView>() };
+    TEST(Empty.Symbols() == 0);
+
+    const U32 Plain = Empty.Add("abc");
+    TEST(Empty.Compressed(Plain).Len() == 6);
+    TEST(Empty.Get(Plain) == "abc");
+
+    const U32 Nothing = Empty.Add("");
+    TEST(Empty.Get(Nothing) == "");
+    TEST(Empty.Length(Nothing) == 0);
+    TEST(Empty.Equals(Nothing, ""));
+    TEST(Empty.StartsWith(Nothing, ""));
+    TEST(!Empty.StartsWith(Nothing, "a"));
+
+    //every byte value including zero, trained and compressed with text that doesnt look alike
+    char Binary[256];
+    for(U32 I = 0; I < 256; I++)
+        Binary[I] = (char)(255 - I);
+
+    Array<StringView> Sample;
+    Sample.Append(StringView(Binary, 256));
+    Sample.Append(StringView("\0\0\0\0\0\0\0\0\0\0\0\0", 12));
+
+    CompressedStringTable Table(Sample);
+
+    for(U32 Round = 0; Round < 500; Round++)
+    {
+        char Text[300];
+        const U32 Len = Random(300);
+
+        for(U32 I = 0; I < Len; I++)
+            Text[I] = Random(4) == 0 ? '\0' : (char)Random(256);
+
+        const U32 Index = Table.Add(StringView(Text, Len));
+
+        BufferWriter Out;
+        Table.DecompressTo(Index, Out);
+
+        TEST(Out.Length == Len);
+        TEST(Memory::Compare(Out.Data, Text, Len) == 0);
+        TEST(Table.Length(Index) == Len);
+        TEST(Table.Equals(Index, StringView(Text, Len)));
+        TEST(Table.StartsWith(Index, StringView(Text, Random(Len + 1))));
+
+        //Get has to keep the nulls too, past 32 bytes it comes off the heap
+        const String Got = Table.Get(Index);
+        TEST(Got.Len() == Len);
+        TEST(Memory::Compare(Got.CStr(), Text, Len) == 0);
+    }
+
+    //long enough to leave the inline buffer with a null right at the start
+    char Leading[100] = { 0 };
+    for(U32 I = 1; I < 100; I++)
+        Leading[I] = (char)('a' + I % 26);
+
+    const U32 Nulled = Table.Add(StringView(Leading, 100));
+    TEST(Table.Get(Nulled).Len() == 100);
+    TEST(Table.Get(Nulled).Len() == Table.Length(Nulled));
+
+    //one string much longer than anything in the sample
+    String Long;
+    for(U32 I = 0; I < 10000; I++)
+        Long += MakeUrl(I);
+
+    const U32 Index = Table.Add(Long);
+    TEST(Table.Get(Index) == Long);
+}
+
+int main()
+{
+    Urls();
+    Writers();
+    Unusual();
+}
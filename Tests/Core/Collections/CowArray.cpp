@@ -0,0 +1,260 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/CowArray.h>
+#include <Core/Collections/CthulhuString.h>
+#include <Core/Memory/Arena.h>
+
+using namespace Cthulhu;
+
+struct Counted
+{
+    static I32 Alive;
+    static I32 Copies;
+
+    U64 Value;
+
+    Counted() : Value(0) { Alive++; }
+    Counted(U64 InValue) : Value(InValue) { Alive++; }
+    Counted(const Counted& Other) : Value(Other.Value) { Alive++; Copies++; }
+    Counted(Counted&& Other) : Value(Other.Value) { Alive++; }
+    Counted& operator=(const Counted& Other) { Value = Other.Value; Copies++; return *this; }
+    ~Counted() { Alive--; }
+
+    bool operator==(const Counted& Other) const { return Value == Other.Value; }
+};
+
+I32 Counted::Alive = 0;
+I32 Counted::Copies = 0;
+
+void Sharing()
+{
+    CowArray<U32> Empty;
+    TEST(Empty.Len() == 0);
+    TEST(Empty.IsUnique());
+    TEST(Empty.Items() == nullptr);
+
+    CowArray<U32> Numbers = { 1, 2, 3 };
+    TEST(Numbers.Len() == 3);
+    TEST(Numbers[2] == 3);
+
+    //copying shares the items
+    CowArray<U32> Reader = Numbers;
+    TEST(Reader.SharesWith(Numbers));
+    TEST(!Numbers.IsUnique());
+    TEST(Reader.Items() == Numbers.Items());
+
+    //reading never copies
+    U32 Sum = 0;
+    for(U32 Item : Reader)
+        Sum += Item;
+
+    TEST(Sum == 6);
+    TEST(Reader.SharesWith(Numbers));
+
+    //the first write gives the writer its own items
+    Numbers.Set(0, 10);
+    TEST(!Reader.SharesWith(Numbers));
+    TEST(Numbers.IsUnique());
+    TEST(Reader.IsUnique());
+    TEST(Numbers[0] == 10);
+    TEST(Reader[0] == 1);
+
+    //and later writes dont copy again
+    const U32* Before = Numbers.Items();
+    Numbers.At(1) = 20;
+    TEST(Numbers.Items() == Before);
+
+    Numbers.Append(4);
+    TEST(Numbers.Len() == 4);
+    TEST(Numbers.Capacity() >= CowArray<U32>::MinCapacity);
+
+    CowArray<U32> Snap = Numbers.Snapshot();
+    Numbers.Append(5);
+    TEST(Snap.Len() == 4);
+    TEST(Numbers.Len() == 5);
+    TEST(Numbers.Back() == 5);
+
+    TEST(Numbers.Pop() == 5);
+    TEST(Numbers == Snap);
+    TEST(Numbers != Reader);
+    TEST(Numbers.Find(20).Valid());
+    TEST(!Numbers.Has(2));
+
+    //clearing a shared array doesnt copy anything
+    CowArray<U32> Other = Snap;
+    Other.Clear();
+    TEST(Other.Len() == 0);
+    TEST(Snap.Len() == 4);
+
+    //shrinking a shared array only copies what is kept
+    CowArray<U32> Shrunk = Snap;
+    Shrunk.Resize(2);
+    TEST(Shrunk.Len() == 2);
+    TEST(Shrunk.Capacity() == 2);
+    TEST(Snap.Len() == 4);
+
+    Shrunk.Resize(100);
+    TEST(Shrunk[99] == 0);
+    TEST(Shrunk[1] == 20);
+
+    Array<U32> Plain = Snap.ToArray();
+    TEST(Plain.Len() == 4);
+    TEST(Plain[1] == 20);
+}
+
+void Lifetimes()
+{
+    {
+        CowArray<Counted> Items;
+
+        for(U64 I = 0; I < 100; I++)
+            Items.Append(Counted(I));
+
+        TEST(Counted::Alive == 100);
+
+        Counted::Copies = 0;
+
+        CowArray<Counted> Copies[10];
+        for(CowArray<Counted>& Each : Copies)
+            Each = Items;
+
+        TEST(Counted::Copies == 0);
+        TEST(Counted::Alive == 100);
+
+        Copies[3].At(5).Value = 500;
+        TEST(Counted::Copies == 100);
+        TEST(Counted::Alive == 200);
+        TEST(Items[5].Value == 5);
+
+        Copies[3].Resize(10);
+        TEST(Counted::Alive == 110);
+
+        //the other copies still share the old items so popping copies them first
+        Counted Last = Items.Pop();
+        TEST(Last.Value == 99);
+        TEST(Counted::Alive == 210);
+    }
+
+    TEST(Counted::Alive == 0);
+
+    //moving an array in takes its items as they are
+    Array<String> Names = { "a", "b", "c" };
+    const String* Where = Names.Data();
+
+    CowArray<String> Shared = (Array<String>&&)Names;
+    TEST(Shared.Items() == Where);
+    TEST(Shared.Len() == 3);
+    TEST(Names.Len() == 0);
+
+    CowArray<String> Copy = Shared;
+
+    //writing in place is fine once it is unique again
+    Copy = CowArray<String>();
+    Shared.Set(0, "z");
+    TEST(Shared.Items() == Where);
+
+    //changing the length gets items of its own
+    Shared.Append("d");
+    TEST(Shared.Items() != Where);
+    TEST(Shared[0] == "z");
+    TEST(Shared[3] == "d");
+
+    //items from an allocator are copied since they cant go to the heap
+    Memory::Arena Scratch;
+    Array<U32> Scratched(Scratch);
+    Scratched.Append(1);
+    Scratched.Append(2);
+
+    CowArray<U32> Kept = (Array<U32>&&)Scratched;
+    TEST(Kept.Len() == 2);
+    TEST(Kept[1] == 2);
+    TEST(Scratched.Len() == 0);
+}
+
+void ArrayCopies()
+{
+    Array<String> First = { "one", "two" };
+    Array<String> Second;
+    Second.Append("three");
+
+    //assigning copies every item rather than sharing the buffer
+    Second = First;
+    TEST(Second.Len() == 2);
+    TEST(Second.Data() != First.Data());
+    First[0] = "changed";
+    TEST(Second[0] == "one");
+
+    Array<String> Moved = (Array<String>&&)First;
+    TEST(Moved.Len() == 2);
+    TEST(First.Len() == 0);
+
+    //moved from arrays can still be used
+    First.Append("again");
+    TEST(First[0] == "again");
+
+    Second = (Array<String>&&)Moved;
+    TEST(Second[0] == "changed");
+}
+
+CowArray<U64> Common;
+
+void* Reader(void*)
+{
+    for(U32 I = 0; I < 100000; I++)
+    {
+        CowArray<U64> Mine = Common.Snapshot();
+        TEST(Mine[I % 1000] == I % 1000);
+
+        //a write only ever touches this threads copy
+        if(I % 1000 == 0)
+        {
+            Mine.Set(0, 7);
+            TEST(Mine.IsUnique());
+        }
+    }
+
+    return nullptr;
+}
+
+void Threads()
+{
+    for(U64 I = 0; I < 1000; I++)
+        Common.Append(I);
+
+    pthread_t Threads[4];
+    for(U32 I = 0; I < 4; I++)
+        pthread_create(&Threads[I], nullptr, Reader, nullptr);
+
+    for(U32 I = 0; I < 4; I++)
+        pthread_join(Threads[I], nullptr);
+
+    TEST(Common.IsUnique());
+    TEST(Common[0] == 0);
+}
+
+int main()
+{
+    Sharing();
+    Lifetimes();
+    ArrayCopies();
+    Threads();
+}
@@ -0,0 +1,100 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/Map.h>
+#include <Core/Collections/CthulhuString.h>
+#include <Core/Memory/Arena.h>
+
+using namespace Cthulhu;
+
+void Copies()
+{
+    Map<String, int> A;
+    A["x"] = 1;
+    A["y"] = 2;
+
+    {
+        Map<String, int> B;
+        B["z"] = 3;
+        B = A;
+
+        TEST(B["x"] == 1);
+        TEST(B["y"] == 2);
+        TEST(B.Get("z", -1) == -1);
+
+        B["x"] = 10;
+    }
+
+    //B is gone and took only its own nodes with it
+    TEST(A["x"] == 1);
+    TEST(A["y"] == 2);
+
+    {
+        Map<String, int> C = A;
+        A = A;
+        TEST(A["x"] == 1);
+        TEST(C["y"] == 2);
+    }
+
+    TEST(A["x"] == 1);
+
+    //a copy into a map with an allocator keeps that allocator
+    Memory::Arena Scratch;
+    Map<String, int> D(Scratch);
+    D = A;
+    TEST(D.Allocator() == &Scratch);
+    TEST(D["y"] == 2);
+}
+
+void Moves()
+{
+    //declared first so it outlives the maps that end up with its nodes
+    Memory::Arena Scratch;
+
+    Map<String, int> A;
+    A["x"] = 1;
+
+    Map<String, int> B = (Map<String, int>&&)A;
+    TEST(B["x"] == 1);
+
+    //the moved from map is empty but still usable
+    TEST(A.Get("x", -1) == -1);
+    A["x"] = 5;
+    TEST(A["x"] == 5);
+
+    B = (Map<String, int>&&)A;
+    TEST(B["x"] == 5);
+    TEST(A.Get("x", -1) == -1);
+
+    Map<String, int> C(Scratch);
+    C["w"] = 7;
+
+    B = (Map<String, int>&&)C;
+    TEST(B["w"] == 7);
+    TEST(B.Get("x", -1) == -1);
+    TEST(B.Allocator() == &Scratch);
+    TEST(C.Allocator() == nullptr);
+}
+
+int main()
+{
+    Copies();
+    Moves();
+}
@@ -0,0 +1,285 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/Rope.h>
+#include <FileSystem/BufferedFile.h>
+#include <FileSystem/File.h>
+
+using namespace Cthulhu;
+
+bool Matches(const Rope& Text, const char* Expected)
+{
+    return Text.Flatten() == Expected;
+}
+
+void Basics()
+{
+    Rope Empty;
+    TEST(Empty.Len() == 0);
+    TEST(Empty.IsEmpty());
+    TEST(Matches(Empty, ""));
+
+    Rope Text = "hello world";
+    TEST(Text.Len() == 11);
+    TEST(Text[4] == 'o');
+
+    Rope Saved = Text;
+
+    Text.Insert(5, ",");
+    TEST(Matches(Text, "hello, world"));
+
+    Text.Erase(0, 1);
+    TEST(Matches(Text, "ello, world"));
+
+    //the copy is a snapshot
+    TEST(Matches(Saved, "hello world"));
+
+    Text.Replace(0, 4, "jell");
+    TEST(Matches(Text, "jell, world"));
+
+    TEST(Matches(Text.Slice(6, 5), "world"));
+    TEST(Matches(Text.Slice(0, 0), ""));
+
+    //flattening keeps nulls
+    Rope Nulled("a\0b", 3);
+    TEST(Nulled.Flatten().Len() == 3);
+
+    Text.Push("[").Append("]");
+    TEST(Matches(Text, "[jell, world]"));
+
+    Text.Cut(1).Drop(1);
+    TEST(Matches(Text, "jell, world"));
+
+    TEST(Matches(Rope("ab") + Rope("cd"), "abcd"));
+    TEST(Rope("abcd") == Rope("ab") + Rope("cd"));
+    TEST(Rope("abcd") != Rope("abce"));
+
+    //inserting a rope into itself
+    Rope Twice = "xy";
+    Twice.Insert(1, Twice);
+    TEST(Matches(Twice, "xxyy"));
+
+    TEST(Utils::ToString(Rope(String("from a string"))) == "from a string");
+}
+
+void Lines()
+{
+    Rope Text = "first\nsecond\n\nfourth";
+
+    TEST(Text.LineCount() == 4);
+    TEST(Text.LineStart(0) == 0);
+    TEST(Text.LineStart(1) == 6);
+    TEST(Text.LineStart(3) == 14);
+
+    TEST(Text.LineOf(0) == 0);
+    TEST(Text.LineOf(5) == 0);
+    TEST(Text.LineOf(6) == 1);
+    TEST(Text.LineOf(14) == 3);
+
+    TEST(Matches(Text.Line(1), "second"));
+    TEST(Matches(Text.Line(2), ""));
+    TEST(Matches(Text.Line(3), "fourth"));
+
+    //lines spread across many chunks
+    Rope Big;
+    char Buffer[32];
+
+    for(U32 I = 0; I < 5000; I++)
+    {
+        snprintf(Buffer, sizeof(Buffer), "line %u\n", I);
+        Big.Append(Buffer);
+    }
+
+    TEST(Big.LineCount() == 5001);
+    snprintf(Buffer, sizeof(Buffer), "line %u", 4321);
+    TEST(Matches(Big.Line(4321), Buffer));
+    TEST(Big.LineOf(Big.LineStart(4321) + 3) == 4321);
+}
+
+void Random()
+{
+    //check every edit against a plain buffer
+    constexpr U32 Capacity = 1 << 20;
+    static char Model[Capacity];
+    U32 ModelLen = 0;
+
+    Rope Text;
+    U64 State = 0x2545F4914F6CDD1DULL;
+
+    auto Next = [&State](U32 Max) {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+        return (U32)(State % Max);
+    };
+
+    char Insert[4096];
+
+    for(U32 Step = 0; Step < 4000; Step++)
+    {
+        const U32 Op = Next(4);
+
+        if(Op < 2 || ModelLen == 0)
+        {
+            const U32 Len = 1 + Next(Op == 0 ? 16 : sizeof(Insert));
+            const U32 At = Next(ModelLen + 1);
+
+            if(ModelLen + Len >= Capacity)
+                continue;
+
+            for(U32 I = 0; I < Len; I++)
+                Insert[I] = (Next(20) == 0) ? '\n' : (char)('a' + Next(26));
+
+            memmove(Model + At + Len, Model + At, ModelLen - At);
+            memcpy(Model + At, Insert, Len);
+            ModelLen += Len;
+
+            Text.Insert(At, Rope(Insert, Len));
+        }
+        else if(Op == 2)
+        {
+            const U32 At = Next(ModelLen);
+            const U32 Len = Next(Math::Min(ModelLen - At, 2000U) + 1);
+
+            memmove(Model + At, Model + At + Len, ModelLen - At - Len);
+            ModelLen -= Len;
+
+            Text.Erase(At, Len);
+        }
+        else
+        {
+            const U32 At = Next(ModelLen);
+            const U32 Len = Next(ModelLen - At + 1);
+
+            Rope Part = Text.Slice(At, Len);
+            TEST(Part.Len() == Len);
+            TEST(Part == Rope(Model + At, Len));
+        }
+
+        TEST(Text.Len() == ModelLen);
+
+        if(Step % 100 == 0)
+        {
+            Model[ModelLen] = '\0';
+            TEST(Matches(Text, Model));
+
+            for(U32 I = 0; I < 50; I++)
+            {
+                const U32 At = Next(ModelLen);
+                TEST(Text[At] == Model[At]);
+            }
+
+            //an avl tree is never more than 1.44 times as tall as a perfect one
+            U32 Chunks = 0;
+            for(RopeChunk Chunk : Text)
+                Chunks += Chunk.Length != 0;
+
+            TEST(Text.Depth() <= 2 + (U32)(1.45 * (32 - __builtin_clz(Chunks | 1))));
+        }
+    }
+}
+
+void Build()
+{
+    //one big string should become a tree not one giant chunk
+    const U32 Len = 3 * 1024 * 1024;
+    char* Big = new char[Len + 1];
+
+    for(U32 I = 0; I < Len; I++)
+        Big[I] = (I % 64 == 63) ? '\n' : (char)('a' + (I % 26));
+
+    Big[Len] = '\0';
+
+    Rope Text(Big, Len);
+    TEST(Text.Len() == Len);
+    TEST(Text.LineCount() == (Len / 64) + 1);
+    TEST(Text.Depth() < 20);
+
+    Text.Insert(Len / 2, "middle");
+    TEST(Text.Slice(Len / 2, 6) == Rope("middle"));
+    TEST(Text[Len / 2 + 6] == Big[Len / 2]);
+
+    delete[] Big;
+}
+
+U32 ChunkBytes(const Rope& Text)
+{
+    U32 Ret = 0;
+
+    for(RopeChunk Chunk : Text)
+        Ret += Chunk.Length;
+
+    return Ret;
+}
+
+void SelfJoin()
+{
+    //big enough to be a branch so joining it to itself puts one node on both sides
+    String Part;
+    for(U32 I = 0; I < 300; I++)
+        Part += "abcdefgh";
+
+    Rope Text(Part);
+    Text += Text;
+
+    TEST(Text.Len() == 4800);
+    TEST(ChunkBytes(Text) == 4800);
+    TEST(Text.Flatten() == Part + Part);
+
+    Rope Nested = "0123456789";
+
+    for(U32 Round = 0; Round < 8; Round++)
+        Nested.Insert(Nested.Len() / 2, Nested);
+
+    TEST(Nested.Len() == 10 << 8);
+    TEST(ChunkBytes(Nested) == Nested.Len());
+    TEST(Nested.Flatten().Len() == Nested.Len());
+}
+
+void Files()
+{
+    Rope Text = "written ";
+    Text.Append(Rope("without ")).Append(Rope("flattening"));
+
+    {
+        FileSystem::BufferedFile Out("rope_test.txt", FileSystem::Mode::WriteBinary);
+        TEST(Out.Valid());
+        Out.Write(Text);
+    }
+
+    FileSystem::BufferedFile In("rope_test.txt");
+    char Buffer[64] = {};
+    TEST(In.ReadN(Buffer, sizeof(Buffer)) == Text.Len());
+    TEST(Matches(Text, Buffer));
+    In.Close();
+
+    remove("rope_test.txt");
+}
+
+int main()
+{
+    Basics();
+    Lines();
+    Random();
+    Build();
+    SelfJoin();
+    Files();
+}
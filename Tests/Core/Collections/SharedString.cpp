@@ -0,0 +1,176 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/SharedString.h>
+#include <Core/Collections/Map.h>
+#include <Core/Collections/Array.h>
+
+using namespace Cthulhu;
+
+void Sharing()
+{
+    SharedString Empty;
+    TEST(Empty.IsEmpty() && Empty.CStr()[0] == '\0');
+    TEST(Empty == SharedString(""));
+
+    SharedString Name = "a string long enough to be worth sharing";
+    SharedString Copy = Name;
+
+    TEST(Copy.CStr() == Name.CStr());
+    TEST(!Name.IsUnique());
+    TEST(Copy == Name);
+    TEST(Copy == SharedString(String("a string long enough to be worth sharing")));
+    TEST(Copy != SharedString("something else"));
+
+    {
+        SharedString Third = Copy;
+        Third = Name;
+        Third = Third;
+    }
+
+    //mutating detaches and leaves the other copy alone
+    Copy.Mutate()[0] = 'A';
+    TEST(Copy.CStr() != Name.CStr());
+    TEST(Name[0] == 'a' && Copy[0] == 'A');
+    TEST(Name.IsUnique() && Copy.IsUnique());
+
+    SharedString Moved = static_cast<SharedString&&>(Copy);
+    TEST(Copy.IsEmpty() && Moved[0] == 'A');
+}
+
+void Appending()
+{
+    SharedString Text = "abc";
+    SharedString Before = Text;
+
+    Text += "def";
+    TEST(Before.View() == "abc");
+    TEST(Text.View() == "abcdef");
+
+    //unique strings with space grow in place
+    Text += "g";
+    const char* Where = Text.CStr();
+    Text += "h";
+    TEST(Text.CStr() == Where && Text.View() == "abcdefgh");
+
+    //appending a string to itself
+    Text += Text;
+    TEST(Text.View() == "abcdefghabcdefgh");
+
+    SharedString Built;
+    for(U32 I = 0; I < 100; I++)
+        Built += "x";
+
+    TEST(Built.Len() == 100);
+}
+
+void Strings()
+{
+    String Source = "taken without copying";
+    const char* Buffer = Source.CStr();
+
+    SharedString Taken = static_cast<String&&>(Source);
+    TEST(Taken.CStr() == Buffer);
+    TEST(Source.IsEmpty() && Source == "");
+
+    String Back = Taken.Take();
+    TEST(Back.CStr() == Buffer && Back == "taken without copying");
+    TEST(Taken.IsEmpty());
+
+    //shared or inline text has to be copied
+    SharedString Inline = "inline";
+    SharedString Other = Inline;
+    String Copied = Inline.Take();
+    TEST(Copied == "inline" && Other.View() == "inline");
+
+    TEST(Utils::ToString(SharedString("x")) == "x");
+    TEST(SharedString().Take() == "");
+}
+
+void Containers()
+{
+    SharedString Key = "key";
+    TEST(Key.Hash() == SharedString(String("key")).Hash());
+    TEST(Key.Hash() != SharedString("kez").Hash());
+
+    Map<SharedString, U32> Counts;
+    Counts.Add(Key, 1);
+    Counts.Add("other", 2);
+    TEST(Counts.Get(SharedString("key"), 0) == 1);
+    TEST(Counts.Get(SharedString("other"), 0) == 2);
+
+    Key = SharedString(String("key"));
+
+    Array<SharedString> Many;
+    for(U32 I = 0; I < 100; I++)
+        Many.Append(Key);
+
+    TEST(!Key.IsUnique());
+
+    for(SharedString& Item : Many)
+        Item = SharedString();
+
+    TEST(Key.IsUnique());
+}
+
+constexpr U32 ThreadCount = 8;
+SharedString Global = "shared between every thread";
+
+void* Worker(void*)
+{
+    for(U32 I = 0; I < 100000; I++)
+    {
+        SharedString Local = Global;
+        SharedString Another = Local;
+
+        if(Another.Len() != Global.Len() || Another.Hash() != Global.Hash())
+            exit(1);
+
+        //detaching from another thread cant touch the shared text
+        if(I % 1000 == 0)
+            Another.Mutate()[0] = 'S';
+    }
+
+    return nullptr;
+}
+
+void Threads()
+{
+    pthread_t Handles[ThreadCount];
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Worker, nullptr);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+
+    TEST(Global.IsUnique());
+    TEST(Global.View() == "shared between every thread");
+}
+
+int main()
+{
+    Sharing();
+    Appending();
+    Strings();
+    Containers();
+    Threads();
+}
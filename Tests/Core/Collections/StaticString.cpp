@@ -0,0 +1,104 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/StaticString.h>
+#include <Core/Collections/CthulhuString.h>
+#include <Core/Collections/Map.h>
+#include <Core/Math/Hash.h>
+
+using namespace Cthulhu;
+
+//everything here has to be worked out by the compiler
+constexpr StaticString Name = "cthulhu";
+static_assert(Name.Len() == 7);
+static_assert(Name == "cthulhu"_S);
+static_assert(Name != "hastur"_S);
+static_assert(Name.Hash() == "cthulhu"_S.Hash());
+static_assert(Name.Hash() == Private::HashText("cthulhu", 7));
+static_assert(Name[6] == 'u');
+
+constexpr FixedString Greeting = FixedString("ph'nglui") + FixedString(" ") + FixedString("mglw'nafh");
+static_assert(Greeting.Len() == 18);
+static_assert(StringView(Greeting) == "ph'nglui mglw'nafh");
+static_assert(StaticString(Greeting).Hash() == Greeting.Hash());
+
+constexpr auto Joined = FixedString<6>::Join("ab", StringView("cd"), FixedString("ef"));
+static_assert(StringView(Joined) == "abcdef");
+
+static_assert(Consts::Digits() == "0123456789");
+static_assert(Consts::Chars().Len() == 52);
+static_assert(Consts::Printable().Len() == 100);
+static_assert(Consts::Printable()[10] == 'a');
+
+U32 Length(const String& Text)
+{
+    return Text.Len();
+}
+
+bool Viewed(StringView Text)
+{
+    return Text == "view";
+}
+
+void Conversions()
+{
+    //a StaticString goes anywhere a String or a StringView does
+    TEST(Length(Name) == 7);
+    TEST(Viewed("view"_S));
+
+    String Copy = Name;
+    TEST(Copy == Name);
+    TEST(Name == Copy);
+    TEST(Copy.CStr() != Name.CStr());
+
+    String Direct(Consts::Whitespace());
+    TEST(Direct == " \n\r\t\x0b\x0c");
+
+    Copy += '!';
+    TEST(Copy != Name);
+    TEST(Name != Copy);
+
+    TEST(String("Stuff") == "Stuff"_S);
+    TEST(StringView(Consts::Chars()).StartsWith("abc"));
+    TEST(Consts::Printable().CStr()[100] == '\0');
+    TEST(Greeting.CStr()[18] == '\0');
+
+    String Path = "usr";
+    Path /= "bin";
+    TEST(Path == StaticString("usr/bin"));
+}
+
+void Hashing()
+{
+    //precomputed hashes are what Utils::Hash uses
+    TEST(Utils::Hash(Name) == Name.Hash());
+    TEST(Utils::Hash("cthulhu"_S) == Name.Hash());
+    TEST(Utils::Hash("dagon"_S) != Name.Hash());
+
+    Map<String, U32> Ages;
+    Ages.Add(Name, 1);
+    TEST(Ages.Get(Name, 0) == 1);
+}
+
+int main()
+{
+    Conversions();
+    Hashing();
+}
@@ -28,6 +28,16 @@ void Ctor()
     String S1 = '5';
     String S2 = "AAAA";
     String S3 = S2;
+
+    //copies take every byte even past a null and can still grow afterwards
+    String Nulled("a\0bcdefghijklmnopqrstuvwxyz", 27);
+    String Copy = Nulled;
+    TEST(Copy.Len() == 27);
+    TEST(Copy[1] == '\0' && Copy[26] == 'z');
+
+    Copy += "x";
+    TEST(Copy.Len() == 28);
+    TEST(Copy[27] == 'x');
 }
 
 void Ops()
@@ -111,12 +121,12 @@ void Ops()
     TEST(S3 == "A5true");
 
     S3 << 5.5f;
-    TEST(S3 == "A5true5.50");
+    TEST(S3 == "A5true5.5");
 
     // / op
     String S4 = "Path";
     
-#ifdef OS_WINDOWS
+#if OS_WINDOWS
     TEST(S4 / "File.txt" == "Path\\File.txt");
 #else
     TEST(S4 / "File.txt" == "Path/File.txt");
@@ -129,7 +139,7 @@ void Ops()
     S5 /= "Dir";
     S5 /= "File.txt";
 
-#ifdef OS_WINDOWS
+#if OS_WINDOWS
     TEST(S5 == "Path\\Thing\\Dir\\File.txt");
 #else
     TEST(S5 == "Path/Thing/Dir/File.txt");
@@ -0,0 +1,162 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Collections/VirtualArray.h>
+#include <Core/Collections/CthulhuString.h>
+
+using namespace Cthulhu;
+
+struct Counted
+{
+    static I64 Alive;
+
+    U64 Value;
+
+    Counted() : Value(0) { Alive++; }
+    Counted(U64 InValue) : Value(InValue) { Alive++; }
+    Counted(const Counted& Other) : Value(Other.Value) { Alive++; }
+    ~Counted() { Alive--; }
+};
+
+I64 Counted::Alive = 0;
+
+void Growing()
+{
+    //far more than the machine has, only what is used is committed
+    VirtualArray<U64> Numbers(64ULL * 1024 * 1024 * 1024 / sizeof(U64));
+    TEST(Numbers.Len() == 0);
+    TEST(Numbers.Committed() == 0);
+
+    U64* First = &Numbers.Append(7);
+    TEST(Numbers.Committed() == VirtualArray<U64>::CommitStep);
+
+    for(U64 I = 1; I < 1000000; I++)
+        Numbers.Append(I);
+
+    //nothing ever moved
+    TEST(First == &Numbers[0]);
+    TEST(*First == 7);
+    TEST(Numbers.Data() == First);
+    TEST(Numbers[999999] == 999999);
+    TEST(Numbers.Back() == 999999);
+    TEST(Numbers.Committed() >= 1000000 * sizeof(U64));
+    TEST(Numbers.Committed() < 1000000 * sizeof(U64) + VirtualArray<U64>::CommitStep);
+
+    U64 Sum = 0;
+    for(U64 Item : Numbers)
+        Sum += Item;
+
+    TEST(Sum == 7 + (999999ULL * 1000000) / 2);
+
+    TEST(Numbers.Pop() == 999999);
+    TEST(Numbers.Len() == 999999);
+
+    //shrinking keeps memory until asked to give it back
+    const U64 Before = Numbers.Committed();
+    Numbers.Resize(10);
+    TEST(Numbers.Committed() == Before);
+
+    Numbers.Decommit();
+    TEST(Numbers.Committed() == VirtualArray<U64>::CommitStep);
+    TEST(Numbers[9] == 9);
+
+    //and decommitted memory comes back as zero
+    Numbers.Resize(500000);
+    TEST(Numbers[400000] == 0);
+    TEST(First == &Numbers[0]);
+
+    Numbers.Clear();
+    Numbers.Decommit();
+    TEST(Numbers.Committed() == 0);
+
+    Numbers.Reserve(300000);
+    TEST(Numbers.Committed() >= 300000 * sizeof(U64));
+    TEST(Numbers.Len() == 0);
+}
+
+void Objects()
+{
+    {
+        VirtualArray<Counted> Items(100000);
+
+        for(U64 I = 0; I < 50000; I++)
+            Items.Emplace(I);
+
+        TEST(Counted::Alive == 50000);
+
+        Items.Resize(100);
+        TEST(Counted::Alive == 100);
+
+        Items.Resize(200);
+        TEST(Counted::Alive == 200);
+        TEST(Items[150].Value == 0);
+
+        Counted Last = Items.Pop();
+        TEST(Counted::Alive == 200);
+        TEST(Items.Max() == 100000);
+
+        //moving hands the range over without touching any items
+        VirtualArray<Counted> Moved((VirtualArray<Counted>&&)Items);
+        TEST(Moved.Len() == 199);
+        TEST(Items.Len() == 0);
+        TEST(Counted::Alive == 200);
+
+        //assigning destroys what was there before taking the range
+        VirtualArray<Counted> Assigned(10);
+        Assigned.Emplace(1);
+        TEST(Counted::Alive == 201);
+
+        Assigned = (VirtualArray<Counted>&&)Moved;
+        TEST(Counted::Alive == 200);
+        TEST(Assigned.Len() == 199);
+        TEST(Assigned.Max() == 100000);
+        TEST(Moved.Len() == 0 && Moved.Max() == 0);
+    }
+
+    TEST(Counted::Alive == 0);
+
+    VirtualArray<String> Names(1000);
+    String& First = Names.Append(String("first"));
+
+    for(U32 I = 0; I < 999; I++)
+        Names.Append("name");
+
+    TEST(First == "first");
+    TEST(Names[998] == "name");
+
+    //a full reservation still commits to the very end
+    VirtualArray<Byte> Exact(5000);
+    Exact.Resize(5000);
+    Exact[4999] = 1;
+    TEST(Exact.Committed() >= 5000);
+
+#ifndef CTU_DEBUG
+    //more bytes than a U64 holds is a failed reservation rather than a wrapped around tiny one
+    VirtualArray<U64> Huge(~0ULL / 4);
+    TEST(Huge.Data() == nullptr);
+    TEST(Huge.Max() == 0);
+#endif
+}
+
+int main()
+{
+    Growing();
+    Objects();
+}
@@ -0,0 +1,63 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Math/Hash.h>
+#include <Core/Collections/Map.h>
+#include <Core/Collections/Atom.h>
+
+using namespace Cthulhu;
+
+void Builtins()
+{
+    //these have to pick the plain overloads rather than the one for types with a Hash member
+    TEST(Utils::Hash('a') == Utils::Hash((I32)'a'));
+    TEST(Utils::Hash(true) == 1);
+    TEST(Utils::Hash("text") == Utils::Hash(String("text")));
+    TEST(Utils::Hash((U64)5) == Utils::Hash((U64)5));
+
+    Atom Name = "name";
+    TEST(Utils::Hash(Name) == Name.Hash());
+}
+
+void Maps()
+{
+    Map<char, U32> Letters;
+    Letters['a'] = 1;
+    Letters['b'] = 2;
+    TEST(Letters['a'] == 1 && Letters['b'] == 2);
+
+    Map<bool, U32> Flags;
+    Flags[true] = 3;
+    TEST(Flags.Get(false, 0) == 0 && Flags[true] == 3);
+
+    Map<String, U32> Words;
+    Words["text"] = 4;
+    TEST(Words.Get("text", 0) == 4);
+
+    Map<Atom, U32> Atoms;
+    Atoms[Atom("x")] = 5;
+    TEST(Atoms[Atom("x")] == 5);
+}
+
+int main()
+{
+    Builtins();
+    Maps();
+}
@@ -0,0 +1,176 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/Allocator.h>
+#include <Core/Memory/Arena.h>
+#include <Core/Memory/Binary.h>
+#include <Core/Collections/Map.h>
+
+using namespace Cthulhu;
+
+//counts what is live so anything a container forgets to give back shows up
+struct Counting : Memory::Allocator
+{
+    void* Allocate(U64 Size, U64 Align) override
+    {
+        Live += Size;
+        Calls++;
+        return Memory::Heap().Allocate(Size, Align);
+    }
+
+    void Deallocate(void* Ptr, U64 Size, U64 Align) override
+    {
+        Live -= Size;
+        Memory::Heap().Deallocate(Ptr, Size, Align);
+    }
+
+    void* Reallocate(void* Ptr, U64 OldSize, U64 NewSize, U64 Align) override
+    {
+        Live += NewSize - OldSize;
+        Calls++;
+        return Memory::Heap().Reallocate(Ptr, OldSize, NewSize, Align);
+    }
+
+    U64 Live = 0;
+    U64 Calls = 0;
+};
+
+void Heap()
+{
+    Memory::Allocator& Heap = Memory::Heap();
+    TEST(!Heap.Scoped);
+
+    Byte* Plain = (Byte*)Heap.Allocate(100);
+    TEST(((U64)Plain % Memory::DefaultAlign) == 0);
+    Memory::Set(Plain, 3, 100);
+
+    Plain = (Byte*)Heap.Reallocate(Plain, 100, 10000);
+    TEST(Plain[0] == 3 && Plain[99] == 3);
+    Heap.Deallocate(Plain, 10000);
+
+    //bigger alignments than malloc gives, growing keeps them
+    Byte* Aligned = (Byte*)Heap.Allocate(100, 4096);
+    TEST(((U64)Aligned % 4096) == 0);
+    Memory::Set(Aligned, 5, 100);
+
+    Aligned = (Byte*)Heap.Reallocate(Aligned, 100, 5000, 4096);
+    TEST(((U64)Aligned % 4096) == 0);
+    TEST(Aligned[0] == 5 && Aligned[99] == 5);
+    Heap.Deallocate(Aligned, 5000, 4096);
+
+    void* Nothing = Heap.Allocate(0);
+    TEST(Nothing != nullptr);
+    Heap.Deallocate(Nothing, 0);
+
+    U64* Made = Heap.New<U64>(7);
+    TEST(*Made == 7);
+    Heap.Delete(Made);
+}
+
+void Containers()
+{
+    Counting Counter;
+    TEST(!Counter.Scoped);
+
+    {
+        Array<String> Names(Counter);
+        TEST(Names.Allocator() == &Counter);
+
+        for(U32 I = 0; I < 200; I++)
+            Names.Append(String(StringView("name"), Counter));
+
+        TEST(Names.Len() == 200 && Names[199] == "name");
+
+        String Text(Counter);
+        for(U32 I = 0; I < 100; I++)
+            Text += "abc";
+
+        TEST(Text.Len() == 300);
+        TEST(Text.Allocator() == &Counter);
+
+        Map<U32, String> Labels(Counter);
+        TEST(Labels.Allocator() == &Counter);
+
+        for(U32 I = 0; I < 500; I++)
+            Labels.Add(I, "label");
+
+        TEST(Labels.Remove(5));
+        TEST(Labels.Get(6, "") == "label");
+
+        Block<U32, 64> Numbers(Counter);
+        TEST(Numbers.Allocator() == &Counter);
+        Numbers.Wipe();
+        Numbers[63] = 5;
+
+        Binary Data(Counter);
+        TEST(Data.Allocator() == &Counter);
+
+        for(U32 I = 0; I < 1000; I++)
+            Data.Write<U32>(I);
+
+        Data.Seek(4 * 500);
+        TEST(Data.Read<U32>() == 500);
+        Data.Cleanup();
+
+        TEST(Counter.Live > 0);
+    }
+
+    //everything went back through the allocator
+    TEST(Counter.Live == 0);
+    TEST(Counter.Calls > 0);
+
+    //default containers never touch an allocator
+    Array<U32> Plain;
+    String Text = "text";
+    Map<U32, U32> Counts;
+    TEST(Plain.Allocator() == nullptr);
+    TEST(Text.Allocator() == nullptr);
+    TEST(Counts.Allocator() == nullptr);
+}
+
+void Scoped()
+{
+    //arenas are allocators too and skip walking nodes that dont need destroying
+    Memory::Arena Scratch;
+    TEST(Scratch.Scoped);
+
+    Memory::Allocator& Any = Scratch;
+    void* First = Any.Allocate(16, 16);
+    TEST(Scratch.Used() == 16);
+    Any.Deallocate(First, 16, 16);
+    TEST(Scratch.Used() == 0);
+
+    Map<U32, U32> Counts(Scratch);
+    for(U32 I = 0; I < 1000; I++)
+        Counts[I % 100] += 1;
+
+    TEST(Counts.Get(99, 0) == 10);
+
+    Block<U64, 16> Numbers(Scratch);
+    Numbers.Wipe();
+    TEST(Numbers[15] == 0);
+}
+
+int main()
+{
+    Heap();
+    Containers();
+    Scoped();
+}
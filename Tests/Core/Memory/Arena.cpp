@@ -0,0 +1,204 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/Arena.h>
+#include <Core/Collections/Map.h>
+#include <Core/Collections/SharedString.h>
+
+using namespace Cthulhu;
+
+void Bumping()
+{
+    Memory::Arena Scratch(256);
+    TEST(Scratch.Used() == 0);
+    TEST(Scratch.Reserved() == 0);
+
+    Byte* First = (Byte*)Scratch.Allocate(10, 1);
+    Byte* Second = (Byte*)Scratch.Allocate(10, 1);
+    TEST(Second == First + 10);
+    TEST(Scratch.Used() == 20);
+
+    //alignment pads from wherever the cursor is
+    U64* Aligned = (U64*)Scratch.Allocate(8, 64);
+    TEST(((U64)Aligned % 64) == 0);
+
+    //bigger than a chunk gets its own and everything still adds up
+    Byte* Big = (Byte*)Scratch.Allocate(10000, 1);
+    Memory::Set(Big, 1, 10000);
+    TEST(Scratch.Reserved() > 10000);
+
+    //the newest allocation grows in place
+    Byte* Small = (Byte*)Scratch.Allocate(16, 1);
+    Byte* Grown = (Byte*)Scratch.Reallocate(Small, 16, 64, 1);
+    TEST(Grown == Small);
+
+    //anything older moves and keeps its data
+    Memory::Set(First, 7, 10);
+    Byte* Moved = (Byte*)Scratch.Reallocate(First, 10, 5000, 1);
+    TEST(Moved != First);
+    TEST(Moved[0] == 7 && Moved[9] == 7);
+
+    //the newest allocation can be given back
+    const U64 Before = Scratch.Used();
+    void* Temp = Scratch.Allocate(32, 1);
+    Scratch.Deallocate(Temp, 32);
+    TEST(Scratch.Used() == Before);
+
+    //lots of small allocations over many chunks
+    for(U32 I = 0; I < 10000; I++)
+    {
+        U32* Item = Scratch.New<U32>(I);
+        TEST(*Item == I);
+        TEST(((U64)Item % alignof(U32)) == 0);
+    }
+
+    U64* Zeros = Scratch.NewArray<U64>(100);
+    for(U32 I = 0; I < 100; I++)
+        TEST(Zeros[I] == 0);
+
+    const U64 Reserved = Scratch.Reserved();
+    Scratch.Reset();
+    TEST(Scratch.Used() == 0);
+    TEST(Scratch.Reserved() > 0 && Scratch.Reserved() < Reserved);
+
+    //the kept chunk is reused
+    Scratch.Allocate(16, 1);
+    TEST(Scratch.Used() == 16);
+}
+
+void Marks()
+{
+    Memory::Arena Scratch(128);
+
+    const Memory::ArenaMark Start = Scratch.Mark();
+
+    Scratch.Allocate(64, 1);
+    const Memory::ArenaMark Middle = Scratch.Mark();
+    const U64 UsedAtMiddle = Scratch.Used();
+
+    for(U32 I = 0; I < 100; I++)
+        Scratch.Allocate(100, 8);
+
+    TEST(Scratch.Used() > UsedAtMiddle);
+
+    Scratch.Rewind(Middle);
+    TEST(Scratch.Used() == UsedAtMiddle);
+    TEST(Scratch.Reserved() == 128);
+
+    Scratch.Rewind(Start);
+    TEST(Scratch.Used() == 0);
+    TEST(Scratch.Reserved() == 0);
+
+    //still usable after rewinding everything
+    TEST(Scratch.Allocate(8) != nullptr);
+}
+
+void Containers()
+{
+    Memory::Arena Scratch;
+
+    {
+        Array<U32> Numbers(Scratch);
+        TEST(Numbers.Allocator() == &Scratch);
+
+        for(U32 I = 0; I < 1000; I++)
+            Numbers.Append(I);
+
+        TEST(Numbers.Len() == 1000);
+        TEST(Numbers[999] == 999);
+
+        //copies go to the heap so they can outlive the arena
+        Array<U32> Copy = Numbers;
+        TEST(Copy.Allocator() == nullptr);
+        TEST(Copy.Len() == 1000 && Copy[500] == 500);
+
+        String Text(Scratch);
+        TEST(Text.Allocator() == &Scratch);
+        TEST(Text == "");
+
+        for(U32 I = 0; I < 100; I++)
+            Text += "abc";
+
+        TEST(Text.Len() == 300);
+        TEST(Text.StartsWith("abcabc"));
+
+        Text.Push('>');
+        TEST(Text[0] == '>');
+        Text.Cut(1);
+        TEST(Text.Len() == 300 && Text[0] == 'a');
+
+        Text = String("a string long enough to need a new allocation from the arena so the old one is left behind");
+        TEST(Text.Allocator() == &Scratch);
+        TEST(Text.Len() == 90);
+
+        String Named(StringView("named"), Scratch);
+        TEST(Named == "named");
+
+        //a heap copy of arena text
+        String HeapCopy = Named;
+        TEST(HeapCopy.Allocator() == nullptr);
+        TEST(HeapCopy == "named");
+
+        //shared strings copy arena text rather than taking it
+        SharedString Shared = static_cast<String&&>(Named);
+        TEST(Shared.View() == "named");
+
+        //strings inside an arena array using the arena as well
+        Array<String> Names(Scratch);
+        for(U32 I = 0; I < 100; I++)
+            Names.Append(String(StringView("name"), Scratch));
+
+        TEST(Names.Len() == 100 && Names[99] == "name");
+
+        Map<U32, U32> Counts(Scratch);
+        TEST(Counts.Allocator() == &Scratch);
+
+        for(U32 I = 0; I < 2000; I++)
+            Counts[I % 500] += 1;
+
+        TEST(Counts.Get(0, 0) == 4);
+        TEST(Counts.Get(499, 0) == 4);
+        TEST(Counts.Get(500, 0) == 0);
+
+        Map<String, String> Labels(Scratch);
+        Labels.Add("key", "value");
+        Labels.Add("key", "other");
+        TEST(Labels.Get("key", "") == "other");
+    }
+
+    TEST(Scratch.Used() > 0);
+    Scratch.Reset();
+    TEST(Scratch.Used() == 0);
+
+    //heap maps still replace values and free their nodes
+    Map<U32, String> Heap;
+    for(U32 I = 0; I < 1000; I++)
+        Heap.Add(I % 300, Utils::ToString((I64)I));
+
+    TEST(Heap.Get(0, "") == "900");
+    TEST(Heap.Get(299, "") == "899");
+}
+
+int main()
+{
+    Bumping();
+    Marks();
+    Containers();
+}
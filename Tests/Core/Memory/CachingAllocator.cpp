@@ -0,0 +1,238 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/CachingAllocator.h>
+#include <Core/Memory/Memory.h>
+
+using namespace Cthulhu;
+
+U64 State = 0x9E3779B97F4A7C15ULL;
+
+U32 Random(U32 Limit)
+{
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return (U32)(State % Limit);
+}
+
+void Sizes()
+{
+    //every small size and a few big ones, each one filled so overlaps show up
+    Byte* Blocks[3000];
+    U32 Lengths[3000];
+
+    for(U32 I = 0; I < 3000; I++)
+    {
+        Lengths[I] = I < 2000 ? I * 17 : 40000 + I * 100;
+        Blocks[I] = (Byte*)Memory::CachedAlloc(Lengths[I]);
+
+        TEST(Blocks[I] != nullptr);
+        TEST(((U64)Blocks[I] % 16) == 0);
+        TEST(Memory::CachedSize(Blocks[I]) >= Lengths[I]);
+
+        Memory::Set(Blocks[I], (int)(I & 0xFF), Lengths[I]);
+    }
+
+    for(U32 I = 0; I < 3000; I++)
+    {
+        if(Lengths[I] != 0)
+            TEST(Blocks[I][0] == (Byte)(I & 0xFF) && Blocks[I][Lengths[I] - 1] == (Byte)(I & 0xFF));
+
+        Memory::CachedFree(Blocks[I]);
+    }
+
+    Memory::CachedFree(nullptr);
+}
+
+void Reallocating()
+{
+    Byte* Data = (Byte*)Memory::CachedRealloc(nullptr, 10);
+
+    for(U32 I = 0; I < 10; I++)
+        Data[I] = (Byte)I;
+
+    //through small classes and into big spans then back down
+    for(U32 Size = 10; Size < 200000; Size *= 3)
+    {
+        Data = (Byte*)Memory::CachedRealloc(Data, Size);
+        TEST(Data[9] == 9);
+    }
+
+    Data = (Byte*)Memory::CachedRealloc(Data, 20);
+    TEST(Data[0] == 0 && Data[9] == 9);
+
+    TEST(Memory::CachedRealloc(Data, 0) == nullptr);
+}
+
+void Releasing()
+{
+    //big spans that are all freed at once end up given back
+    void* Big[64];
+
+    for(U32 I = 0; I < 64; I++)
+    {
+        Big[I] = Memory::CachedAlloc(1024 * 1024);
+        Memory::Set((Byte*)Big[I], 1, 1024 * 1024);
+    }
+
+    const Memory::CachedStats Before = Memory::CachedAllocStats();
+    TEST(Before.Mapped >= 64ULL * 1024 * 1024);
+
+    for(U32 I = 0; I < 64; I++)
+        Memory::CachedFree(Big[I]);
+
+    //freeing this much goes over the limit and some of it is released straight away
+    const Memory::CachedStats After = Memory::CachedAllocStats();
+    TEST(After.Released > 0);
+    TEST(After.Free <= 32ULL * 1024 * 1024);
+
+    Memory::ReleaseFreeMemory();
+    TEST(Memory::CachedAllocStats().Free == 0);
+
+    //released pages are handed out again instead of mapping more
+    Byte* Again = (Byte*)Memory::CachedAlloc(1024 * 1024);
+    Memory::Set(Again, 2, 1024 * 1024);
+    TEST(Again[1024 * 1024 - 1] == 2);
+    Memory::CachedFree(Again);
+
+    TEST(Memory::CachedAllocStats().Mapped == After.Mapped);
+}
+
+constexpr U32 ThreadCount = 8;
+constexpr U32 Rounds = 200000;
+
+struct Handoff
+{
+    Byte* Blocks[1024];
+    U32 Sizes[1024];
+};
+
+Handoff Shared[ThreadCount];
+
+void* Worker(void* Arg)
+{
+    const U64 Index = (U64)Arg;
+    U64 Seed = Index * 7919 + 1;
+
+    Byte* Live[256] = {};
+    U32 Sizes[256] = {};
+
+    for(U32 I = 0; I < Rounds; I++)
+    {
+        Seed ^= Seed << 13;
+        Seed ^= Seed >> 7;
+        Seed ^= Seed << 17;
+
+        const U32 Slot = (U32)(Seed % 256);
+
+        if(Live[Slot] != nullptr)
+        {
+            if(Live[Slot][0] != (Byte)Slot || Live[Slot][Sizes[Slot] - 1] != (Byte)Slot)
+                exit(2);
+
+            Memory::CachedFree(Live[Slot]);
+        }
+
+        Sizes[Slot] = 1 + (U32)((Seed >> 20) % ((Seed & 7) == 0 ? 40000 : 512));
+        Live[Slot] = (Byte*)Memory::CachedAlloc(Sizes[Slot]);
+        Memory::Set(Live[Slot], (int)Slot, Sizes[Slot]);
+    }
+
+    for(U32 I = 0; I < 256; I++)
+        Memory::CachedFree(Live[I]);
+
+    //leave some for the next thread to free
+    for(U32 I = 0; I < 1024; I++)
+    {
+        Shared[Index].Sizes[I] = 1 + I % 300;
+        Shared[Index].Blocks[I] = (Byte*)Memory::CachedAlloc(Shared[Index].Sizes[I]);
+        Memory::Set(Shared[Index].Blocks[I], (int)Index, Shared[Index].Sizes[I]);
+    }
+
+    return nullptr;
+}
+
+void* Collector(void* Arg)
+{
+    const U64 Index = ((U64)Arg + 1) % ThreadCount;
+
+    for(U32 I = 0; I < 1024; I++)
+    {
+        if(Shared[Index].Blocks[I][Shared[Index].Sizes[I] - 1] != (Byte)Index)
+            exit(3);
+
+        Memory::CachedFree(Shared[Index].Blocks[I]);
+    }
+
+    return nullptr;
+}
+
+void Threads()
+{
+    pthread_t Handles[ThreadCount];
+
+    for(U64 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Worker, (void*)I);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+
+    for(U64 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Collector, (void*)I);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+}
+
+void Random()
+{
+    //the same churn on one thread with lots of live memory
+    Byte* Live[4096] = {};
+    U32 Sizes[4096] = {};
+
+    for(U32 I = 0; I < 500000; I++)
+    {
+        const U32 Slot = Random(4096);
+
+        if(Live[Slot] != nullptr)
+        {
+            TEST(Live[Slot][Sizes[Slot] - 1] == (Byte)Slot);
+            Memory::CachedFree(Live[Slot]);
+        }
+
+        Sizes[Slot] = 1 + Random(Random(10) == 0 ? 100000 : 1000);
+        Live[Slot] = (Byte*)Memory::CachedAlloc(Sizes[Slot]);
+        Memory::Set(Live[Slot], (int)Slot, Sizes[Slot]);
+    }
+
+    for(U32 I = 0; I < 4096; I++)
+        Memory::CachedFree(Live[I]);
+}
+
+int main()
+{
+    Sizes();
+    Reallocating();
+    Releasing();
+    Threads();
+    Random();
+}
@@ -0,0 +1,175 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/FrameAllocator.h>
+#include <Core/Collections/Array.h>
+#include <Core/Collections/CthulhuString.h>
+
+using namespace Cthulhu;
+
+void Lifetimes()
+{
+    Memory::FrameAllocator& Frames = Memory::Frames();
+    Memory::NextFrame();
+
+    U64* First = (U64*)Frames.Allocate(sizeof(U64), alignof(U64));
+    *First = 42;
+
+    Memory::FramePtr<U64> Kept = First;
+    TEST(Kept.Live());
+    TEST(Frames.Stats().Used >= sizeof(U64));
+
+    //still there for the whole of the next frame
+    Memory::NextFrame();
+
+    U64* Second = (U64*)Frames.Allocate(sizeof(U64), alignof(U64));
+    *Second = 7;
+
+    TEST(Kept.Live());
+    TEST(*Kept == 42);
+    TEST(Second != First);
+    TEST(Frames.Stats().Used == sizeof(U64));
+
+    //the frame after that reuses the first buffer
+    Memory::NextFrame();
+    TEST(!Kept.Live());
+
+    U64* Third = (U64*)Frames.Allocate(sizeof(U64), alignof(U64));
+    TEST(Third == First);
+    TEST(*Second == 7);
+
+    //skipping frames throws both buffers away
+    Memory::NextFrame();
+    Memory::NextFrame();
+    Memory::NextFrame();
+    Frames.Allocate(16);
+    TEST(Frames.Stats().Used == 16);
+}
+
+void Containers()
+{
+    Memory::FrameAllocator& Frames = Memory::Frames();
+    Memory::NextFrame();
+
+    {
+        Array<U32> Scratch(Frames);
+
+        for(U32 I = 0; I < 100000; I++)
+            Scratch.Append(I);
+
+        TEST(Scratch[99999] == 99999);
+        TEST(Scratch.Allocator() == &Frames);
+
+        String Text(Frames);
+
+        for(U32 I = 0; I < 1000; I++)
+            Text += "frame";
+
+        TEST(Text.Len() == 5000);
+        TEST(Text.StartsWith("frameframe"));
+
+        TEST(Frames.Stats().Used >= 100000 * sizeof(U32) + 5000);
+        TEST(Frames.Stats().Committed >= 100000 * sizeof(U32));
+    }
+
+    //destroyed newest first so both gave their memory straight back
+    TEST(Frames.Stats().Used == 0);
+
+    //growing the newest allocation happens in place
+    Byte* Grown = (Byte*)Frames.Allocate(64);
+    TEST(Frames.Reallocate(Grown, 64, 4096) == Grown);
+
+    Frames.Deallocate(Grown, 4096);
+    TEST(Frames.Allocate(32) == Grown);
+
+    //more than a buffer holds spills onto the heap until the buffer resets
+    Byte* Big = (Byte*)Frames.Allocate(Memory::FrameBufferSize + 1);
+    Big[Memory::FrameBufferSize] = 1;
+    TEST(Frames.Stats().Used > Memory::FrameBufferSize);
+
+    Memory::NextFrame();
+    Memory::NextFrame();
+    TEST(Frames.Stats().Used == 0);
+}
+
+void HighWater()
+{
+    Memory::FrameAllocator& Frames = Memory::Frames();
+    Frames.ResetHighWater();
+    Memory::NextFrame();
+
+    Frames.Allocate(1000000, 64);
+    Memory::NextFrame();
+    Frames.Allocate(100);
+    Memory::NextFrame();
+    Frames.Allocate(100);
+
+    TEST(Frames.Stats().HighWater >= 1000000);
+    TEST(Frames.Stats().HighWater < 1000000 + 64);
+    TEST(Frames.HighWater() == Frames.Stats().HighWater);
+
+    Frames.ResetHighWater();
+    TEST(Frames.Stats().HighWater < 1000);
+}
+
+void* Worker(void* Amount)
+{
+    Memory::FrameAllocator& Frames = Memory::Frames();
+
+    //every thread has its own buffers
+    Array<U64> Local(Frames);
+
+    for(U64 I = 0; I < (U64)Amount; I++)
+        Local.Append(I);
+
+    return (void*)(Local[Local.Len() - 1] + 1);
+}
+
+void Threads()
+{
+    Memory::FrameAllocator& Frames = Memory::Frames();
+    Frames.ResetHighWater();
+
+    Frames.Allocate(10);
+
+    pthread_t Threads[4];
+    for(U64 I = 0; I < 4; I++)
+        pthread_create(&Threads[I], nullptr, Worker, (void*)(100000 * (I + 1)));
+
+    for(U64 I = 0; I < 4; I++)
+    {
+        void* Ret;
+        pthread_join(Threads[I], &Ret);
+        TEST((U64)Ret == 100000 * (I + 1));
+    }
+
+    //the biggest thread counts once it finishes even though this one used almost nothing
+    TEST(Frames.Stats().Used < 1000);
+    TEST(Frames.HighWater() >= 400000 * sizeof(U64));
+}
+
+int main()
+{
+    Lifetimes();
+    Containers();
+    HighWater();
+    Threads();
+}
@@ -0,0 +1,166 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/Pages.h>
+#include <Core/Memory/Memory.h>
+#include <Core/Memory/Binary.h>
+
+using namespace Cthulhu;
+
+void Aligned()
+{
+    for(size_t Align = 1; Align <= 64 * 1024; Align *= 2)
+    {
+        Byte* Block = Memory::AlignedAlloc<Byte>(100, Align);
+        TEST(Block != nullptr);
+        TEST(((U64)Block % Align) == 0);
+
+        Memory::Set(Block, 1, 100);
+        Memory::AlignedFree(Block);
+    }
+
+    Memory::AlignedFree((Byte*)nullptr);
+
+    //prefetching is only a hint so even null is fine
+    U64 Value = 5;
+    Memory::Prefetch(&Value);
+    Memory::Prefetch(&Value, Memory::PrefetchFor::Write);
+    Memory::Prefetch((U64*)nullptr);
+    TEST(Value == 5);
+}
+
+void Mapping()
+{
+    const U64 Page = Memory::PageSize();
+    TEST(Page >= 4096 && (Page & (Page - 1)) == 0);
+
+    Byte* Small = (Byte*)Memory::MapPages(10);
+    TEST(Small != nullptr);
+    TEST(((U64)Small % Page) == 0);
+
+    //fresh pages are zeroed and the whole rounded page can be used
+    TEST(Small[0] == 0 && Small[Page - 1] == 0);
+    Memory::Set(Small, 7, (U32)Page);
+    Memory::UnmapPages(Small, 10);
+
+    //huge pages fall back to normal ones but the mapping still lines up to them
+    const U64 Size = 3 * Memory::HugePageSize + 10;
+    Byte* Huge = (Byte*)Memory::MapPages(Size, Memory::PageFlags::HugePages | Memory::PageFlags::Populate);
+    TEST(Huge != nullptr);
+    TEST(((U64)Huge % Memory::HugePageSize) == 0);
+
+    Huge[0] = 1;
+    Huge[Size - 1] = 2;
+    TEST(Huge[4 * Memory::HugePageSize - 1] == 0);
+
+    //throwing the pages away leaves zeroes behind
+    Memory::Set(Huge, 9, (U32)Memory::HugePageSize);
+    TEST(Memory::Advise(Huge, Memory::HugePageSize, Memory::Advice::DontNeed));
+    TEST(Huge[0] == 0 && Huge[Memory::HugePageSize - 1] == 0);
+
+    TEST(Memory::Advise(Huge + 100, 10, Memory::Advice::Sequential));
+    TEST(Memory::Advise(Huge, Size, Memory::Advice::Random));
+    TEST(Memory::Advise(Huge, Size, Memory::Advice::WillNeed));
+    TEST(Memory::Advise(Huge, Size, Memory::Advice::Normal));
+
+    Memory::UnmapPages(Huge, Size, Memory::PageFlags::HugePages | Memory::PageFlags::Populate);
+    Memory::UnmapPages(nullptr, 100);
+}
+
+void Nodes()
+{
+    const U32 Count = Memory::NodeCount();
+    TEST(Count >= 1);
+    TEST(Memory::LocalNode() < Count);
+
+    //binding to the node we are on always works, even when there is only one
+    const U64 Size = 16 * Memory::PageSize();
+    Byte* Local = (Byte*)Memory::MapPages(Size, Memory::PageFlags::Populate, Memory::LocalNode());
+    TEST(Local != nullptr);
+    TEST(Local[Size - 1] == 0);
+
+    TEST(Memory::BindToNode(Local, Size, Memory::LocalNode()));
+    TEST(!Memory::BindToNode(Local, Size, Count));
+
+    Memory::UnmapPages(Local, Size, Memory::PageFlags::Populate);
+}
+
+void Containers()
+{
+    Memory::PageAllocator Huge(Memory::PageFlags::HugePages, Memory::LocalNode());
+
+    //small blocks come from the heap and big ones get pages
+    void* Small = Huge.Allocate(100);
+    TEST(Small != nullptr);
+    Huge.Deallocate(Small, 100);
+
+    Byte* Big = (Byte*)Huge.Allocate(Memory::PageAllocator::MinMapped);
+    TEST(((U64)Big % Memory::HugePageSize) == 0);
+    Big[0] = 3;
+
+    //growing inside the same huge page keeps the same pages
+    Byte* Same = (Byte*)Huge.Reallocate(Big, Memory::PageAllocator::MinMapped, 1024 * 1024);
+    TEST(Same == Big && Same[0] == 3);
+
+    Byte* Grown = (Byte*)Huge.Reallocate(Same, 1024 * 1024, 5 * 1024 * 1024);
+    TEST(Grown[0] == 3);
+
+    //and back down to the heap
+    Byte* Shrunk = (Byte*)Huge.Reallocate(Grown, 5 * 1024 * 1024, 10);
+    TEST(Shrunk[0] == 3);
+    Huge.Deallocate(Shrunk, 10);
+
+    //normal pages can be moved by the kernel rather than copied
+    Memory::PageAllocator Plain;
+    U64* Moved = (U64*)Plain.Allocate(1024 * 1024);
+
+    for(U32 I = 0; I < 1024 * 1024 / 8; I++)
+        Moved[I] = I;
+
+    Moved = (U64*)Plain.Reallocate(Moved, 1024 * 1024, 64 * 1024 * 1024);
+    TEST(Moved[1024 * 1024 / 8 - 1] == 1024 * 1024 / 8 - 1);
+    TEST(Moved[64 * 1024 * 1024 / 8 - 1] == 0);
+    Plain.Deallocate(Moved, 64 * 1024 * 1024);
+
+    //big containers opt in by taking the allocator
+    Array<U64> Table(Huge);
+
+    for(U32 I = 0; I < 100000; I++)
+        Table.Append(I);
+
+    TEST(Table[99999] == 99999);
+
+    Binary Data(Huge);
+
+    for(U32 I = 0; I < 100000; I++)
+        Data.Write<U32>(I);
+
+    Data.Seek(4 * 90000);
+    TEST(Data.Read<U32>() == 90000);
+    Data.Cleanup();
+}
+
+int main()
+{
+    Aligned();
+    Mapping();
+    Nodes();
+    Containers();
+}
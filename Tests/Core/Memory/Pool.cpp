@@ -0,0 +1,240 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/Pool.h>
+#include <Core/Memory/Arena.h>
+#include <Core/Collections/Map.h>
+
+using namespace Cthulhu;
+
+struct Thing
+{
+    U64 A;
+    U32 B;
+
+    static U32 Alive;
+
+    Thing(U64 InA, U32 InB) : A(InA), B(InB) { Alive++; }
+    ~Thing() { Alive--; }
+};
+
+U32 Thing::Alive = 0;
+
+void Slabs()
+{
+    Memory::SlabPool Blocks(24, 8, 1024);
+    TEST(Blocks.Stride() == 24);
+    TEST(Blocks.Reserved() == 0);
+
+    //tiny blocks still have room for the free list
+    Memory::SlabPool Tiny(1, 1);
+    TEST(Tiny.Stride() == sizeof(void*));
+
+    void* Items[1000];
+
+    for(U32 I = 0; I < 1000; I++)
+    {
+        Items[I] = Blocks.Alloc();
+        TEST(((U64)Items[I] % 8) == 0);
+        Memory::Set((Byte*)Items[I], (int)(I & 0xFF), 24);
+    }
+
+    TEST(Blocks.Used() == 1000);
+    TEST(Blocks.Reserved() >= 24 * 1000);
+
+    //nothing overlaps
+    for(U32 I = 0; I < 1000; I++)
+        TEST(((Byte*)Items[I])[23] == (Byte)(I & 0xFF));
+
+    //the block just freed is the next one handed out
+    Blocks.Free(Items[500]);
+    TEST(Blocks.Alloc() == Items[500]);
+
+    const U64 Reserved = Blocks.Reserved();
+
+    for(U32 I = 0; I < 1000; I++)
+        Blocks.Free(Items[I]);
+
+    TEST(Blocks.Used() == 0);
+
+    //empty slabs go back apart from the one being used and a spare
+    TEST(Blocks.Reserved() < Reserved);
+    TEST(Blocks.Reserved() <= 2 * 1024);
+
+    //and churn afterwards doesnt grow anything
+    for(U32 I = 0; I < 10000; I++)
+        Blocks.Free(Blocks.Alloc());
+
+    TEST(Blocks.Reserved() <= 2 * 1024);
+
+    //a pool with blocks still out frees all its slabs, asan will complain if it doesnt
+    Memory::Pool<Thing> Things;
+
+    for(U32 I = 0; I < 2000; I++)
+    {
+        Thing* Made = Things.New(I, I * 2);
+        TEST(Made->A == I && Made->B == I * 2);
+
+        if(I % 3 == 0)
+            Things.Delete(Made);
+    }
+
+    TEST(Thing::Alive == 2000 - 667);
+    TEST(Things.Used() == 2000 - 667);
+}
+
+void Shared()
+{
+    //every size up to the biggest class and some bigger ones
+    for(U32 Size = 0; Size < 400; Size += 7)
+    {
+        Byte* Block = (Byte*)Memory::PoolAlloc(Size);
+        TEST(((U64)Block % Memory::DefaultAlign) == 0);
+        Memory::Set(Block, 1, Size);
+        Memory::PoolFree(Block, Size);
+    }
+
+    Memory::PoolFree(nullptr, 16);
+
+    Thing* Made = Memory::PoolNew<Thing>(5, 6);
+    TEST(Made->A == 5 && Made->B == 6);
+    Memory::PoolDelete(Made);
+    TEST(Thing::Alive == 2000 - 667);
+}
+
+constexpr U32 ThreadCount = 4;
+constexpr U32 PerThread = 20000;
+
+//every thread frees the blocks the thread before it made
+Thing* Handoff[ThreadCount][PerThread];
+
+void* Maker(void* Arg)
+{
+    const U64 Index = (U64)Arg;
+
+    for(U32 I = 0; I < PerThread; I++)
+        Handoff[Index][I] = Memory::PoolNew<Thing>(Index, I);
+
+    return nullptr;
+}
+
+void* Freer(void* Arg)
+{
+    const U64 Index = ((U64)Arg + 1) % ThreadCount;
+
+    for(U32 I = 0; I < PerThread; I++)
+    {
+        if(Handoff[Index][I]->A != Index || Handoff[Index][I]->B != I)
+            exit(2);
+
+        Memory::PoolDelete(Handoff[Index][I]);
+    }
+
+    //and some of its own that go back when the thread exits
+    for(U32 I = 0; I < 100; I++)
+        Memory::PoolDelete(Memory::PoolNew<Thing>(I, I));
+
+    return nullptr;
+}
+
+void Threads()
+{
+    const U32 Before = Thing::Alive;
+
+    pthread_t Handles[ThreadCount];
+
+    for(U64 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Maker, (void*)I);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+
+    for(U64 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Freer, (void*)I);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+
+    TEST(Thing::Alive == Before);
+}
+
+void Maps()
+{
+    Map<U32, String> Names;
+
+    for(U32 I = 0; I < 1000; I++)
+        Names.Add(I, Utils::ToString((I64)I));
+
+    TEST(Names.Remove(10));
+    TEST(!Names.Remove(10));
+    TEST(!Names.HasKey(10));
+    TEST(Names.HasKey(11) && Names.HasKey(161));
+
+    //the first, middle and last node of a chain
+    TEST(Names.Remove(0));
+    TEST(Names.Remove(151 * 3));
+    TEST(Names.Remove(151 * 6));
+    TEST(Names.Get(151, "") == "151");
+    TEST(Names.Get(151 * 5, "") == "755");
+
+    Map<U32, String> Copy = Names;
+    Names.Remove(11);
+    Names.Add(12, "twelve");
+
+    TEST(Copy.Get(11, "") == "11");
+    TEST(Copy.Get(12, "") == "12");
+    TEST(!Copy.HasKey(0));
+    TEST(Copy.Items().Len() == 996);
+
+    //churn through the same keys
+    for(U32 Round = 0; Round < 10; Round++)
+    {
+        for(U32 I = 0; I < 1000; I++)
+            Names.Remove(I);
+
+        TEST(Names.Items().Len() == 0);
+
+        for(U32 I = 0; I < 1000; I++)
+            Names[I] = "again";
+    }
+
+    TEST(Names.Get(999, "") == "again");
+
+    Memory::Arena Scratch;
+    Map<U32, U32> Counts(Scratch);
+    Counts.Add(1, 1);
+    Counts.Add(2, 2);
+    TEST(Counts.Remove(1));
+    TEST(Counts.Get(2, 0) == 2);
+
+    //copies of arena maps use the pools
+    Map<U32, U32> Heap = Counts;
+    TEST(Heap.Allocator() == nullptr);
+    TEST(Heap.Get(2, 0) == 2);
+}
+
+int main()
+{
+    Slabs();
+    Shared();
+    Threads();
+    Maps();
+}
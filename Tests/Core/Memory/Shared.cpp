@@ -0,0 +1,224 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/Shared.h>
+
+using namespace Cthulhu;
+
+struct Counted
+{
+    static I32 Alive;
+
+    U64 Value;
+
+    Counted(U64 InValue = 0) : Value(InValue) { Alive++; }
+    virtual ~Counted() { Alive--; }
+};
+
+I32 Counted::Alive = 0;
+
+struct Derived : Counted
+{
+    Derived(U64 InValue) : Counted(InValue * 2) {}
+};
+
+struct Node : Sharable<Node>
+{
+    static I32 Alive;
+
+    U32 Id;
+
+    Node(U32 InId) : Id(InId) { Alive++; }
+    ~Node() { Alive--; }
+
+    Shared<Node> Self() { return SharedThis(); }
+};
+
+I32 Node::Alive = 0;
+
+struct Interface
+{
+    virtual ~Interface() {}
+};
+
+struct Connection : Interface, Sharable<Connection> {};
+
+void Owning()
+{
+    {
+        Shared<Counted> First = MakeShared<Counted>(5);
+        TEST(Counted::Alive == 1);
+        TEST(First->Value == 5);
+        TEST(First.Refs() == 1);
+
+        Shared<Counted> Second = First;
+        TEST(First.Refs() == 2);
+        TEST(Second == First);
+
+        //moving never touches the count
+        Shared<Counted> Third = (Shared<Counted>&&)Second;
+        TEST(!Second.Valid());
+        TEST(Third.Refs() == 2);
+
+        Third.Reset();
+        TEST(First.Refs() == 1);
+        TEST(Counted::Alive == 1);
+
+        Shared<Counted> Adopted(new Counted(9));
+        First = Adopted;
+        TEST(Counted::Alive == 1);
+        TEST(First->Value == 9);
+        TEST(Adopted.Refs() == 2);
+
+        //a derived object can be held as its base
+        Shared<Counted> Base = MakeShared<Derived>(4);
+        TEST(Base->Value == 8);
+        TEST(Counted::Alive == 2);
+    }
+
+    TEST(Counted::Alive == 0);
+
+    Shared<Counted> Empty;
+    TEST(!Empty);
+    TEST(Empty.Refs() == 0);
+    Shared<Counted> AlsoEmpty = Empty;
+    TEST(AlsoEmpty.Get() == nullptr);
+
+    Shared<Byte> Raw = Shared<Byte>::Adopt<Freeer<Byte>>(Memory::Alloc<Byte>(64));
+    Raw.Get()[63] = 1;
+}
+
+void Watching()
+{
+    Weak<Counted> Watcher;
+    TEST(Watcher.Expired());
+    TEST(!Watcher.Lock());
+
+    {
+        Shared<Counted> Owner = MakeShared<Counted>(3);
+        Watcher = Owner;
+
+        TEST(!Watcher.Expired());
+        TEST(Owner.Refs() == 1);
+
+        Shared<Counted> Locked = Watcher.Lock();
+        TEST(Locked->Value == 3);
+        TEST(Owner.Refs() == 2);
+    }
+
+    //the object is gone even though the weak reference is still there
+    TEST(Counted::Alive == 0);
+    TEST(Watcher.Expired());
+    TEST(!Watcher.Lock().Valid());
+
+    Weak<Counted> Copy = Watcher;
+    TEST(Copy.Expired());
+
+    LocalShared<Counted> Local = MakeLocalShared<Counted>(1);
+    LocalWeak<Counted> LocalWatcher = Local;
+    TEST(LocalWatcher.Lock()->Value == 1);
+    Local.Reset();
+    TEST(LocalWatcher.Expired());
+    TEST(Counted::Alive == 0);
+}
+
+void Intrusive()
+{
+    {
+        Shared<Node> First = MakeShared<Node>(1);
+        TEST(First->Refs() == 1);
+
+        //the count is in the object so a Shared can be made from a plain pointer again
+        Node* Raw = First.Get();
+        Shared<Node> Second(Raw);
+        TEST(First.Refs() == 2);
+
+        Shared<Node> Third = Raw->Self();
+        TEST(Raw->Refs() == 3);
+
+        First.Reset();
+        Second.Reset();
+        TEST(Node::Alive == 1);
+        TEST(Third->Id == 1);
+    }
+
+    TEST(Node::Alive == 0);
+
+    Shared<Node> Made(new Node(2));
+    TEST(Made.Refs() == 1);
+
+    //copying the object doesnt copy the count
+    Shared<Node> Copy = MakeShared<Node>(*Made);
+    TEST(Copy.Refs() == 1);
+    TEST(Copy->Id == 2);
+
+#ifndef CTU_DEBUG
+    //the counts go with the object so a Weak through a base class watches nothing
+    Shared<Connection> Client = MakeShared<Connection>();
+    Shared<Interface> Base = Client;
+    Weak<Interface> Watcher = Base;
+    TEST(Watcher.Expired());
+    TEST(!Watcher.Lock());
+
+    Client.Reset();
+    Base.Reset();
+    TEST(Watcher.Expired());
+#endif
+}
+
+Shared<Counted> Common;
+
+void* Churn(void*)
+{
+    for(U32 I = 0; I < 100000; I++)
+    {
+        Shared<Counted> Mine = Common;
+        Weak<Counted> Watcher = Mine;
+        TEST(Watcher.Lock()->Value == 77);
+    }
+
+    return nullptr;
+}
+
+void Threads()
+{
+    Common = MakeShared<Counted>(77);
+
+    pthread_t Threads[4];
+    for(U32 I = 0; I < 4; I++)
+        pthread_create(&Threads[I], nullptr, Churn, nullptr);
+
+    for(U32 I = 0; I < 4; I++)
+        pthread_join(Threads[I], nullptr);
+
+    TEST(Common.Refs() == 1);
+
+    Common.Reset();
+    TEST(Counted::Alive == 0);
+}
+
+int main()
+{
+    Owning();
+    Watching();
+    Intrusive();
+    Threads();
+}
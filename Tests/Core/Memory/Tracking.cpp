@@ -0,0 +1,303 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Memory/Tracking.h>
+#include <Core/Memory/Memory.h>
+#include <Core/Collections/Map.h>
+#include <Core/Collections/Atom.h>
+#include <Core/Collections/Array.h>
+
+using namespace Cthulhu;
+
+Memory::Tag Textures("Textures");
+Memory::Tag Workers("Workers");
+
+bool Listed(const Memory::Tag& Which)
+{
+    for(const Memory::Tag* Item = Memory::FirstTag(); Item != nullptr; Item = Item->Next())
+    {
+        if(Item == &Which)
+            return true;
+    }
+
+    return false;
+}
+
+void Disabled()
+{
+    //the api is still there, it just doesnt do anything
+    Memory::TagScope Scope(Textures);
+
+    void* Block = Memory::TrackedAlloc(100);
+    TEST(Block != nullptr);
+    Memory::TrackedFree(Block);
+
+    TEST(Memory::FirstTag() == nullptr);
+    TEST(!Memory::Snapshot("/tmp/ctu-tracking-disabled.txt"));
+    TEST(Textures.Live() == 0);
+}
+
+void Scopes()
+{
+    const U64 Before = Memory::TrackedTotals().Live();
+
+    {
+        Memory::TagScope Scope(Textures);
+
+        Byte* Data = Memory::Alloc<Byte>(1000);
+        TEST(Textures.Live() == 1000);
+        TEST(Textures.Count() == 1);
+        TEST(Listed(Textures));
+
+        //growing keeps the tag that is active when it happens
+        Data = Memory::Realloc(Data, 3000);
+        TEST(Textures.Live() == 3000);
+        TEST(Textures.Peak() == 3000);
+
+        //an explicit tag beats the containers own tag
+        const U64 ArrayBefore = Memory::Tags::Array.Live();
+        Array<U64> Numbers;
+
+        for(U32 I = 0; I < 1000; I++)
+            Numbers.Append(I);
+
+        TEST(Memory::Tags::Array.Live() == ArrayBefore);
+        TEST(Textures.Live() >= 3000 + 1000 * sizeof(U64));
+
+        Memory::Free(Data);
+    }
+
+    TEST(Textures.Live() == 0);
+    TEST(Textures.Count() == 0);
+    TEST(Textures.Total() > 3000);
+    TEST(Memory::TrackedTotals().Live() == Before);
+
+    //scopes nest and put the outer tag back
+    {
+        Memory::TagScope Outer(Textures);
+
+        {
+            Memory::TagScope Inner(Workers);
+            //volatile so the optimiser cant drop the pair of calls
+            U64* volatile Short = new U64(5);
+            delete Short;
+            TEST(Workers.Total() == sizeof(U64));
+        }
+
+        U64* volatile Made = new U64(6);
+        TEST(Textures.Live() == sizeof(U64));
+        delete Made;
+    }
+}
+
+void Containers()
+{
+    //with no scope every container counts against its own tag
+    const U64 Arrays = Memory::Tags::Array.Live();
+    const U64 Strings = Memory::Tags::String.Live();
+    //map nodes come from the shared pools whose slabs are kept for the whole program
+    const U64 Maps = Memory::Tags::Map.Live() + Memory::Tags::Lifetime.Live();
+
+    {
+        Array<U32> Numbers;
+        String Text;
+        Map<U32, U32> Counts;
+
+        for(U32 I = 0; I < 2000; I++)
+        {
+            Numbers.Append(I);
+            Text += "abc";
+            Counts[I] = I;
+        }
+
+        TEST(Memory::Tags::Array.Live() > Arrays);
+        TEST(Memory::Tags::String.Live() >= Strings + 6000);
+        TEST(Memory::Tags::Map.Live() + Memory::Tags::Lifetime.Live() > Maps);
+        TEST(Listed(Memory::Tags::Array));
+    }
+
+    TEST(Memory::Tags::Array.Live() == Arrays);
+    TEST(Memory::Tags::String.Live() == Strings);
+
+    //memory that didnt come from Memory::Alloc or new can be recorded by hand
+    Byte Outside[64];
+    Memory::TrackAllocation(Outside, 64);
+    TEST(Memory::Tags::Untagged.Count() >= 1);
+    Memory::TrackFree(Outside);
+}
+
+void Snapshots()
+{
+    Memory::SetSampleThreshold(4096);
+
+    Memory::TagScope Scope(Textures);
+    Byte* Big = Memory::Alloc<Byte>(5000);
+    Byte* Small = Memory::Alloc<Byte>(100);
+
+    const char* Path = "/tmp/ctu-tracking-snapshot.txt";
+    TEST(Memory::Snapshot(Path));
+
+    FILE* In = fopen(Path, "r");
+    TEST(In != nullptr);
+
+    char Text[64 * 1024];
+    const size_t Len = fread(Text, 1, sizeof(Text) - 1, In);
+    Text[Len] = '\0';
+    fclose(In);
+    remove(Path);
+
+    //the tag table and a call stack for the big allocation but not the small one
+    TEST(strstr(Text, "Textures") != nullptr);
+    TEST(strstr(Text, "5000 bytes tagged Textures") != nullptr);
+    TEST(strstr(Text, "100 bytes tagged") == nullptr);
+
+    Memory::Free(Big);
+    Memory::Free(Small);
+
+    TEST(!Memory::Snapshot("/this/path/does/not/exist"));
+
+    Memory::SetSampleThreshold(1024 * 1024);
+}
+
+constexpr U32 ThreadCount = 4;
+constexpr U32 PerThread = 5000;
+
+U64* Handoff[ThreadCount][PerThread];
+
+void* Maker(void* Arg)
+{
+    const U64 Index = (U64)Arg;
+    Memory::TagScope Scope(Workers);
+
+    for(U32 I = 0; I < PerThread; I++)
+        Handoff[Index][I] = new U64(I);
+
+    return nullptr;
+}
+
+void* Freer(void* Arg)
+{
+    const U64 Index = ((U64)Arg + 1) % ThreadCount;
+
+    //freed with no scope but still comes off the tag it was made with
+    for(U32 I = 0; I < PerThread; I++)
+        delete Handoff[Index][I];
+
+    return nullptr;
+}
+
+void Threads()
+{
+    const U64 Before = Workers.Live();
+
+    pthread_t Handles[ThreadCount];
+
+    for(U64 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Maker, (void*)I);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+
+    TEST(Workers.Live() == Before + ThreadCount * PerThread * sizeof(U64));
+    TEST(Workers.Peak() >= Workers.Live());
+
+    for(U64 I = 0; I < ThreadCount; I++)
+        pthread_create(&Handles[I], nullptr, Freer, (void*)I);
+
+    for(U32 I = 0; I < ThreadCount; I++)
+        pthread_join(Handles[I], nullptr);
+
+    TEST(Workers.Live() == Before);
+}
+
+//made before the tracker exists and only given memory later so it is destroyed after the tracker is set up
+Array<U64> Kept;
+
+//what a normal program leaves behind, pools, atoms and globals, none of it is a leak
+void Clean()
+{
+    Map<String, U32> Names;
+    Names["first"] = 1;
+
+    Atom Name = "tracked";
+    (void)Name;
+
+    for(U64 I = 0; I < 1000; I++)
+        Kept.Append(I);
+}
+
+//run this program again and collect what it writes to stderr
+String RunSelf(const char* Self, const char* Mode)
+{
+    char Command[512];
+    snprintf(Command, sizeof(Command), "%s %s 2>&1 >/dev/null", Self, Mode);
+
+    FILE* Child = popen(Command, "r");
+    TEST(Child != nullptr);
+
+    String Ret;
+    char Buffer[256];
+
+    while(U64 Read = fread(Buffer, 1, sizeof(Buffer), Child))
+        Ret += String(Buffer, (U32)Read);
+
+    TEST(pclose(Child) == 0);
+
+    return Ret;
+}
+
+void ExitReport(const char* Self)
+{
+    TEST(RunSelf(Self, "clean").Len() == 0);
+    TEST(RunSelf(Self, "leak").Find("still live").Valid());
+}
+
+int main(int Argc, char** Argv)
+{
+    if(!Memory::TrackingEnabled)
+    {
+        Disabled();
+        return 0;
+    }
+
+    if(Argc > 1)
+    {
+        Clean();
+
+        if(strcmp(Argv[1], "leak") == 0)
+        {
+            U64* volatile Lost = new U64[100];
+            (void)Lost;
+        }
+
+        return 0;
+    }
+
+    ExitReport(Argv[0]);
+
+    Memory::SetLeakReport(false);
+
+    Scopes();
+    Containers();
+    Snapshots();
+    Threads();
+}
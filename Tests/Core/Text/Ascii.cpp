@@ -0,0 +1,148 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Ascii.h>
+#include <Core/Collections/CthulhuString.h>
+#include <Core/Collections/Option.h>
+
+using namespace Cthulhu;
+
+void Classify()
+{
+    //the c library agrees for every ascii character in the C locale
+    for(int I = 0; I < 128; I++)
+    {
+        const char C = (char)I;
+
+        TEST(Utils::IsSpace(C) == !!isspace(I));
+        TEST(Utils::IsUpper(C) == !!isupper(I));
+        TEST(Utils::IsLower(C) == !!islower(I));
+        TEST(Utils::IsNum(C) == !!isdigit(I));
+        TEST(Utils::IsHex(C) == !!isxdigit(I));
+        TEST(Utils::IsAlpha(C) == !!isalpha(I));
+        TEST(Utils::IsAlnum(C) == !!isalnum(I));
+        TEST(Utils::IsPunctuation(C) == !!ispunct(I));
+        TEST(Utils::ToUpper(C) == toupper(I));
+        TEST(Utils::ToLower(C) == tolower(I));
+    }
+
+    //nothing past ascii is classified
+    for(int I = 128; I < 256; I++)
+    {
+        TEST(!Utils::IsPrintable((char)I));
+        TEST(!Utils::IsAlpha((char)I));
+        TEST(Utils::ToUpper((char)I) == (char)I);
+    }
+
+    TEST(Utils::IsNewline('\r') && Utils::IsNewline('\n') && !Utils::IsNewline(' '));
+    TEST(Utils::IsPrintable('\t') && !Utils::IsPrintable('\0'));
+    TEST(Utils::IsEOF('\0') && Utils::IsEOF((char)-1));
+
+    static_assert(Utils::IsAlpha('q') && !Utils::IsAlpha('1'), "classifiers should work at compile time");
+    static_assert(Utils::ToUpper('q') == 'Q', "case mapping should work at compile time");
+}
+
+void Case()
+{
+    //long enough to go through the vector loop and the tail, with utf-8 that has to be left alone
+    const char* Mixed = "Hello, World! The Quick Brown Fox @[`{ caf\xc3\xa9 Z";
+    const U32 Len = (U32)strlen(Mixed);
+
+    char Upper[64], Lower[64];
+    Utils::ToUpper(Mixed, Upper, Len);
+    Utils::ToLower(Mixed, Lower, Len);
+
+    for(U32 I = 0; I < Len; I++)
+    {
+        TEST(Upper[I] == ((unsigned char)Mixed[I] < 128 ? toupper(Mixed[I]) : Mixed[I]));
+        TEST(Lower[I] == ((unsigned char)Mixed[I] < 128 ? tolower(Mixed[I]) : Mixed[I]));
+    }
+
+    String Text = Mixed;
+    TEST(Text.Upper() == String(Upper, Len));
+    TEST(Text.Lower() == String(Lower, Len));
+    TEST(Text == Mixed);
+
+    Text.ToUpper();
+    TEST(Text == String(Upper, Len));
+
+    TEST(String("").Upper() == "");
+}
+
+void NoCase()
+{
+    TEST(Utils::EqualsNoCase("Content-Length", "content-LENGTH"));
+    TEST(!Utils::EqualsNoCase("Content-Length", "content-lengtx"));
+    TEST(!Utils::EqualsNoCase("abc", "abcd"));
+    TEST(Utils::EqualsNoCase("", ""));
+
+    //@ and ` are next to the letters and shouldnt match them
+    TEST(!Utils::EqualsNoCase("@", "`"));
+    TEST(!Utils::EqualsNoCase("[[[[[[[[[[[[[[[[[", "{{{{{{{{{{{{{{{{{"));
+
+    TEST(Utils::EqualsNoCase("THE QUICK BROWN FOX JUMPS", "the quick brown fox jumps"));
+    TEST(!Utils::EqualsNoCase("THE QUICK BROWN FOX JUMPS", "the quick brown fox jumpz"));
+    TEST(!Utils::EqualsNoCase("THE QUICK BROWN FOX JUMPS", "thx quick brown fox jumps"));
+
+    TEST(Utils::CompareNoCase("abc", "ABC") == 0);
+    TEST(Utils::CompareNoCase("abc", "ABD") < 0);
+    TEST(Utils::CompareNoCase("B", "a") > 0);
+    TEST(Utils::CompareNoCase("ab", "ABC") < 0);
+    TEST(Utils::CompareNoCase("abc", "AB") > 0);
+
+    TEST(Utils::HashNoCase("Accept") == Utils::HashNoCase("ACCEPT"));
+    TEST(Utils::HashNoCase("Accept") != Utils::HashNoCase("Accent"));
+
+    String Header = "Host";
+    TEST(Header.EqualsNoCase("host"));
+    TEST(Header.CompareNoCase("HOSTS") < 0);
+}
+
+void Trimming()
+{
+    String Line = "  key = value\r\n";
+
+    TEST(Line.TrimAny() == "key = value");
+    TEST(Line.TrimEnd() == "  key = value");
+    TEST(Line.TrimStart(" k") == "ey = value\r\n");
+    TEST(Line.TrimAny().Data() == Line.CStr() + 2);
+
+    TEST(Utils::TrimAny("--[x]--", "-[]") == "x");
+    TEST(Utils::TrimAny("    ").IsEmpty());
+    TEST(Utils::TrimAny("").IsEmpty());
+    TEST(Utils::TrimAny("x") == "x");
+
+    static_assert(Utils::TrimAny(" a ") == "a", "trimming should work at compile time");
+
+    //the old pattern trim is unchanged
+    TEST(String("ababxab").Trim("ab") == "x");
+
+    TEST(Utils::ParseInt(" \t42\n").Get() == 42);
+}
+
+int main()
+{
+    Classify();
+    Case();
+    NoCase();
+    Trimming();
+}
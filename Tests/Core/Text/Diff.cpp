@@ -0,0 +1,263 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Diff.h>
+#include <Core/Text/Scan.h>
+
+using namespace Cthulhu;
+
+U64 State = 0x2545F4914F6CDD1DULL;
+
+U32 Random(U32 Limit)
+{
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return (U32)(State % Limit);
+}
+
+//applying the script to Old has to give New and every kept item has to match
+template<typename T>
+U32 Check(const Array<T>& Old, const Array<T>& New, const Array<Edit>& Edits)
+{
+    U32 I = 0, J = 0, Cost = 0;
+
+    for(const Edit& Current : Edits)
+    {
+        TEST(Current.Old == I && Current.New == J);
+
+        if(Current.Kind == EditKind::Keep)
+        {
+            for(U32 N = 0; N < Current.Length; N++)
+                TEST(Old[I + N] == New[J + N]);
+
+            I += Current.Length;
+            J += Current.Length;
+        }
+        else if(Current.Kind == EditKind::Delete)
+        {
+            I += Current.Length;
+            Cost += Current.Length;
+        }
+        else
+        {
+            J += Current.Length;
+            Cost += Current.Length;
+        }
+    }
+
+    TEST(I == Old.Len() && J == New.Len());
+
+    return Cost;
+}
+
+//the shortest script has Old + New - 2 * lcs edits
+U32 Shortest(const Array<I64>& Old, const Array<I64>& New)
+{
+    const U32 W = New.Len() + 1;
+    U32* Table = new U32[(Old.Len() + 1) * W]();
+
+    for(U32 I = 1; I <= Old.Len(); I++)
+    {
+        for(U32 J = 1; J <= New.Len(); J++)
+        {
+            const U32 Up = Table[(I - 1) * W + J], Left = Table[I * W + J - 1];
+            Table[I * W + J] = Old[I - 1] == New[J - 1] ? Table[(I - 1) * W + J - 1] + 1 : (Up > Left ? Up : Left);
+        }
+    }
+
+    const U32 Ret = Old.Len() + New.Len() - (2 * Table[Old.Len() * W + New.Len()]);
+    delete[] Table;
+
+    return Ret;
+}
+
+void Scans()
+{
+    char Left[100], Right[100];
+
+    for(U32 I = 0; I < 100; I++)
+        Left[I] = Right[I] = (char)I;
+
+    TEST(Utils::CommonPrefix(Left, Right, 100) == 100);
+    TEST(Utils::CommonSuffix(Left, Right, 100) == 100);
+
+    for(U32 At = 0; At < 100; At++)
+    {
+        Right[At] = 'x';
+        TEST(Utils::CommonPrefix(Left, Right, 100) == At);
+        TEST(Utils::CommonSuffix(Left, Right, 100) == 99 - At);
+        Right[At] = Left[At];
+    }
+}
+
+void Arrays()
+{
+    Array<I64> Old = { 1, 2, 3, 4 };
+    Array<I64> New = { 1, 3, 4, 5 };
+
+    const Array<Edit> Edits = Utils::Diff(Old, New);
+    TEST(Edits.Len() == 4);
+    TEST(Edits[0].Kind == EditKind::Keep && Edits[0].Length == 1);
+    TEST(Edits[1].Kind == EditKind::Delete && Edits[1].Old == 1);
+    TEST(Edits[2].Kind == EditKind::Keep && Edits[2].Length == 2);
+    TEST(Edits[3].Kind == EditKind::Insert && Edits[3].New == 3);
+
+    TEST(Utils::Diff(Array<I64>(), Array<I64>()).Len() == 0);
+    TEST(Check(Array<I64>(), New, Utils::Diff(Array<I64>(), New)) == 4);
+
+    //random small sequences have to give the shortest script
+    for(U32 Round = 0; Round < 2000; Round++)
+    {
+        Array<I64> A, B;
+        const U32 Alphabet = 2 + Random(6);
+
+        for(U32 I = Random(40); I > 0; I--)
+            A.Append(Random(Alphabet));
+
+        for(U32 I = Random(40); I > 0; I--)
+            B.Append(Random(Alphabet));
+
+        TEST(Check(A, B, Utils::Diff(A, B, true)) == Shortest(A, B));
+        Check(A, B, Utils::Diff(A, B));
+    }
+
+    //inputs this different make the search give up on being minimal but it still has to be right
+    Array<I64> Big, Noise;
+    Big.Reserve(6000);
+    Noise.Reserve(6000);
+
+    for(U32 I = 0; I < 6000; I++)
+    {
+        Big.Append(Random(50));
+        Noise.Append(Random(50));
+    }
+
+    const U32 Cost = Check(Big, Noise, Utils::Diff(Big, Noise));
+    TEST(Cost >= Check(Big, Noise, Utils::Diff(Big, Noise, true)));
+
+    Array<String> Words = { "a", "b", "c" };
+    Array<String> Other = { "c", "b", "a" };
+    TEST(Check(Words, Other, Utils::Diff(Words, Other)) == 4);
+}
+
+void Text()
+{
+    TEST(Utils::UnifiedDiff("same\n", "same\n") == "");
+
+    //gaps wider than twice the context split the hunks
+    TEST(Utils::UnifiedDiff("1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n11\n12\n", "1\nTWO\n3\n4\n5\n6\n7\n8\n9\n10\n12\n", "a/x", "b/x") ==
+        "--- a/x\n"
+        "+++ b/x\n"
+        "@@ -1,5 +1,5 @@\n"
+        " 1\n"
+        "-2\n"
+        "+TWO\n"
+        " 3\n"
+        " 4\n"
+        " 5\n"
+        "@@ -8,5 +8,4 @@\n"
+        " 8\n"
+        " 9\n"
+        " 10\n"
+        "-11\n"
+        " 12\n");
+
+    //closer changes share a hunk
+    TEST(Utils::UnifiedDiff("1\n2\n3\n4\n5\n6\n7\n8\n", "1\nTWO\n3\n4\n5\n6\n7\n8\neight") ==
+        "--- a\n"
+        "+++ b\n"
+        "@@ -1,8 +1,9 @@\n"
+        " 1\n"
+        "-2\n"
+        "+TWO\n"
+        " 3\n"
+        " 4\n"
+        " 5\n"
+        " 6\n"
+        " 7\n"
+        " 8\n"
+        "+eight\n"
+        "\\ No newline at end of file\n");
+
+    //empty ranges name the line before them
+    TEST(Utils::UnifiedDiff("a\nb\nc\n", "a\nc\n", "a", "b", 0) == "--- a\n+++ b\n@@ -2 +1,0 @@\n-b\n");
+    TEST(Utils::UnifiedDiff("", "x\n") == "--- a\n+++ b\n@@ -0,0 +1 @@\n+x\n");
+    TEST(Utils::UnifiedDiff("x\ny\n", "x\nz\ny\n") == "--- a\n+++ b\n@@ -1,2 +1,3 @@\n x\n+z\n y\n");
+
+    //a last line that only differs by its newline is still a change
+    TEST(Utils::UnifiedDiff("x\ny", "x\ny\n") == "--- a\n+++ b\n@@ -1,2 +1,2 @@\n x\n-y\n\\ No newline at end of file\n+y\n");
+
+    //lines that share an ending still have to line up
+    TEST(Utils::UnifiedDiff("x\n", "yx\n") == "--- a\n+++ b\n@@ -1 +1 @@\n-x\n+yx\n");
+
+    //random line edits have to reproduce the new text
+    const char* Pieces[] = { "x", "yx", "", "xx", "y" };
+
+    for(U32 Round = 0; Round < 2000; Round++)
+    {
+        String A, B;
+
+        for(U32 I = Random(30); I > 0; I--)
+        {
+            A += Pieces[Random(5)];
+            A += '\n';
+        }
+
+        for(U32 I = Random(30); I > 0; I--)
+        {
+            B += Pieces[Random(5)];
+            B += '\n';
+        }
+
+        //sometimes leave the last line without a newline
+        if(Random(4) == 0)
+            A += Pieces[Random(5)];
+
+        if(Random(4) == 0)
+            B += Pieces[Random(5)];
+
+        const TextDiff Diff = Utils::DiffLines(StringView(A), StringView(B));
+        Check(Diff.OldLines, Diff.NewLines, Diff.Edits);
+
+        String Rebuilt;
+
+        for(const Edit& Current : Diff.Edits)
+        {
+            for(U32 I = 0; I < Current.Length; I++)
+            {
+                if(Current.Kind == EditKind::Keep)
+                    Rebuilt += String(Diff.OldLines[Current.Old + I]);
+                else if(Current.Kind == EditKind::Insert)
+                    Rebuilt += String(Diff.NewLines[Current.New + I]);
+            }
+        }
+
+        TEST(Rebuilt == B);
+        TEST(Diff.Changed() == (A != B));
+    }
+}
+
+int main()
+{
+    Scans();
+    Arrays();
+    Text();
+}
@@ -0,0 +1,185 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Float.h>
+#include <Core/Collections/CthulhuString.h>
+#include <Core/Collections/Option.h>
+
+using namespace Cthulhu;
+
+template<typename T>
+String Write(T Num)
+{
+    char Buffer[Utils::MaxFloatChars + 1];
+    Buffer[Utils::FloatToChars(Num, Buffer)] = '\0';
+    return Buffer;
+}
+
+template<typename T>
+bool SameBits(T Left, T Right)
+{
+    return memcmp(&Left, &Right, sizeof(T)) == 0;
+}
+
+void Shortest()
+{
+    TEST(Write(0.1) == "0.1");
+    TEST(Write(0.1f) == "0.1");
+    TEST(Write(1.0 / 3.0) == "0.3333333333333333");
+    TEST(Write(100.0) == "100");
+    TEST(Write(-0.0) == "-0");
+    TEST(Write(1e21) == "1e+21");
+    TEST(Write(123456789012345678.0) == "123456789012345680");
+    TEST(Write(1e-7) == "1e-7");
+    TEST(Write(0.000001) == "0.000001");
+    TEST(Write(5e-324) == "5e-324");
+    TEST(Write(1.7976931348623157e308) == "1.7976931348623157e+308");
+    TEST(Write(3.4028235e38f) == "3.4028235e+38");
+    TEST(Write(1e-45f) == "1e-45");
+    TEST(Write(1.0 / 0.0) == "inf");
+    TEST(Write(-1.0 / 0.0) == "-inf");
+    TEST(Write(0.0 / 0.0) == "nan");
+
+    String Out = "x=";
+    Out << 2.5;
+    Out += ' ';
+    Out << 0.2f;
+    TEST(Out == "x=2.5 0.2");
+}
+
+void Parse()
+{
+    TEST(Utils::ParseDouble("0.1").Get() == 0.1);
+    TEST(Utils::ParseDouble("  -1.5e3 ").Get() == -1500.0);
+    TEST(Utils::ParseDouble(".5").Get() == 0.5);
+    TEST(Utils::ParseDouble("1e400").Get() == 1.0 / 0.0);
+    TEST(SameBits(Utils::ParseDouble("-1e-400").Get(), -0.0));
+    TEST(Utils::ParseDouble("Infinity").Get() == 1.0 / 0.0);
+    TEST(Utils::ParseFloat("3.4028235e38").Get() == 3.4028235e38f);
+    TEST(Utils::ParseFloat("1e39").Get() == 1.0f / 0.0f);
+
+    TEST(!Utils::ParseDouble("").Valid());
+    TEST(!Utils::ParseDouble("1.5x").Valid());
+    TEST(!Utils::ParseDouble("e5").Valid());
+
+    //halfway between two doubles rounds to even
+    TEST(Utils::ParseDouble("9007199254740993").Get() == 9007199254740992.0);
+    TEST(Utils::ParseDouble("2.4703282292062327e-324").Get() == 0.0);
+    TEST(Utils::ParseDouble("2.4703282292062328e-324").Get() == 5e-324);
+
+    //more digits than fit in 64 bits
+    TEST(Utils::ParseDouble("9007199254740993.0000000000000000001").Get() == 9007199254740994.0);
+    TEST(Utils::ParseDouble("3.14159265358979323846264338327950288").Get() == 3.141592653589793);
+
+    //an exponent without digits isnt part of the number
+    F64 Num;
+    TEST(Utils::FloatFromChars("2e+", 3, Num) == 1 && Num == 2.0);
+}
+
+void Doubles()
+{
+    //random bit patterns cover every exponent
+    U64 State = 0x853C49E6748FEA9BULL;
+
+    for(U32 I = 0; I < 1000000; I++)
+    {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        F64 Num;
+        memcpy(&Num, &State, sizeof(F64));
+
+        if(Num != Num || Num - Num != 0)
+            continue;
+
+        char Buffer[Utils::MaxFloatChars + 1];
+        const U32 Len = Utils::FloatToChars(Num, Buffer);
+        Buffer[Len] = '\0';
+
+        F64 Parsed;
+        TEST(Utils::FloatFromChars(Buffer, Len, Parsed) == Len);
+        TEST(SameBits(Parsed, Num));
+        TEST(SameBits(strtod(Buffer, nullptr), Num));
+    }
+}
+
+void Floats()
+{
+    //every finite float has to survive a round trip
+    for(U64 Bits = 0; Bits <= 0xFFFFFFFF; Bits++)
+    {
+        F32 Num;
+        const U32 Word = (U32)Bits;
+        memcpy(&Num, &Word, sizeof(F32));
+
+        if(Num != Num || Num - Num != 0)
+            continue;
+
+        char Buffer[Utils::MaxFloatChars + 1];
+        const U32 Len = Utils::FloatToChars(Num, Buffer);
+
+        F32 Parsed;
+        TEST(Utils::FloatFromChars(Buffer, Len, Parsed) == Len);
+        TEST(SameBits(Parsed, Num));
+
+        //check against the c library now and then so the two halves cant agree on the same mistake
+        if((Bits & 0xFFF) == 0)
+        {
+            Buffer[Len] = '\0';
+            TEST(SameBits(strtof(Buffer, nullptr), Num));
+
+            //one less significant digit than we wrote shouldnt be enough
+            U32 First = Len, Last = 0;
+
+            for(U32 I = 0; I < Len && Buffer[I] != 'e'; I++)
+            {
+                if('1' <= Buffer[I] && Buffer[I] <= '9')
+                {
+                    First = First < I ? First : I;
+                    Last = I;
+                }
+            }
+
+            //zero has no significant digits at all
+            U32 Digits = First < Len ? Last + 1 - First : 0;
+
+            //a decimal point in between doesnt count
+            for(U32 I = First; I < Last; I++)
+                Digits -= Buffer[I] == '.';
+
+            if(Digits > 1)
+            {
+                char Shorter[64];
+                snprintf(Shorter, sizeof(Shorter), "%.*e", Digits - 2, (F64)Num);
+                TEST(!SameBits(strtof(Shorter, nullptr), Num));
+            }
+        }
+    }
+}
+
+int main()
+{
+    Shortest();
+    Parse();
+    Doubles();
+    Floats();
+}
@@ -0,0 +1,89 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Format.h>
+
+using namespace Cthulhu;
+
+void Basic()
+{
+    TEST(Format(FMT("{} took {}ms"), "Load", 25) == "Load took 25ms");
+    TEST(Format(FMT("{{}} {1} {0}"), 1, 2) == "{} 2 1");
+    TEST(Format(FMT("{} {} {:c} {:b}"), true, 'x', 65, 5u) == "true x A 101");
+
+    char* Ptr = (char*)"ptr";
+    TEST(Format(FMT("{}"), Ptr) == "ptr");
+    TEST(Format(FMT("{}"), String("str")) == "str");
+
+    //strings that arent wrapped in FMT are still parsed, just at runtime
+    TEST(Format("{} {}", String("a"), 2) == "a 2");
+}
+
+void Specs()
+{
+    TEST(Format(FMT("{:08.3f}|{:>6}|{:x}"), 3.14159, "R", 255) == "0003.142|     R|ff");
+    TEST(Format(FMT("{:*^7}"), "ab") == "**ab***");
+    TEST(Format(FMT("{:<4}|"), 7) == "7   |");
+    TEST(Format(FMT("{:.2s}"), "abc") == "ab");
+    TEST(Format(FMT("{:X}"), 48879) == "BEEF");
+
+    //the smallest I64 cant be negated as a signed number
+    TEST(Format(FMT("{:+d} {:05} {}"), 5, -42, (I64)(-9223372036854775807LL - 1)) == "+5 -0042 -9223372036854775808");
+
+    //as long as printf would make it, neither the precision nor the length is capped
+    char Expected[1024];
+    const int Len = snprintf(Expected, sizeof(Expected), "%.300f", 1e300);
+    TEST(Len == 602);
+    TEST(Format(FMT("{:.300f}"), 1e300) == Expected);
+    TEST(Format(FMT("{:.500f}"), 0.5).Len() == 502);
+    TEST(Format(FMT("{:>700.1f}"), -1e300).Len() == 700);
+}
+
+void Sinks()
+{
+    //FormatTo truncates but still reports the full length like snprintf
+    char Buffer[8];
+    TEST(FormatTo(Buffer, sizeof(Buffer), FMT("{}-{}"), 12345, 67890) == 11);
+    TEST(String(Buffer) == "12345-6");
+
+    //FormatInto appends without reallocating when there is space
+    String Into = "x=";
+    Into.Reserve(64);
+    char* Before = Into.CStr();
+
+    FormatInto(Into, FMT("{}/{}"), 1, 2);
+    TEST(Into == "x=1/2");
+    TEST(Into.CStr() == Before);
+
+    String Long;
+    for(U32 I = 0; I < 100; I++)
+        FormatInto(Long, FMT("{:>10}"), I);
+
+    TEST(Long.Len() == 1000);
+
+    //bigger than the stack buffer Format starts with
+    TEST(Format(FMT("{:>300}"), "end").Len() == 300);
+}
+
+int main()
+{
+    Basic();
+    Specs();
+    Sinks();
+}
@@ -0,0 +1,134 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Integer.h>
+
+using namespace Cthulhu;
+
+void Formatting()
+{
+    TEST(Utils::ToString(0LL) == "0");
+    TEST(Utils::ToString(-7LL) == "-7");
+    TEST(Utils::ToString(1234567890123LL) == "1234567890123");
+    TEST(Utils::ToString((I64)(-9223372036854775807LL - 1)) == "-9223372036854775808");
+    TEST(Utils::HexToString(0xBEEF) == "0xbeef");
+
+    char Buffer[Utils::MaxIntegerChars];
+    TEST(Utils::IntegerToChars(18446744073709551615ULL, Buffer) == 20);
+    TEST(memcmp(Buffer, "18446744073709551615", 20) == 0);
+
+    //every length has to be measured right on both sides of each power of 10
+    U64 Pow = 1;
+    for(U32 Digits = 1; Digits < 20; Digits++, Pow *= 10)
+    {
+        TEST(Utils::DecimalLength(Pow) == Digits);
+        TEST(Utils::DecimalLength((Pow * 10) - 1) == Digits);
+    }
+
+    //compare against the c library for lots of numbers of every size
+    U64 State = 0x2545F4914F6CDD1DULL;
+    for(U32 I = 0; I < 100000; I++)
+    {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        const I64 Num = (I64)(State >> (State & 63));
+
+        char Expected[32];
+        snprintf(Expected, sizeof(Expected), "%lld", Num);
+
+        TEST(Utils::ToString(Num) == Expected);
+    }
+}
+
+void Parsing()
+{
+    TEST(Utils::ParseInt("12345").Get() == 12345);
+    TEST(Utils::ParseInt(" -42 ").Get() == -42);
+    TEST(Utils::ParseInt("+0000000000000000000000000001").Get() == 1);
+    TEST(Utils::ParseInt("9223372036854775807").Get() == 9223372036854775807LL);
+    TEST(Utils::ParseInt("-9223372036854775808").Get() == (I64)(-9223372036854775807LL - 1));
+
+    //too big to fit is an error rather than wrapping around
+    TEST(!Utils::ParseInt("9223372036854775808").Valid());
+    TEST(!Utils::ParseInt("123456789012345678901").Valid());
+    TEST(!Utils::ParseInt("12a").Valid());
+    TEST(!Utils::ParseInt("-").Valid());
+    TEST(!Utils::ParseInt("").Valid());
+
+    U64 Big;
+    TEST(Utils::IntegerFromChars("18446744073709551615", 20, Big) == 20 && Big == 18446744073709551615ULL);
+    TEST(Utils::IntegerFromChars("18446744073709551616", 20, Big) == 0);
+
+    //the digits stop at the first character that isnt one, wherever it lands in a chunk
+    for(U32 Len = 1; Len <= 19; Len++)
+    {
+        char Text[32];
+        memcpy(Text, "1234567890123456789", Len);
+        Text[Len] = ',';
+        memcpy(Text + Len + 1, "99999999", 8);
+
+        I64 Num;
+        TEST(Utils::IntegerFromChars(Text, Len + 9, Num) == Len);
+        TEST(Num == atoll(Text));
+    }
+
+    TEST(Utils::ParseHex("0xFF").Get() == 255);
+    TEST(Utils::ParseHex("deadBEEF").Get() == 0xDEADBEEF);
+    TEST(Utils::ParseHex("ffffffffffffffff").Get() == -1);
+    TEST(!Utils::ParseHex("1ffffffffffffffff").Valid());
+    TEST(!Utils::ParseHex("0xg").Valid());
+
+    TEST(Utils::ParseBits("0b101").Get() == 5);
+    TEST(Utils::ParseBits(Utils::ToBits<I64>(-2)).Get() == -2);
+    TEST(!Utils::ParseBits("102").Valid());
+}
+
+void Bulk()
+{
+    Array<I64> Numbers;
+
+    auto Parsed = Utils::ParseIntegers("1,2, 3\r\n-4,5000000000\n", Numbers);
+    TEST(Parsed.Valid());
+    TEST(Parsed.Value() == 5);
+    TEST(Numbers.Len() == 5);
+    TEST(Numbers[2] == 3 && Numbers[3] == -4 && Numbers[4] == 5000000000LL);
+
+    Array<I64> Spaced;
+    TEST(Utils::ParseIntegers("10 20 30", Spaced, " ").Value() == 3);
+    TEST(Spaced[1] == 20);
+
+    Array<I64> Bad;
+    auto Failed = Utils::ParseIntegers("1,x,3", Bad);
+    TEST(!Failed.Valid());
+    TEST(Failed.Error() == 2);
+
+    TEST(!Utils::ParseIntegers("1,,3", Bad).Valid());
+    TEST(!Utils::ParseIntegers("1 2", Bad).Valid());
+}
+
+int main()
+{
+    Formatting();
+    Parsing();
+    Bulk();
+}
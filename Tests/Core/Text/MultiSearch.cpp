@@ -0,0 +1,219 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/MultiSearch.h>
+#include <Core/Collections/Map.h>
+
+using namespace Cthulhu;
+
+void Find()
+{
+    MultiSearch Search = { "he", "she", "his", "hers" };
+
+    TEST(Search.IsDense());
+
+    //leftmost wins even though "he" ends first
+    auto First = Search.Find("ushers");
+    TEST(First.Valid());
+    TEST(First.Get().Offset == 1);
+    TEST(First.Get().Length == 3);
+    TEST(First.Get().Pattern == 1);
+
+    TEST(!Search.Find("nothing to see").Valid());
+    TEST(!Search.Find("").Valid());
+}
+
+void FindAll()
+{
+    MultiSearch Search = { "cat", "category", "dog" };
+
+    auto Matches = Search.FindAll("category of dog and cat");
+
+    TEST(Matches.Len() == 3);
+
+    //longest wins when two patterns start at the same place
+    TEST(Matches[0].Offset == 0 && Matches[0].Length == 8 && Matches[0].Pattern == 1);
+    TEST(Matches[1].Offset == 12 && Matches[1].Pattern == 2);
+    TEST(Matches[2].Offset == 20 && Matches[2].Pattern == 0);
+
+    //matches never overlap
+    MultiSearch Overlap = { "aa" };
+    TEST(Overlap.Count("aaaaa") == 2);
+
+    //a longer match that starts earlier beats a shorter one that ends earlier
+    MultiSearch Nested = { "bcd", "abcde" };
+    auto NestedMatches = Nested.FindAll("xabcdex");
+    TEST(NestedMatches.Len() == 1);
+    TEST(NestedMatches[0].Offset == 1 && NestedMatches[0].Pattern == 1);
+}
+
+void Sparse()
+{
+    //enough distinct characters to push the search off the dense table
+    Array<String> Patterns;
+    String Chars = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!@#$%^&*()";
+
+    for(U32 I = 0; I + 3 <= Chars.Len(); I += 3)
+        Patterns.Append(Chars.SubString(I, 3));
+
+    MultiSearch Search(Patterns);
+
+    TEST(!Search.IsDense());
+    TEST(Search.Count(Chars) == Patterns.Len());
+    TEST(Search.Find("zzzdefzzz").Get().Offset == 3);
+}
+
+void Replace()
+{
+    MultiSearch Search = { "{0}", "{1}", "{10}" };
+
+    String Out = Search.Replace("{0}-{1}-{10}-{2}", { "zero", "one", "ten" });
+    TEST(Out == "zero-one-ten-{2}");
+
+    String Same = Search.Replace("no tokens here", { "a", "b", "c" });
+    TEST(Same == "no tokens here");
+
+    //nulls in the text are copied like any other byte
+    String Nulled = Search.Replace("{0}\0{1}", 7, { "x", "y", "z" });
+    TEST(Nulled.Len() == 3);
+    TEST(Nulled[1] == '\0' && Nulled[2] == 'y');
+
+    String Text = "Hello $Name, welcome to $Place";
+    TEST(Text.ReplaceAll({ { "$Name", "Bob" }, { "$Place", "R'lyeh" } }) == "Hello Bob, welcome to R'lyeh");
+
+    TEST(String("{0} and {1}").ArrayFormat({ "A", "B" }) == "A and B");
+    TEST(String("{First} {Last}").Format({ { "First", "Jeb" }, { "Last", "Kerman" } }) == "Jeb Kerman");
+}
+
+void Pending()
+{
+    //the second "a" shows up while "aab" could still start at 0
+    MultiSearch Search = { "aab", "a" };
+
+    TEST(Search.Count("aa") == 2);
+    TEST(Search.Count("aab") == 1);
+    TEST(Search.Replace("aax", { "X", "Y" }) == "YYx");
+    TEST(Search.Replace("aaab", { "X", "Y" }) == "YX");
+}
+
+U64 State = 0x2545F4914F6CDD1DULL;
+
+U32 Random(U32 Limit)
+{
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return (U32)(State % Limit);
+}
+
+//the obvious way, at every offset take the longest pattern that starts there
+Array<SearchMatch> BruteForce(const Array<String>& Patterns, const String& Text)
+{
+    Array<SearchMatch> Ret;
+    U32 At = 0;
+
+    while(At < Text.Len())
+    {
+        SearchMatch Best = { 0, 0, 0 };
+
+        for(U32 P = 0; P < Patterns.Len(); P++)
+        {
+            const String& Pattern = Patterns[P];
+
+            if(Pattern.Len() > Best.Length && At + Pattern.Len() <= Text.Len() && Memory::Compare(Text.CStr() + At, Pattern.CStr(), Pattern.Len()) == 0)
+                Best = { At, Pattern.Len(), P };
+        }
+
+        if(Best.Length == 0)
+        {
+            At++;
+            continue;
+        }
+
+        Ret.Append(Best);
+        At += Best.Length;
+    }
+
+    return Ret;
+}
+
+void Brute()
+{
+    for(U32 Round = 0; Round < 2000; Round++)
+    {
+        Array<String> Patterns;
+        const U32 Count = 1 + Random(5);
+
+        for(U32 P = 0; P < Count; P++)
+        {
+            String Pattern;
+            const U32 Len = 1 + Random(4);
+
+            for(U32 I = 0; I < Len; I++)
+                Pattern += (char)('a' + Random(3));
+
+            Patterns.Append(Pattern);
+        }
+
+        //a pattern that never matches but has enough characters to need the sparse search
+        if(Round % 2)
+        {
+            String Wide;
+            for(char C = '!'; C <= '~'; C++)
+            {
+                if(C < 'a' || C > 'c')
+                    Wide += C;
+            }
+
+            Patterns.Append(Wide);
+        }
+
+        MultiSearch Search(Patterns);
+        TEST(Search.IsDense() == (Round % 2 == 0));
+
+        String Text;
+        const U32 Len = Random(40);
+
+        for(U32 I = 0; I < Len; I++)
+            Text += (char)('a' + Random(3));
+
+        const Array<SearchMatch> Expected = BruteForce(Patterns, Text);
+        const Array<SearchMatch> Found = Search.FindAll(Text);
+
+        TEST(Found.Len() == Expected.Len());
+        TEST(Search.Count(Text) == Expected.Len());
+
+        for(U32 I = 0; I < Found.Len(); I++)
+        {
+            TEST(Found[I].Offset == Expected[I].Offset);
+            TEST(Found[I].Length == Expected[I].Length);
+            TEST(Found[I].Pattern == Expected[I].Pattern);
+        }
+    }
+}
+
+int main()
+{
+    Find();
+    FindAll();
+    Sparse();
+    Replace();
+    Pending();
+    Brute();
+}
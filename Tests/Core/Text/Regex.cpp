@@ -0,0 +1,312 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Regex.h>
+#include <Core/Collections/CthulhuString.h>
+
+using namespace Cthulhu;
+
+Regex Make(const char* Pattern)
+{
+    auto Compiled = Regex::Compile(Pattern);
+    TEST(Compiled.Valid());
+    return Compiled.Value();
+}
+
+bool Rejected(const char* Pattern, U32 Offset)
+{
+    auto Compiled = Regex::Compile(Pattern);
+    return !Compiled.Valid() && Compiled.Error().Offset == Offset;
+}
+
+bool Found(const Regex& Pattern, const char* Text, U32 Offset, U32 Length)
+{
+    auto Match = Pattern.Find(Text);
+    return Match.Valid() && Match.Get() == RegexMatch{ Offset, Length };
+}
+
+//a tiny backtracking matcher for patterns of literals . and *, returns where the preferred match ends
+const char* Slow(const char* Pattern, const char* Text, bool Whole)
+{
+    if(*Pattern == '\0')
+        return !Whole || *Text == '\0' ? Text : nullptr;
+
+    auto Accepts = [&](char C) { return C != '\0' && (Pattern[0] == '.' || Pattern[0] == C); };
+
+    if(Pattern[1] == '*')
+    {
+        //greedy so the longest run is tried first
+        U32 Run = 0;
+
+        while(Accepts(Text[Run]))
+            Run++;
+
+        for(U32 I = Run + 1; I-- > 0;)
+            if(const char* End = Slow(Pattern + 2, Text + I, Whole))
+                return End;
+
+        return nullptr;
+    }
+
+    return Accepts(*Text) ? Slow(Pattern + 1, Text + 1, Whole) : nullptr;
+}
+
+void Syntax()
+{
+    TEST(Make("abc").Match("abc"));
+    TEST(!Make("abc").Match("abcd"));
+    TEST(Make("a.c").Match("abc"));
+    TEST(!Make("a.c").Match("a\nc"));
+    TEST(Make("a*").Match(""));
+    TEST(Make("a+b?").Match("aaa"));
+    TEST(!Make("a+").Match(""));
+    TEST(Make("(ab|cd)+").Match("abcdab"));
+    TEST(Make("[a-c]{2,3}").Match("cab"));
+    TEST(!Make("[a-c]{2,3}").Match("cabc"));
+    TEST(!Make("[a-c]{2,3}").Match("c"));
+    TEST(Make("x{2,}").Match("xxxxx"));
+    TEST(Make("[^0-9]+").Match("abc"));
+    TEST(!Make("[^0-9]+").Match("a1c"));
+    TEST(Make("\\d+\\.\\d+").Match("3.14"));
+    TEST(Make("\\w+\\s\\W").Match("ab_9 !"));
+    TEST(Make("[\\d\\-]+").Match("1-2-3"));
+    TEST(Make("[]a]+").Match("]a]"));
+    TEST(Make("\\x41\\t").Match("A\t"));
+    TEST(Make("(?:ab)*c").Match("ababc"));
+    TEST(Make("").Match(""));
+    TEST(!Make("").Match("a"));
+    TEST(Make("^ab$").Match("ab"));
+
+    //empty text is both the start and the end so the anchors can come in either order
+    TEST(Make("^$").Match(""));
+    TEST(Make("$^").Match(""));
+    TEST(Make("($)+^").Match(""));
+    TEST(Make("a|$^").Match(""));
+    TEST(!Make("$^").Match("a"));
+    TEST(Make("$^").Contains(""));
+    TEST(!Make("a$^").Contains("a"));
+    TEST(Make("a|$^").Find("").Valid());
+
+    TEST(Make("(a)(b(c))").Groups() == 3);
+    TEST(Make("(?:a)b").Groups() == 0);
+
+    TEST(Rejected("*a", 0));
+    TEST(Rejected("a(b", 3));
+    TEST(Rejected("ab)", 2));
+    TEST(Rejected("[ab", 3));
+    TEST(Rejected("[z-a]", 4));
+    TEST(Rejected("a\\q", 2));
+    TEST(Rejected("a{3,1}", 6));
+    TEST(Rejected("a{5000}", 7));
+    TEST(!Regex::Compile("(((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((a").Valid());
+    TEST(!Regex::Compile("(a{1000}){1000}").Valid());
+
+    //a default regex matches nothing
+    Regex Nothing;
+    TEST(!Nothing.Contains("abc"));
+    TEST(!Nothing.Find("abc").Valid());
+}
+
+void Searching()
+{
+    TEST(Found(Make("b+"), "abbbc", 1, 3));
+    TEST(Found(Make("b+?"), "abbbc", 1, 1));
+    TEST(Found(Make("a|ab"), "xab", 1, 1));
+    TEST(Found(Make("ab|a"), "xab", 1, 2));
+    TEST(Found(Make("x*"), "abc", 0, 0));
+    TEST(Found(Make("c$"), "cabc", 3, 1));
+    TEST(!Make("^b").Find("ab").Valid());
+    TEST(!Make("^a").Find("aa", 1).Valid());
+    TEST(Found(Make("needle"), "haystack with a needle in it", 16, 6));
+    TEST(Found(Make("[xy]z+"), "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaayzzz", 44, 4));
+    TEST(Found(Make("\\d{3}-\\d{4}"), "call 555-0199 now", 5, 8));
+
+    TEST(Make("needle").Contains("haystack with a needle"));
+    TEST(!Make("needle").Contains("haystack without one"));
+    TEST(Make("e[a-z]d$").Contains("the end"));
+    TEST(!Make("e[a-z]d$").Contains("the end."));
+
+    auto All = Make("\\d+").FindAll("a1 b22 c333");
+    TEST(All.Len() == 3);
+    TEST(All[0] == (RegexMatch{ 1, 1 }));
+    TEST(All[1] == (RegexMatch{ 4, 2 }));
+    TEST(All[2] == (RegexMatch{ 8, 3 }));
+
+    //empty matches dont get stuck
+    auto Empty = Make("a*").FindAll("baab");
+    TEST(Empty.Len() == 4);
+    TEST(Empty[0] == (RegexMatch{ 0, 0 }));
+    TEST(Empty[1] == (RegexMatch{ 1, 2 }));
+    TEST(Empty[2] == (RegexMatch{ 3, 0 }));
+    TEST(Empty[3] == (RegexMatch{ 4, 0 }));
+
+    //a String works as well as a raw buffer
+    String Line = "key=value";
+    TEST(Found(Make("=\\w+"), Line.CStr(), 3, 6));
+    TEST(Make("=").Find(Line).Get().In(Line) == "=");
+
+    const char Raw[] = { 'a', '\0', 'b', 'c' };
+    auto InRaw = Make("\\0b").Find(StringView(Raw, 4));
+    TEST(InRaw.Valid() && InRaw.Get() == (RegexMatch{ 1, 2 }));
+}
+
+void Captures()
+{
+    Regex Pattern = Make("(\\w+)=(\\d+)?(;)?");
+    StringView Text = "x width=640 height=";
+
+    Array<RegexMatch> Groups;
+    TEST(Pattern.Capture(Text, Groups));
+    TEST(Groups.Len() == 4);
+    TEST(Groups[0].In(Text) == "width=640");
+    TEST(Groups[1].In(Text) == "width");
+    TEST(Groups[2].In(Text) == "640");
+    TEST(!Groups[3].Valid());
+
+    Array<RegexMatch> Next;
+    TEST(Pattern.Capture(Text, Next, Groups[0].End()));
+    TEST(Next[1].In(Text) == "height");
+    TEST(!Next[2].Valid());
+
+    //reusing an array replaces what the last call put there
+    TEST(Pattern.Capture(Text, Groups, Groups[0].End()));
+    TEST(Groups.Len() == 4);
+    TEST(Groups[0].In(Text) == "height=");
+    TEST(Groups[1].In(Text) == "height");
+
+    //the last time round a loop wins
+    Array<RegexMatch> Loop;
+    TEST(Make("(?:(a)|(b))+").Capture("ab", Loop));
+    TEST(Loop[1] == (RegexMatch{ 0, 1 }) && Loop[2] == (RegexMatch{ 1, 1 }));
+
+    Array<RegexMatch> None;
+    TEST(!Make("(z)").Capture("abc", None));
+    TEST(None.Len() == 0);
+}
+
+void Copies()
+{
+    Regex Original = Make("[0-9]+");
+    Regex Copy = Original;
+
+    Regex Assigned;
+    Assigned = Copy;
+
+    TEST(Original.Contains("a1") && Copy.Contains("b2") && Assigned.Contains("c3"));
+
+    Assigned = Assigned;
+    TEST(Assigned.Contains("c3"));
+
+    Assigned = Regex();
+    TEST(!Assigned.Contains("c3"));
+    TEST(Copy.Contains("4"));
+}
+
+void Linear()
+{
+    //(a*)*b is exponential with backtracking
+    String Text;
+
+    for(U32 I = 0; I < 100000; I++)
+        Text += 'a';
+
+    TEST(!Make("(a*)*b").Contains(Text));
+    TEST(!Make("(a|aa)+$b").Find(Text).Valid());
+
+    //lots of distinct states makes the cache throw itself away a few times
+    Regex Wide = Make("[ab]*a[ab]{12}c");
+    String Mixed;
+    U32 State = 12345;
+
+    for(U32 I = 0; I < 200000; I++)
+    {
+        State = (State * 1103515245) + 12345;
+        Mixed += (State >> 16) & 1 ? 'a' : 'b';
+    }
+
+    TEST(!Wide.Contains(Mixed));
+    Mixed += 'c';
+    TEST(Wide.Contains(Mixed));
+}
+
+void Random()
+{
+    //compare against a simple backtracking matcher, which prefers the same matches
+    const char Alphabet[] = "ab.";
+    U32 State = 987654321;
+
+    auto Next = [&](U32 Range) {
+        State = (State * 1103515245) + 12345;
+        return (State >> 16) % Range;
+    };
+
+    for(U32 Round = 0; Round < 20000; Round++)
+    {
+        char Pattern[16];
+        U32 Len = 0;
+
+        for(U32 Items = Next(5) + 1; Items > 0; Items--)
+        {
+            Pattern[Len++] = Alphabet[Next(3)];
+
+            if(Next(3) == 0)
+                Pattern[Len++] = '*';
+        }
+
+        Pattern[Len] = '\0';
+
+        char Text[16];
+        const U32 TextLen = Next(10);
+
+        for(U32 I = 0; I < TextLen; I++)
+            Text[I] = "ab"[Next(2)];
+
+        Text[TextLen] = '\0';
+
+        Regex Compiled = Make(Pattern);
+
+        TEST(Compiled.Match(Text) == (Slow(Pattern, Text, true) != nullptr));
+
+        const char* End = nullptr;
+        U32 First = 0;
+
+        for(; First <= TextLen && !End; First++)
+            End = Slow(Pattern, Text + First, false);
+
+        TEST(Compiled.Contains(Text) == (End != nullptr));
+
+        auto Match = Compiled.Find(Text);
+        TEST(Match.Valid() == (End != nullptr));
+
+        if(End)
+            TEST(Match.Get() == (RegexMatch{ First - 1, (U32)(End - Text) - (First - 1) }));
+    }
+}
+
+int main()
+{
+    Syntax();
+    Searching();
+    Captures();
+    Copies();
+    Linear();
+    Random();
+}
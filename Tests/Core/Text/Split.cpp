@@ -0,0 +1,152 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Split.h>
+#include <Core/Collections/CthulhuString.h>
+#include <Core/Collections/Array.h>
+
+using namespace Cthulhu;
+
+template<typename TRange>
+bool Pieces(const TRange& Range, Array<StringView> Expected)
+{
+    Array<StringView> Got = Range.Collect();
+
+    if(Got.Len() != Expected.Len())
+        return false;
+
+    for(U32 I = 0; I < Got.Len(); I++)
+        if(Got[I] != Expected[I])
+            return false;
+
+    return Range.Count() == Expected.Len();
+}
+
+void Scanning()
+{
+    //long enough that the vector loops run with a scalar tail after them
+    const char* Text = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const U32 Len = 62;
+
+    for(U32 I = 0; I < Len; I++)
+    {
+        TEST(Utils::FindByte(Text, Len, Text[I]) == I);
+        TEST(Utils::FindAny(Text, Len, CharSet(StringView(Text + I, 1))) == I);
+        TEST(Utils::FindPattern(Text, Len, StringView(Text + I, Len - I < 3 ? Len - I : 3)) == I);
+    }
+
+    TEST(Utils::FindByte(Text, Len, '!') == Len);
+    TEST(Utils::FindByte(Text, 0, 'a') == 0);
+    TEST(Utils::FindAny(Text, Len, "!?") == Len);
+    TEST(Utils::FindAny(Text, Len, "Z9z") == 25);
+
+    //big sets go through the bitmap
+    TEST(Utils::FindAny(Text, Len, "!@#$%^&*(0") == 26);
+    TEST(Utils::FindPattern(Text, Len, "xyz1") == Len);
+    TEST(Utils::FindPattern("aaab", 4, "ab") == 2);
+    TEST(Utils::FindPattern("ab", 2, "abc") == 2);
+
+    CharSet Set = " \t\n";
+    TEST(Set.Len() == 3);
+    TEST(Set.Has('\t') && !Set.Has('a'));
+    TEST(CharSet("aab").Len() == 2);
+}
+
+void Splitting()
+{
+    String Row = "a,b,,c";
+
+    TEST(Pieces(Row.Split(','), { "a", "b", "", "c" }));
+    TEST(Pieces(Row.Split(',', 2), { "a", "b,,c" }));
+    TEST(Pieces(Row.Split(',', 1), { "a,b,,c" }));
+    TEST(Pieces(Row.Split(';'), { "a,b,,c" }));
+    TEST(Pieces(Utils::Split(",a,", ','), { "", "a", "" }));
+    TEST(Pieces(Utils::Split("", ','), { "" }));
+
+    TEST(Pieces(Utils::Split("one::two::::three", "::"), { "one", "two", "", "three" }));
+    TEST(Pieces(Utils::Split("one::two::three", "::", 2), { "one", "two::three" }));
+    TEST(Pieces(Utils::Split(":::", "::"), { "", ":" }));
+
+    TEST(Pieces(Utils::SplitAny("a b\tc\n", " \t\n"), { "a", "b", "c", "" }));
+    TEST(Pieces(Utils::SplitAny("a1b2c3d4e5f", "12345"), { "a", "b", "c", "d", "e", "f" }));
+
+    //pieces point into the original text
+    StringView First = *Row.Split(',').begin();
+    TEST(First.Data() == Row.CStr());
+
+    //views can be split again
+    U32 Total = 0;
+    for(StringView Line : Utils::Lines("1,2\n3,4,5\n"))
+        Total += Utils::Split(Line, ',').Count();
+
+    TEST(Total == 5);
+}
+
+void Lines()
+{
+    TEST(Pieces(Utils::Lines(""), {}));
+    TEST(Pieces(Utils::Lines("\n"), { "" }));
+    TEST(Pieces(Utils::Lines("one"), { "one" }));
+    TEST(Pieces(Utils::Lines("one\ntwo\n"), { "one", "two" }));
+    TEST(Pieces(Utils::Lines("one\r\ntwo\r\n\r\nthree"), { "one", "two", "", "three" }));
+    TEST(Pieces(Utils::Lines("a\n\n"), { "a", "" }));
+
+    //a lone \r isnt a line ending
+    TEST(Pieces(Utils::Lines("a\rb\n"), { "a\rb" }));
+
+    String Text = "x\ny";
+    TEST(Text.Lines().Count() == 2);
+}
+
+bool IsBlank(char C) { return C == ' ' || C == '\t'; }
+
+void Tokens()
+{
+    String Code = "  let x =  1 ";
+    TEST(Pieces(Code.Tokenize(IsBlank), { "let", "x", "=", "1" }));
+    TEST(Pieces(Utils::Tokenize("", IsBlank), {}));
+    TEST(Pieces(Utils::Tokenize("   ", IsBlank), {}));
+    TEST(Pieces(Utils::Tokenize("a+b-c", [](char C) { return C == '+' || C == '-'; }), { "a", "b", "c" }));
+}
+
+void Views()
+{
+    StringView View = "hello world";
+    TEST(View.Len() == 11);
+    TEST(View.SubView(6, 5) == "world");
+    TEST(View.StartsWith("hello") && View.EndsWith("world"));
+    TEST(!View.StartsWith("world"));
+
+    String Copy = String(View.SubView(0, 5));
+    TEST(Copy == "hello" && Copy.Len() == 5);
+
+    TEST(String("abc", 2) == "ab");
+
+    static_assert(StringView("abc").Len() == 3, "views should be usable at compile time");
+}
+
+int main()
+{
+    Scanning();
+    Splitting();
+    Lines();
+    Tokens();
+    Views();
+}
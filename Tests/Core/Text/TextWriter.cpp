@@ -0,0 +1,189 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/TextWriter.h>
+#include <Core/Text/Format.h>
+#include <Core/Collections/Map.h>
+#include <Core/Collections/Range.h>
+#include <Core/Collections/Rope.h>
+#include <Core/Types/Errno.h>
+#include <FileSystem/FileWriter.h>
+
+using namespace Cthulhu;
+
+void Buffers()
+{
+    BufferWriter Out;
+    WriteTo(Out, "abc");
+    WriteTo(Out, -12);
+    WriteTo(Out, 2.5);
+    WriteTo(Out, true);
+    TEST(Out.Take() == "abc-122.5true");
+
+    //taking resets the writer so it can be used again
+    TEST(Out.Total == 0);
+
+    //spill past the inline buffer
+    for(U32 I = 0; I < 1000; I++)
+        Out.Write('x', 3);
+
+    const String Big = Out.Take();
+    TEST(Big.Len() == 3000);
+    TEST(Big[0] == 'x' && Big[2999] == 'x');
+
+    //nulls in the text survive both the inline and the heap buffer
+    Out.Write("a\0b", 3);
+    TEST(Out.Take().Len() == 3);
+
+    Out.Write('x', 300);
+    Out.Write("\0y", 2);
+
+    const String Nulls = Out.Take();
+    TEST(Nulls.Len() == 302);
+    TEST(Nulls[300] == '\0' && Nulls[301] == 'y');
+
+    WriteTo(Out, 7U);
+    TEST(Out.Take() == "7");
+}
+
+void Strings()
+{
+    String Into = "n=";
+    Into.Reserve(64);
+
+    {
+        StringWriter Out(Into);
+        WriteTo(Out, 42);
+        Out.Flush();
+        TEST(Into == "n=42");
+
+        //writing carries on after a flush and spills past the reserved space
+        for(U32 I = 0; I < 100; I++)
+            Out.Write("ab", 2);
+    }
+
+    TEST(Into.Len() == 204);
+    TEST(Into.CStr()[204] == '\0');
+
+    String Num = "x";
+    Num << (I64)5 << 0.5f << false;
+    TEST(Num == "x50.5false");
+}
+
+void Fixed()
+{
+    char Buffer[8];
+    FixedWriter Out(Buffer, sizeof(Buffer));
+    WriteTo(Out, "hello world");
+
+    TEST(Out.Truncated());
+    TEST(Out.Total == 11);
+    TEST(strcmp(Out.Terminate(), "hello w") == 0);
+
+    FixedWriter Empty(nullptr, 0);
+    WriteTo(Empty, 123);
+    TEST(Empty.Total == 3 && Empty.Length == 0);
+
+    StackWriter<32> Stack;
+    WriteTo(Stack, Range(2, 4));
+    TEST(strcmp(Stack.Terminate(), "{ Start: 2, End: 5, Index: 2 }") == 0);
+    TEST(!Stack.Truncated());
+}
+
+void Values()
+{
+    Array<I64> Nums = { 1, 2, 3 };
+    TEST(Utils::ToString(Nums) == "{ 1, 2, 3 }");
+    TEST(Utils::ToString(Array<I64>()) == "{ }");
+
+    Array<String> Names = { "a", "b" };
+    TEST(Utils::ToString(Names) == "{ \"a\", \"b\" }");
+
+    Array<Pair<I64, bool>> Nested = { { 1, true }, { 2, false } };
+    TEST(Utils::ToString(Nested) == "{ { First: 1, Second: true }, { First: 2, Second: false } }");
+
+    TEST(Utils::ToString(Some<I64>(5)) == "Some(5)");
+    TEST(Utils::ToString(None<I64>()) == "None()");
+
+    TEST(Utils::ToString(Pair<I64, bool>{ 1, true }) == "{ First: 1, Second: true }");
+    TEST(Utils::ToString(Triplet<I64, I64, String>{ 1, 2, "x" }) == "{ First: 1, Second: 2, Third: \"x\" }");
+
+    Map<String, Pair<I64, bool>> Single;
+    Single["key"] = { 1, true };
+    TEST(Utils::ToString(Single) == "{\"key\": { First: 1, Second: true }}");
+    TEST(Utils::ToString(Map<String, I64>()) == "{}");
+
+    TEST(Utils::ToString(Range(3)) == "{ Start: 0, End: 4, Index: 0 }");
+    TEST(ToString(Errno::None) == "Not an error");
+    TEST(ToString((Errno)250) == "Invalid error");
+
+    Rope Text = Rope("abc") + Rope("def");
+    BufferWriter Out;
+    WriteTo(Out, Text);
+    TEST(Out.Take() == "abcdef");
+
+    //format uses WriteTo for anything it doesnt know, padding still works
+    TEST(Format(FMT("{}"), Nums) == "{ 1, 2, 3 }");
+    TEST(Format(FMT("[{:>13}]"), Nums) == "[  { 1, 2, 3 }]");
+}
+
+void Files()
+{
+    FILE* Temp = tmpfile();
+    TEST(Temp != nullptr);
+
+    {
+        FileSystem::FileWriter Out(Temp);
+
+        //more than the buffer so it has to flush part way through
+        for(U32 I = 0; I < 2000; I++)
+        {
+            WriteTo(Out, I);
+            Out.Write('\n');
+        }
+
+        TEST(!Out.Failed());
+    }
+
+    rewind(Temp);
+
+    char Line[16];
+    U32 Count = 0;
+
+    while(fgets(Line, sizeof(Line), Temp))
+    {
+        TEST((U32)atoi(Line) == Count);
+        Count++;
+    }
+
+    TEST(Count == 2000);
+
+    fclose(Temp);
+}
+
+int main()
+{
+    Buffers();
+    Strings();
+    Fixed();
+    Values();
+    Files();
+}
@@ -0,0 +1,224 @@
+/**   Copyright 2018 Elliot Haisley Brown
+ *
+ *  Licensed under the (modified) Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      https://github.com/Apache-HB/CTULib/blob/master/LICENSE
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST(Expr) if(!(Expr)) { printf("Test failed: " __FILE__ ":%d", __LINE__); exit(1); }
+
+#include <Core/Text/Unicode.h>
+
+using namespace Cthulhu;
+
+bool Valid(const char* Text)
+{
+    const U32 Len = (U32)strlen(Text);
+    const bool Ret = Unicode::IsValid(Text, Len);
+
+    //the fast and slow paths always have to agree
+    TEST(Ret == (Unicode::ValidPrefix(Text, Len) == Len));
+
+    return Ret;
+}
+
+void Validation()
+{
+    TEST(Valid(""));
+    TEST(Valid("plain ascii"));
+    TEST(Valid("caf\xC3\xA9"));
+    TEST(Valid("\xE2\x82\xAC"));
+    TEST(Valid("\xF0\x9F\x98\x80"));
+    TEST(Valid("\xF4\x8F\xBF\xBF"));
+    TEST(Valid("\xED\x9F\xBF"));
+    TEST(Valid("\xEE\x80\x80"));
+
+    //overlongs
+    TEST(!Valid("\xC0\xAF"));
+    TEST(!Valid("\xC1\xBF"));
+    TEST(!Valid("\xE0\x80\xAF"));
+    TEST(!Valid("\xE0\x9F\xBF"));
+    TEST(!Valid("\xF0\x80\x80\xAF"));
+    TEST(!Valid("\xF0\x8F\xBF\xBF"));
+
+    //surrogates and too large
+    TEST(!Valid("\xED\xA0\x80"));
+    TEST(!Valid("\xED\xBF\xBF"));
+    TEST(!Valid("\xF4\x90\x80\x80"));
+    TEST(!Valid("\xF5\x80\x80\x80"));
+    TEST(!Valid("\xFF"));
+
+    //truncated and stray bytes
+    TEST(!Valid("\xC3"));
+    TEST(!Valid("abc\xE2\x82"));
+    TEST(!Valid("\xF0\x9F\x98"));
+    TEST(!Valid("\x80"));
+    TEST(!Valid("a\xBF" "b"));
+    TEST(!Valid("\xC3\xA9\xA9"));
+    TEST(!Valid("\xE2\x82\xAC\xAC"));
+
+    //a sequence crossing the edge between 2 blocks
+    TEST(Valid("0123456789abcde\xE2\x82\xAC"));
+    TEST(Valid("0123456789abcd\xF0\x9F\x98\x80" "0123456789abcdef"));
+    TEST(!Valid("0123456789abcde\xE2\x82"));
+    TEST(!Valid("0123456789abcde\xE2" "0123456789abcdef"));
+
+    //an incomplete sequence right before a block of ascii
+    TEST(!Valid("0123456789abcde\xC3" "0123456789abcdef0123456789abcdef"));
+
+    TEST(Unicode::ValidPrefix("ab\xC3\xA9\xFF", 5) == 4);
+}
+
+void Fuzz()
+{
+    //mutate valid text at random and check the simd validator agrees with the simple one
+    const char* Seed = "Hello, \xE4\xB8\x96\xE7\x95\x8C! caf\xC3\xA9 \xF0\x9F\x98\x80 na\xC3\xAFve \xE2\x82\xAC 100 ";
+    const U32 SeedLen = (U32)strlen(Seed);
+
+    char Buffer[256];
+    U64 State = 0x9E3779B97F4A7C15ULL;
+
+    auto Next = [&State]() {
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+        return State;
+    };
+
+    U32 Invalid = 0;
+
+    for(U32 Round = 0; Round < 200000; Round++)
+    {
+        const U32 Len = (U32)(Next() % sizeof(Buffer));
+
+        for(U32 I = 0; I < Len; I++)
+            Buffer[I] = Seed[(I + Round) % SeedLen];
+
+        const U32 Flips = (U32)(Next() % 3);
+
+        for(U32 I = 0; I < Flips && Len; I++)
+            Buffer[Next() % Len] = (char)Next();
+
+        const bool Fast = Unicode::IsValid(Buffer, Len);
+        TEST(Fast == (Unicode::ValidPrefix(Buffer, Len) == Len));
+
+        Invalid += !Fast;
+    }
+
+    //make sure the mutations actually broke something now and then
+    TEST(Invalid > 1000);
+
+    //every 1, 2 and 3 byte sequence against the decoder
+    for(U32 Bits = 0; Bits < (1 << 24); Bits++)
+    {
+        const char Bytes[3] = { (char)(Bits >> 16), (char)(Bits >> 8), (char)Bits };
+        C32 Point;
+        const U32 Width = Unicode::Decode(Bytes, 3, Point);
+
+        const bool Fast = Unicode::IsValid(Bytes, 3);
+        TEST(Fast == (Unicode::ValidPrefix(Bytes, 3) == 3));
+
+        if(Width != 0)
+        {
+            char Again[4];
+            TEST(Unicode::Encode(Point, Again) == Width);
+            TEST(memcmp(Again, Bytes, Width) == 0);
+        }
+    }
+}
+
+void Counting()
+{
+    TEST(Unicode::CountCodePoints("", 0) == 0);
+    TEST(Unicode::CountCodePoints(String("caf\xC3\xA9")) == 4);
+    TEST(Unicode::CountCodePoints(String("\xF0\x9F\x98\x80 and \xE2\x82\xAC, twice: \xF0\x9F\x98\x80\xE2\x82\xAC")) == 18);
+
+    TEST(Unicode::IsAscii(String("plain ascii that is long enough to take the fast path")));
+    TEST(!Unicode::IsAscii(String("plain ascii that is long enough to take the fast path \xC3\xA9")));
+
+    C32 Expected[] = { 'c', 'a', 'f', 0xE9, Unicode::Replacement, 0x1F600 };
+    U32 I = 0;
+
+    //the range only points into the string so it has to outlive the loop
+    const String Mixed = "caf\xC3\xA9\xFF\xF0\x9F\x98\x80";
+
+    for(C32 Point : Unicode::CodePoints(Mixed))
+        TEST(Point == Expected[I++]);
+
+    TEST(I == 6);
+}
+
+void Transcoding()
+{
+    const String Text = "h\xC3\xA9llo w\xC3\xB6rld \xE4\xB8\x96\xE7\x95\x8C \xF0\x9F\x98\x80!";
+
+    Array<C16> Wide;
+    auto Units = Unicode::ToUTF16(Text, Wide);
+    TEST(Units.Valid());
+    TEST(Units.Value() == 18);
+    TEST(Wide.Len() == 18);
+    TEST(Wide[1] == 0xE9);
+    TEST((U16)Wide[15] == 0xD83D && (U16)Wide[16] == 0xDE00);
+
+    auto Back = Unicode::FromUTF16(Wide.Data(), Wide.Len());
+    TEST(Back.Valid());
+    TEST(Back.Value() == Text);
+
+    Array<C32> Points;
+    auto Count = Unicode::ToUTF32(Text, Points);
+    TEST(Count.Valid());
+    TEST(Count.Value() == 17);
+    TEST(Points[15] == 0x1F600);
+
+    auto Again = Unicode::FromUTF32(Points.Data(), Points.Len());
+    TEST(Again.Valid());
+    TEST(Again.Value() == Text);
+
+    //U+0000 is a real character and stays in the string
+    const C16 WideNull[] = { 'a', 0, 'b' };
+    TEST(Unicode::FromUTF16(WideNull, 3).Value().Len() == 3);
+
+    const C32 PointNull[] = { 0, 0x1F600 };
+    auto Nulled = Unicode::FromUTF32(PointNull, 2);
+    TEST(Nulled.Value().Len() == 5);
+    TEST(Nulled.Value()[0] == '\0');
+
+    //appending keeps whats already there
+    Array<C32> Ascii;
+    Unicode::ToUTF32(String("ab"), Ascii);
+    Unicode::ToUTF32(String("cd"), Ascii);
+    TEST(Ascii.Len() == 4 && Ascii[3] == 'd');
+
+    auto Bad = Unicode::ToUTF16(String("ok\xC3(oops"), Wide);
+    TEST(!Bad.Valid());
+    TEST(Bad.Error() == 2);
+
+    const C16 Lone[] = { 'a', (C16)0xDC00, 'b' };
+    TEST(Unicode::FromUTF16(Lone, 3).Error() == 1);
+
+    const C16 Unpaired[] = { 'a', (C16)0xD800 };
+    TEST(Unicode::FromUTF16(Unpaired, 2).Error() == 1);
+
+    const C32 TooBig[] = { 'a', 'b', 0x110000 };
+    TEST(Unicode::FromUTF32(TooBig, 3).Error() == 2);
+}
+
+int main()
+{
+    Validation();
+    Fuzz();
+    Counting();
+    Transcoding();
+}